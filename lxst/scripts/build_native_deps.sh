@@ -5,7 +5,7 @@
 #   abi: armeabi-v7a | arm64-v8a | all (default: armeabi-v7a)
 #
 # Prerequisites: Android NDK r21e at $ANDROID_HOME/ndk/21.4.7075529
-#                git, cmake, make
+#                git, cmake, make, autoconf/automake/libtool, wget (Opus DNN model)
 
 set -euo pipefail
 
@@ -76,6 +76,13 @@ build_opus() {
         git clone --depth 1 --branch "$OPUS_VERSION" "$OPUS_REPO" "$src_dir"
     fi
 
+    # DRED and OSCE (LACE/NoLACE) need the DNN model weights, which aren't in git. autogen.sh
+    # downloads the set matching this release.
+    if [[ ! -f "$src_dir/dnn/fargan_data.c" ]]; then
+        log "Fetching Opus DNN model..."
+        (cd "$src_dir" && ./autogen.sh)
+    fi
+
     log "Building Opus for $abi..."
     rm -rf "$build_dir"
     mkdir -p "$build_dir"
@@ -90,6 +97,8 @@ build_opus() {
         -DOPUS_BUILD_TESTING=OFF \
         -DOPUS_BUILD_PROGRAMS=OFF \
         -DOPUS_INSTALL_PKG_CONFIG_MODULE=OFF \
+        -DOPUS_DRED=ON \
+        -DOPUS_OSCE=ON \
         -DBUILD_SHARED_LIBS=ON
 
     cmake --build "$build_dir" --parallel "$(nproc)"
@@ -44,7 +44,7 @@ class OboeLineSourceCaptureInstrumentedTest {
     private val samplesPerFrame = 960 // 20ms at 48kHz
 
     // Ring buffer sizing for tests (matching OboeLineSource defaults)
-    private val maxBufferFrames = 75 // 1500ms / 20ms
+    private val maxBufferMs = 1500
 
     @Before
     fun setup() {
@@ -74,7 +74,7 @@ class OboeLineSourceCaptureInstrumentedTest {
                 sampleRate,
                 channels,
                 samplesPerFrame,
-                maxBufferFrames,
+                maxBufferMs,
                 enableFilters = true,
             )
         assertTrue("Native capture engine should be created", created)
@@ -121,7 +121,7 @@ class OboeLineSourceCaptureInstrumentedTest {
                 sampleRate,
                 channels,
                 samplesPerFrame,
-                maxBufferFrames,
+                maxBufferMs,
                 enableFilters = true,
             )
         assertTrue("Native capture engine should be created", created)
@@ -160,7 +160,7 @@ class OboeLineSourceCaptureInstrumentedTest {
                 sampleRate,
                 channels,
                 samplesPerFrame,
-                maxBufferFrames,
+                maxBufferMs,
                 enableFilters = false,
             )
         assertTrue("Native capture engine should be created", created)
@@ -299,7 +299,7 @@ class OboeLineSourceCaptureInstrumentedTest {
                 sampleRate,
                 channels,
                 samplesPerFrame,
-                maxBufferFrames,
+                maxBufferMs,
                 enableFilters = true,
             )
         assertTrue("Engine should be created", created)
@@ -18,9 +18,9 @@ import org.junit.runner.RunWith
 import tech.torlando.lxst.audio.LinkSource
 import tech.torlando.lxst.audio.NativeCaptureEngine
 import tech.torlando.lxst.audio.NativePlaybackEngine
-import tech.torlando.lxst.audio.OboeLineSink
 import tech.torlando.lxst.codec.Codec
 import tech.torlando.lxst.codec.Codec2
+import tech.torlando.lxst.codec.Null
 import tech.torlando.lxst.codec.Opus
 
 /**
@@ -39,6 +39,9 @@ import tech.torlando.lxst.codec.Opus
  * **Mute tests:** Verify native capture/playback mute produces silence
  * without breaking the packet stream.
  *
+ * **LAN codec tests:** PCM16, G.711 µ-law/A-law and G.722 packets from
+ * the native encoder decode in the native decoder, one frame per packet.
+ *
  * **Reconfiguration tests:** Verify codec can be destroyed and reconfigured
  * mid-stream (simulates profile switch during active call).
  *
@@ -163,23 +166,15 @@ class NativeCodecInstrumentedTest {
                 sampleRate = decParams.sampleRate,
                 channels = decParams.channels,
                 frameSamples = decodedFrameSamples,
-                maxBufferFrames = 75,
-                prebufferFrames = PREBUFFER_FRAMES,
+                prebufferMs = PREBUFFER_FRAMES * profile.frameTimeMs,
+                maxBufferMs = 75 * profile.frameTimeMs,
             )
         assertTrue("Native playback engine should create for ${profile.abbreviation}", created)
         playbackEngineCreated = true
 
         // Configure native decoder
         val configured =
-            NativePlaybackEngine.configureDecoder(
-                codecType = decParams.codecType,
-                sampleRate = decParams.sampleRate,
-                channels = decParams.channels,
-                opusApp = decParams.opusApplication,
-                opusBitrate = decParams.opusBitrate,
-                opusComplexity = decParams.opusComplexity,
-                codec2Mode = decParams.codec2LibraryMode,
-            )
+            NativePlaybackEngine.configureDecoder(decParams.copy(dredDurationMs = 0).toConfigArray())
         assertTrue("Native decoder should configure for ${profile.abbreviation}", configured)
 
         // Prebuffer: write encoded packets that decode into ring buffer
@@ -286,8 +281,8 @@ class NativeCodecInstrumentedTest {
                 sampleRate = 48000,
                 channels = 1,
                 frameSamples = decFrameSamples,
-                maxBufferFrames = 75,
-                prebufferFrames = PREBUFFER_FRAMES,
+                prebufferMs = PREBUFFER_FRAMES * 60,
+                maxBufferMs = 75 * 60,
             )
         assertTrue("Playback engine should create", created)
         playbackEngineCreated = true
@@ -295,15 +290,7 @@ class NativeCodecInstrumentedTest {
         // Phase 1: MQ native decode (1.5s)
         val mqEnc = trackCodec(Profile.MQ.createCodec())
         val mqDecParams = Profile.MQ.nativeDecodeParams()
-        NativePlaybackEngine.configureDecoder(
-            codecType = mqDecParams.codecType,
-            sampleRate = mqDecParams.sampleRate,
-            channels = mqDecParams.channels,
-            opusApp = mqDecParams.opusApplication,
-            opusBitrate = mqDecParams.opusBitrate,
-            opusComplexity = mqDecParams.opusComplexity,
-            codec2Mode = mqDecParams.codec2LibraryMode,
-        )
+        NativePlaybackEngine.configureDecoder(mqDecParams.copy(dredDurationMs = 0).toConfigArray())
 
         // Prebuffer MQ frames
         repeat(PREBUFFER_FRAMES + 1) {
@@ -324,15 +311,7 @@ class NativeCodecInstrumentedTest {
 
         val hqEnc = trackCodec(Profile.HQ.createCodec())
         val hqDecParams = Profile.HQ.nativeDecodeParams()
-        NativePlaybackEngine.configureDecoder(
-            codecType = hqDecParams.codecType,
-            sampleRate = hqDecParams.sampleRate,
-            channels = hqDecParams.channels,
-            opusApp = hqDecParams.opusApplication,
-            opusBitrate = hqDecParams.opusBitrate,
-            opusComplexity = hqDecParams.opusComplexity,
-            codec2Mode = hqDecParams.codec2LibraryMode,
-        )
+        NativePlaybackEngine.configureDecoder(hqDecParams.copy(dredDurationMs = 0).toConfigArray())
 
         val baseline = NativePlaybackEngine.getXRunCount()
 
@@ -364,22 +343,14 @@ class NativeCodecInstrumentedTest {
                 sampleRate = encParams.sampleRate,
                 channels = encParams.channels,
                 frameSamples = encParams.sampleRate * Profile.MQ.frameTimeMs / 1000,
-                maxBufferFrames = 75,
+                maxBufferMs = 75 * 60,
                 enableFilters = true,
             )
         assertTrue("Capture engine should create", created)
 
         // Configure native encoder
         val encoderConfigured =
-            NativeCaptureEngine.configureEncoder(
-                codecType = encParams.codecType,
-                sampleRate = encParams.sampleRate,
-                channels = encParams.channels,
-                opusApp = encParams.opusApplication,
-                opusBitrate = encParams.opusBitrate,
-                opusComplexity = encParams.opusComplexity,
-                codec2Mode = encParams.codec2LibraryMode,
-            )
+            NativeCaptureEngine.configureEncoder(encParams.copy(dredDurationMs = 0).toConfigArray())
         assertTrue("Native encoder should configure", encoderConfigured)
 
         val started = NativeCaptureEngine.startStream()
@@ -431,21 +402,13 @@ class NativeCodecInstrumentedTest {
                 sampleRate = encParams.sampleRate,
                 channels = encParams.channels,
                 frameSamples = encParams.sampleRate * Profile.HQ.frameTimeMs / 1000,
-                maxBufferFrames = 75,
+                maxBufferMs = 75 * 60,
                 enableFilters = true,
             )
         assertTrue("Capture engine should create", created)
 
         val encoderConfigured =
-            NativeCaptureEngine.configureEncoder(
-                codecType = encParams.codecType,
-                sampleRate = encParams.sampleRate,
-                channels = encParams.channels,
-                opusApp = encParams.opusApplication,
-                opusBitrate = encParams.opusBitrate,
-                opusComplexity = encParams.opusComplexity,
-                codec2Mode = encParams.codec2LibraryMode,
-            )
+            NativeCaptureEngine.configureEncoder(encParams.copy(dredDurationMs = 0).toConfigArray())
         assertTrue("HQ native encoder should configure", encoderConfigured)
 
         val started = NativeCaptureEngine.startStream()
@@ -465,6 +428,114 @@ class NativeCodecInstrumentedTest {
         )
     }
 
+    // =====================================================================
+    //  LAN CODECS: PCM16, G.711 and G.722 through both native engines
+    // =====================================================================
+
+    /**
+     * Native capture → encode → readEncodedPacket → writeEncodedPacket →
+     * native decode, for one of the Android-only LAN codecs (20ms frames).
+     * Only the LAN profile (G.722) selects one of these, so this is what
+     * exercises the others end to end; bit-level round trips and G.722 SNR
+     * are in the host tests (pcm_g722_codec_test.cpp).
+     *
+     * @return Encoded packets captured
+     */
+    private fun runLanCodecLoopback(
+        codecType: Int,
+        sampleRate: Int,
+        packetBytes: Int,
+    ): List<ByteArray> {
+        val frameSamples = sampleRate * 20 / 1000
+        val config = NativeCodecParams(codecType = codecType, sampleRate = sampleRate, channels = 1).toConfigArray()
+
+        assertTrue(
+            "Capture engine should create for codec $codecType",
+            NativeCaptureEngine.create(
+                sampleRate = sampleRate,
+                channels = 1,
+                frameSamples = frameSamples,
+                maxBufferMs = 2000,
+                enableFilters = true,
+            ),
+        )
+        assertTrue("Native encoder should configure for codec $codecType", NativeCaptureEngine.configureEncoder(config))
+        assertTrue("Capture stream should start", NativeCaptureEngine.startStream())
+        Thread.sleep(1000)
+
+        val encodedBuf = ByteArray(1500)
+        val packets = mutableListOf<ByteArray>()
+        while (true) {
+            val len = NativeCaptureEngine.readEncodedPacket(encodedBuf)
+            if (len <= 0) break
+            packets.add(encodedBuf.copyOf(len))
+        }
+        NativeCaptureEngine.stopStream()
+        NativeCaptureEngine.destroyEncoder()
+        NativeCaptureEngine.destroy()
+
+        // 50 packets/s; allow margin for stream startup
+        assertTrue("Codec $codecType: should capture >=20 packets in 1s (got ${packets.size})", packets.size >= 20)
+        packets.forEach { assertEquals("Codec $codecType: packet size", packetBytes, it.size) }
+
+        assertTrue(
+            "Playback engine should create for codec $codecType",
+            NativePlaybackEngine.create(
+                sampleRate = sampleRate,
+                channels = 1,
+                frameSamples = frameSamples,
+                prebufferMs = 100,
+                maxBufferMs = 2000,
+            ),
+        )
+        playbackEngineCreated = true
+        assertTrue("Native decoder should configure for codec $codecType", NativePlaybackEngine.configureDecoder(config))
+
+        // The stream is not started, so every decoded frame stays queued.
+        // Decoding may run on the decode worker: give it a moment.
+        val written = packets.take(20)
+        written.forEach {
+            assertTrue("Codec $codecType: packet should decode", NativePlaybackEngine.writeEncodedPacket(it, 0, it.size))
+        }
+        val deadline = System.currentTimeMillis() + 500
+        while (NativePlaybackEngine.getBufferedFrameCount() < written.size && System.currentTimeMillis() < deadline) {
+            Thread.sleep(10)
+        }
+        assertEquals("Codec $codecType: one decoded frame per packet", written.size, NativePlaybackEngine.getBufferedFrameCount())
+
+        NativePlaybackEngine.destroyDecoder()
+        NativePlaybackEngine.destroy()
+        playbackEngineCreated = false
+        return packets
+    }
+
+    @Test
+    fun pcm16_nativeLoopback_matchesKotlinNullCodec() {
+        val packets = runLanCodecLoopback(Profile.CODEC_TYPE_PCM16, 8000, packetBytes = 320)
+
+        // Same wire layout as the Kotlin Null codec: int16 little-endian
+        val decoded = Null().decode(packets.last())
+        assertEquals(160, decoded.size)
+        assertTrue("PCM16 samples should be in range", decoded.all { it >= -1f && it < 1f })
+    }
+
+    @Test
+    fun pcmu_nativeLoopback_oneBytePerSample() {
+        runLanCodecLoopback(Profile.CODEC_TYPE_PCMU, 8000, packetBytes = 160)
+    }
+
+    @Test
+    fun pcma_nativeLoopback_oneBytePerSample() {
+        runLanCodecLoopback(Profile.CODEC_TYPE_PCMA, 8000, packetBytes = 160)
+    }
+
+    @Test
+    fun lan_g722_nativeLoopback_oneBytePerTwoSamples() {
+        val params = Profile.LAN.nativeEncodeParams()
+        assertEquals(Profile.CODEC_TYPE_G722, params.codecType)
+        runLanCodecLoopback(params.codecType, params.sampleRate, packetBytes = 160)
+    }
+
     // =====================================================================
     //  NATIVE MUTE: Capture mute encodes silence
     // =====================================================================
@@ -478,20 +549,12 @@ class NativeCodecInstrumentedTest {
                 sampleRate = encParams.sampleRate,
                 channels = encParams.channels,
                 frameSamples = encParams.sampleRate * Profile.MQ.frameTimeMs / 1000,
-                maxBufferFrames = 75,
+                maxBufferMs = 75 * 60,
                 enableFilters = true,
             )
         assertTrue("Capture engine should create", created)
 
-        NativeCaptureEngine.configureEncoder(
-            codecType = encParams.codecType,
-            sampleRate = encParams.sampleRate,
-            channels = encParams.channels,
-            opusApp = encParams.opusApplication,
-            opusBitrate = encParams.opusBitrate,
-            opusComplexity = encParams.opusComplexity,
-            codec2Mode = encParams.codec2LibraryMode,
-        )
+        NativeCaptureEngine.configureEncoder(encParams.copy(dredDurationMs = 0).toConfigArray())
 
         // Enable mute BEFORE starting — should encode silence
         NativeCaptureEngine.setCaptureMute(true)
@@ -542,22 +605,14 @@ class NativeCodecInstrumentedTest {
                 sampleRate = 48000,
                 channels = 1,
                 frameSamples = decFrameSamples,
-                maxBufferFrames = 75,
-                prebufferFrames = PREBUFFER_FRAMES,
+                prebufferMs = PREBUFFER_FRAMES * 60,
+                maxBufferMs = 75 * 60,
             )
         assertTrue("Playback engine should create", created)
         playbackEngineCreated = true
 
         val mqDecParams = Profile.MQ.nativeDecodeParams()
-        NativePlaybackEngine.configureDecoder(
-            codecType = mqDecParams.codecType,
-            sampleRate = mqDecParams.sampleRate,
-            channels = mqDecParams.channels,
-            opusApp = mqDecParams.opusApplication,
-            opusBitrate = mqDecParams.opusBitrate,
-            opusComplexity = mqDecParams.opusComplexity,
-            codec2Mode = mqDecParams.codec2LibraryMode,
-        )
+        NativePlaybackEngine.configureDecoder(mqDecParams.copy(dredDurationMs = 0).toConfigArray())
 
         // Prebuffer and start unmuted
         val enc = trackCodec(Profile.MQ.createCodec())
@@ -613,20 +668,12 @@ class NativeCodecInstrumentedTest {
                 sampleRate = mqParams.sampleRate,
                 channels = mqParams.channels,
                 frameSamples = mqParams.sampleRate * Profile.MQ.frameTimeMs / 1000,
-                maxBufferFrames = 75,
+                maxBufferMs = 75 * 60,
                 enableFilters = true,
             )
         assertTrue("Capture engine should create", created)
 
-        NativeCaptureEngine.configureEncoder(
-            codecType = mqParams.codecType,
-            sampleRate = mqParams.sampleRate,
-            channels = mqParams.channels,
-            opusApp = mqParams.opusApplication,
-            opusBitrate = mqParams.opusBitrate,
-            opusComplexity = mqParams.opusComplexity,
-            codec2Mode = mqParams.codec2LibraryMode,
-        )
+        NativeCaptureEngine.configureEncoder(mqParams.copy(dredDurationMs = 0).toConfigArray())
 
         val started = NativeCaptureEngine.startStream()
         assertTrue("Capture stream should start", started)
@@ -642,15 +689,7 @@ class NativeCodecInstrumentedTest {
         NativeCaptureEngine.destroyEncoder()
 
         val llParams = Profile.LL.nativeEncodeParams()
-        NativeCaptureEngine.configureEncoder(
-            codecType = llParams.codecType,
-            sampleRate = llParams.sampleRate,
-            channels = llParams.channels,
-            opusApp = llParams.opusApplication,
-            opusBitrate = llParams.opusBitrate,
-            opusComplexity = llParams.opusComplexity,
-            codec2Mode = llParams.codec2LibraryMode,
-        )
+        NativeCaptureEngine.configureEncoder(llParams.copy(dredDurationMs = 0).toConfigArray())
 
         Thread.sleep(1500)
 
@@ -681,15 +720,7 @@ class NativeCodecInstrumentedTest {
         // Phase 1: configureEncoder BEFORE create() — should return false
         // (This was the bug: C++ sCaptureEngine is nullptr)
         val configBeforeCreate =
-            NativeCaptureEngine.configureEncoder(
-                codecType = encParams.codecType,
-                sampleRate = encParams.sampleRate,
-                channels = encParams.channels,
-                opusApp = encParams.opusApplication,
-                opusBitrate = encParams.opusBitrate,
-                opusComplexity = encParams.opusComplexity,
-                codec2Mode = encParams.codec2LibraryMode,
-            )
+            NativeCaptureEngine.configureEncoder(encParams.copy(dredDurationMs = 0).toConfigArray())
         assertFalse(
             "configureEncoder before create() must return false (engine doesn't exist)",
             configBeforeCreate,
@@ -706,21 +737,13 @@ class NativeCodecInstrumentedTest {
                 sampleRate = encParams.sampleRate,
                 channels = encParams.channels,
                 frameSamples = encParams.sampleRate * Profile.MQ.frameTimeMs / 1000,
-                maxBufferFrames = 75,
+                maxBufferMs = 75 * 60,
                 enableFilters = true,
             )
         assertTrue("Capture engine should create", created)
 
         val configAfterCreate =
-            NativeCaptureEngine.configureEncoder(
-                codecType = encParams.codecType,
-                sampleRate = encParams.sampleRate,
-                channels = encParams.channels,
-                opusApp = encParams.opusApplication,
-                opusBitrate = encParams.opusBitrate,
-                opusComplexity = encParams.opusComplexity,
-                codec2Mode = encParams.codec2LibraryMode,
-            )
+            NativeCaptureEngine.configureEncoder(encParams.copy(dredDurationMs = 0).toConfigArray())
         assertTrue(
             "configureEncoder after create() must return true",
             configAfterCreate,
@@ -757,7 +780,7 @@ class NativeCodecInstrumentedTest {
                 sampleRate = encParams.sampleRate,
                 channels = encParams.channels,
                 frameSamples = frameSamples,
-                maxBufferFrames = 75,
+                maxBufferMs = 75 * 60,
                 enableFilters = true,
             )
         assertTrue("Step 1: create should succeed", created)
@@ -765,15 +788,7 @@ class NativeCodecInstrumentedTest {
         // Step 2: configureEncoder (moved from Telephone.openPipelinesNativeCodec()
         // into OboeLineSource.start(), after create())
         val configured =
-            NativeCaptureEngine.configureEncoder(
-                codecType = encParams.codecType,
-                sampleRate = encParams.sampleRate,
-                channels = encParams.channels,
-                opusApp = encParams.opusApplication,
-                opusBitrate = encParams.opusBitrate,
-                opusComplexity = encParams.opusComplexity,
-                codec2Mode = encParams.codec2LibraryMode,
-            )
+            NativeCaptureEngine.configureEncoder(encParams.copy(dredDurationMs = 0).toConfigArray())
         assertTrue("Step 2: configureEncoder after create should succeed", configured)
 
         // Step 3: startStream
@@ -838,23 +853,15 @@ class NativeCodecInstrumentedTest {
                 sampleRate = 48000,
                 channels = 1,
                 frameSamples = decFrameSamples,
-                maxBufferFrames = 75,
-                prebufferFrames = PREBUFFER_FRAMES,
+                prebufferMs = PREBUFFER_FRAMES * 60,
+                maxBufferMs = 75 * 60,
             )
         assertTrue("Playback engine should create", created)
         playbackEngineCreated = true
 
         // Configure native decoder (HQ profile)
         val hqDecParams = Profile.HQ.nativeDecodeParams()
-        NativePlaybackEngine.configureDecoder(
-            codecType = hqDecParams.codecType,
-            sampleRate = hqDecParams.sampleRate,
-            channels = hqDecParams.channels,
-            opusApp = hqDecParams.opusApplication,
-            opusBitrate = hqDecParams.opusBitrate,
-            opusComplexity = hqDecParams.opusComplexity,
-            codec2Mode = hqDecParams.codec2LibraryMode,
-        )
+        NativePlaybackEngine.configureDecoder(hqDecParams.copy(dredDurationMs = 0).toConfigArray())
 
         // Prebuffer encoded frames into ring buffer
         val enc = trackCodec(Profile.HQ.createCodec())
@@ -920,20 +927,12 @@ class NativeCodecInstrumentedTest {
                 sampleRate = encParams.sampleRate,
                 channels = encParams.channels,
                 frameSamples = encParams.sampleRate * Profile.HQ.frameTimeMs / 1000,
-                maxBufferFrames = 75,
+                maxBufferMs = 75 * 60,
                 enableFilters = true,
             )
         assertTrue("Capture engine should create", created)
 
-        NativeCaptureEngine.configureEncoder(
-            codecType = encParams.codecType,
-            sampleRate = encParams.sampleRate,
-            channels = encParams.channels,
-            opusApp = encParams.opusApplication,
-            opusBitrate = encParams.opusBitrate,
-            opusComplexity = encParams.opusComplexity,
-            codec2Mode = encParams.codec2LibraryMode,
-        )
+        NativeCaptureEngine.configureEncoder(encParams.copy(dredDurationMs = 0).toConfigArray())
 
         // Start stream — race condition lived here
         val started = NativeCaptureEngine.startStream()
@@ -994,23 +993,15 @@ class NativeCodecInstrumentedTest {
                 sampleRate = 48000,
                 channels = 1,
                 frameSamples = decFrameSamples,
-                maxBufferFrames = 75,
-                prebufferFrames = PREBUFFER_FRAMES,
+                prebufferMs = PREBUFFER_FRAMES * 60,
+                maxBufferMs = 75 * 60,
             )
         assertTrue("Playback engine should create", created)
         playbackEngineCreated = true
 
         // Configure native decoder (HQ profile)
         val hqDecParams = Profile.HQ.nativeDecodeParams()
-        NativePlaybackEngine.configureDecoder(
-            codecType = hqDecParams.codecType,
-            sampleRate = hqDecParams.sampleRate,
-            channels = hqDecParams.channels,
-            opusApp = hqDecParams.opusApplication,
-            opusBitrate = hqDecParams.opusBitrate,
-            opusComplexity = hqDecParams.opusComplexity,
-            codec2Mode = hqDecParams.codec2LibraryMode,
-        )
+        NativePlaybackEngine.configureDecoder(hqDecParams.copy(dredDurationMs = 0).toConfigArray())
 
         // Pre-load ALL frames into ring buffer (no real-time pacing)
         val enc = trackCodec(Profile.HQ.createCodec())
@@ -1073,7 +1064,7 @@ class NativeCodecInstrumentedTest {
      */
     private fun createDecoderEngine(
         profile: Profile,
-        prebufferFrames: Int,
+        prebufferMs: Int,
     ): Codec {
         val encCodec = trackCodec(profile.createCodec())
         val decParams = profile.nativeDecodeParams()
@@ -1085,22 +1076,14 @@ class NativeCodecInstrumentedTest {
                 sampleRate = decParams.sampleRate,
                 channels = decParams.channels,
                 frameSamples = decodedFrameSamples,
-                maxBufferFrames = OboeLineSink.MAX_QUEUE_SLOTS,
-                prebufferFrames = prebufferFrames,
+                prebufferMs = prebufferMs,
+                maxBufferMs = LinkSource.computeMaxBufferMs(profile.frameTimeMs),
             )
         assertTrue("Engine should create for ${profile.abbreviation}", created)
         playbackEngineCreated = true
 
         val configured =
-            NativePlaybackEngine.configureDecoder(
-                codecType = decParams.codecType,
-                sampleRate = decParams.sampleRate,
-                channels = decParams.channels,
-                opusApp = decParams.opusApplication,
-                opusBitrate = decParams.opusBitrate,
-                opusComplexity = decParams.opusComplexity,
-                codec2Mode = decParams.codec2LibraryMode,
-            )
+            NativePlaybackEngine.configureDecoder(decParams.copy(dredDurationMs = 0).toConfigArray())
         assertTrue("Decoder should configure for ${profile.abbreviation}", configured)
 
         return encCodec
@@ -1138,7 +1121,7 @@ class NativeCodecInstrumentedTest {
     @Test
     fun ull_lowPrebuffer_drainsInstantly() {
         sinePhase = 0.0
-        val enc = createDecoderEngine(Profile.ULL, prebufferFrames = 5)
+        val enc = createDecoderEngine(Profile.ULL, prebufferMs = 5 * Profile.ULL.frameTimeMs)
 
         // Pre-load exactly 5 ULL frames (50ms of audio)
         repeat(5) { writeEncodedFrame(enc, Profile.ULL) }
@@ -1168,10 +1151,10 @@ class NativeCodecInstrumentedTest {
     }
 
     /**
-     * Fix verification: ULL with 30-frame prebuffer (300ms) — pre-loaded data
+     * Fix verification: ULL with time-based prebuffer (450ms) — pre-loaded data
      * plays with minimal silence.
      *
-     * Fix: LinkSource.computePrebufferFrames(10ms) = max(5, 300/10) = 30 frames.
+     * Fix: LinkSource.computePrebufferMs(10ms) = max(450, 5 × 10) = 450ms.
      *
      * This is the same pattern as nativeDecoder_prebuffer_preventsExcessiveSilence
      * but specifically for ULL (10ms frames). Pre-loads all data, verifies the
@@ -1180,11 +1163,11 @@ class NativeCodecInstrumentedTest {
     @Test
     fun ull_adequatePrebuffer_preloaded_minimalSilence() {
         sinePhase = 0.0
-        val prebufferFrames = LinkSource.computePrebufferFrames(Profile.ULL.frameTimeMs)
-        // Should be max(5, 300/10) = 30
+        val prebufferMs = LinkSource.computePrebufferMs(Profile.ULL.frameTimeMs)
+        // Should be max(450, 5 × 10) = 450ms
         val framesToLoad = 50 // 500ms of ULL audio
 
-        val enc = createDecoderEngine(Profile.ULL, prebufferFrames = prebufferFrames)
+        val enc = createDecoderEngine(Profile.ULL, prebufferMs = prebufferMs)
 
         // Pre-load ALL frames (500ms) — no real-time pacing
         repeat(framesToLoad) { writeEncodedFrame(enc, Profile.ULL) }
@@ -1224,20 +1207,20 @@ class NativeCodecInstrumentedTest {
     }
 
     /**
-     * Fix verification: LL with 15-frame prebuffer (300ms) — pre-loaded data
+     * Fix verification: LL with time-based prebuffer (450ms) — pre-loaded data
      * plays with minimal silence.
      *
-     * LL (20ms frames): computePrebufferFrames(20) = max(5, 300/20) = 15 frames.
+     * LL (20ms frames): computePrebufferMs(20) = max(450, 5 × 20) = 450ms.
      * Pre-loads 30 LL frames (600ms), verifies smooth playback.
      */
     @Test
     fun ll_adequatePrebuffer_preloaded_minimalSilence() {
         sinePhase = 0.0
-        val prebufferFrames = LinkSource.computePrebufferFrames(Profile.LL.frameTimeMs)
-        // Should be max(5, 300/20) = 15
+        val prebufferMs = LinkSource.computePrebufferMs(Profile.LL.frameTimeMs)
+        // Should be max(450, 5 × 20) = 450ms
         val framesToLoad = 30 // 600ms of LL audio
 
-        val enc = createDecoderEngine(Profile.LL, prebufferFrames = prebufferFrames)
+        val enc = createDecoderEngine(Profile.LL, prebufferMs = prebufferMs)
 
         // Pre-load ALL frames (600ms)
         repeat(framesToLoad) { writeEncodedFrame(enc, Profile.LL) }
@@ -1270,22 +1253,24 @@ class NativeCodecInstrumentedTest {
     }
 
     /**
-     * Verify computePrebufferFrames gives correct values for all profiles.
+     * Verify computePrebufferMs / computeMaxBufferMs give correct values for all profiles.
      */
     @Test
-    fun computePrebufferFrames_timeBased_allProfiles() {
-        // Standard profiles (60ms): 300/60 = 5, max(5,5) = 5
-        assertEquals(5, LinkSource.computePrebufferFrames(Profile.MQ.frameTimeMs))
-        assertEquals(5, LinkSource.computePrebufferFrames(Profile.HQ.frameTimeMs))
-        assertEquals(5, LinkSource.computePrebufferFrames(Profile.SHQ.frameTimeMs))
-
-        // Low-latency profiles
-        assertEquals(15, LinkSource.computePrebufferFrames(Profile.LL.frameTimeMs)) // 300/20 = 15
-        assertEquals(30, LinkSource.computePrebufferFrames(Profile.ULL.frameTimeMs)) // 300/10 = 30
-
-        // Codec2 profiles (long frames): floor clamps to 5
-        assertEquals(5, LinkSource.computePrebufferFrames(Profile.ULBW.frameTimeMs)) // 300/400 = 0 → 5
-        assertEquals(5, LinkSource.computePrebufferFrames(Profile.VLBW.frameTimeMs)) // 300/320 = 0 → 5
-        assertEquals(5, LinkSource.computePrebufferFrames(Profile.LBW.frameTimeMs)) // 300/200 = 1 → 5
+    fun computePrebufferMs_timeBased_allProfiles() {
+        // Same target regardless of frame size
+        assertEquals(450, LinkSource.computePrebufferMs(Profile.MQ.frameTimeMs))
+        assertEquals(450, LinkSource.computePrebufferMs(Profile.HQ.frameTimeMs))
+        assertEquals(450, LinkSource.computePrebufferMs(Profile.SHQ.frameTimeMs))
+        assertEquals(450, LinkSource.computePrebufferMs(Profile.LL.frameTimeMs))
+        assertEquals(450, LinkSource.computePrebufferMs(Profile.ULL.frameTimeMs))
+
+        // Codec2 long frames: the five-frame floor of the old frame-count prebuffer
+        assertEquals(1000, LinkSource.computePrebufferMs(Profile.LBW.frameTimeMs)) // 5 × 200
+        assertEquals(2000, LinkSource.computePrebufferMs(Profile.ULBW.frameTimeMs)) // 5 × 400
+        assertEquals(1600, LinkSource.computePrebufferMs(Profile.VLBW.frameTimeMs)) // 5 × 320
+
+        // Capacity leaves room above the 2× drain threshold
+        assertEquals(1500, LinkSource.computeMaxBufferMs(Profile.MQ.frameTimeMs))
+        assertEquals(4400, LinkSource.computeMaxBufferMs(Profile.ULBW.frameTimeMs)) // 2 × 2000 + 400
     }
 }
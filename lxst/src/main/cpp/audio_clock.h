@@ -0,0 +1,39 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_AUDIO_CLOCK_H
+#define LXST_AUDIO_CLOCK_H
+
+#include <cstdint>
+#include <ctime>
+
+/**
+ * CLOCK_MONOTONIC in nanoseconds.
+ *
+ * Same clock Oboe uses for AudioStream::getTimestamp(CLOCK_MONOTONIC), so
+ * engine timestamps can be compared directly against presentation times.
+ * Safe to call from the SCHED_FIFO callback (vDSO, no syscall on arm64).
+ */
+inline int64_t monotonicNanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/** Interleaved int16 sample count covering durationMs of audio. */
+inline int samplesForMs(int durationMs, int sampleRate, int channels) {
+    return static_cast<int>(static_cast<int64_t>(durationMs) * sampleRate / 1000) * channels;
+}
+
+/**
+ * Ring buffer slots needed to hold at least `samples` samples in
+ * frames of frameSamples, plus the slot SPSC rings keep empty.
+ */
+inline int slotsForSamples(int samples, int frameSamples) {
+    if (frameSamples <= 0) return 2;
+    int frames = (samples + frameSamples - 1) / frameSamples;
+    return (frames < 1 ? 1 : frames) + 1;
+}
+
+#endif // LXST_AUDIO_CLOCK_H
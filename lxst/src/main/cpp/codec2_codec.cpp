@@ -0,0 +1,258 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "codec2_codec.h"
+#include "include/codec2/codec2.h"
+#include <android/log.h>
+#include <cstring>
+
+#define LOG_TAG "LXST:Codec2Codec"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+Codec2Codec::~Codec2Codec() {
+    if (codec2_) codec2_destroy(codec2_);
+}
+
+bool Codec2Codec::create(const CodecConfig& config, MemoryLedger* /*ledger*/) {
+    const int libraryMode = config.codec2Mode;
+    if (codec2_) { codec2_destroy(codec2_); codec2_ = nullptr; }
+
+    codec2_ = codec2_create(libraryMode);
+    if (!codec2_) {
+        LOGE("Codec2 create failed for library mode %d", libraryMode);
+        return false;
+    }
+
+    libraryMode_ = libraryMode;
+    samplesPerFrame_ = codec2_samples_per_frame(codec2_);
+    bytesPerFrame_ = codec2_bytes_per_frame(codec2_);
+    modeHeader_ = libraryModeToHeader(libraryMode);
+
+    type_ = CodecType::CODEC2;
+    channels_ = 1;
+    sampleRate_ = 8000;  // Codec2 is always 8kHz
+
+    LOGI("Codec2 created: libMode=%d header=0x%02x samplesPerFrame=%d bytesPerFrame=%d",
+         libraryMode, modeHeader_, samplesPerFrame_, bytesPerFrame_);
+    return true;
+}
+
+int Codec2Codec::decode(const uint8_t* encoded, int encodedBytes,
+                        int16_t* output, int maxOutputSamples) {
+    if (!codec2_ || encodedBytes < 1) return -1;
+
+    // First byte is mode header — check if mode changed
+    uint8_t header = encoded[0];
+    bool isInterleaved = (header & INTERLEAVE_FLAG) != 0;
+    uint8_t modeHeader = isInterleaved ? (header & 0x0F) : header;
+    if (modeHeader != modeHeader_ && !switchMode(modeHeader)) return -1;
+
+    // Skip header byte, decode remaining sub-frames
+    const uint8_t* data = encoded + 1;
+    int dataLen = encodedBytes - 1;
+    int numFrames = dataLen / bytesPerFrame_;
+    if (isInterleaved) {
+        return decodeInterleaved(header, data, numFrames, output, maxOutputSamples);
+    }
+    int totalSamples = numFrames * samplesPerFrame_;
+
+    if (totalSamples > maxOutputSamples) {
+        LOGW("Codec2 decode: output buffer too small (%d > %d)",
+             totalSamples, maxOutputSamples);
+        return -1;
+    }
+
+    for (int i = 0; i < numFrames; i++) {
+        codec2_decode(codec2_,
+                      output + i * samplesPerFrame_,
+                      data + i * bytesPerFrame_);
+    }
+
+    return totalSamples;
+}
+
+int Codec2Codec::encode(const int16_t* pcm, int pcmSamples,
+                        uint8_t* output, int maxOutputBytes) {
+    if (!codec2_) return -1;
+
+    int numFrames = pcmSamples / samplesPerFrame_;
+    int encodedSize = 1 + numFrames * bytesPerFrame_;  // header + data
+
+    if (encodedSize > maxOutputBytes) {
+        LOGW("Codec2 encode: output buffer too small (%d > %d)",
+             encodedSize, maxOutputBytes);
+        return -1;
+    }
+
+    if (interleave_ && numFrames >= 2 && numFrames <= 32 &&
+        encodedSize <= MAX_PACKET_BYTES) {
+        output[0] = static_cast<uint8_t>(modeHeader_ | INTERLEAVE_FLAG | (seq_ << 4));
+        seq_ = (seq_ + 1) & 0x7;
+        encodeInterleaved(pcm, numFrames, output + 1);
+        return encodedSize;
+    }
+
+    // Prepend mode header byte
+    output[0] = modeHeader_;
+
+    for (int i = 0; i < numFrames; i++) {
+        codec2_encode(codec2_,
+                      output + 1 + i * bytesPerFrame_,
+                      const_cast<int16_t*>(pcm + i * samplesPerFrame_));
+    }
+
+    return encodedSize;
+}
+
+// --- Sub-frame interleaving ---
+
+void Codec2Codec::setInterleave(bool enabled) {
+    interleave_ = enabled;
+    prevValid_ = false;
+    seq_ = 0;
+    LOGI("Codec2 interleave: %d", enabled);
+}
+
+bool Codec2Codec::switchMode(uint8_t header) {
+    int newMode = headerToLibraryMode(header);
+    if (newMode < 0) {
+        LOGW("Unknown Codec2 header: 0x%02x", header);
+        return false;
+    }
+    LOGI("Codec2 mode switch: header 0x%02x → libMode %d", header, newMode);
+    codec2_destroy(codec2_);
+    codec2_ = codec2_create(newMode);
+    if (!codec2_) {
+        LOGE("Codec2 mode switch failed");
+        return false;
+    }
+    libraryMode_ = newMode;
+    samplesPerFrame_ = codec2_samples_per_frame(codec2_);
+    bytesPerFrame_ = codec2_bytes_per_frame(codec2_);
+    modeHeader_ = header;
+    pendingValid_ = false;  // Held sub-frames belong to the old mode
+    return true;
+}
+
+int Codec2Codec::encodeInterleaved(const int16_t* pcm, int numFrames, uint8_t* output) {
+    const int bytes = bytesPerFrame_;
+
+    // Before the first packet the "previous frame" is encoded silence, so
+    // the receiver's first output frame is quiet rather than garbage.
+    if (!prevValid_) {
+        int16_t silence[640] = {};
+        for (int i = 0; i < numFrames && samplesPerFrame_ <= 640; i++) {
+            codec2_encode(codec2_, prev_ + i * bytes, silence);
+        }
+        prevValid_ = true;
+    }
+
+    for (int i = 0; i < numFrames; i++) {
+        codec2_encode(codec2_, scratch_ + i * bytes,
+                      const_cast<int16_t*>(pcm + i * samplesPerFrame_));
+    }
+
+    // Even slots: this frame. Odd slots: the previous frame.
+    for (int i = 0; i < numFrames; i++) {
+        const uint8_t* src = (i & 1) ? prev_ : scratch_;
+        std::memcpy(output + i * bytes, src + i * bytes, bytes);
+    }
+    std::memcpy(prev_, scratch_, numFrames * bytes);
+    return numFrames * bytes;
+}
+
+int Codec2Codec::decodeInterleaved(uint8_t header, const uint8_t* data, int numFrames,
+                                   int16_t* output, int maxOutputSamples) {
+    const int bytes = bytesPerFrame_;
+    const int frameSamples = numFrames * samplesPerFrame_;
+    if (numFrames < 2 || numFrames > 32 || numFrames * bytes > MAX_PACKET_BYTES) return -1;
+
+    int seq = (header >> 4) & 0x7;
+    bool inOrder = pendingValid_ && pendingSlots_ == numFrames &&
+                   seq == ((pendingSeq_ + 1) & 0x7);
+    uint32_t evenMask = 0;
+    for (int i = 0; i < numFrames; i += 2) evenMask |= 1u << i;
+    uint32_t oddMask = ((numFrames >= 32) ? 0xFFFFFFFFu : ((1u << numFrames) - 1)) & ~evenMask;
+
+    int total = 0;
+    if (pendingValid_ && !inOrder) {
+        // The packet after the held frame was lost: play its even half
+        int pendingSamples = pendingSlots_ * samplesPerFrame_;
+        if (pendingSamples + frameSamples > maxOutputSamples) return -1;
+        decodeSlots(pending_, evenMask, pendingSlots_, output + total);
+        total += pendingSamples;
+    }
+
+    // Previous frame: odd half from this packet, even half if it was held
+    if (total + frameSamples > maxOutputSamples) return -1;
+    for (int i = 0; i < numFrames; i++) {
+        const uint8_t* src = (i & 1) ? data : pending_;
+        std::memcpy(scratch_ + i * bytes, src + i * bytes, bytes);
+    }
+    decodeSlots(scratch_, inOrder ? (evenMask | oddMask) : oddMask,
+                numFrames, output + total);
+    total += frameSamples;
+
+    // This frame's even half waits for the next packet
+    std::memcpy(pending_, data, numFrames * bytes);
+    pendingValid_ = true;
+    pendingSeq_ = seq;
+    pendingSlots_ = numFrames;
+    return total;
+}
+
+void Codec2Codec::decodeSlots(const uint8_t* frame, uint32_t presentMask, int numFrames,
+                              int16_t* output) {
+    for (int i = 0; i < numFrames; i++) {
+        int src = i;
+        if (!(presentMask & (1u << i))) {
+            // Neighbours are from the other half, so one of them is here
+            src = (i > 0 && (presentMask & (1u << (i - 1)))) ? i - 1 : i + 1;
+            if (src >= numFrames || !(presentMask & (1u << src))) {
+                std::memset(output + i * samplesPerFrame_, 0,
+                            sizeof(int16_t) * samplesPerFrame_);
+                continue;
+            }
+        }
+        codec2_decode(codec2_, output + i * samplesPerFrame_, frame + src * bytesPerFrame_);
+    }
+}
+
+// --- Static helpers: Codec2 mode header ↔ library mode mapping ---
+// Wire format (matches Python LXST and Kotlin Codec2.kt):
+//   header 0x00 = 700C  → library mode 8
+//   header 0x01 = 1200  → library mode 5
+//   header 0x02 = 1300  → library mode 4
+//   header 0x03 = 1400  → library mode 3
+//   header 0x04 = 1600  → library mode 2
+//   header 0x05 = 2400  → library mode 1
+//   header 0x06 = 3200  → library mode 0
+
+int Codec2Codec::headerToLibraryMode(uint8_t header) {
+    switch (header) {
+        case 0x00: return 8;  // 700C
+        case 0x01: return 5;  // 1200
+        case 0x02: return 4;  // 1300
+        case 0x03: return 3;  // 1400
+        case 0x04: return 2;  // 1600
+        case 0x05: return 1;  // 2400
+        case 0x06: return 0;  // 3200
+        default:   return -1; // Unknown
+    }
+}
+
+uint8_t Codec2Codec::libraryModeToHeader(int libraryMode) {
+    switch (libraryMode) {
+        case 8:  return 0x00;  // 700C
+        case 5:  return 0x01;  // 1200
+        case 4:  return 0x02;  // 1300
+        case 3:  return 0x03;  // 1400
+        case 2:  return 0x04;  // 1600
+        case 1:  return 0x05;  // 2400
+        case 0:  return 0x06;  // 3200
+        default: return 0xFF;  // Unknown
+    }
+}
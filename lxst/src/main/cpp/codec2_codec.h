@@ -0,0 +1,92 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_CODEC2_CODEC_H
+#define LXST_CODEC2_CODEC_H
+
+#include "codec_backend.h"
+
+struct CODEC2;
+
+/**
+ * libcodec2 encoder+decoder (always 8kHz mono).
+ *
+ * - Multi-frame: loops floor(encodedLen / bytesPerFrame) times
+ * - Mode header: first byte of encoded data; switch mode if different
+ * - Mode↔library mapping: wire headers 0x00-0x06 ↔ library modes 8,5,4,3,2,1,0
+ * - Optional sub-frame interleaving (see setInterleave)
+ *
+ * Codec2 allocates its state inside the library, so only this object is
+ * charged to the ledger.
+ */
+class Codec2Codec : public CodecBackend {
+public:
+    Codec2Codec() = default;
+    ~Codec2Codec();
+
+    /** Uses codec2Mode (0=3200, 1=2400, ..., 8=700C) from config. */
+    bool create(const CodecConfig& config, MemoryLedger* ledger);
+
+    /**
+     * Strips the mode header byte and loops over sub-frames. Interleaved
+     * packets yield the previous frame, or two frames after a loss.
+     */
+    int decode(const uint8_t* encoded, int encodedBytes, int16_t* output, int maxOutputSamples);
+
+    /** Prepends the mode header byte and loops over sub-frames. */
+    int encode(const int16_t* pcm, int pcmSamples, uint8_t* output, int maxOutputBytes);
+
+    /** See CodecWrapper::setCodec2Interleave. */
+    void setInterleave(bool enabled);
+    bool interleaved() const { return interleave_; }
+
+    /** Mode header bit marking an interleaved Codec2 packet. */
+    static constexpr uint8_t INTERLEAVE_FLAG = 0x80;
+
+    /** Largest Codec2 packet (header + sub-frames) the interleaver holds. */
+    static constexpr int MAX_PACKET_BYTES = 1500;
+
+private:
+    struct CODEC2* codec2_ = nullptr;
+    int samplesPerFrame_ = 0;
+    int bytesPerFrame_ = 0;
+    uint8_t modeHeader_ = 0;
+    int libraryMode_ = 0;
+
+    // Interleaving. Encoder: previous frame's sub-frames (its odd half
+    // goes out with the next packet). Decoder: the even half of the frame
+    // whose odd half arrives with the next packet.
+    bool interleave_ = false;
+    bool prevValid_ = false;
+    uint8_t seq_ = 0;                              // Encoder packet sequence (mod 8)
+    uint8_t prev_[MAX_PACKET_BYTES] = {};
+    bool pendingValid_ = false;
+    int pendingSeq_ = 0;
+    int pendingSlots_ = 0;
+    uint8_t pending_[MAX_PACKET_BYTES] = {};
+    uint8_t scratch_[MAX_PACKET_BYTES] = {};
+
+    // Switch the decoder to a new Codec2 wire mode header.
+    bool switchMode(uint8_t header);
+
+    // Encode/decode paths for interleaved packets (sub-frame data only,
+    // without the mode header).
+    int encodeInterleaved(const int16_t* pcm, int numFrames, uint8_t* output);
+    int decodeInterleaved(uint8_t header, const uint8_t* data, int numFrames,
+                          int16_t* output, int maxOutputSamples);
+
+    // Decode one frame's sub-frames; slots with present bit clear are
+    // concealed from a neighbouring slot.
+    void decodeSlots(const uint8_t* frame, uint32_t presentMask, int numFrames,
+                     int16_t* output);
+
+    // Codec2 mode header ↔ library mode mapping (matches Kotlin Codec2.kt)
+    // Wire headers: 0x00=700C, 0x01=1200, 0x02=1300, 0x03=1400,
+    //               0x04=1600, 0x05=2400, 0x06=3200
+    // Library modes: 8=700C, 5=1200, 4=1300, 3=1400, 2=1600, 1=2400, 0=3200
+    static int headerToLibraryMode(uint8_t header);
+    static uint8_t libraryModeToHeader(int libraryMode);
+};
+
+#endif // LXST_CODEC2_CODEC_H
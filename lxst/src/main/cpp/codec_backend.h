@@ -0,0 +1,117 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_CODEC_BACKEND_H
+#define LXST_CODEC_BACKEND_H
+
+#include <cstdint>
+#include "memory_ledger.h"
+
+/**
+ * Codec identifiers shared with Kotlin (Profile.CODEC_TYPE_*). The values
+ * of the Android-only codecs match their Packetizer header bytes.
+ */
+enum class CodecType {
+    NONE = 0,
+    OPUS = 1,
+    CODEC2 = 2,
+    PCM16 = 3,   // Linear 16-bit little-endian
+    PCMU = 4,    // G.711 µ-law
+    PCMA = 5,    // G.711 A-law
+    G722 = 6,    // G.722 sub-band ADPCM, 64 kbit/s
+};
+
+/**
+ * Codec configuration as passed over JNI: a flat int array, one entry per
+ * field (NativeCodecConfig.kt has the same layout). Fields missing from
+ * the end of a shorter array keep their defaults, so the layout can grow.
+ */
+enum CodecConfigField : int {
+    CODEC_CFG_TYPE = 0,
+    CODEC_CFG_SAMPLE_RATE,
+    CODEC_CFG_CHANNELS,
+    CODEC_CFG_OPUS_APPLICATION,
+    CODEC_CFG_OPUS_BITRATE,
+    CODEC_CFG_OPUS_COMPLEXITY,
+    CODEC_CFG_CODEC2_MODE,
+    CODEC_CFG_DRED_DURATION_MS,
+    CODEC_CFG_FIELDS
+};
+
+struct CodecConfig {
+    CodecType type = CodecType::NONE;
+    int sampleRate = 0;
+    int channels = 1;
+    int opusApplication = 0;    // Opus only
+    int opusBitrate = 0;        // Opus only
+    int opusComplexity = 10;    // Opus only
+    int codec2Mode = 0;         // Codec2 library mode
+    int dredDurationMs = 0;     // Opus DRED span (0 = off)
+};
+
+/** @return false (and a NONE config) for a missing array or one without a type */
+inline bool readCodecConfig(const int32_t* in, int len, CodecConfig* out) {
+    *out = CodecConfig();
+    if (!in || len <= CODEC_CFG_TYPE) return false;
+    auto field = [&](int i, int fallback) { return i < len ? in[i] : fallback; };
+    out->type = static_cast<CodecType>(in[CODEC_CFG_TYPE]);
+    out->sampleRate = field(CODEC_CFG_SAMPLE_RATE, out->sampleRate);
+    out->channels = field(CODEC_CFG_CHANNELS, out->channels);
+    out->opusApplication = field(CODEC_CFG_OPUS_APPLICATION, out->opusApplication);
+    out->opusBitrate = field(CODEC_CFG_OPUS_BITRATE, out->opusBitrate);
+    out->opusComplexity = field(CODEC_CFG_OPUS_COMPLEXITY, out->opusComplexity);
+    out->codec2Mode = field(CODEC_CFG_CODEC2_MODE, out->codec2Mode);
+    out->dredDurationMs = field(CODEC_CFG_DRED_DURATION_MS, out->dredDurationMs);
+    return true;
+}
+
+/**
+ * Defaults for codec backends (codec_registry.h).
+ *
+ * Backends derive from this and hide the members they implement; the
+ * CodecWrapper visitor calls them on the concrete type, so there are no
+ * virtual calls and an unimplemented operation falls back to the "not
+ * supported" default here. A backend needs create(), decode() and
+ * encode(); everything else is optional.
+ *
+ * Backends hold codec state in place (CodecWrapper keeps one in a
+ * variant) and are neither copied nor moved.
+ */
+class CodecBackend {
+public:
+    CodecBackend() = default;
+    CodecBackend(const CodecBackend&) = delete;
+    CodecBackend& operator=(const CodecBackend&) = delete;
+
+    /** Conceal one lost frame. @return Total samples written, or -1 if unsupported */
+    int decodePlc(int16_t* /*output*/, int /*samplesPerChannel*/) { return -1; }
+
+    /** True if decodePlc() does more than fail; otherwise the engine plays silence. */
+    static constexpr bool HAS_PLC = false;
+
+    /** Start a fresh talk spurt (no-op for stateless codecs). */
+    void resetEncoder() {}
+
+    bool setEncoderComplexity(int /*complexity*/) { return false; }
+    bool setDecoderComplexity(int /*complexity*/) { return false; }
+
+    CodecType type() const { return type_; }
+    int channels() const { return channels_; }
+    int sampleRate() const { return sampleRate_; }
+
+protected:
+    CodecType type_ = CodecType::NONE;
+    int channels_ = 1;
+    int sampleRate_ = 0;
+};
+
+/** Empty slot: every operation fails. */
+class NoCodec : public CodecBackend {
+public:
+    bool create(const CodecConfig& /*config*/, MemoryLedger* /*ledger*/) { return false; }
+    int decode(const uint8_t*, int, int16_t*, int) { return -1; }
+    int encode(const int16_t*, int, uint8_t*, int) { return -1; }
+};
+
+#endif // LXST_CODEC_BACKEND_H
@@ -0,0 +1,54 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_CODEC_REGISTRY_H
+#define LXST_CODEC_REGISTRY_H
+
+#include <variant>
+#include "codec_backend.h"
+#include "opus_codec.h"
+#include "codec2_codec.h"
+#include "pcm_codec.h"
+#include "g722_codec.h"
+
+/**
+ * The codecs CodecWrapper can hold.
+ *
+ * Adding a codec: a CodecBackend subclass in its own file (sources go in
+ * LXST_CODEC_SOURCES in CMakeLists.txt), an alternative here, a row in
+ * CODEC_REGISTRY, and a CodecType value shared with Kotlin. The engines
+ * and JNI take a CodecConfig and need no change.
+ */
+using CodecBackendVariant = std::variant<NoCodec, OpusCodec, Codec2Codec, PcmCodec, G722Codec>;
+
+struct CodecRegistryEntry {
+    CodecType type;
+    const char* name;
+    /** Emplace the backend in the slot and create() it from the config. */
+    bool (*create)(CodecBackendVariant& slot, const CodecConfig& config, MemoryLedger* ledger);
+};
+
+template <typename Backend>
+bool createCodecBackend(CodecBackendVariant& slot, const CodecConfig& config, MemoryLedger* ledger) {
+    return slot.emplace<Backend>().create(config, ledger);
+}
+
+inline constexpr CodecRegistryEntry CODEC_REGISTRY[] = {
+    {CodecType::OPUS,   "Opus",   createCodecBackend<OpusCodec>},
+    {CodecType::CODEC2, "Codec2", createCodecBackend<Codec2Codec>},
+    {CodecType::PCM16,  "PCM16",  createCodecBackend<PcmCodec>},
+    {CodecType::PCMU,   "PCMU",   createCodecBackend<PcmCodec>},
+    {CodecType::PCMA,   "PCMA",   createCodecBackend<PcmCodec>},
+    {CodecType::G722,   "G.722",  createCodecBackend<G722Codec>},
+};
+
+/** Registry row for a codec type, or null if none. */
+inline const CodecRegistryEntry* findCodec(CodecType type) {
+    for (const auto& entry : CODEC_REGISTRY) {
+        if (entry.type == type) return &entry;
+    }
+    return nullptr;
+}
+
+#endif // LXST_CODEC_REGISTRY_H
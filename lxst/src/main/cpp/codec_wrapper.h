@@ -6,34 +6,31 @@
 #define LXST_CODEC_WRAPPER_H
 
 #include <cstdint>
-
-// Forward declarations (avoid pulling full headers into every translation unit)
-struct OpusEncoder;
-struct OpusDecoder;
-struct CODEC2;
+#include <type_traits>
+#include <variant>
+#include "codec_registry.h"
+#include "memory_ledger.h"
 
 /**
- * Unified C++ codec abstraction wrapping both libopus and libcodec2.
- *
- * Used by OboePlaybackEngine (decode) and OboeCaptureEngine (encode) to
- * perform codec operations directly in native code, eliminating JNI
+ * Codec facade used by OboePlaybackEngine (decode) and OboeCaptureEngine
+ * (encode) to run codecs directly in native code, eliminating JNI
  * crossings and Kotlin heap allocations on the audio hot path.
  *
- * Codec2 quirks handled natively:
- * - Multi-frame: loops floor(encodedLen / bytesPerFrame) times
- * - Mode header: first byte of encoded data; switch mode if different
- * - Mode↔library mapping: wire headers 0x00-0x06 ↔ library modes 8,5,4,3,2,1,0
+ * Holds one backend from codec_registry.h in place and dispatches to it
+ * with std::visit: the concrete type is known at each call, so there is
+ * no virtual call on the audio thread and backends only implement what
+ * they support (CodecBackend has the defaults). Codec-specific features
+ * (Opus DRED, Codec2 interleaving) go straight to that backend and
+ * report false for the others.
  *
- * Opus quirks handled natively:
- * - Mono→stereo upmix: when encoder has channels=2 but capture is mono,
- *   duplicate each sample: stereo[2i]=stereo[2i+1]=mono[i]
+ * Backend state is allocated in place or by the backend itself, charged
+ * to the owner's MemoryLedger as MEM_CODEC (Codec2's library state is
+ * not counted).
  */
-
-enum class CodecType { NONE = 0, OPUS = 1, CODEC2 = 2 };
-
 class CodecWrapper {
 public:
-    CodecWrapper();
+    /** @param ledger Charged with codec state as MEM_CODEC (null = untracked) */
+    explicit CodecWrapper(MemoryLedger* ledger = nullptr);
     ~CodecWrapper();
 
     // Non-copyable
@@ -41,25 +38,11 @@ public:
     CodecWrapper& operator=(const CodecWrapper&) = delete;
 
     /**
-     * Create an Opus encoder+decoder pair.
-     *
-     * @param sampleRate   Sample rate (8000, 12000, 24000, 48000)
-     * @param channels     Number of channels (1=mono, 2=stereo)
-     * @param application  OPUS_APPLICATION_VOIP or OPUS_APPLICATION_AUDIO
-     * @param bitrate      Target bitrate in bps
-     * @param complexity   Encoder complexity (0-10)
-     * @return true on success
-     */
-    bool createOpus(int sampleRate, int channels, int application,
-                    int bitrate, int complexity);
-
-    /**
-     * Create a Codec2 encoder+decoder.
+     * Create an encoder+decoder for config.type from the registry.
      *
-     * @param libraryMode  Codec2 library mode (0=3200, 1=2400, ..., 8=700C)
-     * @return true on success
+     * @return false for an unknown type or if the backend rejects the config
      */
-    bool createCodec2(int libraryMode);
+    bool create(const CodecConfig& config);
 
     /** Destroy the codec and release all resources. */
     void destroy();
@@ -67,33 +50,37 @@ public:
     /**
      * Decode encoded bytes to PCM int16.
      *
-     * Codec2: strips mode header byte, loops over sub-frames.
-     * Opus: single decode call.
-     *
-     * @param encoded         Encoded data (Codec2: with mode header; Opus: raw)
+     * @param encoded         Encoded data (Codec2: with mode header; others: raw)
      * @param encodedBytes    Length of encoded data
      * @param output          Output PCM int16 buffer
      * @param maxOutputSamples Maximum samples that fit in output buffer
      * @return Decoded sample count (total, including all channels), or -1 on error
      */
     int decode(const uint8_t* encoded, int encodedBytes,
-               int16_t* output, int maxOutputSamples);
+               int16_t* output, int maxOutputSamples) {
+        return std::visit([&](auto& c) { return c.decode(encoded, encodedBytes, output, maxOutputSamples); },
+                          backend_);
+    }
 
     /**
      * Generate Packet Loss Concealment (PLC) audio from decoder state.
      *
-     * Opus: calls opus_decode(NULL, 0, ...) which extrapolates plausible
-     * continuation audio from the decoder's internal state. Much better
-     * than hard silence for short gaps (1-5 frames).
-     *
-     * Codec2: returns -1 (no PLC support).
-     * NONE: returns -1.
+     * Opus: opus_decode(NULL, 0, ...) extrapolates plausible continuation
+     * audio from the decoder's internal state. Much better than hard
+     * silence for short gaps (1-5 frames). Other codecs return -1.
      *
      * @param output            Output PCM int16 buffer
      * @param samplesPerChannel Samples per channel to generate (e.g., 2880 for MQ)
      * @return Decoded sample count (total, including all channels), or -1 if unsupported
      */
-    int decodePlc(int16_t* output, int samplesPerChannel);
+    int decodePlc(int16_t* output, int samplesPerChannel) {
+        return std::visit([&](auto& c) { return c.decodePlc(output, samplesPerChannel); }, backend_);
+    }
+
+    /** True if decodePlc() is implemented for this codec. */
+    bool hasPlc() const {
+        return std::visit([](const auto& c) { return std::decay_t<decltype(c)>::HAS_PLC; }, backend_);
+    }
 
     /**
      * Encode PCM int16 to encoded bytes.
@@ -108,34 +95,144 @@ public:
      * @return Encoded byte count, or -1 on error
      */
     int encode(const int16_t* pcm, int pcmSamples,
-               uint8_t* output, int maxOutputBytes);
+               uint8_t* output, int maxOutputBytes) {
+        return std::visit([&](auto& c) { return c.encode(pcm, pcmSamples, output, maxOutputBytes); },
+                          backend_);
+    }
+
+    /**
+     * Reset encoder state so the next frame starts a fresh talk spurt.
+     *
+     * Opus: OPUS_RESET_STATE (clears prediction, VAD/DTX and bandwidth
+     * history; keeps bitrate/complexity settings).
+     * Others: no-op (Codec2 and PCM frames are independent; G.722 must
+     * stay in step with the peer's decoder).
+     */
+    void resetEncoder() {
+        std::visit([](auto& c) { c.resetEncoder(); }, backend_);
+    }
+
+    /**
+     * Change Opus encoder complexity (0-10) on a live encoder.
+     *
+     * @return false if not Opus or the ctl failed
+     */
+    bool setEncoderComplexity(int complexity) {
+        return std::visit([&](auto& c) { return c.setEncoderComplexity(complexity); }, backend_);
+    }
+
+    /**
+     * Set Opus decoder complexity (independent of the encoder's).
+     *
+     * In Opus 1.5 this selects the decoder's neural tools: 5+ enables deep
+     * PLC, 6 LACE and 7+ NoLACE speech enhancement (when libopus was built
+     * with them). Below 5 the decoder is classic Opus.
+     *
+     * @return false if not Opus or the ctl failed
+     */
+    bool setDecoderComplexity(int complexity) {
+        return std::visit([&](auto& c) { return c.setDecoderComplexity(complexity); }, backend_);
+    }
+
+    /**
+     * Enable Opus Deep REDundancy (DRED) on the encoder.
+     *
+     * Each packet then carries a low-rate neural summary of the preceding
+     * audio, so the receiver can rebuild a burst of lost packets from the
+     * first packet that arrives after it. DRED is only given bits when
+     * the encoder expects loss, so the expected loss is set alongside.
+     *
+     * @param durationMs      Redundancy carried per packet (10ms steps, max 1040)
+     * @param expectedLossPct Loss to plan for (OPUS_SET_PACKET_LOSS_PERC)
+     * @return false if not Opus or libopus was built without DRED
+     */
+    bool setEncoderDred(int durationMs, int expectedLossPct) {
+        auto* opus = std::get_if<OpusCodec>(&backend_);
+        return opus && opus->setEncoderDred(durationMs, expectedLossPct);
+    }
+
+    /**
+     * Allocate DRED decoder state so decodeDred() can be used.
+     *
+     * @return false if not Opus or libopus was built without DRED
+     */
+    bool enableDredDecoder() {
+        auto* opus = std::get_if<OpusCodec>(&backend_);
+        return opus && opus->enableDredDecoder();
+    }
+
+    /** True once enableDredDecoder() has succeeded. */
+    bool dredDecoderEnabled() const {
+        const auto* opus = std::get_if<OpusCodec>(&backend_);
+        return opus && opus->dredDecoderEnabled();
+    }
+
+    /**
+     * Rebuild frames lost just before a packet from its DRED payload.
+     *
+     * Call with the first packet after a gap, before decode() of that same
+     * packet, so the decoder state runs through the rebuilt audio. Only the
+     * newest frames the packet's redundancy reaches are rebuilt; they are
+     * written oldest first.
+     *
+     * @param packet            First Opus packet after the gap
+     * @param packetBytes       Packet length
+     * @param lostFrames        Frames missing immediately before the packet
+     * @param samplesPerChannel Samples per channel of one frame
+     * @param output            Output PCM int16 buffer
+     * @param maxOutputSamples  Maximum samples that fit in output
+     * @return Frames written to output (0 if not Opus or the packet carries no DRED)
+     */
+    int decodeDred(const uint8_t* packet, int packetBytes, int lostFrames,
+                   int samplesPerChannel, int16_t* output, int maxOutputSamples) {
+        auto* opus = std::get_if<OpusCodec>(&backend_);
+        return opus ? opus->decodeDred(packet, packetBytes, lostFrames, samplesPerChannel,
+                                       output, maxOutputSamples)
+                    : 0;
+    }
+
+    /**
+     * Interleave Codec2 sub-frames across consecutive packets.
+     *
+     * Packet k carries the even sub-frames of frame k and the odd
+     * sub-frames of frame k-1, so a lost packet leaves alternating 40ms
+     * holes in two frames instead of one 320-400ms hole. Holes are
+     * concealed by decoding a neighbouring sub-frame's parameters again.
+     * Costs one frame of latency at the receiver.
+     *
+     * Interleaved packets set C2_INTERLEAVE_FLAG in the mode header with a
+     * 3-bit packet sequence in bits 4-6; decode() recognises them on its
+     * own, so only the encoder needs this. Peers that don't know the flag
+     * drop the packets, so enable only toward peers that do. Has no effect
+     * when a packet holds fewer than two sub-frames.
+     *
+     * @return false if not Codec2
+     */
+    bool setCodec2Interleave(bool enabled) {
+        auto* c2 = std::get_if<Codec2Codec>(&backend_);
+        if (c2) c2->setInterleave(enabled);
+        return c2 != nullptr;
+    }
+
+    /** True if encode() interleaves Codec2 sub-frames. */
+    bool codec2Interleaved() const {
+        const auto* c2 = std::get_if<Codec2Codec>(&backend_);
+        return c2 && c2->interleaved();
+    }
+
+    /** Mode header bit marking an interleaved Codec2 packet. */
+    static constexpr uint8_t C2_INTERLEAVE_FLAG = Codec2Codec::INTERLEAVE_FLAG;
+
+    /** Largest Codec2 packet (header + sub-frames) the interleaver holds. */
+    static constexpr int C2_MAX_PACKET_BYTES = Codec2Codec::MAX_PACKET_BYTES;
 
-    CodecType type() const { return type_; }
-    int channels() const { return channels_; }
-    int sampleRate() const { return sampleRate_; }
+    CodecType type() const { return std::visit([](const auto& c) { return c.type(); }, backend_); }
+    int channels() const { return std::visit([](const auto& c) { return c.channels(); }, backend_); }
+    int sampleRate() const { return std::visit([](const auto& c) { return c.sampleRate(); }, backend_); }
 
 private:
-    CodecType type_ = CodecType::NONE;
-    int channels_ = 1;
-    int sampleRate_ = 0;
-
-    // Opus
-    OpusEncoder* opusEnc_ = nullptr;
-    OpusDecoder* opusDec_ = nullptr;
-
-    // Codec2
-    struct CODEC2* codec2_ = nullptr;
-    int c2SamplesPerFrame_ = 0;
-    int c2BytesPerFrame_ = 0;
-    uint8_t c2ModeHeader_ = 0;
-    int c2LibraryMode_ = 0;
-
-    // Codec2 mode header ↔ library mode mapping (matches Kotlin Codec2.kt)
-    // Wire headers: 0x00=700C, 0x01=1200, 0x02=1300, 0x03=1400,
-    //               0x04=1600, 0x05=2400, 0x06=3200
-    // Library modes: 8=700C, 5=1200, 4=1300, 3=1400, 2=1600, 1=2400, 0=3200
-    static int headerToLibraryMode(uint8_t header);
-    static uint8_t libraryModeToHeader(int libraryMode);
+    MemoryLedger* ledger_ = nullptr;
+    CodecBackendVariant backend_;
 };
 
 #endif // LXST_CODEC_WRAPPER_H
@@ -0,0 +1,120 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_COMPLEXITY_GOVERNOR_H
+#define LXST_COMPLEXITY_GOVERNOR_H
+
+/**
+ * Load-driven codec complexity governor with hysteresis.
+ *
+ * Walks an ordered list of complexity levels (cheapest first). Each
+ * update() takes the measured cost of one codec call as a percentage of
+ * its time budget and smooths it (EWMA, 1/8):
+ *   - Step down one level as soon as the smoothed load crosses highPct,
+ *     or a single call overruns its whole budget.
+ *   - Step up one level once holdSamples calls in a row stay under lowPct.
+ * The level never rises above the ceiling, which callers can lower at
+ * runtime (e.g. a thermal hint) without touching the configured range.
+ *
+ * Not thread-safe: owned by the one thread that runs the codec.
+ */
+class ComplexityGovernor {
+public:
+    static constexpr int MAX_LEVELS = 11;
+
+    /**
+     * @param levels      Complexity values, cheapest first (at most MAX_LEVELS)
+     * @param numLevels   Entries in levels
+     * @param startIndex  Index to start at (clamped to the range)
+     * @param highPct     Smoothed load that forces a step down
+     * @param lowPct      Load every call must stay under to step up
+     * @param holdSamples Consecutive low-load calls before stepping up
+     */
+    void configure(const int* levels, int numLevels, int startIndex,
+                   int highPct, int lowPct, int holdSamples) {
+        if (numLevels > MAX_LEVELS) numLevels = MAX_LEVELS;
+        if (numLevels < 1) numLevels = 1;
+        for (int i = 0; i < numLevels; i++) levels_[i] = levels ? levels[i] : 0;
+        numLevels_ = numLevels;
+        ceilingIndex_ = numLevels - 1;
+        index_ = clampIndex(startIndex);
+        highPct_ = highPct;
+        lowPct_ = lowPct;
+        holdSamples_ = holdSamples;
+        smoothedPct_ = 0;
+        lowRun_ = 0;
+    }
+
+    /**
+     * Record one measured load sample.
+     *
+     * @param loadPct Cost of the last codec call as % of its budget
+     * @return true if the level changed (apply level() to the codec)
+     */
+    bool update(int loadPct) {
+        if (loadPct < 0) loadPct = 0;
+        smoothedPct_ += (loadPct - smoothedPct_) / 8;
+
+        if (index_ > 0 && (smoothedPct_ > highPct_ || loadPct >= 100)) {
+            index_--;
+            smoothedPct_ = lowPct_;  // Let the new level prove itself
+            lowRun_ = 0;
+            return true;
+        }
+
+        lowRun_ = (loadPct < lowPct_) ? lowRun_ + 1 : 0;
+        if (index_ < ceilingIndex_ && lowRun_ >= holdSamples_) {
+            index_++;
+            lowRun_ = 0;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Cap the level at levels[ceilingIndex]. Drops the current level
+     * immediately if it is above the new ceiling.
+     *
+     * @return true if the level changed
+     */
+    bool setCeilingIndex(int ceilingIndex) {
+        ceilingIndex_ = clampIndex(ceilingIndex);
+        if (index_ > ceilingIndex_) {
+            index_ = ceilingIndex_;
+            lowRun_ = 0;
+            return true;
+        }
+        return false;
+    }
+
+    /** Current complexity value. */
+    int level() const { return levels_[index_]; }
+
+    /** Current index into the level list. */
+    int index() const { return index_; }
+
+    int numLevels() const { return numLevels_; }
+
+    /** Smoothed load, % of budget. */
+    int smoothedPct() const { return smoothedPct_; }
+
+private:
+    int clampIndex(int i) const {
+        if (i < 0) return 0;
+        if (i >= numLevels_) return numLevels_ - 1;
+        return i;
+    }
+
+    int levels_[MAX_LEVELS] = {};
+    int numLevels_ = 1;
+    int index_ = 0;
+    int ceilingIndex_ = 0;
+    int highPct_ = 100;
+    int lowPct_ = 0;
+    int holdSamples_ = 1;
+    int smoothedPct_ = 0;
+    int lowRun_ = 0;
+};
+
+#endif // LXST_COMPLEXITY_GOVERNOR_H
@@ -5,19 +5,19 @@
 #include "encoded_ring_buffer.h"
 #include <cstring>
 
-EncodedRingBuffer::EncodedRingBuffer(int maxSlots, int maxBytesPerSlot)
+EncodedRingBuffer::EncodedRingBuffer(int maxSlots, int maxBytesPerSlot, MemoryLedger* ledger)
     : maxSlots_(maxSlots),
       maxBytesPerSlot_(maxBytesPerSlot),
       slotSize_(static_cast<int>(sizeof(int32_t)) + maxBytesPerSlot),
-      buffer_(new uint8_t[maxSlots * (static_cast<int>(sizeof(int32_t)) + maxBytesPerSlot)]) {
-    std::memset(buffer_, 0, maxSlots * slotSize_);
+      buffer_(makeTrackedArray<uint8_t>(ledger, MEM_ENCODED_RING,
+                                        static_cast<size_t>(maxSlots) * slotSize_)),
+      captureNs_(makeTrackedArray<int64_t>(ledger, MEM_ENCODED_RING, maxSlots)),
+      tags_(makeTrackedArray<int32_t>(ledger, MEM_ENCODED_RING, maxSlots)) {
 }
 
-EncodedRingBuffer::~EncodedRingBuffer() {
-    delete[] buffer_;
-}
+EncodedRingBuffer::~EncodedRingBuffer() = default;
 
-bool EncodedRingBuffer::write(const uint8_t* data, int length) {
+bool EncodedRingBuffer::write(const uint8_t* data, int length, int64_t captureNs, int tag) {
     if (length <= 0 || length > maxBytesPerSlot_) return false;
 
     int w = writeIndex_.load(std::memory_order_relaxed);
@@ -29,15 +29,17 @@ bool EncodedRingBuffer::write(const uint8_t* data, int length) {
     }
 
     // Write length prefix + data into slot
-    uint8_t* slot = buffer_ + w * slotSize_;
+    uint8_t* slot = buffer_.get() + w * slotSize_;
     std::memcpy(slot, &length, sizeof(int32_t));
     std::memcpy(slot + sizeof(int32_t), data, length);
+    captureNs_[w] = captureNs;
+    tags_[w] = tag;
 
     writeIndex_.store(nextW, std::memory_order_release);
     return true;
 }
 
-bool EncodedRingBuffer::read(uint8_t* dest, int maxLength, int* actualLength) {
+bool EncodedRingBuffer::read(uint8_t* dest, int maxLength, int* actualLength, int* tag) {
     int r = readIndex_.load(std::memory_order_relaxed);
     int w = writeIndex_.load(std::memory_order_acquire);
 
@@ -46,7 +48,7 @@ bool EncodedRingBuffer::read(uint8_t* dest, int maxLength, int* actualLength) {
     }
 
     // Read length prefix
-    uint8_t* slot = buffer_ + r * slotSize_;
+    uint8_t* slot = buffer_.get() + r * slotSize_;
     int32_t length;
     std::memcpy(&length, slot, sizeof(int32_t));
 
@@ -60,11 +62,25 @@ bool EncodedRingBuffer::read(uint8_t* dest, int maxLength, int* actualLength) {
     // Copy data
     std::memcpy(dest, slot + sizeof(int32_t), length);
     *actualLength = length;
+    if (tag) *tag = tags_[r];
 
     readIndex_.store((r + 1) % maxSlots_, std::memory_order_release);
     return true;
 }
 
+int EncodedRingBuffer::dropStale(int64_t cutoffNs) {
+    int r = readIndex_.load(std::memory_order_relaxed);
+    int w = writeIndex_.load(std::memory_order_acquire);
+
+    int dropped = 0;
+    while (r != w && captureNs_[r] != 0 && captureNs_[r] < cutoffNs) {
+        r = (r + 1) % maxSlots_;
+        dropped++;
+    }
+    if (dropped > 0) readIndex_.store(r, std::memory_order_release);
+    return dropped;
+}
+
 int EncodedRingBuffer::availableSlots() const {
     int w = writeIndex_.load(std::memory_order_acquire);
     int r = readIndex_.load(std::memory_order_acquire);
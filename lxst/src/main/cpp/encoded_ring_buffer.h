@@ -7,6 +7,7 @@
 
 #include <atomic>
 #include <cstdint>
+#include "memory_ledger.h"
 
 /**
  * Lock-free SPSC ring buffer for variable-length encoded audio packets.
@@ -20,14 +21,17 @@
  *
  * Slot layout (flat array):
  *   [int32 length][uint8 data[maxBytesPerSlot]] × maxSlots
+ * plus a parallel capture timestamp per slot, so the consumer can skip
+ * packets that waited too long (dropStale), and a caller tag per slot.
  */
 class EncodedRingBuffer {
 public:
     /**
      * @param maxSlots        Maximum number of packets the buffer can hold
      * @param maxBytesPerSlot Maximum encoded packet size per slot
+     * @param ledger          Charged with the slab as MEM_ENCODED_RING (null = untracked)
      */
-    EncodedRingBuffer(int maxSlots, int maxBytesPerSlot);
+    EncodedRingBuffer(int maxSlots, int maxBytesPerSlot, MemoryLedger* ledger = nullptr);
     ~EncodedRingBuffer();
 
     // Non-copyable
@@ -37,11 +41,13 @@ public:
     /**
      * Write an encoded packet into the next available slot.
      *
-     * @param data    Encoded packet bytes
-     * @param length  Actual packet length (must be <= maxBytesPerSlot)
+     * @param data      Encoded packet bytes
+     * @param length    Actual packet length (must be <= maxBytesPerSlot)
+     * @param captureNs Monotonic capture time of the audio (0 = never stale)
+     * @param tag       Caller value returned by read() with the packet
      * @return true if written, false if buffer full or length exceeds slot size
      */
-    bool write(const uint8_t* data, int length);
+    bool write(const uint8_t* data, int length, int64_t captureNs = 0, int tag = 0);
 
     /**
      * Read the next encoded packet from the buffer.
@@ -49,9 +55,18 @@ public:
      * @param dest         Destination buffer
      * @param maxLength    Size of destination buffer
      * @param actualLength [out] Actual number of bytes read
+     * @param tag          [out] The packet's write() tag (may be null)
      * @return true if a packet was read, false if buffer empty
      */
-    bool read(uint8_t* dest, int maxLength, int* actualLength);
+    bool read(uint8_t* dest, int maxLength, int* actualLength, int* tag = nullptr);
+
+    /**
+     * Discard packets captured before cutoffNs from the head (consumer side).
+     * Stops at the first fresh or unstamped packet, so order is kept.
+     *
+     * @return Number of packets discarded
+     */
+    int dropStale(int64_t cutoffNs);
 
     /** Number of packets available to read. */
     int availableSlots() const;
@@ -64,7 +79,9 @@ private:
     const int maxBytesPerSlot_;
     const int slotSize_;  // sizeof(int32_t) + maxBytesPerSlot_
 
-    uint8_t* buffer_;  // Flat: maxSlots * slotSize
+    TrackedArray<uint8_t> buffer_;  // Flat: maxSlots * slotSize
+    TrackedArray<int64_t> captureNs_;  // Per slot
+    TrackedArray<int32_t> tags_;       // Per slot
 
     std::atomic<int> writeIndex_{0};
     std::atomic<int> readIndex_{0};
@@ -0,0 +1,275 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "g722_codec.h"
+#include <android/log.h>
+
+#define LOG_TAG "LXST:G722Codec"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+// --- ITU-T G.722 tables ---
+
+// QMF taps, half of the symmetric 24-tap filter
+static const int QMF_COEFFS[12] = {
+    3, -11, 12, 32, -210, 951, 3876, -805, 362, -156, 53, -11,
+};
+
+// Low band: 6-bit quantizer decision levels and codes (QUANTL)
+static const int Q6[32] = {
+    0, 35, 72, 110, 150, 190, 233, 276, 323, 370, 422, 473, 530, 587, 650, 714,
+    786, 858, 940, 1023, 1121, 1219, 1339, 1458, 1612, 1765, 1980, 2195, 2557, 2919, 0, 0,
+};
+static const int ILN[32] = {
+    0, 63, 62, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19,
+    18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 0,
+};
+static const int ILP[32] = {
+    0, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47,
+    46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 0,
+};
+
+// Low band: inverse quantizers (6-bit output, 4-bit predictor feedback)
+static const int QM6[64] = {
+    -136, -136, -136, -136, -24808, -21904, -19008, -16704,
+    -14984, -13512, -12280, -11192, -10232, -9360, -8576, -7856,
+    -7192, -6576, -6000, -5456, -4944, -4464, -4008, -3576,
+    -3168, -2776, -2400, -2032, -1688, -1360, -1040, -728,
+    24808, 21904, 19008, 16704, 14984, 13512, 12280, 11192,
+    10232, 9360, 8576, 7856, 7192, 6576, 6000, 5456,
+    4944, 4464, 4008, 3576, 3168, 2776, 2400, 2032,
+    1688, 1360, 1040, 728, 432, 136, -432, -136,
+};
+static const int QM4[16] = {
+    0, -20456, -12896, -8968, -6288, -4240, -2584, -1200,
+    20456, 12896, 8968, 6288, 4240, 2584, 1200, 0,
+};
+
+// Low band: log scale factor adaptation (LOGSCL)
+static const int RL42[16] = {0, 7, 6, 5, 4, 3, 2, 1, 7, 6, 5, 4, 3, 2, 1, 0};
+static const int WL[8] = {-60, -30, 58, 172, 334, 538, 1198, 3042};
+
+// Log → linear step size (SCALEL/SCALEH)
+static const int ILB[32] = {
+    2048, 2093, 2139, 2186, 2233, 2282, 2332, 2383, 2435, 2489, 2543, 2599, 2656, 2714, 2774, 2834,
+    2896, 2960, 3025, 3091, 3158, 3228, 3298, 3371, 3444, 3520, 3597, 3676, 3756, 3838, 3922, 4008,
+};
+
+// High band: 2-bit quantizer, inverse quantizer and scale adaptation
+static const int IHN[3] = {0, 1, 0};
+static const int IHP[3] = {0, 3, 2};
+static const int QM2[4] = {-7408, -1616, 7408, 1616};
+static const int RH2[4] = {2, 1, 2, 1};
+static const int WH[3] = {0, -214, 798};
+
+static const int LOW_NB_MAX = 18432;
+static const int HIGH_NB_MAX = 22528;
+
+static inline int saturate(int v) {
+    return v > 32767 ? 32767 : (v < -32768 ? -32768 : v);
+}
+
+static inline int clampInt(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+// SCALEL (shift 8) / SCALEH (shift 10): step size from the log scale factor
+static inline int stepSize(int nb, int shift) {
+    int wd1 = (nb >> 6) & 31;
+    int wd2 = shift - (nb >> 11);
+    int wd3 = (wd2 < 0) ? (ILB[wd1] << -wd2) : (ILB[wd1] >> wd2);
+    return wd3 << 2;
+}
+
+// --- Block 4: reconstruction and adaptive predictor ---
+
+void G722Codec::Band::update(int dq) {
+    // RECONS, PARREC
+    d[0] = dq;
+    r[0] = saturate(s + dq);
+    p[0] = saturate(sz + dq);
+
+    // UPPOL2
+    for (int i = 0; i < 3; i++) sg[i] = p[i] >> 15;
+    int wd1 = saturate(a[1] * 4);
+    int wd2 = (sg[0] == sg[1]) ? -wd1 : wd1;
+    if (wd2 > 32767) wd2 = 32767;
+    int wd3 = (sg[0] == sg[2]) ? 128 : -128;
+    wd3 += wd2 >> 7;
+    wd3 += (a[2] * 32512) >> 15;
+    ap[2] = clampInt(wd3, -12288, 12288);
+
+    // UPPOL1
+    sg[0] = p[0] >> 15;
+    sg[1] = p[1] >> 15;
+    wd1 = (sg[0] == sg[1]) ? 192 : -192;
+    wd2 = (a[1] * 32640) >> 15;
+    ap[1] = saturate(wd1 + wd2);
+    wd3 = saturate(15360 - ap[2]);
+    ap[1] = clampInt(ap[1], -wd3, wd3);
+
+    // UPZERO
+    wd1 = (dq == 0) ? 0 : 128;
+    sg[0] = dq >> 15;
+    for (int i = 1; i < 7; i++) {
+        sg[i] = d[i] >> 15;
+        wd2 = (sg[i] == sg[0]) ? wd1 : -wd1;
+        wd3 = (b[i] * 32640) >> 15;
+        bp[i] = saturate(wd2 + wd3);
+    }
+
+    // DELAYA
+    for (int i = 6; i > 0; i--) {
+        d[i] = d[i - 1];
+        b[i] = bp[i];
+    }
+    for (int i = 2; i > 0; i--) {
+        r[i] = r[i - 1];
+        p[i] = p[i - 1];
+        a[i] = ap[i];
+    }
+
+    // FILTEP
+    wd1 = saturate(r[1] + r[1]);
+    wd1 = (a[1] * wd1) >> 15;
+    wd2 = saturate(r[2] + r[2]);
+    wd2 = (a[2] * wd2) >> 15;
+    sp = saturate(wd1 + wd2);
+
+    // FILTEZ
+    sz = 0;
+    for (int i = 6; i > 0; i--) {
+        wd1 = saturate(d[i] + d[i]);
+        sz += (b[i] * wd1) >> 15;
+    }
+    sz = saturate(sz);
+
+    // PREDIC
+    s = saturate(sp + sz);
+}
+
+bool G722Codec::create(const CodecConfig& config, MemoryLedger* /*ledger*/) {
+    if (config.sampleRate != 16000 || config.channels != 1) {
+        LOGE("G.722 create failed: rate=%d ch=%d (16kHz mono only)",
+             config.sampleRate, config.channels);
+        return false;
+    }
+    encoder_.reset();
+    decoder_.reset();
+
+    type_ = CodecType::G722;
+    channels_ = 1;
+    sampleRate_ = 16000;
+
+    LOGI("G.722 created: 64 kbit/s");
+    return true;
+}
+
+int G722Codec::encode(const int16_t* pcm, int pcmSamples,
+                      uint8_t* output, int maxOutputBytes) {
+    int encodedSize = pcmSamples / 2;
+    if (encodedSize > maxOutputBytes) {
+        LOGW("G.722 encode: output buffer too small (%d > %d)", encodedSize, maxOutputBytes);
+        return -1;
+    }
+
+    State& st = encoder_;
+    Band& lo = st.band[0];
+    Band& hi = st.band[1];
+    for (int n = 0; n < encodedSize; n++) {
+        // Transmit QMF: two input samples → one low and one high band sample
+        for (int i = 0; i < 22; i++) st.x[i] = st.x[i + 2];
+        st.x[22] = pcm[2 * n];
+        st.x[23] = pcm[2 * n + 1];
+        int sumEven = 0;
+        int sumOdd = 0;
+        for (int i = 0; i < 12; i++) {
+            sumOdd += st.x[2 * i] * QMF_COEFFS[i];
+            sumEven += st.x[2 * i + 1] * QMF_COEFFS[11 - i];
+        }
+        int xlow = (sumEven + sumOdd) >> 14;
+        int xhigh = (sumEven - sumOdd) >> 14;
+
+        // Low band: SUBTRA, QUANTL
+        int el = saturate(xlow - lo.s);
+        int wd = (el >= 0) ? el : -(el + 1);
+        int i = 1;
+        for (; i < 30; i++) {
+            if (wd < ((Q6[i] * lo.det) >> 12)) break;
+        }
+        int ilow = (el < 0) ? ILN[i] : ILP[i];
+
+        // INVQAL, LOGSCL, SCALEL
+        int ril = ilow >> 2;
+        int dlow = (lo.det * QM4[ril]) >> 15;
+        lo.nb = clampInt(((lo.nb * 127) >> 7) + WL[RL42[ril]], 0, LOW_NB_MAX);
+        lo.det = stepSize(lo.nb, 8);
+        lo.update(dlow);
+
+        // High band: SUBTRA, QUANTH
+        int eh = saturate(xhigh - hi.s);
+        wd = (eh >= 0) ? eh : -(eh + 1);
+        int mih = (wd >= ((564 * hi.det) >> 12)) ? 2 : 1;
+        int ihigh = (eh < 0) ? IHN[mih] : IHP[mih];
+
+        // INVQAH, LOGSCH, SCALEH
+        int dhigh = (hi.det * QM2[ihigh]) >> 15;
+        hi.nb = clampInt(((hi.nb * 127) >> 7) + WH[RH2[ihigh]], 0, HIGH_NB_MAX);
+        hi.det = stepSize(hi.nb, 10);
+        hi.update(dhigh);
+
+        output[n] = static_cast<uint8_t>((ihigh << 6) | ilow);
+    }
+    return encodedSize;
+}
+
+int G722Codec::decode(const uint8_t* encoded, int encodedBytes,
+                      int16_t* output, int maxOutputSamples) {
+    int samples = encodedBytes * 2;
+    if (samples > maxOutputSamples) {
+        LOGW("G.722 decode: output buffer too small (%d > %d)", samples, maxOutputSamples);
+        return -1;
+    }
+
+    State& st = decoder_;
+    Band& lo = st.band[0];
+    Band& hi = st.band[1];
+    for (int n = 0; n < encodedBytes; n++) {
+        int code = encoded[n];
+        int ilow = code & 0x3F;
+        int ihigh = (code >> 6) & 0x03;
+
+        // Low band: INVQBL, RECONS (the 6-bit value is only played)
+        int rlow = clampInt(lo.s + ((lo.det * QM6[ilow]) >> 15), -16384, 16383);
+
+        // INVQAL, LOGSCL, SCALEL (predictor runs on the 4-bit value, as in the encoder)
+        int ril = ilow >> 2;
+        int dlow = (lo.det * QM4[ril]) >> 15;
+        lo.nb = clampInt(((lo.nb * 127) >> 7) + WL[RL42[ril]], 0, LOW_NB_MAX);
+        lo.det = stepSize(lo.nb, 8);
+        lo.update(dlow);
+
+        // High band: INVQAH, RECONS, LOGSCH, SCALEH
+        int dhigh = (hi.det * QM2[ihigh]) >> 15;
+        int rhigh = clampInt(dhigh + hi.s, -16384, 16383);
+        hi.nb = clampInt(((hi.nb * 127) >> 7) + WH[RH2[ihigh]], 0, HIGH_NB_MAX);
+        hi.det = stepSize(hi.nb, 10);
+        hi.update(dhigh);
+
+        // Receive QMF: one sample per band → two output samples
+        for (int i = 0; i < 22; i++) st.x[i] = st.x[i + 2];
+        st.x[22] = rlow + rhigh;
+        st.x[23] = rlow - rhigh;
+        int xout1 = 0;
+        int xout2 = 0;
+        for (int i = 0; i < 12; i++) {
+            xout2 += st.x[2 * i] * QMF_COEFFS[i];
+            xout1 += st.x[2 * i + 1] * QMF_COEFFS[11 - i];
+        }
+        output[2 * n] = static_cast<int16_t>(saturate(xout1 >> 11));
+        output[2 * n + 1] = static_cast<int16_t>(saturate(xout2 >> 11));
+    }
+    return samples;
+}
@@ -0,0 +1,74 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_G722_CODEC_H
+#define LXST_G722_CODEC_H
+
+#include "codec_backend.h"
+
+/**
+ * ITU-T G.722 at 64 kbit/s: 16kHz wideband, one byte per two samples.
+ *
+ * A 24-tap QMF splits the input into two 8kHz sub-bands, coded with
+ * 6-bit (low) and 2-bit (high) backward-adaptive ADPCM. Integer-only,
+ * about 1.5ms of algorithmic delay (the QMF pair), and no frame
+ * structure, so any even frame size works. 7kHz audio for the cost of a
+ * few multiplies per sample, for LAN links where 64 kbit/s is free.
+ *
+ * Integer arithmetic follows the ITU reference (blocks 1L-6H), so the
+ * bitstream interoperates with other G.722 implementations. Both ends
+ * adapt in step, so a lost packet leaves the decoder off until its
+ * state re-converges (a few ms); there is no PLC.
+ */
+class G722Codec : public CodecBackend {
+public:
+    /** Needs sampleRate 16000 and mono in config. */
+    bool create(const CodecConfig& config, MemoryLedger* ledger);
+
+    /** One byte → two samples. */
+    int decode(const uint8_t* encoded, int encodedBytes, int16_t* output, int maxOutputSamples);
+
+    /** Two samples → one byte; an odd trailing sample is dropped. */
+    int encode(const int16_t* pcm, int pcmSamples, uint8_t* output, int maxOutputBytes);
+
+    // No resetEncoder(): the peer's decoder adapts in step with this
+    // encoder, so a reset on one side only would desynchronise them.
+
+private:
+    // Adaptive predictor and quantizer scale for one sub-band
+    struct Band {
+        int s = 0;       // Predicted signal
+        int sp = 0;      // Pole section of the prediction
+        int sz = 0;      // Zero section of the prediction
+        int r[3] = {};   // Reconstructed signal history
+        int a[3] = {};   // Pole coefficients
+        int ap[3] = {};
+        int p[3] = {};   // Partial reconstruction history
+        int d[7] = {};   // Quantized difference history
+        int b[7] = {};   // Zero coefficients
+        int bp[7] = {};
+        int sg[7] = {};
+        int nb = 0;      // Log scale factor
+        int det = 0;     // Quantizer step size
+
+        // Block 4: predictor update from the quantized difference d
+        void update(int d);
+    };
+
+    struct State {
+        Band band[2];    // [0] low, [1] high
+        int x[24] = {};  // QMF delay line
+
+        State() {
+            band[0].det = 32;
+            band[1].det = 8;
+        }
+        void reset() { *this = State(); }
+    };
+
+    State encoder_;
+    State decoder_;
+};
+
+#endif // LXST_G722_CODEC_H
@@ -0,0 +1,86 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_LATENCY_HISTOGRAM_H
+#define LXST_LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Fixed-bucket latency histogram, safe to record from the audio callback.
+ *
+ * Buckets are linear with a width set at construction; the last bucket
+ * collects everything at or beyond NUM_BUCKETS-1 widths. Recording is a
+ * single relaxed fetch_add — no allocation, no locks — so the SCHED_FIFO
+ * callback can record while a JNI thread snapshots.
+ *
+ * Snapshots are not atomic across buckets; a concurrent record may land
+ * in one bucket but not yet be visible in the total. Fine for diagnostics.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int NUM_BUCKETS = 40;
+
+    /** @param bucketWidthUs Width of each bucket in microseconds */
+    explicit LatencyHistogram(int bucketWidthUs) : bucketWidthUs_(bucketWidthUs) {}
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /** Record one sample. Negative values are clamped into the first bucket. */
+    void record(int64_t valueUs) {
+        int64_t idx = valueUs / bucketWidthUs_;
+        if (idx < 0) idx = 0;
+        if (idx >= NUM_BUCKETS) idx = NUM_BUCKETS - 1;
+        buckets_[idx].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /** Copy up to maxBuckets counts into out. Returns the number copied. */
+    int snapshot(int32_t* out, int maxBuckets) const {
+        int n = (maxBuckets < NUM_BUCKETS) ? maxBuckets : NUM_BUCKETS;
+        for (int i = 0; i < n; i++) {
+            out[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    /** Total number of recorded samples. */
+    int64_t count() const {
+        int64_t total = 0;
+        for (const auto& b : buckets_) total += b.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    /**
+     * Upper edge (µs) of the bucket containing the given percentile,
+     * or 0 if nothing has been recorded.
+     *
+     * @param percent 0..100
+     */
+    int percentileUs(int percent) const {
+        int64_t total = count();
+        if (total == 0) return 0;
+        int64_t target = (total * percent + 99) / 100;
+        int64_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= target) return (i + 1) * bucketWidthUs_;
+        }
+        return NUM_BUCKETS * bucketWidthUs_;
+    }
+
+    int bucketWidthUs() const { return bucketWidthUs_; }
+
+    /** Clear all buckets. Safe to race with record() (a sample may survive). */
+    void reset() {
+        for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    const int bucketWidthUs_;
+    std::atomic<int32_t> buckets_[NUM_BUCKETS] = {};
+};
+
+#endif // LXST_LATENCY_HISTOGRAM_H
@@ -0,0 +1,160 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_MEMORY_LEDGER_H
+#define LXST_MEMORY_LEDGER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <utility>
+
+/**
+ * Where native memory goes, for per-profile budgets.
+ *
+ * Flat int array (JNI getMemoryStats), two entries per component:
+ *   [2c] current bytes, [2c+1] peak bytes, c = MemComponent
+ * followed by [MEM_COMPONENTS*2] total current, [MEM_COMPONENTS*2+1] total peak.
+ */
+enum MemComponent : int {
+    MEM_ENGINE = 0,    // Engine object: fixed packet buffers, reorder window, queues
+    MEM_PCM_RING,      // PacketRingBuffer slabs
+    MEM_ENCODED_RING,  // EncodedRingBuffer slabs
+    MEM_CODEC,         // CodecWrapper and Opus encoder/decoder/DRED states
+    MEM_FILTERS,       // VoiceFilterChain state and work buffer
+    MEM_SCRATCH,       // Engine work buffers: decode, PLC, DRED, preroll, retransmit
+    MEM_COMPONENTS
+};
+
+constexpr int MEM_STATS_FIELDS = (MEM_COMPONENTS + 1) * 2;
+
+/**
+ * Current and peak bytes per component for one engine.
+ *
+ * Allocations happen off the audio thread (create/configure), but a JNI
+ * thread may snapshot at any time, so the counters are atomics. Each
+ * engine owns one ledger, created with it, so the peaks cover one call.
+ *
+ * Codec2 allocates its state inside the library with no size query, so
+ * it is not counted; only the CodecWrapper around it is.
+ */
+class MemoryLedger {
+public:
+    MemoryLedger() = default;
+    MemoryLedger(const MemoryLedger&) = delete;
+    MemoryLedger& operator=(const MemoryLedger&) = delete;
+
+    void charge(MemComponent c, size_t bytes) {
+        auto n = static_cast<int64_t>(bytes);
+        raisePeak(peak_[c], current_[c].fetch_add(n, std::memory_order_relaxed) + n);
+        raisePeak(totalPeak_, total_.fetch_add(n, std::memory_order_relaxed) + n);
+    }
+
+    void release(MemComponent c, size_t bytes) {
+        auto n = static_cast<int64_t>(bytes);
+        current_[c].fetch_sub(n, std::memory_order_relaxed);
+        total_.fetch_sub(n, std::memory_order_relaxed);
+    }
+
+    int64_t currentBytes(MemComponent c) const { return current_[c].load(std::memory_order_relaxed); }
+    int64_t peakBytes(MemComponent c) const { return peak_[c].load(std::memory_order_relaxed); }
+    int64_t totalBytes() const { return total_.load(std::memory_order_relaxed); }
+    int64_t totalPeakBytes() const { return totalPeak_.load(std::memory_order_relaxed); }
+
+    /** Copy the MEM_STATS_FIELDS layout into out. @return Fields written, or 0 if out is too small */
+    int snapshot(int32_t* out, int maxLen) const {
+        if (maxLen < MEM_STATS_FIELDS) return 0;
+        for (int c = 0; c < MEM_COMPONENTS; c++) {
+            out[2 * c] = clampInt(current_[c].load(std::memory_order_relaxed));
+            out[2 * c + 1] = clampInt(peak_[c].load(std::memory_order_relaxed));
+        }
+        out[2 * MEM_COMPONENTS] = clampInt(totalBytes());
+        out[2 * MEM_COMPONENTS + 1] = clampInt(totalPeakBytes());
+        return MEM_STATS_FIELDS;
+    }
+
+private:
+    static void raisePeak(std::atomic<int64_t>& peak, int64_t value) {
+        int64_t seen = peak.load(std::memory_order_relaxed);
+        while (value > seen &&
+               !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    static int32_t clampInt(int64_t v) {
+        return v > INT32_MAX ? INT32_MAX : static_cast<int32_t>(v);
+    }
+
+    std::atomic<int64_t> current_[MEM_COMPONENTS] = {};
+    std::atomic<int64_t> peak_[MEM_COMPONENTS] = {};
+    std::atomic<int64_t> total_{0};
+    std::atomic<int64_t> totalPeak_{0};
+};
+
+// --- Tracked allocation ------------------------------------------------------
+// All take a null ledger (untracked), so shared classes work without one.
+
+/** malloc() charged to the ledger, for C libraries that take caller memory (Opus *_init). */
+inline void* ledgerAlloc(MemoryLedger* ledger, MemComponent c, size_t bytes) {
+    void* p = std::malloc(bytes);
+    if (p && ledger) ledger->charge(c, bytes);
+    return p;
+}
+
+/** Free a ledgerAlloc() block; bytes must match the allocation. */
+inline void ledgerFree(MemoryLedger* ledger, MemComponent c, void* p, size_t bytes) {
+    if (!p) return;
+    if (ledger) ledger->release(c, bytes);
+    std::free(p);
+}
+
+template <typename T>
+struct LedgerArrayDelete {
+    MemoryLedger* ledger = nullptr;
+    MemComponent component = MEM_SCRATCH;
+    size_t count = 0;
+
+    void operator()(T* p) const {
+        if (ledger) ledger->release(component, count * sizeof(T));
+        delete[] p;
+    }
+};
+
+template <typename T>
+struct LedgerDelete {
+    MemoryLedger* ledger = nullptr;
+    MemComponent component = MEM_SCRATCH;
+
+    void operator()(T* p) const {
+        if (ledger) ledger->release(component, sizeof(T));
+        delete p;
+    }
+};
+
+/** unique_ptr<T[]> whose bytes stay charged to a ledger until it is reset. */
+template <typename T>
+using TrackedArray = std::unique_ptr<T[], LedgerArrayDelete<T>>;
+
+/** unique_ptr<T> whose sizeof(T) stays charged to a ledger until it is reset. */
+template <typename T>
+using TrackedPtr = std::unique_ptr<T, LedgerDelete<T>>;
+
+/** Value-initialised like std::make_unique<T[]>(count). */
+template <typename T>
+TrackedArray<T> makeTrackedArray(MemoryLedger* ledger, MemComponent c, size_t count) {
+    TrackedArray<T> p(new T[count](), LedgerArrayDelete<T>{ledger, c, count});
+    if (ledger) ledger->charge(c, count * sizeof(T));
+    return p;
+}
+
+template <typename T, typename... Args>
+TrackedPtr<T> makeTracked(MemoryLedger* ledger, MemComponent c, Args&&... args) {
+    TrackedPtr<T> p(new T(std::forward<Args>(args)...), LedgerDelete<T>{ledger, c});
+    if (ledger) ledger->charge(c, sizeof(T));
+    return p;
+}
+
+#endif // LXST_MEMORY_LEDGER_H
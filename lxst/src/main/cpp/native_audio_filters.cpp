@@ -6,32 +6,37 @@
 #include <cmath>
 #include <algorithm>
 
-// Matches AudioFilters.kt constants
-static constexpr float AGC_ATTACK_TIME = 0.0001f;
-static constexpr float AGC_RELEASE_TIME = 0.002f;
-static constexpr float AGC_HOLD_TIME = 0.001f;
+// AudioFilters.kt applies its per-sample coefficients once per block of
+// 1/10 frame, so its real time constants scale with the frame size. These
+// are the effective ones at 20ms/48kHz, now honoured at every frame size.
+static constexpr float AGC_ATTACK_TIME = 0.010f;
+static constexpr float AGC_RELEASE_TIME = 0.200f;
+static constexpr float AGC_HOLD_TIME = 0.002f;
+static constexpr float AGC_SUBBLOCK_TIME = 0.001f;  // Detector resolution
 static constexpr float AGC_TRIGGER_LEVEL = 0.003f;
 static constexpr float AGC_PEAK_LIMIT = 0.75f;
-static constexpr int   AGC_BLOCK_TARGET = 10;
 
 VoiceFilterChain::VoiceFilterChain(int channels, float hpCutoff, float lpCutoff,
-                                   float agcTargetDb, float agcMaxGain)
-    : channels_(channels),
+                                   float agcTargetDb, float agcMaxGain,
+                                   MemoryLedger* ledger)
+    : ledger_(ledger),
+      channels_(channels),
       hpCutoff_(hpCutoff),
       lpCutoff_(lpCutoff),
       agcTargetDb_(agcTargetDb),
-      agcMaxGain_(agcMaxGain) {
+      agcMaxGain_(agcMaxGain),
+      agcTargetLinear_(std::pow(10.0f, agcTargetDb / 10.0f)),
+      agcMaxGainLinear_(std::pow(10.0f, agcMaxGain / 10.0f)) {
 
-    hp_.filterStates = std::make_unique<float[]>(channels);
-    hp_.lastInputs = std::make_unique<float[]>(channels);
-    lp_.filterStates = std::make_unique<float[]>(channels);
-    agc_.currentGain = std::make_unique<float[]>(channels);
+    hp_.filterStates = makeTrackedArray<float>(ledger_, MEM_FILTERS, channels);
+    hp_.lastInputs = makeTrackedArray<float>(ledger_, MEM_FILTERS, channels);
+    lp_.filterStates = makeTrackedArray<float>(ledger_, MEM_FILTERS, channels);
+    agc_.channels = makeTrackedArray<AGCChannel>(ledger_, MEM_FILTERS, channels);
 
     for (int ch = 0; ch < channels; ++ch) {
         hp_.filterStates[ch] = 0.0f;
         hp_.lastInputs[ch] = 0.0f;
         lp_.filterStates[ch] = 0.0f;
-        agc_.currentGain[ch] = 1.0f;
     }
 }
 
@@ -44,7 +49,7 @@ void VoiceFilterChain::process(int16_t* samples, int numSamples, int sampleRate)
 
     // Ensure work buffer is large enough
     if (workBufferSize_ < numSamples) {
-        workBuffer_ = std::make_unique<float[]>(numSamples);
+        workBuffer_ = makeTrackedArray<float>(ledger_, MEM_FILTERS, numSamples);
         workBufferSize_ = numSamples;
     }
 
@@ -68,9 +73,13 @@ void VoiceFilterChain::process(int16_t* samples, int numSamples, int sampleRate)
     }
     if (agc_.sampleRate != sampleRate) {
         agc_.sampleRate = sampleRate;
-        agc_.attackCoeff = 1.0f - std::exp(-1.0f / (AGC_ATTACK_TIME * sampleRate));
-        agc_.releaseCoeff = 1.0f - std::exp(-1.0f / (AGC_RELEASE_TIME * sampleRate));
+        agc_.subBlockSamples = std::max(1, static_cast<int>(std::lround(AGC_SUBBLOCK_TIME * sampleRate)));
+        float subBlockTime = static_cast<float>(agc_.subBlockSamples) / sampleRate;
+        agc_.attackCoeff = 1.0f - std::exp(-subBlockTime / AGC_ATTACK_TIME);
+        agc_.releaseCoeff = 1.0f - std::exp(-subBlockTime / AGC_RELEASE_TIME);
         agc_.holdSamples = static_cast<int>(AGC_HOLD_TIME * sampleRate);
+        agc_.subBlockPos = 0;
+        for (int ch = 0; ch < channels_; ++ch) agc_.channels[ch].sumSquares = 0.0f;
     }
 
     // Apply filter chain: HPF → LPF → AGC
@@ -141,78 +150,62 @@ void VoiceFilterChain::applyLowPass(float* samples, int numFrames) {
     }
 }
 
-// --- AGC (matches AudioFilters.kt applyAGC) ---
+// --- AGC (streaming) ---
+//
+// One pass per sample: accumulate the detector energy, apply the ramping
+// gain, and catch peaks. At each sub-block boundary the sub-block's input
+// RMS sets a target gain, the smoothed gain moves toward it (attack down,
+// release up after the hold), and the next sub-block ramps to it.
 
 void VoiceFilterChain::applyAGC(float* samples, int numFrames) {
-    float targetLinear = std::pow(10.0f, agcTargetDb_ / 10.0f);
-    float maxGainLinear = std::pow(10.0f, agcMaxGain_ / 10.0f);
-
-    int blockSize = std::max(1, numFrames / AGC_BLOCK_TARGET);
-
-    for (int block = 0; block < AGC_BLOCK_TARGET; ++block) {
-        int blockStart = block * blockSize;
-        int blockEnd = (block == AGC_BLOCK_TARGET - 1) ? numFrames : (block + 1) * blockSize;
-        if (blockEnd > numFrames) blockEnd = numFrames;
-
-        int blockSamples = blockEnd - blockStart;
-        if (blockSamples <= 0) continue;
+    AGCChannel* chans = agc_.channels.get();
 
+    for (int i = 0; i < numFrames; ++i) {
         for (int ch = 0; ch < channels_; ++ch) {
-            // Calculate RMS for this block
-            float sumSquares = 0.0f;
-            for (int i = blockStart; i < blockEnd; ++i) {
-                int idx = i * channels_ + ch;
-                sumSquares += samples[idx] * samples[idx];
-            }
-            float rms = std::sqrt(sumSquares / blockSamples);
-
-            // Calculate target gain
-            float targetGain;
-            if (rms > 1e-9f && rms > AGC_TRIGGER_LEVEL) {
-                targetGain = std::min(targetLinear / rms, maxGainLinear);
-            } else {
-                targetGain = agc_.currentGain[ch];
-            }
-
-            // Smooth gain changes
-            if (targetGain < agc_.currentGain[ch]) {
-                // Attack: reduce gain quickly
-                agc_.currentGain[ch] = agc_.attackCoeff * targetGain +
-                    (1.0f - agc_.attackCoeff) * agc_.currentGain[ch];
-                agc_.holdCounter = agc_.holdSamples;
+            AGCChannel& c = chans[ch];
+            int idx = i * channels_ + ch;
+            float x = samples[idx];
+            c.sumSquares += x * x;
+
+            float y = x * c.appliedGain;
+            float absY = std::fabs(y);
+            if (absY > AGC_PEAK_LIMIT) {
+                // Limit instantly and hold the gain down; release recovers it
+                c.appliedGain *= AGC_PEAK_LIMIT / absY;
+                c.gain = std::min(c.gain, c.appliedGain);
+                c.gainStep = 0.0f;
+                c.holdCounter = agc_.holdSamples;
+                y = std::copysign(AGC_PEAK_LIMIT, x);
             } else {
-                // Release: increase gain slowly (with hold)
-                if (agc_.holdCounter > 0) {
-                    agc_.holdCounter -= blockSamples;
-                } else {
-                    agc_.currentGain[ch] = agc_.releaseCoeff * targetGain +
-                        (1.0f - agc_.releaseCoeff) * agc_.currentGain[ch];
-                }
-            }
-
-            // Apply gain to this block
-            for (int i = blockStart; i < blockEnd; ++i) {
-                int idx = i * channels_ + ch;
-                samples[idx] *= agc_.currentGain[ch];
+                c.appliedGain += c.gainStep;
             }
+            samples[idx] = y;
         }
-    }
 
-    // Peak limiting to prevent clipping
-    for (int ch = 0; ch < channels_; ++ch) {
-        float peak = 0.0f;
-        for (int i = 0; i < numFrames; ++i) {
-            int idx = i * channels_ + ch;
-            float absVal = std::fabs(samples[idx]);
-            if (absVal > peak) peak = absVal;
+        if (++agc_.subBlockPos == agc_.subBlockSamples) {
+            agc_.subBlockPos = 0;
+            for (int ch = 0; ch < channels_; ++ch) updateAGCGain(chans[ch]);
         }
+    }
+}
 
-        if (peak > AGC_PEAK_LIMIT) {
-            float scale = AGC_PEAK_LIMIT / peak;
-            for (int i = 0; i < numFrames; ++i) {
-                int idx = i * channels_ + ch;
-                samples[idx] *= scale;
-            }
-        }
+void VoiceFilterChain::updateAGCGain(AGCChannel& c) {
+    float rms = std::sqrt(c.sumSquares / agc_.subBlockSamples);
+    c.sumSquares = 0.0f;
+
+    // Below the trigger (silence, noise floor) the gain is left where it is
+    float targetGain = (rms > AGC_TRIGGER_LEVEL)
+        ? std::min(agcTargetLinear_ / rms, agcMaxGainLinear_)
+        : c.gain;
+
+    if (targetGain < c.gain) {
+        c.gain += agc_.attackCoeff * (targetGain - c.gain);
+        c.holdCounter = agc_.holdSamples;
+    } else if (c.holdCounter > 0) {
+        c.holdCounter -= agc_.subBlockSamples;
+    } else {
+        c.gain += agc_.releaseCoeff * (targetGain - c.gain);
     }
+
+    c.gainStep = (c.gain - c.appliedGain) / agc_.subBlockSamples;
 }
@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <memory>
+#include "memory_ledger.h"
 
 /**
  * Native voice filter chain for LXST audio capture.
@@ -17,6 +18,11 @@
  *
  * Filter order: HighPass (300Hz) → LowPass (3400Hz) → AGC
  *
+ * The AGC streams: its detector runs on fixed 1ms sub-blocks carried
+ * across calls, so attack/release/hold are real times whatever the frame
+ * size, and the gain ramps per sample between sub-blocks instead of
+ * stepping.
+ *
  * Processes int16 samples in-place. Internally converts to float for
  * filter math and back to int16 on output.
  */
@@ -28,9 +34,11 @@ public:
      * @param lpCutoff      Low-pass cutoff frequency (Hz)
      * @param agcTargetDb   AGC target level in dBFS
      * @param agcMaxGain    AGC maximum gain in dB
+     * @param ledger        Charged with filter state as MEM_FILTERS (null = untracked)
      */
     VoiceFilterChain(int channels, float hpCutoff, float lpCutoff,
-                     float agcTargetDb, float agcMaxGain);
+                     float agcTargetDb, float agcMaxGain,
+                     MemoryLedger* ledger = nullptr);
     ~VoiceFilterChain();
 
     // Non-copyable
@@ -49,44 +57,57 @@ public:
 private:
     // --- High-pass filter (first-order RC) ---
     struct HighPassState {
-        std::unique_ptr<float[]> filterStates;
-        std::unique_ptr<float[]> lastInputs;
+        TrackedArray<float> filterStates;
+        TrackedArray<float> lastInputs;
         float alpha = 0;
         int sampleRate = 0;
     };
 
     // --- Low-pass filter (first-order RC) ---
     struct LowPassState {
-        std::unique_ptr<float[]> filterStates;
+        TrackedArray<float> filterStates;
         float alpha = 0;
         int sampleRate = 0;
     };
 
-    // --- Automatic Gain Control ---
+    // --- Automatic Gain Control (streaming) ---
+    struct AGCChannel {
+        float gain = 1.0f;         // Smoothed gain at the end of the last sub-block
+        float appliedGain = 1.0f;  // Gain on the next sample, ramping toward gain
+        float gainStep = 0.0f;     // Per-sample ramp increment
+        float sumSquares = 0.0f;   // Detector: input energy in the open sub-block
+        int holdCounter = 0;       // Samples left before release may raise gain
+    };
+
     struct AGCState {
-        std::unique_ptr<float[]> currentGain;
-        int holdCounter = 0;
+        TrackedArray<AGCChannel> channels;
         int sampleRate = 0;
-        float attackCoeff = 0;
-        float releaseCoeff = 0;
+        int subBlockSamples = 1;   // Per channel
+        int subBlockPos = 0;       // Frames into the open sub-block
+        float attackCoeff = 0;     // Per sub-block
+        float releaseCoeff = 0;    // Per sub-block
         int holdSamples = 0;
     };
 
     void applyHighPass(float* samples, int numFrames);
     void applyLowPass(float* samples, int numFrames);
     void applyAGC(float* samples, int numFrames);
+    void updateAGCGain(AGCChannel& ch);
 
+    MemoryLedger* ledger_;
     int channels_;
     float hpCutoff_;
     float lpCutoff_;
     float agcTargetDb_;
     float agcMaxGain_;
+    float agcTargetLinear_;
+    float agcMaxGainLinear_;
 
     HighPassState hp_;
     LowPassState lp_;
     AGCState agc_;
 
-    std::unique_ptr<float[]> workBuffer_;
+    TrackedArray<float> workBuffer_;
     int workBufferSize_ = 0;
 };
 
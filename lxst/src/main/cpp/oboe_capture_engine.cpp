@@ -3,7 +3,10 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "oboe_capture_engine.h"
+#include "audio_clock.h"
+#include "sample_convert.h"
 #include <android/log.h>
+#include <cstdlib>
 #include <cstring>
 
 #define LOG_TAG "LXST:OboeCaptureEngine"
@@ -11,14 +14,51 @@
 #define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-OboeCaptureEngine::OboeCaptureEngine() = default;
+// Same cadence as the playback engine's output latency refresh.
+static constexpr int64_t LATENCY_QUERY_INTERVAL_NS = 100000000LL;
+
+// Callback size near the device burst that lines up with LXST frames: a
+// divisor of the frame, so every frame completes on a callback boundary
+// at a steady cadence, or a whole number of frames when they are shorter
+// than a burst. 0 if nothing lands within a factor of two of the burst;
+// the device's own size is better than a forced one that far off.
+static int alignedCallbackFrames(int frameFrames, int burstFrames) {
+    if (frameFrames <= 0 || burstFrames <= 0) return 0;
+    int best = 0;
+    auto consider = [&](int n) {
+        if (n < burstFrames / 2 || n > burstFrames * 2) return;
+        int d = std::abs(n - burstFrames);
+        int bestD = std::abs(best - burstFrames);
+        if (best == 0 || d < bestD || (d == bestD && n > best)) best = n;
+    };
+    for (int d = 1; d * d <= frameFrames; d++) {
+        if (frameFrames % d) continue;
+        consider(d);
+        consider(frameFrames / d);
+    }
+    for (int n = 2 * frameFrames; n <= burstFrames * 2; n += frameFrames) consider(n);
+    return best;
+}
+
+// A burst of burstFrames at burstRate, in frames at rate (the codec rate
+// the callback delivers after Oboe's resampler).
+static int burstAtRate(int burstFrames, int burstRate, int rate) {
+    if (burstRate <= 0 || rate <= 0 || burstRate == rate) return burstFrames;
+    return static_cast<int>((static_cast<int64_t>(burstFrames) * rate + burstRate / 2) / burstRate);
+}
+
+OboeCaptureEngine::OboeCaptureEngine() {
+    memory_.charge(MEM_ENGINE, sizeof(OboeCaptureEngine));
+    sem_init(&txReady_, 0, 0);
+}
 
 OboeCaptureEngine::~OboeCaptureEngine() {
     destroy();
+    sem_destroy(&txReady_);
 }
 
 bool OboeCaptureEngine::create(int sampleRate, int channels, int frameSamples,
-                               int maxBufferFrames, bool enableFilters) {
+                               int maxBufferMs, bool enableFilters) {
     if (isCreated_.load()) {
         LOGW("Engine already created, destroying first");
         destroy();
@@ -28,23 +68,36 @@ bool OboeCaptureEngine::create(int sampleRate, int channels, int frameSamples,
     channels_ = channels;
     frameSamples_ = frameSamples;
 
-    ringBuffer_ = std::make_unique<PacketRingBuffer>(maxBufferFrames, frameSamples);
-    accumBuffer_ = std::make_unique<int16_t[]>(frameSamples);
+    int slots = slotsForSamples(samplesForMs(maxBufferMs, sampleRate, channels), frameSamples);
+    ringBuffer_ = std::make_unique<PacketRingBuffer>(slots, frameSamples, &memory_);
+    accumBuffer_ = makeTrackedArray<int16_t>(&memory_, MEM_SCRATCH, frameSamples);
+    accumTarget_ = accumBuffer_.get();
+    accumInRing_ = false;
     accumCount_ = 0;
 
+    int prerollSamples = samplesForMs(MAX_PREROLL_MS, sampleRate, channels);
+    prerollCapacity_ = (prerollSamples + frameSamples - 1) / frameSamples;
+    if (prerollCapacity_ < 1) prerollCapacity_ = 1;
+    prerollBuf_ = makeTrackedArray<int16_t>(&memory_, MEM_SCRATCH,
+                                            static_cast<size_t>(prerollCapacity_) * frameSamples);
+    prerollHead_ = 0;
+    prerollCount_ = 0;
+
     if (enableFilters) {
-        filterChain_ = std::make_unique<VoiceFilterChain>(
+        filterChain_ = makeTracked<VoiceFilterChain>(
+            &memory_, MEM_FILTERS,
             channels,
             300.0f,    // HP cutoff: remove rumble/hum
             3400.0f,   // LP cutoff: voice band limit
             -12.0f,    // AGC target dBFS
-            12.0f      // AGC max gain dB
+            12.0f,     // AGC max gain dB
+            &memory_
         );
     }
 
     isCreated_.store(true);
-    LOGI("Created: rate=%d ch=%d frameSamples=%d maxBuf=%d filters=%s",
-         sampleRate, channels, frameSamples, maxBufferFrames,
+    LOGI("Created: rate=%d ch=%d frameSamples=%d maxBuf=%dms slots=%d filters=%s",
+         sampleRate, channels, frameSamples, maxBufferMs, slots,
          enableFilters ? "on" : "off");
     return true;
 }
@@ -66,16 +119,34 @@ bool OboeCaptureEngine::startStream() {
 void OboeCaptureEngine::stopStream() {
     isRecording_.store(false);
     closeStream();
+    // Let a blocked reader see the stop before returning; it may still
+    // drain what's queued afterwards
+    haltReaders();
+    resumeReaders();
 }
 
 void OboeCaptureEngine::destroy() {
+    haltReaders();
     stopStream();
     destroyEncoder();
     ringBuffer_.reset();
     accumBuffer_.reset();
     filterChain_.reset();
+    accumTarget_ = nullptr;
+    accumInRing_ = false;
     accumCount_ = 0;
+    prerollBuf_.reset();
+    prerollCapacity_ = 0;
+    prerollHead_ = 0;
+    prerollCount_ = 0;
+    pttMode_.store(false, std::memory_order_relaxed);
+    pttKeyed_.store(false, std::memory_order_relaxed);
+    prerollFrames_.store(0, std::memory_order_relaxed);
+    gateOpen_ = true;
+    inputLatencyUs_.store(0, std::memory_order_relaxed);
+    lastLatencyQueryNs_ = 0;
     isCreated_.store(false);
+    resumeReaders();  // Nothing left to read: they return at once
     LOGI("Destroyed");
 }
 
@@ -84,6 +155,15 @@ bool OboeCaptureEngine::readSamples(int16_t* dest, int count) {
     return ringBuffer_->read(dest, count);
 }
 
+bool OboeCaptureEngine::readSamplesFloat(float* dest, int count, float gain) {
+    if (!ringBuffer_ || count != frameSamples_) return false;
+    const int16_t* slot = ringBuffer_->readSlot();
+    if (!slot) return false;
+    int16ToFloat(slot, dest, count, gain);
+    ringBuffer_->releaseRead();
+    return true;
+}
+
 int OboeCaptureEngine::getBufferedFrameCount() const {
     return ringBuffer_ ? ringBuffer_->availableFrames() : 0;
 }
@@ -98,11 +178,39 @@ int OboeCaptureEngine::getXRunCount() const {
     return (result.value() > 0) ? result.value() : 0;
 }
 
+int OboeCaptureEngine::getCaptureDelayMs() const {
+    if (sampleRate_ <= 0 || channels_ <= 0) return 0;
+
+    // Frames waiting for the Kotlin consumer: encoded packets (Phase 3) or
+    // raw PCM frames (Phase 2), each one LXST frame long.
+    int queuedFrames = encodedRingBuffer_
+        ? encodedRingBuffer_->availableSlots()
+        : getBufferedFrameCount();
+    if (encodeOffload_) queuedFrames += getBufferedFrameCount();  // Awaiting encode
+
+    int64_t frameUs = static_cast<int64_t>(frameSamples_) * 1000000LL
+                      / (static_cast<int64_t>(sampleRate_) * channels_);
+    int64_t totalUs = inputLatencyUs_.load(std::memory_order_relaxed)
+                      + frameUs * (1 + queuedFrames);
+    return static_cast<int>(totalUs / 1000);
+}
+
 // --- Oboe stream management ---
 
 bool OboeCaptureEngine::openStream() {
     oboe::AudioStreamBuilder builder;
 
+    // Ask for callbacks that line up with LXST frames. The burst isn't
+    // known until the stream is open, so size against Oboe's default
+    // burst (at its default rate), scaled to the codec rate, and check
+    // that guess against the device once open.
+    int assumedBurst = burstAtRate(oboe::DefaultStreamValues::FramesPerBurst,
+                                   oboe::DefaultStreamValues::SampleRate, sampleRate_);
+    int callbackFrames = channels_ > 0
+        ? alignedCallbackFrames(frameSamples_ / channels_, assumedBurst)
+        : 0;
+    if (callbackFrames > 0) builder.setFramesPerDataCallback(callbackFrames);
+
     builder.setDirection(oboe::Direction::Input)
            ->setPerformanceMode(oboe::PerformanceMode::LowLatency)
            ->setSharingMode(oboe::SharingMode::Exclusive)
@@ -116,17 +224,35 @@ bool OboeCaptureEngine::openStream() {
 
     oboe::Result result = builder.openStream(stream_);
 
+    // Sized for a different burst than the device's, the forced size would
+    // split device bursts unevenly and add buffering; take the device's own.
+    if (result == oboe::Result::OK && callbackFrames > 0) {
+        int deviceBurst = burstAtRate(stream_->getFramesPerBurst(), stream_->getSampleRate(),
+                                      sampleRate_);
+        if (deviceBurst != assumedBurst) {
+            LOGI("Input burst is %d frames, not the assumed %d: not forcing %d-frame callbacks",
+                 deviceBurst, assumedBurst, callbackFrames);
+            stream_->close();
+            stream_.reset();
+            builder.setFramesPerDataCallback(oboe::kUnspecified);
+            result = builder.openStream(stream_);
+        }
+    }
+
     if (result != oboe::Result::OK) {
         LOGE("Failed to open input stream: %s", oboe::convertToText(result));
         return false;
     }
 
-    LOGI("Input stream opened: API=%s, rate=%d (requested=%d), ch=%d, framesPerBurst=%d, bufferCapacity=%d",
+    LOGI("Input stream opened: API=%s, rate=%d (requested=%d), ch=%d, framesPerBurst=%d, "
+         "framesPerCallback=%d (frame %d), bufferCapacity=%d",
          stream_->getAudioApi() == oboe::AudioApi::AAudio ? "AAudio" : "OpenSLES",
          stream_->getSampleRate(),
          sampleRate_,
          stream_->getChannelCount(),
          stream_->getFramesPerBurst(),
+         stream_->getFramesPerDataCallback(),
+         channels_ > 0 ? frameSamples_ / channels_ : 0,
          stream_->getBufferCapacityInFrames());
 
     if (stream_->getSampleRate() != sampleRate_) {
@@ -140,6 +266,14 @@ bool OboeCaptureEngine::openStream() {
     // permanently killing the stream.
     isRecording_.store(true);
     accumCount_ = 0;
+    accumInRing_ = false;
+
+    // Pre-roll from before a stream restart is stale; start from the
+    // current gate state so reopening doesn't look like a key transition.
+    prerollHead_ = 0;
+    prerollCount_ = 0;
+    gateOpen_ = !pttMode_.load(std::memory_order_relaxed)
+                || pttKeyed_.load(std::memory_order_relaxed);
 
     result = stream_->requestStart();
     if (result != oboe::Result::OK) {
@@ -162,128 +296,606 @@ void OboeCaptureEngine::closeStream() {
     }
 }
 
+void OboeCaptureEngine::updateInputLatency(oboe::AudioStream* stream) {
+    int64_t now = monotonicNanos();
+    if (now - lastLatencyQueryNs_ < LATENCY_QUERY_INTERVAL_NS) return;
+    lastLatencyQueryNs_ = now;
+
+    // For input streams the timestamp is when a frame entered the pipeline
+    // at the microphone. The newest frame we have read entered
+    // (read - position) / rate after that, so its age is the input latency.
+    auto ts = stream->getTimestamp(CLOCK_MONOTONIC);
+    if (!ts) return;
+
+    int32_t rate = stream->getSampleRate();
+    if (rate <= 0) return;
+    int64_t framesAhead = stream->getFramesRead() - ts.value().position;
+    int64_t capturedNs = ts.value().timestamp + framesAhead * 1000000000LL / rate;
+    int64_t latencyNs = now - capturedNs;
+    if (latencyNs < 0) latencyNs = 0;
+    inputLatencyUs_.store(static_cast<int>(latencyNs / 1000), std::memory_order_relaxed);
+}
+
 // --- Oboe audio callback (runs on SCHED_FIFO thread) ---
 
 oboe::DataCallbackResult OboeCaptureEngine::onAudioReady(
-        oboe::AudioStream* /*stream*/,
+        oboe::AudioStream* stream,
         void* audioData,
         int32_t numFrames) {
 
     auto* input = static_cast<int16_t*>(audioData);
     int32_t totalSamples = numFrames * channels_;
     int32_t processed = 0;
+    if (sampleRate_ > 0) burstNs_ = static_cast<int64_t>(numFrames) * 1000000000LL / sampleRate_;
+
+    // PTT gate transitions are applied once per callback, before any new
+    // samples: key-down replays the pre-roll ahead of this burst, key-up
+    // closes the talk spurt with what has accumulated so far.
+    bool gateOpen = !pttMode_.load(std::memory_order_relaxed)
+                    || pttKeyed_.load(std::memory_order_relaxed);
+    if (gateOpen != gateOpen_) {
+        if (gateOpen) {
+            if (pttMode_.load(std::memory_order_relaxed)) emitPreroll();
+            prerollCount_ = 0;
+        } else {
+            flushTalkSpurt();
+        }
+        gateOpen_ = gateOpen;
+    }
 
     // Accumulate callback data into LXST-sized frames.
     // Oboe callbacks may deliver variable-size bursts (e.g., 192 samples)
-    // that don't align with LXST frame size (e.g., 960 samples for 20ms).
+    // that don't align with LXST frame size (e.g., 960 samples for 20ms);
+    // openStream() asks for an aligned size, but the device may not honour it.
     while (processed < totalSamples) {
         int remaining = totalSamples - processed;
         int needed = frameSamples_ - accumCount_;
         int toCopy = (remaining < needed) ? remaining : needed;
 
-        std::memcpy(accumBuffer_.get() + accumCount_, input + processed,
+        if (accumCount_ == 0) beginAccumFrame();
+        std::memcpy(accumTarget_ + accumCount_, input + processed,
                      sizeof(int16_t) * toCopy);
         accumCount_ += toCopy;
         processed += toCopy;
 
         if (accumCount_ == frameSamples_) {
             // Full LXST frame accumulated
-
-            // Apply mute: replace with silence if capture is muted
-            int16_t* frameData = accumBuffer_.get();
-            if (captureMuted_.load(std::memory_order_relaxed)) {
-                if (silenceBuf_) {
-                    frameData = silenceBuf_.get();
-                } else {
-                    std::memset(accumBuffer_.get(), 0, sizeof(int16_t) * frameSamples_);
-                }
-            }
-
-            // Apply filters
-            if (filterChain_) {
-                filterChain_->process(frameData, frameSamples_, sampleRate_);
-            }
-
-            if (encodeInCallback_ && encoder_ && encodedRingBuffer_) {
-                // Phase 3: Encode directly in callback → encoded ring buffer
-                int encodedLen = encoder_->encode(frameData, frameSamples_,
-                                                  encodeBuf_, sizeof(encodeBuf_));
-                if (encodedLen > 0) {
-                    if (!encodedRingBuffer_->write(encodeBuf_, encodedLen)) {
-                        // Encoded ring buffer full — drop (consumer too slow)
-                        uint8_t discard[1];
-                        int discardLen;
-                        encodedRingBuffer_->read(discard, 1, &discardLen);
-                        encodedRingBuffer_->write(encodeBuf_, encodedLen);
-                    }
-                }
-            } else {
-                // Phase 2: Write raw PCM to ring buffer
-                if (!ringBuffer_->write(frameData, frameSamples_)) {
-                    int16_t discard[1];
-                    ringBuffer_->read(discard, frameSamples_);
-                    ringBuffer_->write(frameData, frameSamples_);
-                }
-            }
-
+            processFrame(gateOpen);
             accumCount_ = 0;
         }
     }
 
+    // One wake-up per burst: with 2.5/5 ms frames a burst can complete
+    // several, and the worker drains everything queued anyway.
+    if (encodeSubmitPending_) {
+        encodeSubmitPending_ = false;
+        encodeWorker_.submit(&OboeCaptureEngine::encodeJob, this);
+    }
+
+    updateInputLatency(stream);
+
     return isRecording_.load(std::memory_order_relaxed)
         ? oboe::DataCallbackResult::Continue
         : oboe::DataCallbackResult::Stop;
 }
 
-// --- Phase 3: Native codec integration ---
+void OboeCaptureEngine::processFrame(bool gateOpen) {
+    int64_t mediaSample = mediaSamples_;
+    mediaSamples_ += frameSamples_;
+
+    // Apply mute: replace with silence if capture is muted
+    int16_t* frameData = accumTarget_;
+    if (captureMuted_.load(std::memory_order_relaxed)) {
+        if (silenceBuf_) {
+            frameData = silenceBuf_.get();
+        } else {
+            std::memset(accumTarget_, 0, sizeof(int16_t) * frameSamples_);
+        }
+    }
 
-bool OboeCaptureEngine::configureEncoder(int codecType, int sampleRate, int channels,
-                                          int opusApp, int opusBitrate, int opusComplexity,
-                                          int codec2Mode) {
-    destroyEncoder();
+    // Apply filters — also while PTT is idle, so HPF state and AGC gain
+    // have settled by the time the key goes down
+    if (filterChain_) {
+        filterChain_->process(frameData, frameSamples_, sampleRate_);
+    }
+
+    if (gateOpen) {
+        emitFrame(frameData, mediaSample);
+    } else if (prerollBuf_ && prerollFrames_.load(std::memory_order_relaxed) > 0) {
+        // PTT idle: no encode, just remember the most recent frames
+        std::memcpy(prerollBuf_.get() + prerollHead_ * frameSamples_, frameData,
+                    sizeof(int16_t) * frameSamples_);
+        prerollHead_ = (prerollHead_ + 1) % prerollCapacity_;
+        if (prerollCount_ < prerollCapacity_) prerollCount_++;
+    }
+}
+
+void OboeCaptureEngine::emitFrame(const int16_t* frameData, int64_t mediaSample) {
+    // A frame accumulated in the ring's write slot is published in place
+    bool inSlot = accumInRing_ && frameData == accumTarget_;
+    if (inSlot) accumInRing_ = false;
+
+    if (encodeInCallback_ && encoder_ && encodedRingBuffer_) {
+        if (encodeOffload_) {
+            // Phase 3: Hand the frame to the encode worker, woken once
+            // at the end of the callback. The callback is the PCM ring's
+            // producer, so on overflow the new frame is dropped (worker
+            // owns the read index).
+            FrameInfo info;
+            info.arrivalNs = monotonicNanos();
+            info.mediaSample = mediaSample;
+            if (inSlot) {
+                ringBuffer_->commitWrite(info);
+                encodeSubmitPending_ = true;
+            } else if (ringBuffer_->write(frameData, frameSamples_, info)) {
+                encodeSubmitPending_ = true;
+            }
+        } else {
+            // Phase 3: Encode directly in callback → encoded ring buffer
+            encodeFrame(frameData, encodeBuf_, sizeof(encodeBuf_), mediaSample, monotonicNanos());
+        }
+    } else {
+        // Phase 2: Write raw PCM to ring buffer. The Kotlin reader owns
+        // the read index, so on overflow the new frame is dropped.
+        if (inSlot) {
+            ringBuffer_->commitWrite();
+        } else {
+            ringBuffer_->write(frameData, frameSamples_);
+        }
+    }
+}
 
-    encoder_ = std::make_unique<CodecWrapper>();
-    bool ok = false;
+void OboeCaptureEngine::emitPreroll() {
+    if (!prerollBuf_) return;
+    int n = prerollFrames_.load(std::memory_order_relaxed);
+    if (n > prerollCount_) n = prerollCount_;
+    if (n > 0) detachAccumFrame();  // The pre-roll goes into the ring first
+
+    // Oldest first; the partial frame in accumBuffer_ continues right after
+    int slot = (prerollHead_ - n + prerollCapacity_) % prerollCapacity_;
+    for (int i = 0; i < n; i++) {
+        emitFrame(prerollBuf_.get() + slot * frameSamples_,
+                  mediaSamples_ - static_cast<int64_t>(n - i) * frameSamples_);
+        slot = (slot + 1) % prerollCapacity_;
+    }
+    prerollCount_ = 0;
+}
+
+void OboeCaptureEngine::beginAccumFrame() {
+    int16_t* slot = (ringBuffer_ && framesToRing()) ? ringBuffer_->writeSlot() : nullptr;
+    accumInRing_ = slot != nullptr;
+    accumTarget_ = slot ? slot : accumBuffer_.get();
+}
 
-    if (codecType == static_cast<int>(CodecType::OPUS)) {
-        ok = encoder_->createOpus(sampleRate, channels, opusApp, opusBitrate, opusComplexity);
-    } else if (codecType == static_cast<int>(CodecType::CODEC2)) {
-        ok = encoder_->createCodec2(codec2Mode);
+void OboeCaptureEngine::detachAccumFrame() {
+    if (!accumInRing_) return;
+    if (accumCount_ > 0) {
+        std::memcpy(accumBuffer_.get(), accumTarget_, sizeof(int16_t) * accumCount_);
+    }
+    accumTarget_ = accumBuffer_.get();
+    accumInRing_ = false;
+}
+
+void OboeCaptureEngine::flushTalkSpurt() {
+    // Pad out the last partial frame rather than lose the end of the word
+    if (accumCount_ > 0) {
+        std::memset(accumTarget_ + accumCount_, 0,
+                    sizeof(int16_t) * (frameSamples_ - accumCount_));
+        processFrame(true);
+        accumCount_ = 0;
     }
 
-    if (!ok) {
-        LOGE("configureEncoder failed: type=%d rate=%d ch=%d", codecType, sampleRate, channels);
+    // An interleaved Codec2 frame only completes with the next packet, so
+    // push one frame of silence to carry the last frame's second half.
+    if (encodeInCallback_ && encoder_ && encoder_->codec2Interleaved() && silenceBuf_) {
+        emitFrame(silenceBuf_.get(), mediaSamples_);
+        mediaSamples_ += frameSamples_;
+    }
+
+    // Reset the encoder so the next spurt doesn't predict from this one.
+    // With offload, the worker resets after encoding what's already queued.
+    if (encodeInCallback_ && encoder_) {
+        if (encodeOffload_) {
+            encoderFlushPending_.store(true, std::memory_order_release);
+            encodeWorker_.submit(&OboeCaptureEngine::encodeJob, this);
+        } else {
+            encoder_->resetEncoder();
+            flushFecGroup();
+        }
+    }
+}
+
+// --- Phase 3: Native codec integration ---
+
+bool OboeCaptureEngine::configureEncoder(const CodecConfig& codec, int fecGroupSize,
+                                          bool codec2Interleave, bool headerExt) {
+    haltReaders();  // Until the new encoded ring is in place
+    destroyEncoder();
+
+    encoder_ = makeTracked<CodecWrapper>(&memory_, MEM_CODEC, &memory_);
+    if (!encoder_->create(codec)) {
+        LOGE("configureEncoder failed: type=%d rate=%d ch=%d",
+             static_cast<int>(codec.type), codec.sampleRate, codec.channels);
         encoder_.reset();
+        resumeReaders();
         return false;
     }
 
+    // DRED is optional: a libopus without it just sends plain packets
+    dredDurationMs_ = 0;
+    if (codec.dredDurationMs > 0 && encoder_->type() == CodecType::OPUS) {
+        appliedLossPct_ = plannedLossPct();
+        if (encoder_->setEncoderDred(codec.dredDurationMs, appliedLossPct_)) {
+            dredDurationMs_ = codec.dredDurationMs;
+        }
+    }
+
+    // Complexity governor: the profile's complexity is the ceiling and the
+    // starting point; measured encode cost and thermal headroom pull it down.
+    governEncoder_ = false;
+    encoderComplexity_.store(0, std::memory_order_relaxed);
+    int frameUs = (sampleRate_ > 0 && channels_ > 0)
+        ? static_cast<int>(static_cast<int64_t>(frameSamples_) * 1000000 / (sampleRate_ * channels_)) : 0;
+    if (encoder_->type() == CodecType::OPUS && frameUs > 0) {
+        int maxComplexity = codec.opusComplexity < 0 ? 0
+                          : (codec.opusComplexity > 10 ? 10 : codec.opusComplexity);
+        int levels[ComplexityGovernor::MAX_LEVELS];
+        for (int i = 0; i <= maxComplexity; i++) levels[i] = i;
+        encoderGovernor_.configure(levels, maxComplexity + 1, maxComplexity,
+                                   ENCODER_LOAD_HIGH_PCT, ENCODER_LOAD_LOW_PCT,
+                                   ENCODER_STEP_UP_HOLD_MS * 1000 / frameUs);
+        appliedThermalCeiling_ = thermalCeiling_.load(std::memory_order_relaxed);
+        encoderGovernor_.setCeilingIndex(appliedThermalCeiling_);
+        governEncoder_ = encoder_->setEncoderComplexity(encoderGovernor_.level());
+        encoderComplexity_.store(encoderGovernor_.level(), std::memory_order_relaxed);
+    }
+
+    if (codec2Interleave && encoder_->type() == CodecType::CODEC2) {
+        encoder_->setCodec2Interleave(true);
+    }
+
+    fecEncoder_.configure(fecGroupSize);
+
+    // Nominal packet rate for the TX pacer: one per frame, plus FEC parity
+    int64_t packetIntervalNs = static_cast<int64_t>(frameUs) * 1000;
+    if (fecEncoder_.enabled()) packetIntervalNs = packetIntervalNs * fecGroupSize / (fecGroupSize + 1);
+    txPacketIntervalNs_.store(packetIntervalNs * 100 / PACER_RATE_HEADROOM_PCT,
+                              std::memory_order_relaxed);
+    // txSeq_ carries on across reconfiguration (profile switch) so the
+    // receiver doesn't mistake the new encoder's packets for duplicates
+    headerExt_ = headerExt;
+    if (headerExt_) {
+        retransmitCache_ = makeTrackedArray<CachedPacket>(&memory_, MEM_SCRATCH,
+                                                          RETRANSMIT_CACHE_PACKETS);
+    }
+    retransmitTail_.store(retransmitHead_.load(std::memory_order_acquire), std::memory_order_release);
+    retransmitCount_.store(0, std::memory_order_relaxed);
+    staleDropCount_.store(0, std::memory_order_relaxed);
+
     // Encoded ring buffer: 32 slots, 1500 bytes max per slot
-    encodedRingBuffer_ = std::make_unique<EncodedRingBuffer>(32, 1500);
+    encodedRingBuffer_ = std::make_unique<EncodedRingBuffer>(32, 1500, &memory_);
 
     // Pre-allocate silence buffer for mute
-    silenceBuf_ = std::make_unique<int16_t[]>(frameSamples_);
-    std::memset(silenceBuf_.get(), 0, sizeof(int16_t) * frameSamples_);
+    silenceBuf_ = makeTrackedArray<int16_t>(&memory_, MEM_SCRATCH, frameSamples_);
+
+    // Offload encoding to a big-core worker so complexity-10 Opus never
+    // runs on the Oboe callback. Stale Phase 2 PCM is discarded first — the
+    // worker becomes the ring's consumer from here on.
+    workerPcmBuf_ = makeTrackedArray<int16_t>(&memory_, MEM_SCRATCH, frameSamples_);
+    RtWorkerConfig workerConfig;
+    workerConfig.name = "lxst-enc";
+    if (ringBuffer_) ringBuffer_->drain(0);
+    encodeOffload_ = ringBuffer_ && encodeWorker_.start(workerConfig);
 
     encodeInCallback_ = true;
 
-    LOGI("Encoder configured: type=%d rate=%d ch=%d", codecType, sampleRate, channels);
+    LOGI("Encoder configured: type=%d rate=%d ch=%d offload=%d complexity=%d fecGroup=%d ext=%d",
+         static_cast<int>(codec.type), codec.sampleRate, codec.channels, encodeOffload_,
+         encoderComplexity_.load(std::memory_order_relaxed),
+         fecEncoder_.enabled() ? fecGroupSize : 0, headerExt_);
+    resumeReaders();
+    return true;
+}
+
+void OboeCaptureEngine::encodeFrame(const int16_t* pcm, uint8_t* outBuf, int outSize,
+                                     int64_t mediaSample, int64_t captureNs) {
+    serviceRetransmits();
+    txCaptureNs_ = captureNs;
+    if (headerExt_ && sampleRate_ > 0 && channels_ > 0) {
+        txMediaMs_ = static_cast<uint16_t>(mediaSample * 1000 / (sampleRate_ * channels_));
+    }
+
+    if (dredDurationMs_ > 0) {
+        int lossPct = plannedLossPct();
+        if (lossPct != appliedLossPct_) {
+            appliedLossPct_ = lossPct;
+            encoder_->setEncoderDred(dredDurationMs_, lossPct);
+        }
+    }
+
+    // Leave room for the FEC tag byte and the header extension
+    bool fec = fecEncoder_.enabled();
+    int reserve = (fec ? 1 : 0) + (headerExt_ ? LXST_HEADER_EXT_BYTES : 0);
+    int64_t startNs = governEncoder_ ? monotonicNanos() : 0;
+    int encodedLen = encoder_->encode(pcm, frameSamples_, outBuf, outSize - reserve);
+    if (governEncoder_) governEncoderComplexity(monotonicNanos() - startNs);
+    if (encodedLen <= 0) return;
+
+    if (!fec) {
+        queueEncoded(outBuf, encodedLen);
+        return;
+    }
+    int fecRoom = sizeof(fecBuf_) - (headerExt_ ? LXST_HEADER_EXT_BYTES : 0);
+    int len = fecEncoder_.wrapData(outBuf, encodedLen, fecBuf_, fecRoom);
+    if (len > 0) queueEncoded(fecBuf_, len);
+    len = fecEncoder_.takeParity(fecBuf_, fecRoom);
+    if (len > 0) queueEncoded(fecBuf_, len);
+}
+
+void OboeCaptureEngine::queueEncoded(const uint8_t* data, int length) {
+    if (headerExt_) {
+        if (length + LXST_HEADER_EXT_BYTES > static_cast<int>(sizeof(extBuf_))) return;
+        uint16_t seq = txSeq_++;
+        writeHeaderExt(extBuf_, seq, txMediaMs_);
+        std::memcpy(extBuf_ + LXST_HEADER_EXT_BYTES, data, length);
+        data = extBuf_;
+        length += LXST_HEADER_EXT_BYTES;
+        if (retransmitCache_) {
+            CachedPacket& cached = retransmitCache_[seq & (RETRANSMIT_CACHE_PACKETS - 1)];
+            cached.seq = seq;
+            cached.len = length;
+            std::memcpy(cached.data, data, length);
+        }
+    }
+    if (!encodedRingBuffer_->write(data, length, txCaptureNs_)) {
+        // Encoded ring buffer full — drop (consumer too slow)
+        uint8_t discard[1];
+        int discardLen;
+        encodedRingBuffer_->read(discard, 1, &discardLen);
+        encodedRingBuffer_->write(data, length, txCaptureNs_);
+    }
+    sem_post(&txReady_);
+}
+
+bool OboeCaptureEngine::requestRetransmit(uint16_t seq) {
+    int head = retransmitHead_.load(std::memory_order_relaxed);
+    if (head - retransmitTail_.load(std::memory_order_acquire) >= RETRANSMIT_QUEUE) return false;
+    retransmitQueue_[head % RETRANSMIT_QUEUE] = seq;
+    retransmitHead_.store(head + 1, std::memory_order_release);
     return true;
 }
 
+void OboeCaptureEngine::serviceRetransmits() {
+    int tail = retransmitTail_.load(std::memory_order_relaxed);
+    int head = retransmitHead_.load(std::memory_order_acquire);
+    for (; tail != head; tail++) {
+        uint16_t seq = retransmitQueue_[tail % RETRANSMIT_QUEUE];
+        if (!retransmitCache_) continue;
+        const CachedPacket& cached = retransmitCache_[seq & (RETRANSMIT_CACHE_PACKETS - 1)];
+        if (cached.len <= 0 || cached.seq != seq) continue;  // Aged out
+        // Same bytes, same sequence: the receiver slots it into its hole.
+        // Dropped rather than displacing fresh audio if the ring is full.
+        // Stamped now: the peer asked for it, so it is still wanted.
+        if (encodedRingBuffer_->write(cached.data, cached.len, monotonicNanos())) {
+            sem_post(&txReady_);
+            retransmitCount_.store(retransmitCount_.load(std::memory_order_relaxed) + 1,
+                                   std::memory_order_relaxed);
+        }
+    }
+    retransmitTail_.store(tail, std::memory_order_release);
+}
+
+void OboeCaptureEngine::flushFecGroup() {
+    serviceRetransmits();
+    int fecRoom = sizeof(fecBuf_) - (headerExt_ ? LXST_HEADER_EXT_BYTES : 0);
+    int len = fecEncoder_.takeParity(fecBuf_, fecRoom, true);
+    if (len > 0) queueEncoded(fecBuf_, len);
+}
+
+void OboeCaptureEngine::governEncoderComplexity(int64_t encodeNs) {
+    bool changed = false;
+    int ceiling = thermalCeiling_.load(std::memory_order_relaxed);
+    if (ceiling != appliedThermalCeiling_) {
+        appliedThermalCeiling_ = ceiling;
+        changed = encoderGovernor_.setCeilingIndex(ceiling);
+    }
+
+    // Offloaded encodes have a whole frame; inline ones share the burst
+    int64_t budgetNs = encodeOffload_
+        ? static_cast<int64_t>(frameSamples_ / channels_) * 1000000000LL / sampleRate_
+        : burstNs_;
+    if (budgetNs > 0) {
+        changed |= encoderGovernor_.update(static_cast<int>(encodeNs * 100 / budgetNs));
+    }
+
+    if (changed) {
+        int level = encoderGovernor_.level();
+        encoder_->setEncoderComplexity(level);
+        encoderComplexity_.store(level, std::memory_order_relaxed);
+        LOGI("Encoder complexity -> %d (load %d%%, encode %lldus, thermal cap %d)",
+             level, encoderGovernor_.smoothedPct(),
+             static_cast<long long>(encodeNs / 1000), ceiling);
+    }
+}
+
+int OboeCaptureEngine::plannedLossPct() const {
+    int pct = expectedLossPct_.load(std::memory_order_relaxed);
+    if (pct < 0) return DRED_UNMEASURED_LOSS_PCT;
+    return pct > 100 ? 100 : pct;
+}
+
+int OboeCaptureEngine::thermalComplexityCeiling(float headroom) {
+    if (!(headroom >= 0.0f)) return 10;  // NaN / unsupported: no cap
+    if (headroom < 0.7f) return 10;
+    if (headroom < 0.8f) return 8;
+    if (headroom < 0.9f) return 6;
+    if (headroom < 1.0f) return 4;
+    return 2;  // At or past severe throttling
+}
+
+void OboeCaptureEngine::setThermalHeadroom(float headroom) {
+    int ceiling = thermalComplexityCeiling(headroom);
+    if (thermalCeiling_.exchange(ceiling, std::memory_order_relaxed) != ceiling) {
+        LOGI("Thermal headroom %.2f -> encoder complexity cap %d", headroom, ceiling);
+    }
+}
+
+void OboeCaptureEngine::encodeJob(void* ctx) {
+    static_cast<OboeCaptureEngine*>(ctx)->drainPcmToEncoder();
+}
+
+void OboeCaptureEngine::drainPcmToEncoder() {
+    if (!encoder_ || !encodedRingBuffer_ || !workerPcmBuf_) return;
+    encodeQueuedPcm();
+    if (encoderFlushPending_.exchange(false, std::memory_order_acq_rel)) {
+        // The key-up tail is written before the flag is set, so it may have
+        // arrived after the loop above emptied the ring — encode it first.
+        encodeQueuedPcm();
+        encoder_->resetEncoder();
+        flushFecGroup();
+    }
+}
+
+void OboeCaptureEngine::encodeQueuedPcm() {
+    FrameInfo info;
+    while (ringBuffer_->read(workerPcmBuf_.get(), frameSamples_, &info)) {
+        encodeFrame(workerPcmBuf_.get(), workerEncodeBuf_, sizeof(workerEncodeBuf_),
+                    info.mediaSample, info.arrivalNs);
+    }
+}
+
 bool OboeCaptureEngine::readEncodedPacket(uint8_t* dest, int maxLength, int* actualLength) {
     if (!encodedRingBuffer_) return false;
+    dropStalePackets();
     return encodedRingBuffer_->read(dest, maxLength, actualLength);
 }
 
+bool OboeCaptureEngine::readEncodedPacketBlocking(uint8_t* dest, int maxLength,
+                                                  int* actualLength, int timeoutMs) {
+    // Count in before looking at anything teardown may replace. Sequentially
+    // consistent with haltReaders(): either it sees this reader and waits,
+    // or this reader sees the halt and leaves.
+    blockingReaders_.fetch_add(1);
+    struct Leave {
+        std::atomic<int>& readers;
+        ~Leave() { readers.fetch_sub(1); }
+    } leave{blockingReaders_};
+
+    int64_t deadlineNs = monotonicNanos() + static_cast<int64_t>(timeoutMs) * 1000000LL;
+
+    int burst = txPacingBurst_.load(std::memory_order_relaxed);
+    int64_t intervalNs = burst > 0 ? txPacketIntervalNs_.load(std::memory_order_relaxed) : 0;
+    if (intervalNs != txPacer_.intervalNs() || (burst > 0 && burst != txPacer_.burstPackets())) {
+        txPacer_.configure(intervalNs, burst);
+    }
+
+    for (;;) {
+        if (readerHalts_.load() > 0 || !encodedRingBuffer_) return false;
+        dropStalePackets();
+        int64_t nowNs = monotonicNanos();
+
+        if (encodedRingBuffer_->availableSlots() > 0) {
+            int64_t waitNs = txPacer_.delayNs(nowNs);
+            if (waitNs == 0) {
+                bool ok = encodedRingBuffer_->read(dest, maxLength, actualLength);
+                if (ok) txPacer_.onSent(nowNs);
+                return ok;
+            }
+            // Held by the pacer: sleep until it releases, or give up at the
+            // deadline. A post (new packet, teardown) wakes it early.
+            if (nowNs >= deadlineNs) return false;
+            waitTxReady(nowNs, nowNs + waitNs < deadlineNs ? nowNs + waitNs : deadlineNs);
+            continue;
+        }
+
+        if (!isRecording_.load(std::memory_order_relaxed) || nowNs >= deadlineNs) return false;
+
+        // Empty: forget wake-ups for packets already read, re-check, then
+        // sleep until the next one is queued.
+        while (sem_trywait(&txReady_) == 0) {
+        }
+        if (readerHalts_.load() > 0 || encodedRingBuffer_->availableSlots() > 0) continue;
+        waitTxReady(nowNs, deadlineNs);
+    }
+}
+
+void OboeCaptureEngine::waitTxReady(int64_t nowNs, int64_t deadlineNs) {
+    // sem_timedwait takes CLOCK_REALTIME
+    struct timespec until;
+    clock_gettime(CLOCK_REALTIME, &until);
+    int64_t untilNs = static_cast<int64_t>(until.tv_sec) * 1000000000LL + until.tv_nsec
+                      + (deadlineNs - nowNs);
+    until.tv_sec = static_cast<time_t>(untilNs / 1000000000LL);
+    until.tv_nsec = static_cast<long>(untilNs % 1000000000LL);
+    sem_timedwait(&txReady_, &until);
+}
+
+void OboeCaptureEngine::haltReaders() {
+    readerHalts_.fetch_add(1);
+    while (blockingReaders_.load() > 0) {
+        sem_post(&txReady_);  // Asleep on the queue or the pacer
+        struct timespec tick = {0, 1000000};
+        nanosleep(&tick, nullptr);
+    }
+}
+
+void OboeCaptureEngine::resumeReaders() {
+    readerHalts_.fetch_sub(1);
+}
+
+void OboeCaptureEngine::dropStalePackets() {
+    int maxAgeMs = txMaxAgeMs_.load(std::memory_order_relaxed);
+    if (maxAgeMs <= 0) return;
+    int dropped = encodedRingBuffer_->dropStale(
+        monotonicNanos() - static_cast<int64_t>(maxAgeMs) * 1000000LL);
+    if (dropped > 0) {
+        int total = staleDropCount_.load(std::memory_order_relaxed) + dropped;
+        staleDropCount_.store(total, std::memory_order_relaxed);
+        LOGW("TX stall: dropped %d stale packets (total %d, max age %dms)",
+             dropped, total, maxAgeMs);
+    }
+}
+
 void OboeCaptureEngine::setCaptureMute(bool mute) {
     captureMuted_.store(mute, std::memory_order_relaxed);
 }
 
+void OboeCaptureEngine::setPttMode(bool enabled, int prerollMs) {
+    int frames = 0;
+    if (enabled && frameSamples_ > 0) {
+        if (prerollMs > MAX_PREROLL_MS) prerollMs = MAX_PREROLL_MS;
+        if (prerollMs < 0) prerollMs = 0;
+        int samples = samplesForMs(prerollMs, sampleRate_, channels_);
+        frames = (samples + frameSamples_ - 1) / frameSamples_;
+        if (frames > prerollCapacity_) frames = prerollCapacity_;
+    }
+    prerollFrames_.store(frames, std::memory_order_relaxed);
+    pttKeyed_.store(false, std::memory_order_relaxed);
+    pttMode_.store(enabled, std::memory_order_relaxed);
+    LOGI("PTT mode=%d preroll=%dms (%d frames)", enabled, enabled ? prerollMs : 0, frames);
+}
+
+void OboeCaptureEngine::setPttKeyed(bool keyed) {
+    pttKeyed_.store(keyed, std::memory_order_relaxed);
+}
+
 void OboeCaptureEngine::destroyEncoder() {
+    haltReaders();  // The encoded ring goes away below
     encodeInCallback_ = false;
+    encodeOffload_ = false;
+    encodeWorker_.stop();  // Join before the encoder goes away
+    encoderFlushPending_.store(false, std::memory_order_relaxed);
+    workerPcmBuf_.reset();
+    governEncoder_ = false;
+    encoderComplexity_.store(0, std::memory_order_relaxed);
+    dredDurationMs_ = 0;
     encoder_.reset();
+    fecEncoder_.configure(0);
+    headerExt_ = false;
+    retransmitCache_.reset();
     encodedRingBuffer_.reset();
     silenceBuf_.reset();
+    resumeReaders();
 }
 
 // --- Oboe error callback (stream disconnect recovery) ---
@@ -8,10 +8,17 @@
 #include <oboe/Oboe.h>
 #include <atomic>
 #include <memory>
+#include <semaphore.h>
 #include "packet_ring_buffer.h"
 #include "native_audio_filters.h"
 #include "codec_wrapper.h"
+#include "complexity_governor.h"
 #include "encoded_ring_buffer.h"
+#include "memory_ledger.h"
+#include "packet_header.h"
+#include "rt_worker_pool.h"
+#include "tx_pacer.h"
+#include "xor_fec.h"
 
 /**
  * Oboe-based audio capture engine for LXST.
@@ -22,6 +29,11 @@
  *   2. Applies native voice filters (HPF → LPF → AGC)
  *   3. Writes the filtered frame to a lock-free SPSC ring buffer
  *
+ * In PTT mode the stream keeps running while the key is up: filters stay
+ * warm, nothing is encoded or queued, and the last few hundred ms of
+ * filtered audio are kept in a pre-roll buffer. Key-down emits the
+ * pre-roll ahead of live frames so the first syllable isn't clipped.
+ *
  * Kotlin reads from the ring buffer via JNI (consumer side).
  *
  * Lifecycle: create() → startStream() → readSamples() → stopStream() → destroy()
@@ -42,11 +54,12 @@ public:
      * @param sampleRate      Input sample rate (e.g., 48000)
      * @param channels        Number of channels (1=mono)
      * @param frameSamples    Number of int16 samples per LXST frame
-     * @param maxBufferFrames Maximum frames in ring buffer
+     * @param maxBufferMs     Maximum audio held in the ring buffer (sized in
+     *                        whole frames, rounded up)
      * @param enableFilters   Enable native voice filter chain
      */
     bool create(int sampleRate, int channels, int frameSamples,
-                int maxBufferFrames, bool enableFilters);
+                int maxBufferMs, bool enableFilters);
 
     /** Open and start the Oboe input stream. */
     bool startStream();
@@ -66,6 +79,19 @@ public:
      */
     bool readSamples(int16_t* dest, int count);
 
+    /**
+     * Float variant of readSamples() for the Phase 2 (Kotlin codec) path.
+     *
+     * Converts straight out of the ring buffer slot to float32 with the
+     * gain applied in the same SIMD pass.
+     *
+     * @param dest  Destination (must hold frameSamples floats)
+     * @param count Number of samples to read (must equal frameSamples)
+     * @param gain  Linear gain (1.0 = unity)
+     * @return true if a frame was read, false if buffer is empty
+     */
+    bool readSamplesFloat(float* dest, int count, float gain);
+
     /** Number of frames currently buffered in the native ring buffer. */
     int getBufferedFrameCount() const;
 
@@ -75,18 +101,50 @@ public:
     /** Cumulative xrun count from the Oboe stream. */
     int getXRunCount() const;
 
+    /**
+     * Estimated capture-side delay in milliseconds for the oldest sample of
+     * the next packet: Oboe input latency (from AudioStream::getTimestamp)
+     * plus one LXST frame of accumulation plus frames still queued for the
+     * Kotlin consumer. Feeds the Kotlin LatencyProbe's mouth-to-ear estimate.
+     */
+    int getCaptureDelayMs() const;
+
     // --- Phase 3: Native codec integration ---
 
     /**
      * Configure a native encoder on the capture engine.
      *
-     * When configured, the Oboe callback encodes directly after filtering,
-     * writing encoded packets to an EncodedRingBuffer. Kotlin reads via
-     * readEncodedPacket() instead of readSamples().
+     * When configured, filtered frames are encoded into an EncodedRingBuffer
+     * and Kotlin reads via readEncodedPacket() instead of readSamples().
+     * Encoding runs on a pinned worker thread fed through the PCM ring
+     * buffer; if the worker can't start, the Oboe callback encodes inline.
+     *
+     * @param codec         Codec from the registry (codec_registry.h). Its
+     *                       dredDurationMs is the Opus DRED redundancy per
+     *                       packet (0 = off; ignored for other codecs or a
+     *                       libopus built without DRED)
+     * @param fecGroupSize   Emit one XOR parity packet every this many
+     *                       packets, framed per xor_fec.h (< 2 = off)
+     * @param codec2Interleave Spread Codec2 sub-frames across consecutive
+     *                       packets (CodecWrapper::setCodec2Interleave)
+     * @param headerExt      Prefix each packet with the sequence/timestamp
+     *                       extension (packet_header.h); the header byte
+     *                       must then carry LXST_FLAG_EXT
+     */
+    bool configureEncoder(const CodecConfig& codec, int fecGroupSize,
+                          bool codec2Interleave, bool headerExt);
+
+    /**
+     * Packet loss the encoder plans for when DRED is on, in percent; DRED
+     * gets no bits at 0%. Set from the loss measured on the receive side
+     * of the call (the link is taken as symmetric), or from the peer's
+     * learned profile before that. Picked up on the next encode; persists
+     * across configureEncoder(). -1 = not measured.
      */
-    bool configureEncoder(int codecType, int sampleRate, int channels,
-                          int opusApp, int opusBitrate, int opusComplexity,
-                          int codec2Mode);
+    void setExpectedLossPct(int pct) { expectedLossPct_.store(pct, std::memory_order_relaxed); }
+
+    /** Planned loss while none has been measured. */
+    static constexpr int DRED_UNMEASURED_LOSS_PCT = 10;
 
     /**
      * Read one encoded packet from the encoded ring buffer.
@@ -98,6 +156,31 @@ public:
      */
     bool readEncodedPacket(uint8_t* dest, int maxLength, int* actualLength);
 
+    /**
+     * Blocking readEncodedPacket() for a dedicated reader thread: waits up
+     * to timeoutMs for a packet and, with pacing on, for the pacer to
+     * release it. stopStream(), destroy(), configureEncoder() and
+     * destroyEncoder() interrupt the wait and return only once the
+     * reader has left.
+     *
+     * @return false on timeout, when interrupted, or once the stream has
+     *         stopped and the ring is empty
+     */
+    bool readEncodedPacketBlocking(uint8_t* dest, int maxLength, int* actualLength,
+                                   int timeoutMs);
+
+    /**
+     * Pace readEncodedPacketBlocking() to the encoder's packet rate (one
+     * per frame plus FEC parity, with PACER_RATE_HEADROOM_PCT so the
+     * queue still drains), letting up to burstPackets go back to back
+     * after idle. Smooths the catch-up burst after a reader stall, which
+     * slow interfaces would drop. 0 = off. Persists across configureEncoder().
+     */
+    void setTxPacing(int burstPackets) { txPacingBurst_.store(burstPackets, std::memory_order_relaxed); }
+
+    /** Pacer rate over the nominal packet rate, for retransmits and jitter in production. */
+    static constexpr int PACER_RATE_HEADROOM_PCT = 120;
+
     /**
      * Set capture mute state.
      *
@@ -106,9 +189,86 @@ public:
      */
     void setCaptureMute(bool mute);
 
+    /** Upper bound for setPttMode() pre-roll; the buffer is sized for this at create(). */
+    static constexpr int MAX_PREROLL_MS = 1000;
+
+    /**
+     * Enable or disable push-to-talk gating.
+     *
+     * Entering PTT mode starts key-up (idle): frames are filtered and kept
+     * in the pre-roll buffer, but not encoded or queued. Leaving PTT mode
+     * reopens the gate without emitting the pre-roll.
+     *
+     * @param enabled    True to gate transmission on setPttKeyed()
+     * @param prerollMs  Audio emitted ahead of live frames on key-down
+     *                   (rounded up to whole frames, capped at MAX_PREROLL_MS)
+     */
+    void setPttMode(bool enabled, int prerollMs);
+
+    /**
+     * Key down (true) or up (false). Only has effect in PTT mode.
+     *
+     * Key-down: pre-roll is emitted in a burst, then live frames follow.
+     * Key-up: the partial frame is zero-padded and emitted so the last
+     * syllable isn't cut, then the encoder state is reset.
+     */
+    void setPttKeyed(bool keyed);
+
+    /**
+     * Thermal headroom hint from Kotlin (PowerManager.getThermalHeadroom:
+     * 0 = cool, 1.0 = severe throttling). Caps the Opus encoder complexity
+     * the governor may use; NaN or negative means unknown (no cap).
+     */
+    void setThermalHeadroom(float headroom);
+
+    /** Opus encoder complexity currently applied by the governor (0 if none). */
+    int getEncoderComplexity() const { return encoderComplexity_.load(std::memory_order_relaxed); }
+
+    /**
+     * Encoder governor thresholds, in % of the time budget: one frame time
+     * when encoding on the worker, one burst when encoding inline in the
+     * callback. Step down above HIGH (smoothed), step up after
+     * ENCODER_STEP_UP_HOLD_MS of every encode under LOW.
+     */
+    static constexpr int ENCODER_LOAD_HIGH_PCT = 40;
+    static constexpr int ENCODER_LOAD_LOW_PCT = 15;
+    static constexpr int ENCODER_STEP_UP_HOLD_MS = 3000;
+
+    /**
+     * Queue a retransmit of a packet the peer NACKed, by header-extension
+     * sequence number. The encoding thread resends it unchanged from a
+     * small cache of recent packets on its next frame (or talk-spurt
+     * flush); a packet no longer cached is silently skipped. Callable
+     * from one thread (the signal handler).
+     *
+     * @return false if the request queue is full
+     */
+    bool requestRetransmit(uint16_t seq);
+
+    /** Packets resent on request since the encoder was configured. */
+    int getRetransmitCount() const { return retransmitCount_.load(std::memory_order_relaxed); }
+
+    /**
+     * Drop encoded packets older than maxAgeMs (since capture) at
+     * readEncodedPacket() instead of sending them: after a link stall the
+     * backlog would arrive too late to be played. 0 = send everything.
+     * Persists across configureEncoder().
+     */
+    void setTxMaxAgeMs(int maxAgeMs) { txMaxAgeMs_.store(maxAgeMs, std::memory_order_relaxed); }
+
+    /** Packets dropped as stale since the encoder was configured. */
+    int getStaleDropCount() const { return staleDropCount_.load(std::memory_order_relaxed); }
+
+    /** Recent packets kept for retransmission (power of two; ~640ms of 20ms frames). */
+    static constexpr int RETRANSMIT_CACHE_PACKETS = 32;
+    static constexpr int RETRANSMIT_QUEUE = 16;
+
     /** Destroy the native encoder, freeing codec resources. */
     void destroyEncoder();
 
+    /** Native memory by component since construction (MEM_STATS_FIELDS layout). */
+    const MemoryLedger& memory() const { return memory_; }
+
     // --- Oboe callbacks ---
 
     oboe::DataCallbackResult onAudioReady(
@@ -121,32 +281,179 @@ private:
     bool openStream();
     void closeStream();
 
+    // Refresh inputLatencyUs_ from AudioStream::getTimestamp(). Rate-limited;
+    // called from the audio callback.
+    void updateInputLatency(oboe::AudioStream* stream);
+
+    // Encode one frame into encodedRingBuffer_, dropping the oldest packet if full.
+    // mediaSample is the frame's capture position, for the header extension;
+    // captureNs its monotonic capture time, for the TX age limit.
+    void encodeFrame(const int16_t* pcm, uint8_t* outBuf, int outSize,
+                     int64_t mediaSample, int64_t captureNs);
+    void queueEncoded(const uint8_t* data, int length);
+
+    // Apply the TX age limit to the head of encodedRingBuffer_. Reader thread.
+    void dropStalePackets();
+
+    // Send parity for a partial FEC group (talk-spurt end). Encoding thread.
+    void flushFecGroup();
+
+    // Resend cached packets the peer asked for. Encoding thread.
+    void serviceRetransmits();
+
+    // Feed one encode's cost to the governor and apply any new complexity.
+    // Runs on whichever thread encodes (worker, or callback when inline).
+    void governEncoderComplexity(int64_t encodeNs);
+
+    // Loss for the DRED encoder to plan for (setExpectedLossPct()).
+    int plannedLossPct() const;
+
+    // Highest encoder complexity allowed at a thermal headroom.
+    static int thermalComplexityCeiling(float headroom);
+
+    // Encode worker job: drain the PCM ring through the encoder (worker thread only).
+    static void encodeJob(void* ctx);
+    void drainPcmToEncoder();
+    void encodeQueuedPcm();
+
+    // Callback helpers: mute/filter one accumulated frame, then either
+    // emit it (encode or queue) or keep it as pre-roll while PTT is idle.
+    void processFrame(bool gateOpen);
+    void emitFrame(const int16_t* frameData, int64_t mediaSample);
+    void emitPreroll();
+    void flushTalkSpurt();
+
+    // Pick where the next frame accumulates (callback thread only).
+    void beginAccumFrame();
+    // Move a partial frame out of its ring slot into accumBuffer_, before
+    // anything else is written to the ring.
+    void detachAccumFrame();
+    // True if completed frames go to the PCM ring (Phase 2, encode offload).
+    bool framesToRing() const {
+        return !(encodeInCallback_ && encoder_ && encodedRingBuffer_) || encodeOffload_;
+    }
+
     int sampleRate_ = 0;
     int channels_ = 0;
     int frameSamples_ = 0;
 
+    // Declared before everything it tracks, so it outlives them
+    MemoryLedger memory_;
+
     std::unique_ptr<PacketRingBuffer> ringBuffer_;
-    std::unique_ptr<VoiceFilterChain> filterChain_;
+    TrackedPtr<VoiceFilterChain> filterChain_;
     std::shared_ptr<oboe::AudioStream> stream_;
 
-    // Accumulation buffer: aligns variable-size Oboe callbacks to fixed LXST frames
-    std::unique_ptr<int16_t[]> accumBuffer_;
+    // Frame accumulation: aligns Oboe callbacks to fixed LXST frames. When
+    // frames go to the PCM ring, the frame builds up in the ring's next free
+    // slot and is published in place (commitWrite), so the callback copies
+    // each sample once. accumBuffer_ takes the frame when it is encoded in
+    // the callback, or when the ring was full at the frame's start.
+    TrackedArray<int16_t> accumBuffer_;
+    int16_t* accumTarget_ = nullptr;  // accumBuffer_ or a reserved ring slot
+    bool accumInRing_ = false;        // accumTarget_ is the ring's write slot
     int accumCount_ = 0;
 
     std::atomic<bool> isCreated_{false};
     std::atomic<bool> isRecording_{false};
 
     // Phase 3: Native codec encoder
-    std::unique_ptr<CodecWrapper> encoder_;
+    TrackedPtr<CodecWrapper> encoder_;
     std::unique_ptr<EncodedRingBuffer> encodedRingBuffer_;
-    std::unique_ptr<int16_t[]> monoToStereoBuf_;  // For SHQ stereo upmix
     std::atomic<bool> captureMuted_{false};
     bool encodeInCallback_ = false;  // True when encoder is configured
 
     // Pre-allocated encode output buffer (max Opus output ~1275 bytes)
     uint8_t encodeBuf_[1500];
     // Pre-allocated silence buffer for mute
-    std::unique_ptr<int16_t[]> silenceBuf_;
+    TrackedArray<int16_t> silenceBuf_;
+
+    // Encode offload: callback → ringBuffer_ (PCM, SPSC) → encodeWorker_
+    RtWorkerPool encodeWorker_;
+    bool encodeOffload_ = false;
+    bool encodeSubmitPending_ = false;         // Callback-thread-only: frames queued this burst
+    TrackedArray<int16_t> workerPcmBuf_;       // Worker-thread-only
+    uint8_t workerEncodeBuf_[1500];            // Worker-thread-only
+
+    // XOR FEC send side (encoding thread)
+    XorFecEncoder fecEncoder_;
+    uint8_t fecBuf_[1500];
+
+    // Header extension (encoding thread). Media position counts every
+    // captured frame, including PTT idle, so timestamps track real time.
+    bool headerExt_ = false;
+    uint16_t txSeq_ = 0;
+    uint16_t txMediaMs_ = 0;
+    int64_t txCaptureNs_ = 0;                    // Encoding thread: stamp for queueEncoded()
+    uint8_t extBuf_[1500];
+    int64_t mediaSamples_ = 0;                   // Callback-thread-only
+
+    // NACK retransmit cache, slot by sequence (encoding thread), and the
+    // request queue from JNI (SPSC, free-running indices).
+    struct CachedPacket {
+        uint16_t seq = 0;
+        int len = 0;
+        uint8_t data[1500];
+    };
+    TrackedArray<CachedPacket> retransmitCache_;  // Only with headerExt_
+    uint16_t retransmitQueue_[RETRANSMIT_QUEUE] = {};
+    std::atomic<int> retransmitHead_{0};
+    std::atomic<int> retransmitTail_{0};
+    std::atomic<int> retransmitCount_{0};
+
+    // TX age limit, applied by the encoded ring's consumer (JNI read thread)
+    std::atomic<int> txMaxAgeMs_{0};
+    std::atomic<int> staleDropCount_{0};
+
+    // TX pacing. The rate comes from configureEncoder(), the burst from
+    // setTxPacing(); the reader picks up changes on its next read.
+    std::atomic<int> txPacingBurst_{0};
+    std::atomic<int64_t> txPacketIntervalNs_{0};
+    TxPacer txPacer_;                            // Reader-thread-only
+    sem_t txReady_;                              // Posted per queued packet
+
+    // Readers inside readEncodedPacketBlocking(), and teardown calls
+    // holding them out (nested: destroy() stops the stream and the encoder).
+    std::atomic<int> blockingReaders_{0};
+    std::atomic<int> readerHalts_{0};
+
+    // Wake blocked readers and wait until none is inside; new ones return
+    // at once until the matching resumeReaders().
+    void haltReaders();
+    void resumeReaders();
+
+    // Sleep until a txReady_ post or deadlineNs (monotonic).
+    void waitTxReady(int64_t nowNs, int64_t deadlineNs);
+
+    // PTT gating. Pre-roll is a callback-only circular buffer of filtered
+    // frames, allocated at create() so setPttMode() never races a resize.
+    std::atomic<bool> pttMode_{false};
+    std::atomic<bool> pttKeyed_{false};
+    std::atomic<int> prerollFrames_{0};          // Frames to keep (<= prerollCapacity_)
+    std::atomic<bool> encoderFlushPending_{false}; // Key-up: reset encoder after queued PCM
+    TrackedArray<int16_t> prerollBuf_;
+    int prerollCapacity_ = 0;                    // Slots in prerollBuf_
+    int prerollHead_ = 0;                        // Callback-thread-only: next slot to write
+    int prerollCount_ = 0;                       // Callback-thread-only: valid slots
+    bool gateOpen_ = true;                       // Callback-thread-only: last gate state
+
+    // DRED loss planning (encoding thread); the target is set from JNI
+    int dredDurationMs_ = 0;                     // 0 = DRED off
+    int appliedLossPct_ = 0;
+    std::atomic<int> expectedLossPct_{-1};
+
+    // Encoder complexity governor (owned by the encoding thread). The
+    // thermal ceiling is set from JNI and picked up on the next encode.
+    ComplexityGovernor encoderGovernor_;
+    bool governEncoder_ = false;
+    int appliedThermalCeiling_ = 10;            // Encoding-thread-only
+    int64_t burstNs_ = 0;                       // Callback-thread-only: last burst period
+    std::atomic<int> thermalCeiling_{10};
+    std::atomic<int> encoderComplexity_{0};
+
+    // Capture delay tracking (written by callback, read by JNI getter)
+    std::atomic<int> inputLatencyUs_{0};
+    int64_t lastLatencyQueryNs_ = 0;  // Callback-thread-only
 };
 
 #endif // LXST_OBOE_CAPTURE_ENGINE_H
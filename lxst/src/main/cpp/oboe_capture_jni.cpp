@@ -4,6 +4,8 @@
 
 #include <jni.h>
 #include <android/log.h>
+#include <atomic>
+#include <ctime>
 #include "oboe_capture_engine.h"
 
 #define LOG_TAG "LXST:OboeCaptureJNI"
@@ -12,6 +14,23 @@
 // Singleton engine — one capture stream at a time (matches Telephone lifecycle)
 static OboeCaptureEngine* sCaptureEngine = nullptr;
 
+// Blocking readers from picking up sCaptureEngine until they leave it.
+// The engine is deleted only once none is left, so a reader woken by
+// destroy() never returns into freed memory.
+static std::atomic<int> sBlockingReaders{0};
+
+static void deleteEngine() {
+    OboeCaptureEngine* engine = sCaptureEngine;
+    sCaptureEngine = nullptr;
+    std::atomic_thread_fence(std::memory_order_seq_cst);  // Readers counted in from here see null
+    engine->destroy();  // Wakes readers already inside
+    while (sBlockingReaders.load() > 0) {
+        struct timespec tick = {0, 1000000};
+        nanosleep(&tick, nullptr);
+    }
+    delete engine;
+}
+
 extern "C" {
 
 JNIEXPORT jboolean JNICALL
@@ -21,18 +40,15 @@ Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeCreate(
         jint sampleRate,
         jint channels,
         jint frameSamples,
-        jint maxBufferFrames,
+        jint maxBufferMs,
         jboolean enableFilters) {
 
-    if (sCaptureEngine) {
-        sCaptureEngine->destroy();
-        delete sCaptureEngine;
-    }
+    if (sCaptureEngine) deleteEngine();
 
     sCaptureEngine = new OboeCaptureEngine();
     return static_cast<jboolean>(
         sCaptureEngine->create(sampleRate, channels, frameSamples,
-                               maxBufferFrames, enableFilters));
+                               maxBufferMs, enableFilters));
 }
 
 JNIEXPORT jboolean JNICALL
@@ -56,6 +72,27 @@ Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeReadSamples(
     return static_cast<jboolean>(ok);
 }
 
+JNIEXPORT jboolean JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeReadSamplesFloat(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jobject dest,
+        jint count,
+        jfloat gain) {
+
+    if (!sCaptureEngine) {
+        LOGE("nativeReadSamplesFloat: engine not created");
+        return JNI_FALSE;
+    }
+
+    auto* data = static_cast<float*>(env->GetDirectBufferAddress(dest));
+    if (!data || count < 0 || count > env->GetDirectBufferCapacity(dest)) {
+        LOGE("nativeReadSamplesFloat: not a direct buffer or count %d out of range", count);
+        return JNI_FALSE;
+    }
+    return static_cast<jboolean>(sCaptureEngine->readSamplesFloat(data, count, gain));
+}
+
 JNIEXPORT jboolean JNICALL
 Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeStartStream(
         JNIEnv* /*env*/,
@@ -84,11 +121,7 @@ Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeDestroy(
         JNIEnv* /*env*/,
         jobject /*thiz*/) {
 
-    if (sCaptureEngine) {
-        sCaptureEngine->destroy();
-        delete sCaptureEngine;
-        sCaptureEngine = nullptr;
-    }
+    if (sCaptureEngine) deleteEngine();
 }
 
 JNIEXPORT jint JNICALL
@@ -115,29 +148,42 @@ Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeGetXRunCount(
     return sCaptureEngine ? sCaptureEngine->getXRunCount() : 0;
 }
 
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeGetCaptureDelayMs(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    return sCaptureEngine ? sCaptureEngine->getCaptureDelayMs() : 0;
+}
+
 // --- Phase 3: Native codec JNI methods ---
 
 JNIEXPORT jboolean JNICALL
 Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeConfigureEncoder(
-        JNIEnv* /*env*/,
+        JNIEnv* env,
         jobject /*thiz*/,
-        jint codecType,
-        jint sampleRate,
-        jint channels,
-        jint opusApp,
-        jint opusBitrate,
-        jint opusComplexity,
-        jint codec2Mode) {
+        jintArray codecConfig,
+        jint fecGroupSize,
+        jboolean codec2Interleave,
+        jboolean headerExt) {
 
     if (!sCaptureEngine) {
         LOGE("nativeConfigureEncoder: engine not created");
         return JNI_FALSE;
     }
 
+    CodecConfig codec;
+    jint fields[CODEC_CFG_FIELDS];
+    int len = codecConfig ? env->GetArrayLength(codecConfig) : 0;
+    if (len > CODEC_CFG_FIELDS) len = CODEC_CFG_FIELDS;
+    if (len > 0) env->GetIntArrayRegion(codecConfig, 0, len, fields);
+    if (!readCodecConfig(fields, len, &codec)) {
+        LOGE("nativeConfigureEncoder: no codec config");
+        return JNI_FALSE;
+    }
+
     return static_cast<jboolean>(
-        sCaptureEngine->configureEncoder(codecType, sampleRate, channels,
-                                         opusApp, opusBitrate, opusComplexity,
-                                         codec2Mode));
+        sCaptureEngine->configureEncoder(codec, fecGroupSize, codec2Interleave, headerExt));
 }
 
 JNIEXPORT jint JNICALL
@@ -164,6 +210,35 @@ Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeReadEncodedPacket(
     return ok ? actualLength : 0;
 }
 
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeReadEncodedPacketBlocking(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jbyteArray dest,
+        jint timeoutMs) {
+
+    sBlockingReaders.fetch_add(1);
+    OboeCaptureEngine* engine = sCaptureEngine;
+    if (!engine) {
+        sBlockingReaders.fetch_sub(1);
+        LOGE("nativeReadEncodedPacketBlocking: engine not created");
+        return 0;
+    }
+
+    // Wait on a native buffer: the Java array isn't pinned while blocked
+    uint8_t packet[1500];
+    jint maxLen = env->GetArrayLength(dest);
+    int actualLength = 0;
+    bool ok = engine->readEncodedPacketBlocking(
+        packet, maxLen < static_cast<jint>(sizeof(packet)) ? maxLen : static_cast<jint>(sizeof(packet)),
+        &actualLength, timeoutMs);
+    sBlockingReaders.fetch_sub(1);
+    if (!ok) return 0;
+
+    env->SetByteArrayRegion(dest, 0, actualLength, reinterpret_cast<const jbyte*>(packet));
+    return actualLength;
+}
+
 JNIEXPORT void JNICALL
 Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeSetCaptureMute(
         JNIEnv* /*env*/,
@@ -175,6 +250,107 @@ Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeSetCaptureMute(
     }
 }
 
+JNIEXPORT void JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeSetPttMode(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/,
+        jboolean enabled,
+        jint prerollMs) {
+
+    if (sCaptureEngine) {
+        sCaptureEngine->setPttMode(enabled, prerollMs);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeSetPttKeyed(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/,
+        jboolean keyed) {
+
+    if (sCaptureEngine) {
+        sCaptureEngine->setPttKeyed(keyed);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeSetThermalHeadroom(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/,
+        jfloat headroom) {
+
+    if (sCaptureEngine) {
+        sCaptureEngine->setThermalHeadroom(headroom);
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeGetEncoderComplexity(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    return sCaptureEngine ? sCaptureEngine->getEncoderComplexity() : 0;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeRequestRetransmit(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/,
+        jint seq) {
+
+    if (!sCaptureEngine) return JNI_FALSE;
+    return static_cast<jboolean>(sCaptureEngine->requestRetransmit(static_cast<uint16_t>(seq)));
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeGetRetransmitCount(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    return sCaptureEngine ? sCaptureEngine->getRetransmitCount() : 0;
+}
+
+JNIEXPORT void JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeSetTxMaxAgeMs(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/,
+        jint maxAgeMs) {
+
+    if (sCaptureEngine) {
+        sCaptureEngine->setTxMaxAgeMs(maxAgeMs);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeSetTxPacing(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/,
+        jint burstPackets) {
+
+    if (sCaptureEngine) {
+        sCaptureEngine->setTxPacing(burstPackets);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeSetExpectedLossPct(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/,
+        jint pct) {
+
+    if (sCaptureEngine) {
+        sCaptureEngine->setExpectedLossPct(pct);
+    }
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeGetStaleDropCount(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    return sCaptureEngine ? sCaptureEngine->getStaleDropCount() : 0;
+}
+
 JNIEXPORT void JNICALL
 Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeDestroyEncoder(
         JNIEnv* /*env*/,
@@ -185,4 +361,18 @@ Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeDestroyEncoder(
     }
 }
 
+
+JNIEXPORT jintArray JNICALL
+Java_tech_torlando_lxst_audio_NativeCaptureEngine_nativeGetMemoryStats(
+        JNIEnv* env,
+        jobject /*thiz*/) {
+
+    jintArray result = env->NewIntArray(MEM_STATS_FIELDS);
+    if (!result || !sCaptureEngine) return result;
+    jint stats[MEM_STATS_FIELDS];
+    sCaptureEngine->memory().snapshot(stats, MEM_STATS_FIELDS);
+    env->SetIntArrayRegion(result, 0, MEM_STATS_FIELDS, stats);
+    return result;
+}
+
 } // extern "C"
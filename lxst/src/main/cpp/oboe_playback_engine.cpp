@@ -3,7 +3,10 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "oboe_playback_engine.h"
+#include "audio_clock.h"
+#include "sample_convert.h"
 #include <android/log.h>
+#include <cmath>
 #include <cstring>
 #include <unistd.h>
 
@@ -12,14 +15,21 @@
 #define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-OboePlaybackEngine::OboePlaybackEngine() = default;
+// getTimestamp() is cheap on AAudio but not free — refresh the output latency
+// estimate at most every 100ms rather than on every burst.
+static constexpr int64_t LATENCY_QUERY_INTERVAL_NS = 100000000LL;
+
+OboePlaybackEngine::OboePlaybackEngine() {
+    memory_.charge(MEM_ENGINE, sizeof(OboePlaybackEngine));
+}
 
 OboePlaybackEngine::~OboePlaybackEngine() {
     destroy();
 }
 
 bool OboePlaybackEngine::create(int sampleRate, int channels, int frameSamples,
-                                 int maxBufferFrames, int prebufferFrames) {
+                                 int prebufferMs, int maxBufferMs, int drainThresholdMs,
+                                 const PeerProfile& seed, const PlayoutPolicy& policy) {
     if (isCreated_.load()) {
         LOGW("Engine already created, destroying first");
         destroy();
@@ -28,33 +38,112 @@ bool OboePlaybackEngine::create(int sampleRate, int channels, int frameSamples,
     sampleRate_ = sampleRate;
     channels_ = channels;
     frameSamples_ = frameSamples;
-    prebufferFrames_ = prebufferFrames;
 
-    ringBuffer_ = std::make_unique<PacketRingBuffer>(maxBufferFrames, frameSamples);
-    callbackBuffer_ = std::make_unique<int16_t[]>(frameSamples);
-    dropBuffer_ = std::make_unique<int16_t[]>(frameSamples);
-    callbackBufferOffset_ = 0;
-    callbackBufferValid_ = 0;
+    // A tuned policy may replace the caller's prebuffer and drain cap.
+    policy_ = policy;
+    if (policy.prebufferMs > 0 && policy.prebufferMs != prebufferMs) {
+        prebufferMs = policy.prebufferMs;
+        drainThresholdMs = 0;  // The caller's cap was sized for its own target
+    }
+
+    // A known peer gets a prebuffer sized to its measured jitter instead
+    // of the static target; the ring is grown below if it needs more room.
+    peerSeed_ = seed;
+    plcMaxCallbacks_ = policy.plcMaxCallbacks;
+    int frameUs = frameDurationUs();
+    if (seed.valid && frameUs > 0) {
+        int marginUs = std::max(4 * seed.jitterUs, seed.jitterPeakUs);
+        int seededMs = (frameUs + marginUs + 999) / 1000;
+        seededMs = std::min(std::max(seededMs, (2 * frameUs + 999) / 1000), PEER_PREBUFFER_MAX_MS);
+        if (seed.lossPermille >= PEER_LOSSY_PERMILLE || seed.jitterPeakUs >= frameUs) {
+            plcMaxCallbacks_ = policy.plcMaxCallbacksLossy;
+        }
+        LOGI("Peer seed: jitter=%dus peak=%dus loss=%d/1000 calls=%d -> prebuf %dms (static %dms) plcMax=%d",
+             seed.jitterUs, seed.jitterPeakUs, seed.lossPermille, seed.calls,
+             seededMs, prebufferMs, plcMaxCallbacks_);
+        prebufferMs = seededMs;
+        drainThresholdMs = 0;  // The caller's cap was sized for the static target
+    }
+    prebufferMs_ = prebufferMs;
+    if (drainThresholdMs <= 0) drainThresholdMs = prebufferMs * policy.drainPct / 100;
+    PlayoutLevels levels;
+    levels.prebufferSamples = samplesForMs(prebufferMs, sampleRate, channels);
+    levels.drainThresholdSamples = samplesForMs(drainThresholdMs, sampleRate, channels);
+    levels.softDropSamples = playoutSoftDropSamples(levels.prebufferSamples,
+                                                    levels.drainThresholdSamples,
+                                                    policy.softDropPct);
+
+    // Silence segments: ~10ms each, at most 32 per frame so the mask fits
+    // a uint32 (a 400ms Codec2 frame gets 12.5ms segments).
+    int segment = samplesForMs(SILENCE_SEGMENT_MS, sampleRate, channels);
+    int minSegment = (frameSamples + 31) / 32;
+    if (segment < minSegment) segment = minSegment;
+    if (segment > frameSamples) segment = frameSamples;
+    segmentSamples_ = segment - segment % channels;
+    if (segmentSamples_ <= 0) segmentSamples_ = frameSamples;
+
+    // Size the ring by time, but always leave room above the drain threshold
+    // so writes don't start dropping before the callback gets to drain.
+    int maxSamples = samplesForMs(maxBufferMs, sampleRate, channels);
+    if (maxSamples < levels.drainThresholdSamples + frameSamples) {
+        maxSamples = levels.drainThresholdSamples + frameSamples;
+    }
+    int slots = slotsForSamples(maxSamples, frameSamples);
+
+    playout_ = std::make_unique<PlayoutBuffer>(frameSamples, slots, levels, segmentSamples_, &memory_);
 
     isCreated_.store(true);
     destroyed_.store(false, std::memory_order_release);
-    LOGI("Created: rate=%d ch=%d frameSamples=%d maxBuf=%d prebuf=%d",
-         sampleRate, channels, frameSamples, maxBufferFrames, prebufferFrames);
+    LOGI("Created: rate=%d ch=%d frameSamples=%d prebuf=%dms drainAt=%dms softDrop=%d%% "
+         "plcMax=%d bursts=%d maxBuf=%dms slots=%d",
+         sampleRate, channels, frameSamples, prebufferMs, drainThresholdMs, policy.softDropPct,
+         plcMaxCallbacks_, policy.bufferBursts, maxBufferMs, slots);
     return true;
 }
 
 bool OboePlaybackEngine::writeSamples(const int16_t* samples, int count) {
-    if (!ringBuffer_) return false;
+    if (!playout_) return false;
+
+    FrameInfo info = analyzeFrame(samples, count);
+    info.arrivalNs = monotonicNanos();
+    return playout_->write(samples, count, info);  // false: the oldest frame was dropped
+}
+
+bool OboePlaybackEngine::writeSamplesFloat(const float* samples, int count) {
+    if (!playout_ || count != frameSamples_) return false;
 
-    if (!ringBuffer_->write(samples, count)) {
-        // Buffer full — drop oldest frame and retry.
-        // Use dropBuffer_ (not callbackBuffer_ which holds partial frame state
-        // for the audio callback thread).
-        ringBuffer_->read(dropBuffer_.get(), count);
-        ringBuffer_->write(samples, count);
-        return false;  // Signal that a drop occurred
+    // Full: the oldest frame is dropped, same as writeSamples()
+    bool dropped = false;
+    int16_t* slot = playout_->writeSlot(&dropped);
+    if (!slot) return false;
+
+    floatToInt16(samples, slot, count);
+    FrameInfo info = analyzeFrame(slot, count);
+    info.arrivalNs = monotonicNanos();
+    playout_->commitWrite(info);
+    return !dropped;
+}
+
+FrameInfo OboePlaybackEngine::analyzeFrame(const int16_t* samples, int count) const {
+    FrameInfo info;
+    if (count <= 0 || segmentSamples_ <= 0) return info;
+
+    // Compare sums of squares against the threshold scaled by segment
+    // length — no sqrt or division per segment.
+    const int64_t silenceSq = static_cast<int64_t>(SILENCE_RMS) * SILENCE_RMS;
+    int64_t totalSq = 0;
+    int seg = 0;
+    for (int start = 0; start < count && seg < 32; start += segmentSamples_, seg++) {
+        int end = (start + segmentSamples_ < count) ? start + segmentSamples_ : count;
+        int64_t segSq = 0;
+        for (int i = start; i < end; i++) {
+            segSq += static_cast<int32_t>(samples[i]) * samples[i];
+        }
+        totalSq += segSq;
+        if (segSq < silenceSq * (end - start)) info.silentMask |= 1u << seg;
     }
-    return true;
+    info.rms = static_cast<int32_t>(std::sqrt(static_cast<double>(totalSq) / count));
+    return info;
 }
 
 bool OboePlaybackEngine::startStream() {
@@ -74,6 +163,13 @@ bool OboePlaybackEngine::startStream() {
 }
 
 void OboePlaybackEngine::stopStream() {
+    if (residenceHist_.count() > 0) {
+        LOGI("Playout: residence p50=%dms p95=%dms, output latency p50=%dms p95=%dms (frames=%lld)",
+             residenceHist_.percentileUs(50) / 1000, residenceHist_.percentileUs(95) / 1000,
+             outputLatencyHist_.percentileUs(50) / 1000, outputLatencyHist_.percentileUs(95) / 1000,
+             static_cast<long long>(residenceHist_.count()));
+    }
+
     std::lock_guard<std::mutex> lock(streamLock_);
     isPlaying_.store(false);
     closeStream();
@@ -90,22 +186,102 @@ void OboePlaybackEngine::destroy() {
         stream_.reset();
     }
     destroyDecoder();
-    ringBuffer_.reset();
-    callbackBuffer_.reset();
-    dropBuffer_.reset();
-    callbackBufferOffset_ = 0;
-    callbackBufferValid_ = 0;
+    playout_.reset();  // With its counters
     decodedFrameCount_.store(0, std::memory_order_relaxed);
-    callbackFrameCount_.store(0, std::memory_order_relaxed);
     callbackSilenceCount_.store(0, std::memory_order_relaxed);
     callbackPlcCount_.store(0, std::memory_order_relaxed);
-    callbackDrainCount_.store(0, std::memory_order_relaxed);
+    dredRecoveredFrames_.store(0, std::memory_order_relaxed);
+    dredRecoveries_.store(0, std::memory_order_relaxed);
+    dredCostHist_.reset();
+    concealedSamples_.store(0, std::memory_order_relaxed);
+    latePacketsSalvaged_.store(0, std::memory_order_relaxed);
+    outputLatencyUs_.store(0, std::memory_order_relaxed);
+    residenceHist_.reset();
+    outputLatencyHist_.reset();
+    lastLatencyQueryNs_ = 0;
+    tsValid_ = false;
     consecutivePlcCount_ = 0;
     LOGI("Destroyed");
 }
 
 int OboePlaybackEngine::getBufferedFrameCount() const {
-    return ringBuffer_ ? ringBuffer_->availableFrames() : 0;
+    return playout_ ? playout_->availableFrames() : 0;
+}
+
+int64_t OboePlaybackEngine::queuedUs() const {
+    if (!playout_ || sampleRate_ <= 0 || channels_ <= 0) return 0;
+    return static_cast<int64_t>(playout_->queuedSamples()) * 1000000LL
+        / (static_cast<int64_t>(sampleRate_) * channels_);
+}
+
+int OboePlaybackEngine::getBufferedMs() const {
+    return static_cast<int>(queuedUs() / 1000);
+}
+
+int OboePlaybackEngine::getPrebufferMs() const {
+    return prebufferMs_;
+}
+
+int OboePlaybackEngine::frameDurationMs() const {
+    return frameDurationUs() / 1000;
+}
+
+int OboePlaybackEngine::frameDurationUs() const {
+    if (sampleRate_ <= 0 || channels_ <= 0) return 0;
+    return static_cast<int>(static_cast<int64_t>(frameSamples_) * 1000000LL
+                            / (static_cast<int64_t>(sampleRate_) * channels_));
+}
+
+int OboePlaybackEngine::measuredLossPermille() const {
+    int extPackets = extPackets_.load(std::memory_order_relaxed);
+    if (extPackets < PEER_PROFILE_MIN_PACKETS) return -1;
+    int lost = reorder_.lostCount();
+    return static_cast<int>(lost * 1000LL / (extPackets + lost));
+}
+
+int OboePlaybackEngine::getLossPermille() const {
+    int lossPermille = measuredLossPermille();
+    return lossPermille >= 0 ? lossPermille : peerSeed_.lossPermille;
+}
+
+bool OboePlaybackEngine::exportPeerProfile(PeerProfile* out) const {
+    *out = peerSeed_;
+    if (jitterDevHist_.count() < PEER_PROFILE_MIN_PACKETS) return false;
+
+    int jitterUs = getJitterUs();
+    int peakUs = jitterDevHist_.percentileUs(95);
+    int lossPermille = measuredLossPermille();
+
+    // Running average over the last few calls, so one odd call can't
+    // swing the next one's buffer far either way.
+    if (peerSeed_.valid) {
+        int w = std::min(peerSeed_.calls, 3);
+        jitterUs = (peerSeed_.jitterUs * w + jitterUs) / (w + 1);
+        peakUs = (peerSeed_.jitterPeakUs * w + peakUs) / (w + 1);
+        if (lossPermille < 0) {
+            lossPermille = peerSeed_.lossPermille;
+        } else if (peerSeed_.lossPermille >= 0) {
+            lossPermille = (peerSeed_.lossPermille * w + lossPermille) / (w + 1);
+        }
+    }
+
+    out->valid = true;
+    out->jitterUs = jitterUs;
+    out->jitterPeakUs = peakUs;
+    out->lossPermille = lossPermille;
+    out->calls = peerSeed_.valid ? std::min(peerSeed_.calls + 1, 1000) : 1;
+    return true;
+}
+
+int OboePlaybackEngine::getSilenceDroppedMs() const {
+    if (!playout_ || sampleRate_ <= 0 || channels_ <= 0) return 0;
+    int64_t samples = playout_->silenceDroppedSamples();
+    return static_cast<int>(samples * 1000 / (static_cast<int64_t>(sampleRate_) * channels_));
+}
+
+int OboePlaybackEngine::getPlayoutDelayMs() const {
+    if (!playout_) return 0;
+    return static_cast<int>((queuedUs() + outputLatencyUs_.load(std::memory_order_relaxed)) / 1000);
 }
 
 int OboePlaybackEngine::getXRunCount() const {
@@ -152,9 +328,9 @@ bool OboePlaybackEngine::openStream() {
              stream_->getSampleRate(), sampleRate_);
     }
 
-    // Set buffer size to 2x burst for low latency while avoiding underruns
+    // Buffer a few bursts (policy, default 2) for low latency while avoiding underruns
     auto burstSize = stream_->getFramesPerBurst();
-    stream_->setBufferSizeInFrames(burstSize * 2);
+    stream_->setBufferSizeInFrames(burstSize * policy_.bufferBursts);
 
     // Set isPlaying_ BEFORE requestStart() to avoid a race condition:
     // The SCHED_FIFO callback can fire immediately after requestStart(),
@@ -193,18 +369,19 @@ bool OboePlaybackEngine::restartStream() {
 
     // Reset partial-frame state so the new stream's callback starts clean.
     // Stale offsets from the old stream could cause corrupted audio.
-    callbackBufferOffset_ = 0;
-    callbackBufferValid_ = 0;
+    if (playout_) playout_->resetPartial();
+    tsValid_ = false;
 
-    // Drain excess frames to prevent latency accumulation.
+    // Drain excess audio to prevent latency accumulation.
     // During stream restart, packets keep arriving but the callback isn't
     // consuming — each toggle adds ~200-400ms of undrained audio. Drain to
     // prebuffer level so the new stream starts near real-time.
-    if (ringBuffer_) {
-        int before = ringBuffer_->availableFrames();
-        if (before > prebufferFrames_) {
-            ringBuffer_->drain(prebufferFrames_);
-            LOGI("Drained buffer: %d -> %d frames", before, ringBuffer_->availableFrames());
+    if (playout_) {
+        int before = getBufferedMs();
+        playout_->drainTo(playout_->levels().prebufferSamples);
+        int after = getBufferedMs();
+        if (after < before) {
+            LOGI("Drained buffer: %d -> %d ms", before, after);
         }
     }
 
@@ -222,10 +399,35 @@ bool OboePlaybackEngine::restartStream() {
     return ok;
 }
 
+void OboePlaybackEngine::refreshOutputTimestamp(oboe::AudioStream* stream, int64_t nowNs) {
+    if (tsValid_ && nowNs - lastLatencyQueryNs_ < LATENCY_QUERY_INTERVAL_NS) return;
+    lastLatencyQueryNs_ = nowNs;
+
+    // The timestamp pairs a frame position with the time it was (or will be)
+    // presented. Between queries, later positions are extrapolated at the
+    // nominal rate — drift over 100ms is far below bucket resolution.
+    auto ts = stream->getTimestamp(CLOCK_MONOTONIC);
+    if (!ts) return;  // Not available yet (stream just started) or unsupported
+
+    tsPositionFrames_ = ts.value().position;
+    tsTimeNs_ = ts.value().timestamp;
+    tsValid_ = true;
+}
+
+void OboePlaybackEngine::recordServedFrame(int64_t arrivalNs, int64_t dequeueNs,
+                                           int64_t presentNs) {
+    if (arrivalNs > 0) {
+        residenceHist_.record((dequeueNs - arrivalNs) / 1000);
+    }
+    if (presentNs > 0) {
+        outputLatencyHist_.record((presentNs - dequeueNs) / 1000);
+    }
+}
+
 // --- Oboe audio callback (runs on SCHED_FIFO thread) ---
 
 oboe::DataCallbackResult OboePlaybackEngine::onAudioReady(
-        oboe::AudioStream* /*stream*/,
+        oboe::AudioStream* stream,
         void* audioData,
         int32_t numFrames) {
 
@@ -246,79 +448,59 @@ oboe::DataCallbackResult OboePlaybackEngine::onAudioReady(
             : oboe::DataCallbackResult::Stop;
     }
 
-    // Adaptive playout: skip excess frames to bound latency.
+    // Adaptive playout: skip excess audio to bound latency.
     // Packet bursts (Reticulum delivers multiple frames at once) cause the
     // buffer to grow. Without drain, the buffer level ratchets up because
     // the average arrival rate matches the consumption rate — bursts add
-    // frames but there's never a deficit to drain them back. Skip frames
-    // when the buffer exceeds 2× prebuffer to keep latency bounded.
-    if (ringBuffer_ && prebufferFrames_ > 0) {
-        int buffered = ringBuffer_->availableFrames();
-        int maxTarget = prebufferFrames_ * 2;
-        if (buffered > maxTarget) {
-            ringBuffer_->drain(prebufferFrames_);
-            callbackBufferOffset_ = 0;
-            callbackBufferValid_ = 0;
-            callbackDrainCount_.fetch_add(1, std::memory_order_relaxed);
-        }
+    // frames but there's never a deficit to drain them back.
+    //
+    // Two tiers, both in samples so a 400ms-frame profile lands on the
+    // target as precisely as a 10ms one:
+    //   - Soft: above the soft-drop depth, skip silent segments at the head
+    //     until back at prebuffer. Speech is never cut, so latency is shed
+    //     in the pauses between words.
+    //   - Hard: above the drain threshold (default 2× prebuffer), drain
+    //     regardless of content — continuous speech can't grow unbounded.
+    //
+    // The decision is playoutDrainStep(), which the playout tuner replays.
+    if (playout_) playout_->drainStep();
+
+    // Presentation time of the first sample of this burst. The stream has
+    // written getFramesWritten() frames before this callback, so our first
+    // frame lands (written - anchor position) frames after the anchor time.
+    int64_t nowNs = monotonicNanos();
+    refreshOutputTimestamp(stream, nowNs);
+    int32_t streamRate = stream->getSampleRate();
+    int64_t burstPresentNs = 0;
+    if (tsValid_ && streamRate > 0) {
+        int64_t framesAhead = stream->getFramesWritten() - tsPositionFrames_;
+        burstPresentNs = tsTimeNs_ + framesAhead * 1000000000LL / streamRate;
+        int64_t latencyNs = burstPresentNs - nowNs;
+        if (latencyNs < 0) latencyNs = 0;
+        outputLatencyUs_.store(static_cast<int>(latencyNs / 1000), std::memory_order_relaxed);
     }
-
+    // Presentation time of the sample at output offset `samples` in this burst
+    auto presentAt = [&](int32_t samples) -> int64_t {
+        if (burstPresentNs == 0) return 0;
+        return burstPresentNs + static_cast<int64_t>(samples / channels_) * 1000000000LL / streamRate;
+    };
+
+    // Fill the output buffer from LXST frames, carrying a partly served
+    // frame across callbacks when the burst is shorter than a frame.
+    int framesServed = 0;
     int32_t samplesWritten = 0;
+    if (playout_) {
+        samplesWritten = playout_->fill(output, totalSamples,
+                                        [&](const FrameInfo& info, int offset) {
+            recordServedFrame(info.arrivalNs, nowNs, presentAt(offset));
+            framesServed++;
+        });
+    }
+    if (framesServed > 0) consecutivePlcCount_ = 0;
 
-    // Fill the output buffer from LXST frames.
-    //
-    // Oboe's burst size often differs from our LXST frame size. For example,
-    // burst=192 samples (4ms) while LXST frame=960 samples (20ms). We must
-    // track a partial frame across callbacks: read one LXST frame from the
-    // ring buffer and serve it over multiple callbacks until fully consumed.
-    // This is the inverse of the capture engine's accumBuffer_ pattern.
-    while (samplesWritten < totalSamples && ringBuffer_) {
-        int remaining = totalSamples - samplesWritten;
-
-        // 1) Drain any leftover samples from a partially-consumed LXST frame.
-        if (callbackBufferValid_ > 0) {
-            int available = callbackBufferValid_ - callbackBufferOffset_;
-            int toCopy = (remaining < available) ? remaining : available;
-            std::memcpy(output + samplesWritten,
-                       callbackBuffer_.get() + callbackBufferOffset_,
-                       sizeof(int16_t) * toCopy);
-            samplesWritten += toCopy;
-            callbackBufferOffset_ += toCopy;
-
-            if (callbackBufferOffset_ >= callbackBufferValid_) {
-                // Fully consumed this LXST frame
-                callbackBufferOffset_ = 0;
-                callbackBufferValid_ = 0;
-            }
-            continue;
-        }
-
-        // 2) No partial frame — read a new LXST frame from the ring buffer.
-        if (remaining >= frameSamples_) {
-            // Output has room for a full LXST frame — read directly into output
-            if (ringBuffer_->read(output + samplesWritten, frameSamples_)) {
-                samplesWritten += frameSamples_;
-                callbackFrameCount_.fetch_add(1, std::memory_order_relaxed);
-                consecutivePlcCount_ = 0;
-            } else {
-                break;  // Ring buffer empty
-            }
-        } else {
-            // Output needs fewer samples than a full LXST frame. Read into
-            // callbackBuffer_, copy what's needed now, save the remainder
-            // for subsequent callbacks.
-            if (ringBuffer_->read(callbackBuffer_.get(), frameSamples_)) {
-                std::memcpy(output + samplesWritten, callbackBuffer_.get(),
-                           sizeof(int16_t) * remaining);
-                samplesWritten += remaining;
-                callbackBufferOffset_ = remaining;
-                callbackBufferValid_ = frameSamples_;
-                callbackFrameCount_.fetch_add(1, std::memory_order_relaxed);
-                consecutivePlcCount_ = 0;
-            } else {
-                break;  // Ring buffer empty
-            }
-        }
+    // Real audio reached the play point: concealment before it is settled
+    if (framesServed > 0 && concealedSamples_.load(std::memory_order_relaxed) != 0) {
+        concealedSamples_.store(0, std::memory_order_relaxed);
     }
 
     // Fill remaining output with PLC or silence (underrun)
@@ -326,28 +508,44 @@ oboe::DataCallbackResult OboePlaybackEngine::onAudioReady(
         bool usedPlc = false;
 
         // Try Opus PLC if decoder is available and we haven't exhausted PLC quality
-        if (decoder_ && decoder_->type() == CodecType::OPUS
-                && consecutivePlcCount_ < 5) {
+        if (decoder_ && decoder_->hasPlc() && playout_
+                && consecutivePlcCount_ < plcMaxCallbacks_) {
             // Non-blocking try-lock: if writeEncodedPacket() holds the lock,
             // fall through to silence (near-zero contention in practice since
             // empty buffer means packets aren't arriving).
             if (!decoderLock_.test_and_set(std::memory_order_acquire)) {
                 // Re-check decoder_ inside the lock — destroyDecoder() acquires
                 // the lock before resetting, so if we're here it's still valid.
-                int plcSamples = decoder_
-                    ? decoder_->decodePlc(callbackBuffer_.get(), frameSamples_ / channels_)
-                    : -1;
-                decoderLock_.clear(std::memory_order_release);
-
-                if (plcSamples > 0) {
-                    // Copy PLC samples to output, handling partial frame
-                    int remaining = totalSamples - samplesWritten;
-                    int toCopy = (remaining < plcSamples) ? remaining : plcSamples;
-                    std::memcpy(output + samplesWritten, callbackBuffer_.get(),
+                // Frames shorter than the burst (2.5/5 ms CELT) need several
+                // concealed frames to cover it; the tail of the last is dropped.
+                int64_t plcStartNs = monotonicNanos();
+                int concealed = 0;
+                int16_t* plcBuf = playout_->scratch();  // fill() came up short: no partial frame
+                while (decoder_ && samplesWritten < totalSamples) {
+                    int plcSamples = decoder_->decodePlc(plcBuf, frameSamples_ / channels_);
+                    if (plcSamples <= 0) break;
+                    int toCopy = std::min(totalSamples - samplesWritten, plcSamples);
+                    std::memcpy(output + samplesWritten, plcBuf,
                                sizeof(int16_t) * toCopy);
                     samplesWritten += toCopy;
+                    concealed += toCopy;
+                }
+
+                // Deep PLC runs in this callback, so charge it against the
+                // burst period. No packet decodes during an outage, so this
+                // is what steps the complexity down then; only a costly run
+                // is fed, and stepping back up is left to packet decodes.
+                if (governDecoder_ && decoder_ && concealed > 0 && streamRate > 0 && numFrames > 0) {
+                    int64_t burstNs = static_cast<int64_t>(numFrames) * 1000000000LL / streamRate;
+                    int pct = static_cast<int>((monotonicNanos() - plcStartNs) * 100 / burstNs);
+                    if (pct >= DECODER_LOAD_LOW_PCT) applyDecoderLoad(pct);
+                }
+                decoderLock_.clear(std::memory_order_release);
+
+                if (concealed > 0) {
                     consecutivePlcCount_++;
                     callbackPlcCount_.fetch_add(1, std::memory_order_relaxed);
+                    concealedSamples_.fetch_add(concealed, std::memory_order_relaxed);
                     usedPlc = true;
 
                     // If PLC didn't fill everything, zero the rest
@@ -360,6 +558,9 @@ oboe::DataCallbackResult OboePlaybackEngine::onAudioReady(
         }
 
         if (!usedPlc) {
+            if (consecutivePlcCount_ >= plcMaxCallbacks_) {
+                concealedSamples_.store(0, std::memory_order_relaxed);
+            }
             std::memset(output + samplesWritten, 0,
                        sizeof(int16_t) * (totalSamples - samplesWritten));
             if (samplesWritten == 0) {
@@ -375,39 +576,377 @@ oboe::DataCallbackResult OboePlaybackEngine::onAudioReady(
 
 // --- Phase 3: Native codec integration ---
 
-bool OboePlaybackEngine::configureDecoder(int codecType, int sampleRate, int channels,
-                                           int opusApp, int opusBitrate, int opusComplexity,
-                                           int codec2Mode) {
+bool OboePlaybackEngine::configureDecoder(const CodecConfig& codec, int decoderComplexity) {
     destroyDecoder();
 
-    decoder_ = std::make_unique<CodecWrapper>();
-    bool ok = false;
-
-    if (codecType == static_cast<int>(CodecType::OPUS)) {
-        ok = decoder_->createOpus(sampleRate, channels, opusApp, opusBitrate, opusComplexity);
-    } else if (codecType == static_cast<int>(CodecType::CODEC2)) {
-        ok = decoder_->createCodec2(codec2Mode);
-    }
-
-    if (!ok) {
-        LOGE("configureDecoder failed: type=%d rate=%d ch=%d", codecType, sampleRate, channels);
+    decoder_ = makeTracked<CodecWrapper>(&memory_, MEM_CODEC, &memory_);
+    if (!decoder_->create(codec)) {
+        LOGE("configureDecoder failed: type=%d rate=%d ch=%d",
+             static_cast<int>(codec.type), codec.sampleRate, codec.channels);
         decoder_.reset();
         return false;
     }
+    const int sampleRate = codec.sampleRate;
+    const int channels = codec.channels;
+    const int dredDurationMs = codec.dredDurationMs;
 
     // Pre-allocate decode output buffer.
     // Opus: max 60ms × sampleRate × channels (handles stereo)
-    // Codec2: frame times up to 400ms, but always mono — use frameSamples_
-    decodeBufSize_ = std::max((sampleRate * 60 / 1000) * channels, frameSamples_);
-    decodeBuf_ = std::make_unique<int16_t[]>(decodeBufSize_);
+    // Codec2: frame times up to 400ms, but always mono — use frameSamples_,
+    // twice over since an interleaved packet can release two frames.
+    // PCM and G.722 packets hold one frame, covered by either.
+    decodeBufSize_ = std::max((sampleRate * 60 / 1000) * channels, 2 * frameSamples_);
+    decodeBuf_ = makeTrackedArray<int16_t>(&memory_, MEM_SCRATCH, decodeBufSize_);
+
+    // DRED: rebuild up to dredDurationMs of lost audio, in whole frames.
+    // Optional — a libopus without DRED just keeps plain PLC.
+    // Frame counts are rounded up in µs so 2.5ms frames come out right.
+    int frameUs = frameDurationUs();
+    if (dredDurationMs > 0 && frameUs > 0 && decoder_->enableDredDecoder()) {
+        dredMaxFrames_ = (dredDurationMs * 1000 + frameUs - 1) / frameUs;
+        dredBuf_ = makeTrackedArray<int16_t>(&memory_, MEM_SCRATCH,
+                                             static_cast<size_t>(dredMaxFrames_) * frameSamples_);
+    }
+    lastPacketNs_ = 0;
+    fecDecoder_.reset();
+    fecLastPacketNs_ = 0;
+    fecRecoveredPackets_.store(0, std::memory_order_relaxed);
+
+    // Reorder window in whole frames: large Codec2 frames get one packet
+    // of slack, 20ms Opus frames a few.
+    // The jitter estimate starts from the peer seed, if any.
+    reorder_.configure(frameUs > 0 ? (REORDER_WINDOW_MS * 1000 + frameUs - 1) / frameUs : 1);
+    rxSeqValid_ = false;
+    rxLastPacketNs_ = 0;
+    jitterValid_ = false;
+    jitterSynthUs_ = 0;
+    jitterUs16_ = static_cast<int64_t>(peerSeed_.valid ? peerSeed_.jitterUs : 0) << 4;
+    jitterUs_.store(static_cast<int>(jitterUs16_ >> 4), std::memory_order_relaxed);
+    jitterDevHist_.reset();
+    extPackets_.store(0, std::memory_order_relaxed);
+    resetNack();
+    traceMediaValid_ = false;
+    traceOutCount_ = 0;
+
+    // Decoder complexity: only the Opus 1.5 tier boundaries matter (classic,
+    // deep PLC, LACE, NoLACE). Start at deep PLC and earn the rest.
+    governDecoder_ = false;
+    decoderComplexity_.store(0, std::memory_order_relaxed);
+    concealedSamples_.store(0, std::memory_order_relaxed);
+    if (decoder_->type() == CodecType::OPUS && decoderComplexity > 0 && frameUs > 0) {
+        static const int kTiers[] = {0, 5, 6, 7};
+        int numTiers = 1;
+        while (numTiers < 4 && kTiers[numTiers] <= decoderComplexity) numTiers++;
+        decoderGovernor_.configure(kTiers, numTiers, 1,
+                                   DECODER_LOAD_HIGH_PCT, DECODER_LOAD_LOW_PCT,
+                                   DECODER_STEP_UP_HOLD_MS * 1000 / frameUs);
+        governDecoder_ = decoder_->setDecoderComplexity(decoderGovernor_.level());
+        if (governDecoder_) {
+            decoderComplexity_.store(decoderGovernor_.level(), std::memory_order_relaxed);
+            loggedDecoderComplexity_ = decoderGovernor_.level();
+        }
+    }
+
+    // Decode on a dedicated big-core worker. Single worker keeps packets in
+    // order; if it can't start, writeEncodedPacket() decodes inline as before.
+    inboundRing_ = std::make_unique<EncodedRingBuffer>(32, sizeof(workerPacketBuf_), &memory_);
+    RtWorkerConfig workerConfig;
+    workerConfig.name = "lxst-dec";
+    if (!decodeWorker_.start(workerConfig)) {
+        LOGW("Decode worker unavailable, decoding on caller thread");
+        inboundRing_.reset();
+    }
+
+    LOGI("Decoder configured: type=%d rate=%d ch=%d bufSize=%d offload=%d dredFrames=%d decComplexity=%d",
+         static_cast<int>(codec.type), sampleRate, channels, decodeBufSize_, decodeWorker_.isRunning(),
+         dredMaxFrames_, decoderComplexity_.load(std::memory_order_relaxed));
+    return true;
+}
+
+bool OboePlaybackEngine::writeEncodedPacket(const uint8_t* data, int length, int flags) {
+    if (!decoder_ || !playout_ || !decodeBuf_) return false;
+
+    if (flags & LXST_FLAG_EXT) {
+        uint16_t seq = 0;
+        uint16_t mediaMs = 0;
+        if (!readHeaderExt(data, length, &seq, &mediaMs)) return false;
+        int64_t nowNs = monotonicNanos();
+        if (rxLastPacketNs_ > 0 && nowNs - rxLastPacketNs_ > REORDER_RESET_GAP_MS * 1000000LL) {
+            reorder_.restart();
+            rxSeqValid_ = false;  // Don't count a restarted sequence as a hole
+        }
+        rxLastPacketNs_ = nowNs;
+        updateJitter(mediaMs, nowNs, 1000000);
+        if (traceEnabled_.load(std::memory_order_relaxed)) {
+            recordArrival(data + LXST_HEADER_EXT_BYTES, length - LXST_HEADER_EXT_BYTES,
+                          flags, mediaMs, nowNs);
+        }
+        extPackets_.store(extPackets_.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
+
+        bool requested = clearNack(seq);
+        int droppedBefore = reorder_.lateCount() + reorder_.duplicateCount();
+        reorder_.setHoldLimit(nackHoldLimit(nowNs));
+        reorder_.push(seq, data + LXST_HEADER_EXT_BYTES, length - LXST_HEADER_EXT_BYTES,
+                      flags, &OboePlaybackEngine::reorderSink, this);
+        if (requested && reorder_.lateCount() + reorder_.duplicateCount() == droppedBefore) {
+            nackRecovered_.store(nackRecovered_.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_relaxed);
+        }
+        scheduleNacks(nowNs);
+        return true;
+    }
+
+    // No timestamps: assume one frame per data packet (FEC parity carries
+    // none). A gap of several frames is a pause or a loss, not jitter. The
+    // synthetic clock runs in µs so 2.5ms frames don't drift a ms at a time.
+    int frameUs = frameDurationUs();
+    bool parity = (flags & LXST_FLAG_FEC) && length > 0 && (data[0] & XOR_FEC_TAG_PARITY);
+    if (frameUs > 0 && !parity) {
+        jitterSynthUs_ += frameUs;
+        updateJitter(static_cast<uint16_t>(jitterSynthUs_ / 1000), monotonicNanos(),
+                     3LL * frameUs);
+    }
+    return routePacket(data, length, flags, UNKNOWN_MISSING);
+}
+
+void OboePlaybackEngine::setNackRttMs(int rttMs) {
+    nackRttUs_.store(rttMs > 0 ? rttMs * 1000 : 0, std::memory_order_relaxed);
+}
+
+int OboePlaybackEngine::takeNackRequests(uint16_t* out, int maxCount) {
+    int n = nackOutCount_ < maxCount ? nackOutCount_ : maxCount;
+    std::memcpy(out, nackOut_, sizeof(uint16_t) * n);
+    nackOutCount_ = 0;
+    return n;
+}
+
+void OboePlaybackEngine::scheduleNacks(int64_t nowNs) {
+    int rttUs = nackRttUs_.load(std::memory_order_relaxed);
+    if (rttUs <= 0) return;
+    uint16_t missing[PacketReorderBuffer::MAX_SLOTS];
+    int n = reorder_.missingSeqs(missing, PacketReorderBuffer::MAX_SLOTS);
+    if (n == 0) return;
+
+    // A hole plays once everything queued ahead of it has. Only ask if
+    // the retransmit can land before then.
+    int64_t queuedUsNow = queuedUs();
+    int64_t waitUs = queuedUsNow - NACK_MARGIN_MS * 1000LL;
+    if (waitUs - rttUs <= 0) return;
+    if (waitUs > 2LL * rttUs) waitUs = 2LL * rttUs;  // Overdue after that
+
+    for (int i = 0; i < n; i++) {
+        NackEntry& entry = nackTable_[missing[i] & (PacketReorderBuffer::MAX_SLOTS - 1)];
+        if (entry.active && entry.seq == missing[i]) continue;  // Already asked
+        entry.active = true;
+        entry.seq = missing[i];
+        entry.expiresNs = nowNs + waitUs * 1000;
+        if (nackOutCount_ < PacketReorderBuffer::MAX_SLOTS) nackOut_[nackOutCount_++] = missing[i];
+        nackSent_.store(nackSent_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+}
+
+int OboePlaybackEngine::nackHoldLimit(int64_t nowNs) const {
+    uint16_t head = 0;
+    if (nackRttUs_.load(std::memory_order_relaxed) <= 0 || !reorder_.headHole(&head)) {
+        return reorder_.depth();
+    }
+    const NackEntry& entry = nackTable_[head & (PacketReorderBuffer::MAX_SLOTS - 1)];
+    if (!entry.active || entry.seq != head || nowNs >= entry.expiresNs) return reorder_.depth();
+    // Stop waiting before the queue runs dry
+    if (queuedUs() <= NACK_MARGIN_MS * 1000LL) return reorder_.depth();
+    return PacketReorderBuffer::MAX_SLOTS - 1;
+}
 
-    LOGI("Decoder configured: type=%d rate=%d ch=%d bufSize=%d",
-         codecType, sampleRate, channels, decodeBufSize_);
+bool OboePlaybackEngine::clearNack(uint16_t seq) {
+    NackEntry& entry = nackTable_[seq & (PacketReorderBuffer::MAX_SLOTS - 1)];
+    if (!entry.active || entry.seq != seq) return false;
+    entry.active = false;
     return true;
 }
 
-bool OboePlaybackEngine::writeEncodedPacket(const uint8_t* data, int length) {
-    if (!decoder_ || !ringBuffer_ || !decodeBuf_) return false;
+void OboePlaybackEngine::recordArrival(const uint8_t* payload, int len, int flags,
+                                       uint16_t mediaMs, int64_t nowNs) {
+    int frameUs = frameDurationUs();
+    if (frameUs <= 0) return;
+    // Parity carries the timestamp of a data packet; it isn't a frame
+    if ((flags & LXST_FLAG_FEC) && len > 0 && (payload[0] & XOR_FEC_TAG_PARITY)) return;
+
+    if (traceMediaValid_) {
+        traceMediaMs_ += static_cast<int16_t>(mediaMs - traceLastMediaMs_);
+    } else {
+        traceMediaMs_ = mediaMs;
+        traceMediaValid_ = true;
+    }
+    traceLastMediaMs_ = mediaMs;
+
+    if (traceOutCount_ >= ARRIVAL_TRACE_MAX) return;
+    traceOut_[2 * traceOutCount_] = (traceMediaMs_ * 1000 + frameUs / 2) / frameUs;
+    traceOut_[2 * traceOutCount_ + 1] = nowNs / 1000;
+    traceOutCount_++;
+}
+
+int OboePlaybackEngine::takeArrivalTrace(int64_t* out, int maxPairs) {
+    int n = traceOutCount_ < maxPairs ? traceOutCount_ : maxPairs;
+    std::memcpy(out, traceOut_, sizeof(int64_t) * 2 * n);
+    traceOutCount_ = 0;
+    return n;
+}
+
+void OboePlaybackEngine::resetNack() {
+    for (NackEntry& entry : nackTable_) entry.active = false;
+    nackOutCount_ = 0;
+    nackSent_.store(0, std::memory_order_relaxed);
+    nackRecovered_.store(0, std::memory_order_relaxed);
+}
+
+void OboePlaybackEngine::reorderSink(void* ctx, uint16_t seq, const uint8_t* data, int len,
+                                     int flags) {
+    auto* self = static_cast<OboePlaybackEngine*>(ctx);
+    // Sequence numbers skipped since the last packet out. An upper bound
+    // on lost frames: FEC parity takes sequence numbers too.
+    int missing = self->rxSeqValid_ ? static_cast<uint16_t>(seq - self->rxLastSeq_) - 1 : 0;
+    self->rxSeqValid_ = true;
+    self->rxLastSeq_ = seq;
+    self->routePacket(data, len, flags, missing);
+}
+
+void OboePlaybackEngine::updateJitter(uint16_t mediaMs, int64_t arrivalNs,
+                                      int64_t maxDeviationUs) {
+    if (jitterValid_) {
+        // Only consecutive forward steps: parity shares its group's
+        // timestamp and reordered packets step backwards.
+        int mediaStepMs = static_cast<int16_t>(static_cast<uint16_t>(mediaMs - jitterLastMediaMs_));
+        if (mediaStepMs <= 0) return;
+        int64_t d = (arrivalNs - jitterLastArrivalNs_) / 1000 - mediaStepMs * 1000LL;
+        if (d < 0) d = -d;
+        // A talk-spurt gap or sender restart isn't jitter
+        if (d < maxDeviationUs) {
+            jitterUs16_ += d - ((jitterUs16_ + 8) >> 4);
+            jitterUs_.store(static_cast<int>(jitterUs16_ >> 4), std::memory_order_relaxed);
+            jitterDevHist_.record(d);
+        }
+    }
+    jitterValid_ = true;
+    jitterLastMediaMs_ = mediaMs;
+    jitterLastArrivalNs_ = arrivalNs;
+}
+
+bool OboePlaybackEngine::routePacket(const uint8_t* data, int length, int flags, int missing) {
+    if (!(flags & LXST_FLAG_FEC)) return submitPacket(data, length, missing);
+
+    int64_t nowNs = monotonicNanos();
+    if (fecLastPacketNs_ > 0 && nowNs - fecLastPacketNs_ > FEC_RESET_GAP_MS * 1000000LL) {
+        fecDecoder_.reset();  // Anything still held is long past its playout
+    }
+    fecLastPacketNs_ = nowNs;
+    fecMissing_ = missing;
+    return fecDecoder_.feed(data, length, &OboePlaybackEngine::fecSink, this);
+}
+
+void OboePlaybackEngine::fecSink(void* ctx, const uint8_t* payload, int len, bool recovered) {
+    auto* self = static_cast<OboePlaybackEngine*>(ctx);
+    if (recovered) {
+        int n = self->fecRecoveredPackets_.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (n <= 5 || n % 50 == 0) LOGI("FEC: rebuilt packet #%d (%d bytes)", n, len);
+    }
+    // The hole belongs ahead of the fed packet; a rebuilt one fills it
+    int missing = recovered ? 0 : self->fecMissing_;
+    if (!recovered) self->fecMissing_ = 0;
+    self->submitPacket(payload, len, missing);
+}
+
+bool OboePlaybackEngine::submitPacket(const uint8_t* data, int length, int missing) {
+    if (inboundRing_ && decodeWorker_.isRunning()) {
+        if (!inboundRing_->write(data, length, 0, missing)) {
+            // Worker is 32 packets behind. Only the worker may advance the
+            // read index, so drop this packet rather than the oldest.
+            return false;
+        }
+        // A rejected submit is harmless: any queued job drains the whole ring
+        decodeWorker_.submit(&OboePlaybackEngine::decodeJob, this);
+        return true;
+    }
+    return decodeAndWrite(data, length, missing);
+}
+
+void OboePlaybackEngine::decodeJob(void* ctx) {
+    static_cast<OboePlaybackEngine*>(ctx)->drainInbound();
+}
+
+void OboePlaybackEngine::drainInbound() {
+    int length = 0;
+    int missing = 0;
+    while (inboundRing_ && inboundRing_->read(workerPacketBuf_, sizeof(workerPacketBuf_),
+                                              &length, &missing)) {
+        decodeAndWrite(workerPacketBuf_, length, missing);
+    }
+}
+
+int OboePlaybackEngine::estimateLostFrames(int64_t gapNs, int missing) const {
+    if (dredMaxFrames_ <= 0 || !playout_ || sampleRate_ <= 0 || channels_ <= 0) return 0;
+    int64_t frameNs = static_cast<int64_t>(frameSamples_ / channels_) * 1000000000LL / sampleRate_;
+    if (frameNs <= 0) return 0;
+
+    // The sequence gap when the peer sends it: a packet that is merely
+    // late is not a hole. Otherwise whole frame intervals since the
+    // previous packet; one is on time.
+    int64_t lost = missing != UNKNOWN_MISSING ? missing : (gapNs + frameNs / 2) / frameNs - 1;
+
+    // Far beyond what DRED reaches is a talk-spurt boundary (PTT idle,
+    // sender restart), not a loss burst.
+    if (lost <= 0 || lost > 2 * dredMaxFrames_) return 0;
+
+    // A late packet looks the same as a lost one on arrival, but late
+    // packets still turn up and refill the queue. Only rebuild what the
+    // queue is actually short of, so a delay spike can't add latency.
+    int shortBy = (playout_->levels().prebufferSamples - playout_->queuedSamples()) / frameSamples_;
+    if (lost > shortBy) lost = shortBy;
+    if (lost > dredMaxFrames_) lost = dredMaxFrames_;
+    return lost > 0 ? static_cast<int>(lost) : 0;
+}
+
+void OboePlaybackEngine::governDecoderComplexity(int64_t decodeNs) {
+    int64_t frameNs = static_cast<int64_t>(frameSamples_ / channels_) * 1000000000LL / sampleRate_;
+    if (frameNs <= 0) return;
+
+    applyDecoderLoad(static_cast<int>(decodeNs * 100 / frameNs));
+
+    // Also reports steps the callback took during PLC
+    int level = decoderGovernor_.level();
+    if (level != loggedDecoderComplexity_) {
+        loggedDecoderComplexity_ = level;
+        LOGI("Decoder complexity -> %d (load %d%%, decode %lldus)",
+             level, decoderGovernor_.smoothedPct(), static_cast<long long>(decodeNs / 1000));
+    }
+}
+
+void OboePlaybackEngine::applyDecoderLoad(int loadPct) {
+    if (!decoderGovernor_.update(loadPct)) return;
+    int level = decoderGovernor_.level();
+    decoder_->setDecoderComplexity(level);
+    decoderComplexity_.store(level, std::memory_order_relaxed);
+}
+
+void OboePlaybackEngine::logDredReport() const {
+    if (dredMaxFrames_ <= 0 || sampleRate_ <= 0 || channels_ <= 0) return;
+    int frameUs = static_cast<int>(static_cast<int64_t>(frameSamples_ / channels_) * 1000000LL / sampleRate_);
+    int p50 = dredCostHist_.percentileUs(50);
+    int p95 = dredCostHist_.percentileUs(95);
+    LOGI("DRED: recoveries=%d frames=%d cost/frame p50=%dus p95=%dus (p95 %d%% of %dms frame)",
+         dredRecoveries_.load(std::memory_order_relaxed),
+         dredRecoveredFrames_.load(std::memory_order_relaxed),
+         p50, p95, frameUs > 0 ? p95 * 100 / frameUs : 0, frameUs / 1000);
+}
+
+bool OboePlaybackEngine::decodeAndWrite(const uint8_t* data, int length, int missing) {
+    if (!decoder_ || !playout_ || !decodeBuf_) return false;
+
+    int64_t nowNs = monotonicNanos();
+    bool late = takeConcealedFrame(missing);
+    int lost = (!late && dredMaxFrames_ > 0 && lastPacketNs_ > 0)
+        ? estimateLostFrames(nowNs - lastPacketNs_, missing) : 0;
+    lastPacketNs_ = nowNs;
 
     // Acquire decoder lock with bounded spin. PLC hold time is microseconds
     // so contention is near-zero. Bounded spin prevents theoretical priority
@@ -419,9 +958,40 @@ bool OboePlaybackEngine::writeEncodedPacket(const uint8_t* data, int length) {
             return false;
         }
     }
+    // DRED must run before this packet's own decode so the decoder state
+    // continues through the rebuilt frames.
+    int rebuilt = 0;
+    int64_t dredNs = 0;
+    if (lost > 0) {
+        int64_t dredStartNs = monotonicNanos();
+        rebuilt = decoder_->decodeDred(data, length, lost, frameSamples_ / channels_,
+                                       dredBuf_.get(), dredMaxFrames_ * frameSamples_);
+        dredNs = monotonicNanos() - dredStartNs;
+    }
+    int64_t decodeStartNs = monotonicNanos();
     int decodedSamples = decoder_->decode(data, length,
                                           decodeBuf_.get(), decodeBufSize_);
+    if (governDecoder_ && decodedSamples > 0) {
+        governDecoderComplexity(monotonicNanos() - decodeStartNs);
+    }
     decoderLock_.clear(std::memory_order_release);
+
+    if (late) {
+        // Its slot already played as PLC: the decode above carried the
+        // decoder state forward; queueing the PCM would only add delay.
+        int n = latePacketsSalvaged_.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (n <= 5 || n % 50 == 0) LOGI("Late packet #%d: decoder state only, PCM discarded", n);
+        return true;
+    }
+
+    if (rebuilt > 0) {
+        dredCostHist_.record(dredNs / 1000 / rebuilt);
+        dredRecoveries_.fetch_add(1, std::memory_order_relaxed);
+        dredRecoveredFrames_.fetch_add(rebuilt, std::memory_order_relaxed);
+        for (int i = 0; i < rebuilt; i++) {
+            writeSamples(dredBuf_.get() + i * frameSamples_, frameSamples_);
+        }
+    }
     if (decodedSamples <= 0) {
         static int errCount = 0;
         if (++errCount <= 5) {
@@ -432,7 +1002,7 @@ bool OboePlaybackEngine::writeEncodedPacket(const uint8_t* data, int length) {
     }
 
     // Sanity check: decoded sample count must match ring buffer frame size
-    if (decodedSamples != frameSamples_) {
+    if (decodedSamples % frameSamples_ != 0) {
         static int mismatchCount = 0;
         if (++mismatchCount <= 5) {
             LOGW("writeEncodedPacket: decoded %d samples but frameSamples=%d (mismatch #%d)",
@@ -442,24 +1012,57 @@ bool OboePlaybackEngine::writeEncodedPacket(const uint8_t* data, int length) {
 
     int count = decodedFrameCount_.fetch_add(1, std::memory_order_relaxed) + 1;
     if (count <= 5 || count % 50 == 0) {
-        int buf = ringBuffer_->availableFrames();
-        int cb = callbackFrameCount_.load(std::memory_order_relaxed);
+        int buf = playout_->availableFrames();
+        int cb = playout_->framesServed();
         int sil = callbackSilenceCount_.load(std::memory_order_relaxed);
         int plc = callbackPlcCount_.load(std::memory_order_relaxed);
-        int drn = callbackDrainCount_.load(std::memory_order_relaxed);
-        LOGI("RX#%d: decoded=%d len=%d buf=%d cbServed=%d cbSilence=%d cbPlc=%d cbDrain=%d",
-             count, decodedSamples, length, buf, cb, sil, plc, drn);
+        int drn = playout_->drainCount();
+        LOGI("RX#%d: decoded=%d len=%d buf=%d cbServed=%d cbSilence=%d cbPlc=%d cbDrain=%d silenceDropped=%dms dred=%d late=%d",
+             count, decodedSamples, length, buf, cb, sil, plc, drn, getSilenceDroppedMs(),
+             dredRecoveredFrames_.load(std::memory_order_relaxed), getLatePacketsSalvaged());
     }
 
-    // Write decoded PCM into the existing ring buffer
+    // Write decoded PCM into the existing ring buffer. Interleaved Codec2
+    // releases two frames at once after a loss; queue them one by one.
+    if (decodedSamples > frameSamples_ && decodedSamples % frameSamples_ == 0) {
+        bool ok = true;
+        for (int off = 0; off < decodedSamples; off += frameSamples_) {
+            ok &= writeSamples(decodeBuf_.get() + off, frameSamples_);
+        }
+        return ok;
+    }
     return writeSamples(decodeBuf_.get(), decodedSamples);
 }
 
+bool OboePlaybackEngine::takeConcealedFrame(int missing) {
+    int concealed = concealedSamples_.load(std::memory_order_relaxed);
+    for (;;) {
+        bool late = false;
+        int claim = playoutConcealedClaim(concealed / frameSamples_, missing, &late);
+        if (claim == 0) return false;
+        if (concealedSamples_.compare_exchange_weak(concealed, concealed - claim * frameSamples_,
+                                                    std::memory_order_relaxed)) {
+            return late;
+        }
+    }
+}
+
 void OboePlaybackEngine::setPlaybackMute(bool mute) {
     playbackMuted_.store(mute, std::memory_order_relaxed);
 }
 
 void OboePlaybackEngine::destroyDecoder() {
+    // Join the worker first so no job is mid-decode when the decoder goes away
+    decodeWorker_.stop();
+    inboundRing_.reset();
+    logDredReport();
+    if (jitterValid_) {
+        LOGI("Seq: lost=%d late=%d dup=%d reordered=%d jitter=%dus (window %d frames) nack=%d/%d",
+             reorder_.lostCount(), reorder_.lateCount(), reorder_.duplicateCount(),
+             reorder_.reorderedCount(), getJitterUs(), reorder_.depth(),
+             getNackRecovered(), getNackSent());
+    }
+
     // Acquire decoder lock so the PLC callback path (which re-checks decoder_
     // inside the lock) never sees a half-destroyed decoder.
     while (decoderLock_.test_and_set(std::memory_order_acquire)) { /* spin */ }
@@ -467,6 +1070,24 @@ void OboePlaybackEngine::destroyDecoder() {
     decoderLock_.clear(std::memory_order_release);
     decodeBuf_.reset();
     decodeBufSize_ = 0;
+    dredBuf_.reset();
+    dredMaxFrames_ = 0;
+    lastPacketNs_ = 0;
+    fecDecoder_.reset();
+    fecLastPacketNs_ = 0;
+    reorder_.reset();
+    rxSeqValid_ = false;
+    rxLastPacketNs_ = 0;
+    fecMissing_ = 0;
+    jitterValid_ = false;
+    jitterSynthUs_ = 0;
+    jitterDevHist_.reset();
+    extPackets_.store(0, std::memory_order_relaxed);
+    resetNack();
+    traceMediaValid_ = false;
+    traceOutCount_ = 0;
+    governDecoder_ = false;
+    decoderComplexity_.store(0, std::memory_order_relaxed);
 }
 
 // --- Oboe error callback (stream disconnect recovery) ---
@@ -492,10 +1113,10 @@ void OboePlaybackEngine::onErrorAfterClose(
 
     // Reset old stream and try to reopen
     stream_.reset();
-    callbackBufferOffset_ = 0;
-    callbackBufferValid_ = 0;
-    if (ringBuffer_) {
-        ringBuffer_->drain(prebufferFrames_);
+    if (playout_) {
+        playout_->resetPartial();
+        playout_->drainTo(playout_->levels().prebufferSamples);
     }
+    tsValid_ = false;
     openStream();
 }
@@ -11,6 +11,17 @@
 #include <mutex>
 #include "packet_ring_buffer.h"
 #include "codec_wrapper.h"
+#include "complexity_governor.h"
+#include "encoded_ring_buffer.h"
+#include "latency_histogram.h"
+#include "memory_ledger.h"
+#include "packet_header.h"
+#include "peer_profile.h"
+#include "playout_buffer.h"
+#include "playout_policy.h"
+#include "reorder_buffer.h"
+#include "rt_worker_pool.h"
+#include "xor_fec.h"
 
 /**
  * Oboe-based playback engine for LXST audio pipeline.
@@ -45,15 +56,59 @@ public:
      * Allocates the ring buffer but does NOT open an Oboe stream yet.
      * Call startStream() after prebuffering.
      *
-     * @param sampleRate     Output sample rate (e.g., 48000)
-     * @param channels       Number of channels (1=mono, 2=stereo)
-     * @param frameSamples   Samples per audio frame (e.g., 2880 for MQ 60ms)
-     * @param maxBufferFrames Maximum frames in ring buffer
-     * @param prebufferFrames Frames to accumulate before starting playback
+     * Buffer policy is in milliseconds so latency behaves the same for
+     * 10ms and 400ms frame profiles. Internally everything is tracked in
+     * samples, and drains land on a sample boundary rather than a frame
+     * boundary. The ring is sized from maxBufferMs, not a fixed slot count.
+     *
+     * @param sampleRate       Output sample rate (e.g., 48000)
+     * @param channels         Number of channels (1=mono, 2=stereo)
+     * @param frameSamples     Samples per audio frame (e.g., 2880 for MQ 60ms)
+     * @param prebufferMs      Audio to accumulate before playback; also the drain target
+     * @param maxBufferMs      Maximum audio held in the ring buffer
+     * @param drainThresholdMs Hard cap: depth that forces a drain back to prebufferMs
+     *                         regardless of content (<= 0 selects the policy's
+     *                         drainPct, by default 2 × prebufferMs). Above
+     *                         softDropPct of the way from prebufferMs to this
+     *                         cap, only silent audio is dropped.
+     * @param seed             Summary learned on earlier calls with this peer
+     *                         (exportPeerProfile()). When valid it replaces
+     *                         prebufferMs with one sized to the peer's jitter,
+     *                         seeds the jitter estimate and picks the PLC run
+     *                         limit. An invalid seed keeps the static policy.
+     * @param policy           Playout policy (playout_policy.h), e.g. a row of the
+     *                         tuned per-profile table. A non-zero prebufferMs in
+     *                         it replaces the caller's (a seed still wins).
      * @return true on success
      */
     bool create(int sampleRate, int channels, int frameSamples,
-                int maxBufferFrames, int prebufferFrames);
+                int prebufferMs, int maxBufferMs, int drainThresholdMs,
+                const PeerProfile& seed, const PlayoutPolicy& policy = PlayoutPolicy());
+
+    /** Prebuffer target in effect (after any peer seed), in ms. */
+    int getPrebufferMs() const;
+
+    /**
+     * Summarise this call's link for the next call with the same peer,
+     * folded into the create() seed. Call before destroyDecoder(), which
+     * clears the measurements.
+     *
+     * @return false if too few packets were measured to learn anything
+     */
+    bool exportPeerProfile(PeerProfile* out) const;
+
+    /**
+     * Seeded prebuffer: one frame plus the larger of 4 × mean jitter and
+     * the jitter peak, at least two frames and at most
+     * PEER_PREBUFFER_MAX_MS.
+     */
+    static constexpr int PEER_PREBUFFER_MAX_MS = 2000;
+
+    /** Packets with a jitter measurement needed before a call is learned from. */
+    static constexpr int PEER_PROFILE_MIN_PACKETS = 100;
+
+    /** Seeded loss at which the policy's plcMaxCallbacksLossy applies. */
+    static constexpr int PEER_LOSSY_PERMILLE = 30;
 
     /**
      * Write decoded int16 samples into the ring buffer.
@@ -61,12 +116,27 @@ public:
      * Called from Kotlin via JNI on the mixer/decode thread.
      * If the buffer is full, the oldest frame is dropped.
      *
+     * Each frame is tagged with its RMS and a per-segment silence mask
+     * so the callback can shed latency in pauses instead of mid-word.
+     *
      * @param samples  int16 PCM samples
      * @param count    Number of samples (must equal frameSamples)
      * @return true if written without drop, false if oldest was dropped
      */
     bool writeSamples(const int16_t* samples, int count);
 
+    /**
+     * Float variant of writeSamples() for the Phase 2 (Kotlin codec) path.
+     *
+     * Converts float32 [-1, 1] straight into the ring buffer slot with
+     * SIMD, so the caller needs no int16 staging array.
+     *
+     * @param samples  float32 PCM samples (e.g. a direct FloatBuffer)
+     * @param count    Number of samples (must equal frameSamples)
+     * @return true if written without drop, false if oldest was dropped
+     */
+    bool writeSamplesFloat(const float* samples, int count);
+
     /**
      * Open and start the Oboe output stream.
      *
@@ -92,6 +162,9 @@ public:
     /** Number of frames currently available in the ring buffer. */
     int getBufferedFrameCount() const;
 
+    /** Audio currently buffered (ring + unplayed part of the current frame), in ms. */
+    int getBufferedMs() const;
+
     /** True if the Oboe stream is open and playing. */
     bool isPlaying() const { return isPlaying_.load(std::memory_order_relaxed); }
 
@@ -99,7 +172,7 @@ public:
     int getXRunCount() const;
 
     /** Frames read from ring buffer by the Oboe callback. */
-    int getCallbackFrameCount() const { return callbackFrameCount_.load(std::memory_order_relaxed); }
+    int getCallbackFrameCount() const { return playout_ ? playout_->framesServed() : 0; }
 
     /** Callbacks that output full silence (ring buffer empty). */
     int getCallbackSilenceCount() const { return callbackSilenceCount_.load(std::memory_order_relaxed); }
@@ -107,6 +180,69 @@ public:
     /** Callbacks that used Opus PLC instead of silence. */
     int getCallbackPlcCount() const { return callbackPlcCount_.load(std::memory_order_relaxed); }
 
+    /** Silent audio skipped by the soft drain, in ms. */
+    int getSilenceDroppedMs() const;
+
+    /**
+     * Estimated playout delay in milliseconds for a sample written now.
+     *
+     * Sum of the audio queued in the ring buffer, the unconsumed part of the
+     * callback's partial frame, and the Oboe output pipeline latency derived
+     * from AudioStream::getTimestamp(). Feeds the Kotlin LatencyProbe's
+     * mouth-to-ear estimate.
+     */
+    int getPlayoutDelayMs() const;
+
+    /** Output pipeline latency (current burst → speaker), in microseconds. */
+    int getOutputLatencyUs() const { return outputLatencyUs_.load(std::memory_order_relaxed); }
+
+    /**
+     * Per-frame ring buffer residence time: from writeSamples() (arrival)
+     * until the callback dequeued the frame. Reflects network jitter and
+     * the prebuffer target.
+     */
+    const LatencyHistogram& residenceHistogram() const { return residenceHist_; }
+
+    /**
+     * Per-frame output pipeline latency: from callback dequeue until the
+     * frame's first sample reaches the speaker, extrapolated from the
+     * stream's getTimestamp() anchor. Reflects device/HAL latency only.
+     */
+    const LatencyHistogram& outputLatencyHistogram() const { return outputLatencyHist_; }
+
+    /**
+     * DRED decode cost per rebuilt frame (parse + synthesis, averaged over
+     * each recovery). Compare against the frame time to judge whether a
+     * profile's decoder budget can afford DRED on this device.
+     */
+    const LatencyHistogram& dredCostHistogram() const { return dredCostHist_; }
+
+    /** Frames rebuilt from DRED since create(). */
+    int getDredRecoveredFrames() const { return dredRecoveredFrames_.load(std::memory_order_relaxed); }
+
+    /**
+     * Packets that arrived after PLC had already played their slot. They
+     * are decoded only to carry the Opus state forward (so the next frame
+     * joins the concealment cleanly) and their PCM is discarded, rather
+     * than queued behind the concealment as late audio. Since create().
+     */
+    int getLatePacketsSalvaged() const { return latePacketsSalvaged_.load(std::memory_order_relaxed); }
+
+    /** Native memory by component since construction (MEM_STATS_FIELDS layout). */
+    const MemoryLedger& memory() const { return memory_; }
+
+    /** Bucket widths (µs) for the histograms above. */
+    static constexpr int RESIDENCE_BUCKET_US = 25000;
+    static constexpr int OUTPUT_LATENCY_BUCKET_US = 5000;
+    static constexpr int DRED_COST_BUCKET_US = 250;
+    static constexpr int JITTER_BUCKET_US = 10000;
+
+    /** Segment RMS below this (int16 units, ≈ -45 dBFS) counts as silence. */
+    static constexpr int SILENCE_RMS = 180;
+
+    /** Target silence-analysis segment length; frames are split into at most 32. */
+    static constexpr int SILENCE_SEGMENT_MS = 10;
+
     // --- Phase 3: Native codec integration ---
 
     /**
@@ -115,18 +251,30 @@ public:
      * When configured, writeEncodedPacket() decodes directly in native code,
      * eliminating JNI crossings and Kotlin allocations on the RX path.
      *
-     * @param codecType    1=Opus, 2=Codec2
-     * @param sampleRate   Decoder sample rate
-     * @param channels     Number of channels
-     * @param opusApp      Opus application type (ignored for Codec2)
-     * @param opusBitrate  Opus bitrate (ignored for Codec2)
-     * @param opusComplexity Opus complexity (ignored for Codec2)
-     * @param codec2Mode   Codec2 library mode (ignored for Opus)
+     * @param codec        Codec from the registry (codec_registry.h), at the
+     *                     decoder sample rate. Its dredDurationMs is the
+     *                     longest gap rebuilt from Opus DRED (0 = off;
+     *                     ignored for other codecs or a libopus without DRED)
+     * @param decoderComplexity Ceiling for the Opus decoder complexity. The
+     *                       engine starts at deep PLC (5) and moves between
+     *                       0 / 5 / 6 (LACE) / 7 (NoLACE) based on measured
+     *                       decode and PLC cost; 0 keeps classic Opus.
      * @return true on success
      */
-    bool configureDecoder(int codecType, int sampleRate, int channels,
-                          int opusApp, int opusBitrate, int opusComplexity,
-                          int codec2Mode);
+    bool configureDecoder(const CodecConfig& codec, int decoderComplexity);
+
+    /** Opus decoder complexity currently applied by the governor (0 if none). */
+    int getDecoderComplexity() const { return decoderComplexity_.load(std::memory_order_relaxed); }
+
+    /**
+     * Governor load thresholds, in % of the time budget: a packet decode is
+     * budgeted one frame time, a PLC frame generated in the callback one
+     * burst. Step down above HIGH (smoothed), step up after
+     * DECODER_STEP_UP_HOLD_MS of every measurement under LOW.
+     */
+    static constexpr int DECODER_LOAD_HIGH_PCT = 40;
+    static constexpr int DECODER_LOAD_LOW_PCT = 15;
+    static constexpr int DECODER_STEP_UP_HOLD_MS = 5000;
 
     /**
      * Write an encoded packet directly into the engine.
@@ -135,11 +283,114 @@ public:
      * samples into the existing PCM ring buffer. Called from LinkSource's
      * processing loop on Dispatchers.IO.
      *
+     * When the decode worker is running, the packet is queued into
+     * inboundRing_ and decoded on the pinned worker thread instead, so
+     * decode timing no longer depends on IO dispatcher load.
+     *
+     * Header flags (packet_header.h) add stages ahead of decode:
+     *   LXST_FLAG_EXT: the sequence number feeds the reorder window and
+     *     duplicate filter, the media timestamp the jitter estimate.
+     *   LXST_FLAG_FEC: the XOR FEC decoder (xor_fec.h) may hold the packet
+     *     until its group's parity arrives and rebuild one missing packet.
+     *
      * @param data    Encoded packet bytes (without codec header byte)
      * @param length  Encoded packet length
-     * @return true on success
+     * @param flags   LXST_FLAG_* bits from the codec header byte
+     * @return true on success (queued, decoded, or held)
+     */
+    bool writeEncodedPacket(const uint8_t* data, int length, int flags);
+
+    /**
+     * Sequence statistics from the header extension since the decoder
+     * was configured: holes given up on, packets that arrived after their
+     * slot was skipped, duplicates, and holes filled by a reordered packet.
+     */
+    int getSeqLostPackets() const { return reorder_.lostCount(); }
+    int getSeqLatePackets() const { return reorder_.lateCount(); }
+    int getSeqDuplicatePackets() const { return reorder_.duplicateCount(); }
+    int getSeqReorderedPackets() const { return reorder_.reorderedCount(); }
+
+    /**
+     * Interarrival jitter (RFC 3550 estimator) from the header extension's
+     * media timestamps, in µs. 0 until extension packets arrive.
+     */
+    int getJitterUs() const { return jitterUs_.load(std::memory_order_relaxed); }
+
+    /**
+     * Packet loss measured from the header extension's sequence numbers
+     * since the decoder was configured, per mille: holes given up on
+     * against packets received. Until PEER_PROFILE_MIN_PACKETS extension
+     * packets have arrived, the seeded peer profile's loss (-1 if none).
      */
-    bool writeEncodedPacket(const uint8_t* data, int length);
+    int getLossPermille() const;
+
+    /**
+     * How long a packet may wait for a missing earlier one, rounded up to
+     * whole frames (at least one).
+     */
+    static constexpr int REORDER_WINDOW_MS = 60;
+
+    /**
+     * Enable NACK (selective retransmission) with the current signalling
+     * round-trip time; 0 turns it off. Needs the header extension.
+     *
+     * A hole in the sequence is requested only while the audio queued
+     * ahead of it outlasts the round trip plus NACK_MARGIN_MS, and the
+     * reorder window then keeps waiting for it (past its usual depth)
+     * until the retransmit is overdue or the queue runs that low. So
+     * steady-state latency is unchanged; only a hole costs extra hold.
+     */
+    void setNackRttMs(int rttMs);
+
+    /**
+     * Take the sequence numbers to request from the sender. Call on the
+     * writeEncodedPacket() thread after each packet.
+     *
+     * @return Count written to out
+     */
+    int takeNackRequests(uint16_t* out, int maxCount);
+
+    /** NACKs issued, and requested packets that arrived in time, since the decoder was configured. */
+    int getNackSent() const { return nackSent_.load(std::memory_order_relaxed); }
+    int getNackRecovered() const { return nackRecovered_.load(std::memory_order_relaxed); }
+
+    /** Safety margin for a retransmit: decode plus one output burst. */
+    static constexpr int NACK_MARGIN_MS = 20;
+
+    /**
+     * Record packet arrivals for the playout tuner (lxst/tools/playout_tuner).
+     * While on, each data packet with the header extension queues its
+     * frame index (unwrapped media timestamp / frame time) and arrival
+     * time in µs; FEC parity is skipped. Off by default.
+     */
+    void setArrivalTrace(bool enabled) { traceEnabled_.store(enabled, std::memory_order_relaxed); }
+
+    /**
+     * Take queued arrivals as (frame index, arrival µs) pairs. Call on the
+     * writeEncodedPacket() thread after each packet; arrivals past
+     * ARRIVAL_TRACE_MAX untaken are dropped.
+     *
+     * @return Pairs written to out (2 values each)
+     */
+    int takeArrivalTrace(int64_t* out, int maxPairs);
+
+    static constexpr int ARRIVAL_TRACE_MAX = 64;
+
+    /** Packets rebuilt from XOR parity since the decoder was configured. */
+    int getFecRecoveredPackets() const { return fecRecoveredPackets_.load(std::memory_order_relaxed); }
+
+    /**
+     * Silence longer than this between FEC packets drops any half-received
+     * group, so a 3-bit group sequence can't alias across a long gap.
+     */
+    static constexpr int FEC_RESET_GAP_MS = 1000;
+
+    /**
+     * Silence longer than this between extension packets restarts the
+     * reorder window on the next sequence: held packets are past their
+     * playout, and a sender that restarted meanwhile is followed.
+     */
+    static constexpr int REORDER_RESET_GAP_MS = 1000;
 
     /**
      * Set playback mute state.
@@ -169,6 +420,89 @@ private:
     bool openStream();
     void closeStream();
 
+    // Refresh the (position, time) anchor from AudioStream::getTimestamp().
+    // Rate-limited; called from the audio callback.
+    void refreshOutputTimestamp(oboe::AudioStream* stream, int64_t nowNs);
+
+    // Record residence and output latency for one frame dequeued by the callback.
+    void recordServedFrame(int64_t arrivalNs, int64_t dequeueNs, int64_t presentNs);
+
+    // Audio queued ahead of the callback (ring + partial frame), in µs.
+    int64_t queuedUs() const;
+
+    // Compute RMS and per-segment silence mask for one frame (producer side).
+    FrameInfo analyzeFrame(const int16_t* samples, int count) const;
+
+    // Decode one packet and write the PCM into the ring buffer. missing is
+    // the number of sequence numbers skipped just before this packet
+    // (UNKNOWN_MISSING without the header extension).
+    static constexpr int UNKNOWN_MISSING = -1;
+    bool decodeAndWrite(const uint8_t* data, int length, int missing);
+
+    // Claim callback concealment for a packet (playoutConcealedClaim()).
+    // @return true if PLC already covered its slot. Decode thread only.
+    bool takeConcealedFrame(int missing);
+
+    // Hand one codec payload to the decode worker (or decode inline).
+    bool submitPacket(const uint8_t* data, int length, int missing);
+
+    // After the reorder stage: XOR FEC if flagged, then submitPacket().
+    bool routePacket(const uint8_t* data, int length, int flags, int missing);
+
+    // PacketReorderBuffer output.
+    static void reorderSink(void* ctx, uint16_t seq, const uint8_t* data, int len, int flags);
+
+    // NACK: request new holes that can still make their playout time.
+    void scheduleNacks(int64_t nowNs);
+
+    // Reorder hold limit: raised while the head hole awaits a retransmit.
+    int nackHoldLimit(int64_t nowNs) const;
+
+    // Drop the NACK for seq; true if one was outstanding.
+    bool clearNack(uint16_t seq);
+
+    void resetNack();
+
+    // Fold one media timestamp into the jitter estimate. Deviations of
+    // maxDeviationUs or more are pauses or losses, not jitter.
+    void updateJitter(uint16_t mediaMs, int64_t arrivalNs, int64_t maxDeviationUs);
+
+    // LXST frame duration in ms / µs (0 before create()). Low-delay Opus
+    // frames are 2.5ms, so anything counting frames should use µs.
+    int frameDurationMs() const;
+    int frameDurationUs() const;
+
+    // Queue one arrival for takeArrivalTrace(). payload follows the extension.
+    void recordArrival(const uint8_t* payload, int len, int flags, uint16_t mediaMs, int64_t nowNs);
+
+    // XorFecDecoder output: payloads in order, rebuilt ones flagged.
+    static void fecSink(void* ctx, const uint8_t* payload, int len, bool recovered);
+
+    // This call's loss from sequence numbers, per mille (-1 = too few packets).
+    int measuredLossPermille() const;
+
+    // Frames lost before a packet: its sequence gap if known, else
+    // inferred from arriving gapNs after the previous one. Capped so
+    // rebuilt audio can't lift the queue past the prebuffer target.
+    // Decode thread only.
+    int estimateLostFrames(int64_t gapNs, int missing) const;
+
+    // Log the DRED cost report (on decoder teardown).
+    void logDredReport() const;
+
+    // Feed one decode's cost to the governor; apply a new complexity if it
+    // moved, and log it. Decode thread only, with decoderLock_ held.
+    void governDecoderComplexity(int64_t decodeNs);
+
+    // Feed one load sample (% of budget) to the governor and apply a new
+    // complexity if it moved. Decode thread or PLC callback, with
+    // decoderLock_ held (it serialises the governor with the decoder).
+    void applyDecoderLoad(int loadPct);
+
+    // Decode worker job: drain inboundRing_ (worker thread only).
+    static void decodeJob(void* ctx);
+    void drainInbound();
+
 public:
     /**
      * Close and reopen the Oboe stream to pick up audio routing changes.
@@ -184,9 +518,17 @@ private:
     int sampleRate_ = 0;
     int channels_ = 0;
     int frameSamples_ = 0;     // Samples per LXST frame
-    int prebufferFrames_ = 0;
+    int prebufferMs_ = 0;
+    PeerProfile peerSeed_;           // From create(); folded into exports
+    PlayoutPolicy policy_;           // From create()
+    int plcMaxCallbacks_ = PlayoutPolicy().plcMaxCallbacks;
+    int segmentSamples_ = 0;         // Silence-analysis segment length
 
-    std::unique_ptr<PacketRingBuffer> ringBuffer_;
+    // Declared before everything it tracks, so it outlives them
+    MemoryLedger memory_;
+
+    // PCM ring, partial frame and the callback's drain/fill steps
+    std::unique_ptr<PlayoutBuffer> playout_;
     std::shared_ptr<oboe::AudioStream> stream_;
     std::mutex streamLock_;  // Serializes stream lifecycle (open/close/restart)
 
@@ -194,26 +536,80 @@ private:
     std::atomic<bool> isCreated_{false};
     std::atomic<bool> destroyed_{false};
 
-    // Partial frame tracking — handles burst size < LXST frame size.
-    // When the Oboe callback requests fewer samples than one LXST frame,
-    // we read a full frame into callbackBuffer_ and serve it across
-    // multiple callbacks, tracking the offset. This is the inverse of
-    // the capture engine's accumBuffer_ pattern.
-    std::unique_ptr<int16_t[]> callbackBuffer_;  // Used ONLY by callback thread
-    int callbackBufferOffset_ = 0;    // Next sample to copy from callbackBuffer_
-    int callbackBufferValid_ = 0;     // Number of valid samples in callbackBuffer_
-
-    // Separate buffer for the drop-oldest path in writeSamples() (producer thread).
-    // Must NOT share callbackBuffer_ since that holds persistent partial frame state
-    // accessed by the callback thread.
-    std::unique_ptr<int16_t[]> dropBuffer_;
-
     // Phase 3: Native codec decoder
-    std::unique_ptr<CodecWrapper> decoder_;
-    std::unique_ptr<int16_t[]> decodeBuf_;     // Pre-allocated decode output buffer
+    TrackedPtr<CodecWrapper> decoder_;
+    TrackedArray<int16_t> decodeBuf_;          // Pre-allocated decode output buffer
     int decodeBufSize_ = 0;                     // Size of decodeBuf_ in samples
+
+    // DRED burst-loss recovery. A gap is taken from the header extension's
+    // sequence numbers, or inferred from arrival time without them.
+    // Decode-thread-only except stats.
+    int dredMaxFrames_ = 0;                     // 0 = DRED off
+    int64_t lastPacketNs_ = 0;                  // Arrival of the previous packet
+    TrackedArray<int16_t> dredBuf_;             // dredMaxFrames_ rebuilt frames
+    std::atomic<int> dredRecoveredFrames_{0};
+    std::atomic<int> dredRecoveries_{0};
+    LatencyHistogram dredCostHist_{DRED_COST_BUCKET_US};
+
+    // Header extension receive side (writeEncodedPacket() caller thread).
+    // Without the extension, jitter is estimated from arrival against one
+    // frame per packet. Atomics are single-writer, read by exportPeerProfile().
+    PacketReorderBuffer reorder_;
+    bool jitterValid_ = false;
+    uint16_t jitterLastMediaMs_ = 0;
+    int64_t jitterSynthUs_ = 0;                 // Assumed media clock without the extension
+    int64_t jitterLastArrivalNs_ = 0;
+    int64_t jitterUs16_ = 0;                    // Jitter in µs, scaled by 16
+    std::atomic<int> jitterUs_{0};
+    std::atomic<int> extPackets_{0};
+    LatencyHistogram jitterDevHist_{JITTER_BUCKET_US};  // Per-packet |D|
+    bool rxSeqValid_ = false;
+    uint16_t rxLastSeq_ = 0;                    // Last sequence out of reorder_
+    int64_t rxLastPacketNs_ = 0;                // Arrival of the last extension packet
+
+    // NACK receive side (writeEncodedPacket() caller thread). Table slot
+    // by seq, like the reorder buffer; the RTT is set from another thread.
+    struct NackEntry {
+        bool active = false;
+        uint16_t seq = 0;
+        int64_t expiresNs = 0;  // Give up waiting after this
+    };
+    NackEntry nackTable_[PacketReorderBuffer::MAX_SLOTS];
+    uint16_t nackOut_[PacketReorderBuffer::MAX_SLOTS];
+    int nackOutCount_ = 0;
+    std::atomic<int> nackRttUs_{0};
+    std::atomic<int> nackSent_{0};
+    std::atomic<int> nackRecovered_{0};
+
+    // Arrival trace (writeEncodedPacket() caller thread; the switch is set
+    // from another). Media timestamps are unwrapped from 16 bits.
+    std::atomic<bool> traceEnabled_{false};
+    bool traceMediaValid_ = false;
+    uint16_t traceLastMediaMs_ = 0;
+    int64_t traceMediaMs_ = 0;
+    int64_t traceOut_[ARRIVAL_TRACE_MAX * 2];
+    int traceOutCount_ = 0;
+
+    // XOR FEC receive side. Runs on the writeEncodedPacket() caller ahead
+    // of the decode worker, so held packets never block decoding.
+    XorFecDecoder fecDecoder_;
+    int64_t fecLastPacketNs_ = 0;
+    int fecMissing_ = 0;                        // Hole ahead of the packet being fed
+    std::atomic<int> fecRecoveredPackets_{0};
+
+    // Decoder complexity governor, fed by packet decodes and by callback
+    // PLC; both run it under decoderLock_.
+    ComplexityGovernor decoderGovernor_;
+    bool governDecoder_ = false;
+    int loggedDecoderComplexity_ = 0;           // Decode thread only
+    std::atomic<int> decoderComplexity_{0};
     std::atomic<bool> playbackMuted_{false};
 
+    // Decode offload: IO thread → inboundRing_ (SPSC) → decodeWorker_
+    RtWorkerPool decodeWorker_;
+    std::unique_ptr<EncodedRingBuffer> inboundRing_;
+    uint8_t workerPacketBuf_[1500];  // Worker-thread-only
+
     // PLC (Packet Loss Concealment)
     // Non-blocking try-lock for decoder access from the SCHED_FIFO callback.
     // When the ring buffer is empty, the callback can try to generate PLC audio
@@ -223,12 +619,30 @@ private:
     std::atomic_flag decoderLock_ = ATOMIC_FLAG_INIT;
     int consecutivePlcCount_ = 0;  // Callback-thread-only, no atomics needed
 
+    // PLC output not yet matched by a packet, in samples. The callback
+    // adds what it conceals and clears it when it serves a real frame or
+    // PLC gives up to silence (a real gap or talk-spurt end: the next
+    // packet is on time again). The decode thread takes what each packet
+    // and the holes before it account for.
+    std::atomic<int> concealedSamples_{0};
+    std::atomic<int> latePacketsSalvaged_{0};
+
     // Diagnostics
     std::atomic<int> decodedFrameCount_{0};   // Frames decoded via writeEncodedPacket
-    std::atomic<int> callbackFrameCount_{0};  // Frames served to Oboe callback
     std::atomic<int> callbackSilenceCount_{0}; // Callbacks that output silence (underrun)
     std::atomic<int> callbackPlcCount_{0};     // Callbacks that used Opus PLC
-    std::atomic<int> callbackDrainCount_{0};   // Adaptive drain events in callback
+
+    // Playout delay tracking (written by callback, read by JNI getters)
+    std::atomic<int> outputLatencyUs_{0};      // Last measured output pipeline latency
+    LatencyHistogram residenceHist_{RESIDENCE_BUCKET_US};
+    LatencyHistogram outputLatencyHist_{OUTPUT_LATENCY_BUCKET_US};
+
+    // Output timestamp anchor — callback-thread-only. Invalidated whenever
+    // the stream is reopened, since frame positions restart from zero.
+    int64_t lastLatencyQueryNs_ = 0;
+    int64_t tsPositionFrames_ = 0;
+    int64_t tsTimeNs_ = 0;
+    bool tsValid_ = false;
 };
 
 #endif // LXST_OBOE_PLAYBACK_ENGINE_H
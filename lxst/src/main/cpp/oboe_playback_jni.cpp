@@ -16,23 +16,42 @@ extern "C" {
 
 JNIEXPORT jboolean JNICALL
 Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeCreate(
-        JNIEnv* /*env*/,
+        JNIEnv* env,
         jobject /*thiz*/,
         jint sampleRate,
         jint channels,
         jint frameSamples,
-        jint maxBufferFrames,
-        jint prebufferFrames) {
+        jint prebufferMs,
+        jint maxBufferMs,
+        jint drainThresholdMs,
+        jintArray peerProfile,
+        jintArray playoutPolicy) {
 
     if (sEngine) {
         sEngine->destroy();
         delete sEngine;
     }
 
+    PeerProfile seed;
+    if (peerProfile) {
+        jint fields[PEER_PROFILE_FIELDS];
+        if (env->GetArrayLength(peerProfile) >= PEER_PROFILE_FIELDS) {
+            env->GetIntArrayRegion(peerProfile, 0, PEER_PROFILE_FIELDS, fields);
+            readPeerProfile(fields, PEER_PROFILE_FIELDS, &seed);
+        }
+    }
+
+    PlayoutPolicy policy;
+    jint policyFields[PLAYOUT_POLICY_FIELDS];
+    int policyLen = playoutPolicy ? env->GetArrayLength(playoutPolicy) : 0;
+    if (policyLen > PLAYOUT_POLICY_FIELDS) policyLen = PLAYOUT_POLICY_FIELDS;
+    if (policyLen > 0) env->GetIntArrayRegion(playoutPolicy, 0, policyLen, policyFields);
+    readPlayoutPolicy(policyFields, policyLen, &policy);
+
     sEngine = new OboePlaybackEngine();
     return static_cast<jboolean>(
         sEngine->create(sampleRate, channels, frameSamples,
-                        maxBufferFrames, prebufferFrames));
+                        prebufferMs, maxBufferMs, drainThresholdMs, seed, policy));
 }
 
 JNIEXPORT jboolean JNICALL
@@ -55,6 +74,36 @@ Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeWriteSamples(
     return static_cast<jboolean>(ok);
 }
 
+JNIEXPORT jboolean JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeWriteSamplesFloat(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jobject buffer,
+        jint count) {
+
+    if (!sEngine) {
+        LOGE("nativeWriteSamplesFloat: engine not created");
+        return JNI_FALSE;
+    }
+
+    // Direct buffer: no copy and no pinning, the address is stable
+    auto* data = static_cast<const float*>(env->GetDirectBufferAddress(buffer));
+    if (!data || count < 0 || count > env->GetDirectBufferCapacity(buffer)) {
+        LOGE("nativeWriteSamplesFloat: not a direct buffer or count %d out of range", count);
+        return JNI_FALSE;
+    }
+    return static_cast<jboolean>(sEngine->writeSamplesFloat(data, count));
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetBufferedMs(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    if (!sEngine) return 0;
+    return sEngine->getBufferedMs();
+}
+
 JNIEXPORT jboolean JNICALL
 Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeStartStream(
         JNIEnv* /*env*/,
@@ -127,25 +176,27 @@ Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeRestartStream(
 
 JNIEXPORT jboolean JNICALL
 Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeConfigureDecoder(
-        JNIEnv* /*env*/,
+        JNIEnv* env,
         jobject /*thiz*/,
-        jint codecType,
-        jint sampleRate,
-        jint channels,
-        jint opusApp,
-        jint opusBitrate,
-        jint opusComplexity,
-        jint codec2Mode) {
+        jintArray codecConfig,
+        jint decoderComplexity) {
 
     if (!sEngine) {
         LOGE("nativeConfigureDecoder: engine not created");
         return JNI_FALSE;
     }
 
-    return static_cast<jboolean>(
-        sEngine->configureDecoder(codecType, sampleRate, channels,
-                                  opusApp, opusBitrate, opusComplexity,
-                                  codec2Mode));
+    CodecConfig codec;
+    jint fields[CODEC_CFG_FIELDS];
+    int len = codecConfig ? env->GetArrayLength(codecConfig) : 0;
+    if (len > CODEC_CFG_FIELDS) len = CODEC_CFG_FIELDS;
+    if (len > 0) env->GetIntArrayRegion(codecConfig, 0, len, fields);
+    if (!readCodecConfig(fields, len, &codec)) {
+        LOGE("nativeConfigureDecoder: no codec config");
+        return JNI_FALSE;
+    }
+
+    return static_cast<jboolean>(sEngine->configureDecoder(codec, decoderComplexity));
 }
 
 JNIEXPORT jboolean JNICALL
@@ -154,7 +205,8 @@ Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeWriteEncodedPacket(
         jobject /*thiz*/,
         jbyteArray data,
         jint offset,
-        jint length) {
+        jint length,
+        jint flags) {
 
     if (!sEngine) {
         LOGE("nativeWriteEncodedPacket: engine not created");
@@ -166,7 +218,7 @@ Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeWriteEncodedPacket(
     if (!bytes) return JNI_FALSE;
 
     bool ok = sEngine->writeEncodedPacket(
-        reinterpret_cast<const uint8_t*>(bytes + offset), length);
+        reinterpret_cast<const uint8_t*>(bytes + offset), length, flags);
 
     env->ReleaseByteArrayElements(data, bytes, JNI_ABORT);
     return static_cast<jboolean>(ok);
@@ -222,4 +274,216 @@ Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetCallbackPlcCount(
     return sEngine->getCallbackPlcCount();
 }
 
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetPlayoutDelayMs(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    if (!sEngine) return 0;
+    return sEngine->getPlayoutDelayMs();
+}
+
+// Copy a histogram into a new Java int[] (empty array if the engine is gone).
+static jintArray histogramToJava(JNIEnv* env, const LatencyHistogram* hist) {
+    jintArray result = env->NewIntArray(hist ? LatencyHistogram::NUM_BUCKETS : 0);
+    if (!result || !hist) return result;
+    jint counts[LatencyHistogram::NUM_BUCKETS];
+    hist->snapshot(counts, LatencyHistogram::NUM_BUCKETS);
+    env->SetIntArrayRegion(result, 0, LatencyHistogram::NUM_BUCKETS, counts);
+    return result;
+}
+
+JNIEXPORT jintArray JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetResidenceHistogram(
+        JNIEnv* env,
+        jobject /*thiz*/) {
+
+    return histogramToJava(env, sEngine ? &sEngine->residenceHistogram() : nullptr);
+}
+
+JNIEXPORT jintArray JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetOutputLatencyHistogram(
+        JNIEnv* env,
+        jobject /*thiz*/) {
+
+    return histogramToJava(env, sEngine ? &sEngine->outputLatencyHistogram() : nullptr);
+}
+
+JNIEXPORT jintArray JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetDredCostHistogram(
+        JNIEnv* env,
+        jobject /*thiz*/) {
+
+    return histogramToJava(env, sEngine ? &sEngine->dredCostHistogram() : nullptr);
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetDecoderComplexity(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    return sEngine ? sEngine->getDecoderComplexity() : 0;
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetDredRecoveredFrames(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    return sEngine ? sEngine->getDredRecoveredFrames() : 0;
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetLatePacketsSalvaged(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    return sEngine ? sEngine->getLatePacketsSalvaged() : 0;
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetFecRecoveredPackets(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    return sEngine ? sEngine->getFecRecoveredPackets() : 0;
+}
+
+JNIEXPORT jintArray JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetSequenceStats(
+        JNIEnv* env,
+        jobject /*thiz*/) {
+
+    jintArray result = env->NewIntArray(4);
+    if (!result || !sEngine) return result;
+    jint stats[4] = {
+        sEngine->getSeqLostPackets(),
+        sEngine->getSeqLatePackets(),
+        sEngine->getSeqDuplicatePackets(),
+        sEngine->getSeqReorderedPackets(),
+    };
+    env->SetIntArrayRegion(result, 0, 4, stats);
+    return result;
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetJitterUs(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    return sEngine ? sEngine->getJitterUs() : 0;
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetLossPermille(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    return sEngine ? sEngine->getLossPermille() : -1;
+}
+
+JNIEXPORT void JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeSetNackRttMs(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/,
+        jint rttMs) {
+
+    if (sEngine) sEngine->setNackRttMs(rttMs);
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeTakeNackRequests(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jintArray dest) {
+
+    if (!sEngine) return 0;
+    uint16_t seqs[PacketReorderBuffer::MAX_SLOTS];
+    int max = env->GetArrayLength(dest);
+    if (max > PacketReorderBuffer::MAX_SLOTS) max = PacketReorderBuffer::MAX_SLOTS;
+    int n = sEngine->takeNackRequests(seqs, max);
+    if (n == 0) return 0;
+    jint values[PacketReorderBuffer::MAX_SLOTS];
+    for (int i = 0; i < n; i++) values[i] = seqs[i];
+    env->SetIntArrayRegion(dest, 0, n, values);
+    return n;
+}
+
+JNIEXPORT jintArray JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetNackStats(
+        JNIEnv* env,
+        jobject /*thiz*/) {
+
+    jintArray result = env->NewIntArray(2);
+    if (!result || !sEngine) return result;
+    jint stats[2] = {sEngine->getNackSent(), sEngine->getNackRecovered()};
+    env->SetIntArrayRegion(result, 0, 2, stats);
+    return result;
+}
+
+JNIEXPORT void JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeSetArrivalTrace(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/,
+        jboolean enabled) {
+
+    if (sEngine) sEngine->setArrivalTrace(enabled);
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeTakeArrivalTrace(
+        JNIEnv* env,
+        jobject /*thiz*/,
+        jlongArray dest) {
+
+    if (!sEngine) return 0;
+    int64_t pairs[OboePlaybackEngine::ARRIVAL_TRACE_MAX * 2];
+    int max = env->GetArrayLength(dest) / 2;
+    if (max > OboePlaybackEngine::ARRIVAL_TRACE_MAX) max = OboePlaybackEngine::ARRIVAL_TRACE_MAX;
+    int n = sEngine->takeArrivalTrace(pairs, max);
+    if (n == 0) return 0;
+    jlong values[OboePlaybackEngine::ARRIVAL_TRACE_MAX * 2];
+    for (int i = 0; i < 2 * n; i++) values[i] = pairs[i];
+    env->SetLongArrayRegion(dest, 0, 2 * n, values);
+    return n;
+}
+
+JNIEXPORT jint JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetPrebufferMs(
+        JNIEnv* /*env*/,
+        jobject /*thiz*/) {
+
+    if (!sEngine) return 0;
+    return sEngine->getPrebufferMs();
+}
+
+JNIEXPORT jintArray JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeExportPeerProfile(
+        JNIEnv* env,
+        jobject /*thiz*/) {
+
+    PeerProfile profile;
+    if (!sEngine || !sEngine->exportPeerProfile(&profile)) return nullptr;
+    jint fields[PEER_PROFILE_FIELDS];
+    writePeerProfile(profile, fields, PEER_PROFILE_FIELDS);
+    jintArray result = env->NewIntArray(PEER_PROFILE_FIELDS);
+    if (!result) return nullptr;
+    env->SetIntArrayRegion(result, 0, PEER_PROFILE_FIELDS, fields);
+    return result;
+}
+
+
+JNIEXPORT jintArray JNICALL
+Java_tech_torlando_lxst_audio_NativePlaybackEngine_nativeGetMemoryStats(
+        JNIEnv* env,
+        jobject /*thiz*/) {
+
+    jintArray result = env->NewIntArray(MEM_STATS_FIELDS);
+    if (!result || !sEngine) return result;
+    jint stats[MEM_STATS_FIELDS];
+    sEngine->memory().snapshot(stats, MEM_STATS_FIELDS);
+    env->SetIntArrayRegion(result, 0, MEM_STATS_FIELDS, stats);
+    return result;
+}
+
 } // extern "C"
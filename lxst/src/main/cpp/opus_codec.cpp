@@ -0,0 +1,262 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "opus_codec.h"
+#include "include/opus/opus.h"
+#include <android/log.h>
+
+#define LOG_TAG "LXST:OpusCodec"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+OpusCodec::~OpusCodec() {
+    destroy();
+}
+
+bool OpusCodec::create(const CodecConfig& config, MemoryLedger* ledger) {
+    destroy();
+    ledger_ = ledger;
+
+    const int sampleRate = config.sampleRate;
+    const int channels = config.channels;
+    int encBytes = opus_encoder_get_size(channels);
+    int decBytes = opus_decoder_get_size(channels);
+    if (encBytes <= 0 || decBytes <= 0) {
+        LOGE("Opus create failed: bad channel count %d", channels);
+        return false;
+    }
+
+    opusEnc_ = static_cast<OpusEncoder*>(ledgerAlloc(ledger_, MEM_CODEC, encBytes));
+    if (!opusEnc_) {
+        LOGE("Opus encoder alloc failed (%d bytes)", encBytes);
+        return false;
+    }
+    opusEncBytes_ = encBytes;
+    int encErr = opus_encoder_init(opusEnc_, sampleRate, channels, config.opusApplication);
+    if (encErr != OPUS_OK) {
+        LOGE("Opus encoder create failed: %s", opus_strerror(encErr));
+        destroy();
+        return false;
+    }
+
+    opus_encoder_ctl(opusEnc_, OPUS_SET_BITRATE(config.opusBitrate));
+    opus_encoder_ctl(opusEnc_, OPUS_SET_COMPLEXITY(config.opusComplexity));
+
+    opusDec_ = static_cast<OpusDecoder*>(ledgerAlloc(ledger_, MEM_CODEC, decBytes));
+    if (!opusDec_) {
+        LOGE("Opus decoder alloc failed (%d bytes)", decBytes);
+        destroy();
+        return false;
+    }
+    opusDecBytes_ = decBytes;
+    int decErr = opus_decoder_init(opusDec_, sampleRate, channels);
+    if (decErr != OPUS_OK) {
+        LOGE("Opus decoder create failed: %s", opus_strerror(decErr));
+        destroy();
+        return false;
+    }
+
+    if (channels == 2) {
+        upmixBuf_ = makeTrackedArray<int16_t>(ledger_, MEM_CODEC, UPMIX_MAX_SAMPLES);
+    }
+
+    type_ = CodecType::OPUS;
+    channels_ = channels;
+    sampleRate_ = sampleRate;
+
+    LOGI("Opus created: rate=%d ch=%d bitrate=%d complexity=%d app=%d",
+         sampleRate, channels, config.opusBitrate, config.opusComplexity, config.opusApplication);
+    return true;
+}
+
+void OpusCodec::destroy() {
+    ledgerFree(ledger_, MEM_CODEC, opusEnc_, opusEncBytes_);
+    ledgerFree(ledger_, MEM_CODEC, opusDec_, opusDecBytes_);
+    ledgerFree(ledger_, MEM_CODEC, dredDec_, dredDecBytes_);
+    if (dred_) {
+        opus_dred_free(dred_);
+        if (ledger_) ledger_->release(MEM_CODEC, dredBytes_);
+    }
+    opusEnc_ = nullptr;
+    opusDec_ = nullptr;
+    dredDec_ = nullptr;
+    dred_ = nullptr;
+    opusEncBytes_ = opusDecBytes_ = dredDecBytes_ = dredBytes_ = 0;
+    upmixBuf_.reset();
+}
+
+int OpusCodec::decode(const uint8_t* encoded, int encodedBytes,
+                      int16_t* output, int maxOutputSamples) {
+    if (!opusDec_) return -1;
+
+    // Max samples per channel for decode
+    int maxPerChannel = maxOutputSamples / channels_;
+    int decoded = opus_decode(opusDec_,
+                              encoded, encodedBytes,
+                              output, maxPerChannel, 0);
+    if (decoded < 0) {
+        LOGW("Opus decode error: %s", opus_strerror(decoded));
+        return -1;
+    }
+    return decoded * channels_;  // Return total samples
+}
+
+int OpusCodec::decodePlc(int16_t* output, int samplesPerChannel) {
+    if (!opusDec_) return -1;
+
+    int decoded = opus_decode(opusDec_, nullptr, 0,
+                              output, samplesPerChannel, 0);
+    if (decoded < 0) {
+        LOGW("Opus PLC error: %s", opus_strerror(decoded));
+        return -1;
+    }
+    return decoded * channels_;  // Return total samples
+}
+
+int OpusCodec::encode(const int16_t* pcm, int pcmSamples,
+                      uint8_t* output, int maxOutputBytes) {
+    if (!opusEnc_) return -1;
+
+    // Handle mono→stereo upmix for stereo profiles (e.g., SHQ)
+    // Capture is always mono; if codec expects stereo, duplicate samples
+    const int16_t* encodeInput = pcm;
+    int encodeSamples = pcmSamples;
+
+    if (channels_ == 2 && upmixBuf_ && pcmSamples <= UPMIX_MAX_SAMPLES / 2) {
+        // Input is mono, upmix: [s0,s1,...] → [s0,s0,s1,s1,...]
+        int16_t* stereoBuf = upmixBuf_.get();
+        for (int i = 0; i < pcmSamples; i++) {
+            stereoBuf[2 * i] = pcm[i];
+            stereoBuf[2 * i + 1] = pcm[i];
+        }
+        encodeInput = stereoBuf;
+        encodeSamples = pcmSamples * 2;
+    }
+
+    int framesPerChannel = encodeSamples / channels_;
+    int encoded = opus_encode(opusEnc_, encodeInput, framesPerChannel,
+                              output, maxOutputBytes);
+    if (encoded < 0) {
+        LOGW("Opus encode error: %s", opus_strerror(encoded));
+        return -1;
+    }
+    return encoded;
+}
+
+void OpusCodec::resetEncoder() {
+    if (opusEnc_) opus_encoder_ctl(opusEnc_, OPUS_RESET_STATE);
+}
+
+bool OpusCodec::setEncoderComplexity(int complexity) {
+    if (!opusEnc_) return false;
+
+    int err = opus_encoder_ctl(opusEnc_, OPUS_SET_COMPLEXITY(complexity));
+    if (err != OPUS_OK) {
+        LOGW("Encoder complexity %d rejected: %s", complexity, opus_strerror(err));
+        return false;
+    }
+    return true;
+}
+
+bool OpusCodec::setDecoderComplexity(int complexity) {
+    if (!opusDec_) return false;
+
+    int err = opus_decoder_ctl(opusDec_, OPUS_SET_COMPLEXITY(complexity));
+    if (err != OPUS_OK) {
+        LOGW("Decoder complexity %d rejected: %s", complexity, opus_strerror(err));
+        return false;
+    }
+    return true;
+}
+
+bool OpusCodec::setEncoderDred(int durationMs, int expectedLossPct) {
+    if (!opusEnc_) return false;
+
+    int frames = (durationMs + 9) / 10;
+    int err = opus_encoder_ctl(opusEnc_, OPUS_SET_DRED_DURATION(frames));
+    if (err != OPUS_OK) {
+        LOGW("DRED unavailable on encoder: %s", opus_strerror(err));
+        return false;
+    }
+    opus_encoder_ctl(opusEnc_, OPUS_SET_PACKET_LOSS_PERC(expectedLossPct));
+
+    LOGI("DRED encoder enabled: %d x 10ms, expected loss %d%%", frames, expectedLossPct);
+    return true;
+}
+
+bool OpusCodec::enableDredDecoder() {
+    if (!opusDec_) return false;
+    if (dredDec_) return true;
+
+    int decBytes = opus_dred_decoder_get_size();
+    if (decBytes <= 0) {
+        LOGW("DRED unavailable on decoder: no state size");
+        return false;
+    }
+    dredDec_ = static_cast<OpusDREDDecoder*>(ledgerAlloc(ledger_, MEM_CODEC, decBytes));
+    if (!dredDec_) {
+        LOGW("DRED decoder alloc failed (%d bytes)", decBytes);
+        return false;
+    }
+    dredDecBytes_ = decBytes;
+    int err = opus_dred_decoder_init(dredDec_);
+    if (err != OPUS_OK) {
+        LOGW("DRED unavailable on decoder: %s", opus_strerror(err));
+        ledgerFree(ledger_, MEM_CODEC, dredDec_, dredDecBytes_);
+        dredDec_ = nullptr;
+        dredDecBytes_ = 0;
+        return false;
+    }
+    dred_ = opus_dred_alloc(&err);
+    if (err != OPUS_OK || !dred_) {
+        LOGW("DRED state alloc failed: %s", opus_strerror(err));
+        ledgerFree(ledger_, MEM_CODEC, dredDec_, dredDecBytes_);
+        dredDec_ = nullptr;
+        dredDecBytes_ = 0;
+        dred_ = nullptr;
+        return false;
+    }
+    dredBytes_ = opus_dred_get_size();
+    if (ledger_) ledger_->charge(MEM_CODEC, dredBytes_);
+
+    LOGI("DRED decoder enabled");
+    return true;
+}
+
+int OpusCodec::decodeDred(const uint8_t* packet, int packetBytes, int lostFrames,
+                          int samplesPerChannel, int16_t* output, int maxOutputSamples) {
+    if (!dredDec_ || !dred_ || !opusDec_ || lostFrames <= 0 || samplesPerChannel <= 0) return 0;
+
+    int fit = maxOutputSamples / (samplesPerChannel * channels_);
+    if (lostFrames > fit) lostFrames = fit;
+    if (lostFrames <= 0) return 0;
+
+    // opus_dred_parse() caps the request at what the packet carries and
+    // returns how far back (in samples) the redundancy actually reaches.
+    int dredEnd = 0;
+    int available = opus_dred_parse(dredDec_, dred_, packet, packetBytes,
+                                    lostFrames * samplesPerChannel, sampleRate_,
+                                    &dredEnd, 0);
+    if (available <= 0) return 0;
+
+    // Frame i of the gap starts (lostFrames - i) frames before the packet.
+    // Skip the oldest frames the redundancy doesn't reach.
+    int first = lostFrames - available / samplesPerChannel;
+    if (first < 0) first = 0;
+
+    int written = 0;
+    for (int i = first; i < lostFrames; i++) {
+        int offset = (lostFrames - i) * samplesPerChannel;
+        int decoded = opus_decoder_dred_decode(opusDec_, dred_, offset,
+                                               output + written * samplesPerChannel * channels_,
+                                               samplesPerChannel);
+        if (decoded < 0) {
+            LOGW("DRED decode error: %s", opus_strerror(decoded));
+            break;
+        }
+        written++;
+    }
+    return written;
+}
@@ -0,0 +1,78 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_OPUS_CODEC_H
+#define LXST_OPUS_CODEC_H
+
+#include "codec_backend.h"
+
+// Forward declarations (avoid pulling full headers into every translation unit)
+struct OpusEncoder;
+struct OpusDecoder;
+struct OpusDREDDecoder;
+struct OpusDRED;
+
+/**
+ * libopus encoder+decoder pair.
+ *
+ * Mono→stereo upmix: when the encoder has channels=2 but capture is mono,
+ * each sample is duplicated: stereo[2i]=stereo[2i+1]=mono[i].
+ *
+ * States are allocated here (opus_*_get_size + *_init) so they are
+ * charged to the owner's MemoryLedger as MEM_CODEC. The DRED state has
+ * no init call, so only its size is charged.
+ */
+class OpusCodec : public CodecBackend {
+public:
+    OpusCodec() = default;
+    ~OpusCodec();
+
+    /**
+     * Uses sampleRate (8000, 12000, 24000, 48000), channels, opusApplication,
+     * opusBitrate and opusComplexity (0-10) from config.
+     */
+    bool create(const CodecConfig& config, MemoryLedger* ledger);
+
+    int decode(const uint8_t* encoded, int encodedBytes, int16_t* output, int maxOutputSamples);
+
+    /** opus_decode(NULL, ...): extrapolates from the decoder state. */
+    int decodePlc(int16_t* output, int samplesPerChannel);
+    static constexpr bool HAS_PLC = true;
+
+    int encode(const int16_t* pcm, int pcmSamples, uint8_t* output, int maxOutputBytes);
+
+    /** OPUS_RESET_STATE: keeps bitrate/complexity settings. */
+    void resetEncoder();
+
+    bool setEncoderComplexity(int complexity);
+    bool setDecoderComplexity(int complexity);
+
+    // DRED; see CodecWrapper for the contract.
+    bool setEncoderDred(int durationMs, int expectedLossPct);
+    bool enableDredDecoder();
+    bool dredDecoderEnabled() const { return dredDec_ != nullptr; }
+    int decodeDred(const uint8_t* packet, int packetBytes, int lostFrames,
+                   int samplesPerChannel, int16_t* output, int maxOutputSamples);
+
+private:
+    MemoryLedger* ledger_ = nullptr;
+
+    OpusEncoder* opusEnc_ = nullptr;
+    OpusDecoder* opusDec_ = nullptr;
+    OpusDREDDecoder* dredDec_ = nullptr;
+    OpusDRED* dred_ = nullptr;
+    int opusEncBytes_ = 0;
+    int opusDecBytes_ = 0;
+    int dredDecBytes_ = 0;
+    int dredBytes_ = 0;
+
+    // Mono→stereo upmix input (max 60ms * 48kHz * 2ch), stereo encoders only
+    static constexpr int UPMIX_MAX_SAMPLES = 5760;
+    TrackedArray<int16_t> upmixBuf_;
+
+    // Free the Opus states and the upmix buffer.
+    void destroy();
+};
+
+#endif // LXST_OPUS_CODEC_H
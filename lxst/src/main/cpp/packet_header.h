@@ -0,0 +1,44 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_PACKET_HEADER_H
+#define LXST_PACKET_HEADER_H
+
+#include <cstdint>
+
+/**
+ * Optional LXST header flags and the header extension.
+ *
+ * The first byte of every LXST packet is the codec header (Packetizer.kt).
+ * Peers that opt in OR these flags into it (never into CODEC_NULL 0xFF):
+ *
+ *   FLAG_EXT (0x20): a 4-byte extension follows the header byte —
+ *       [uint16 BE sequence][uint16 BE media timestamp, ms]
+ *     Sequence counts every packet the sender emits (FEC parity included);
+ *     the timestamp is the capture position of the frame's first sample.
+ *   FLAG_FEC (0x40): the payload is XOR-FEC framed (xor_fec.h).
+ *
+ * Wire order: [header][extension?][FEC tag?][codec payload]. The Kotlin
+ * side writes the header byte; the capture engine writes the rest.
+ */
+constexpr int LXST_FLAG_EXT = 0x20;
+constexpr int LXST_FLAG_FEC = 0x40;
+constexpr int LXST_HEADER_EXT_BYTES = 4;
+
+inline void writeHeaderExt(uint8_t* out, uint16_t seq, uint16_t mediaMs) {
+    out[0] = static_cast<uint8_t>(seq >> 8);
+    out[1] = static_cast<uint8_t>(seq & 0xFF);
+    out[2] = static_cast<uint8_t>(mediaMs >> 8);
+    out[3] = static_cast<uint8_t>(mediaMs & 0xFF);
+}
+
+/** @return false if the packet is too short to hold the extension and a payload */
+inline bool readHeaderExt(const uint8_t* in, int len, uint16_t* seq, uint16_t* mediaMs) {
+    if (len <= LXST_HEADER_EXT_BYTES) return false;
+    *seq = static_cast<uint16_t>((in[0] << 8) | in[1]);
+    *mediaMs = static_cast<uint16_t>((in[2] << 8) | in[3]);
+    return true;
+}
+
+#endif // LXST_PACKET_HEADER_H
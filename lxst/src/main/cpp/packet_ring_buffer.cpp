@@ -4,18 +4,17 @@
 
 #include "packet_ring_buffer.h"
 
-PacketRingBuffer::PacketRingBuffer(int maxFrames, int frameSamples)
+PacketRingBuffer::PacketRingBuffer(int maxFrames, int frameSamples, MemoryLedger* ledger)
     : maxFrames_(maxFrames),
       frameSamples_(frameSamples),
-      buffer_(new int16_t[maxFrames * frameSamples]) {
-    std::memset(buffer_, 0, sizeof(int16_t) * maxFrames * frameSamples);
+      buffer_(makeTrackedArray<int16_t>(ledger, MEM_PCM_RING,
+                                        static_cast<size_t>(maxFrames) * frameSamples)),
+      info_(makeTrackedArray<FrameInfo>(ledger, MEM_PCM_RING, maxFrames)) {
 }
 
-PacketRingBuffer::~PacketRingBuffer() {
-    delete[] buffer_;
-}
+PacketRingBuffer::~PacketRingBuffer() = default;
 
-bool PacketRingBuffer::write(const int16_t* samples, int count) {
+bool PacketRingBuffer::write(const int16_t* samples, int count, const FrameInfo& info) {
     if (count != frameSamples_) return false;
 
     int w = writeIndex_.load(std::memory_order_relaxed);
@@ -27,12 +26,13 @@ bool PacketRingBuffer::write(const int16_t* samples, int count) {
         return false;
     }
 
-    std::memcpy(buffer_ + w * frameSamples_, samples, sizeof(int16_t) * frameSamples_);
+    std::memcpy(buffer_.get() + w * frameSamples_, samples, sizeof(int16_t) * frameSamples_);
+    info_[w] = info;
     writeIndex_.store(nextW, std::memory_order_release);
     return true;
 }
 
-bool PacketRingBuffer::read(int16_t* dest, int count) {
+bool PacketRingBuffer::read(int16_t* dest, int count, FrameInfo* info) {
     if (count != frameSamples_) return false;
 
     int r = readIndex_.load(std::memory_order_relaxed);
@@ -43,11 +43,46 @@ bool PacketRingBuffer::read(int16_t* dest, int count) {
         return false;
     }
 
-    std::memcpy(dest, buffer_ + r * frameSamples_, sizeof(int16_t) * frameSamples_);
+    std::memcpy(dest, buffer_.get() + r * frameSamples_, sizeof(int16_t) * frameSamples_);
+    if (info) *info = info_[r];
     readIndex_.store((r + 1) % maxFrames_, std::memory_order_release);
     return true;
 }
 
+bool PacketRingBuffer::peekInfo(FrameInfo* info) const {
+    int r = readIndex_.load(std::memory_order_relaxed);
+    int w = writeIndex_.load(std::memory_order_acquire);
+    if (r == w) return false;
+    *info = info_[r];
+    return true;
+}
+
+int16_t* PacketRingBuffer::writeSlot() {
+    int w = writeIndex_.load(std::memory_order_relaxed);
+    int r = readIndex_.load(std::memory_order_acquire);
+    if ((w + 1) % maxFrames_ == r) return nullptr;
+    return buffer_.get() + w * frameSamples_;
+}
+
+void PacketRingBuffer::commitWrite(const FrameInfo& info) {
+    int w = writeIndex_.load(std::memory_order_relaxed);
+    info_[w] = info;
+    writeIndex_.store((w + 1) % maxFrames_, std::memory_order_release);
+}
+
+const int16_t* PacketRingBuffer::readSlot(FrameInfo* info) {
+    int r = readIndex_.load(std::memory_order_relaxed);
+    int w = writeIndex_.load(std::memory_order_acquire);
+    if (r == w) return nullptr;
+    if (info) *info = info_[r];
+    return buffer_.get() + r * frameSamples_;
+}
+
+void PacketRingBuffer::releaseRead() {
+    int r = readIndex_.load(std::memory_order_relaxed);
+    readIndex_.store((r + 1) % maxFrames_, std::memory_order_release);
+}
+
 int PacketRingBuffer::availableFrames() const {
     int w = writeIndex_.load(std::memory_order_acquire);
     int r = readIndex_.load(std::memory_order_acquire);
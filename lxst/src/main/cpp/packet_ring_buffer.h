@@ -8,6 +8,7 @@
 #include <atomic>
 #include <cstdint>
 #include <cstring>
+#include "memory_ledger.h"
 
 /**
  * Lock-free Single-Producer Single-Consumer (SPSC) ring buffer for int16 audio.
@@ -19,18 +20,30 @@
  * correct visibility across threads without mutexes or spinlocks.
  *
  * The buffer stores raw int16 samples in a flat contiguous array.
- * Each "slot" holds one audio frame (variable size set at construction).
+ * Each "slot" holds one audio frame (variable size set at construction)
+ * plus a FrameInfo supplied by the producer, carried alongside so the
+ * consumer can see arrival time and content without touching samples.
  */
+
+/** Per-slot metadata, published together with the slot's samples. */
+struct FrameInfo {
+    int64_t arrivalNs = 0;    // Producer timestamp (0 if unused)
+    int64_t mediaSample = 0;  // Capture: stream position of the first sample
+    int32_t rms = -1;         // Frame RMS in int16 units (-1 if not analysed)
+    uint32_t silentMask = 0;  // Bit i set if segment i is below the silence threshold
+};
+
 class PacketRingBuffer {
 public:
     /**
      * @param maxFrames   Maximum number of frames the buffer can hold
      * @param frameSamples Number of int16 samples per frame
+     * @param ledger       Charged with the slab as MEM_PCM_RING (null = untracked)
      */
-    PacketRingBuffer(int maxFrames, int frameSamples);
+    PacketRingBuffer(int maxFrames, int frameSamples, MemoryLedger* ledger = nullptr);
     ~PacketRingBuffer();
 
-    // Non-copyable, non-movable (owns raw allocation)
+    // Non-copyable
     PacketRingBuffer(const PacketRingBuffer&) = delete;
     PacketRingBuffer& operator=(const PacketRingBuffer&) = delete;
 
@@ -39,18 +52,41 @@ public:
      *
      * @param samples  Pointer to int16 samples
      * @param count    Number of samples (must equal frameSamples)
+     * @param info     Metadata stored with the slot
      * @return true if written, false if buffer is full
      */
-    bool write(const int16_t* samples, int count);
+    bool write(const int16_t* samples, int count, const FrameInfo& info = FrameInfo());
 
     /**
      * Read one frame from the ring buffer (consumer side).
      *
      * @param dest   Destination buffer (must hold frameSamples int16s)
      * @param count  Number of samples to read (must equal frameSamples)
+     * @param info   If non-null, receives the slot's metadata
      * @return true if read, false if buffer is empty
      */
-    bool read(int16_t* dest, int count);
+    bool read(int16_t* dest, int count, FrameInfo* info = nullptr);
+
+    /**
+     * Metadata of the oldest frame without consuming it (consumer side).
+     *
+     * @return false if buffer is empty
+     */
+    bool peekInfo(FrameInfo* info) const;
+
+    /**
+     * Zero-copy producer access: the next free slot, or nullptr if full.
+     * Fill frameSamples samples, then publish with commitWrite().
+     */
+    int16_t* writeSlot();
+    void commitWrite(const FrameInfo& info = FrameInfo());
+
+    /**
+     * Zero-copy consumer access: the oldest frame, or nullptr if empty.
+     * The slot stays valid until releaseRead() hands it back to the producer.
+     */
+    const int16_t* readSlot(FrameInfo* info = nullptr);
+    void releaseRead();
 
     /** Number of frames available to read. */
     int availableFrames() const;
@@ -79,7 +115,8 @@ public:
 private:
     const int maxFrames_;
     const int frameSamples_;
-    int16_t* buffer_;  // Flat array: maxFrames * frameSamples
+    TrackedArray<int16_t> buffer_;  // Flat array: maxFrames * frameSamples
+    TrackedArray<FrameInfo> info_;  // One per slot, published with the slot's samples
 
     // Atomic indices for lock-free SPSC protocol.
     // Only the producer writes writeIndex_; only the consumer writes readIndex_.
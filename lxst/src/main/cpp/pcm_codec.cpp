@@ -0,0 +1,147 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "pcm_codec.h"
+#include <android/log.h>
+
+#define LOG_TAG "LXST:PcmCodec"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+static constexpr int ULAW_BIAS = 0x84;
+static constexpr int ULAW_CLIP = 32635;
+
+// Index of the highest set bit of v (v > 0)
+static inline int topBit(int v) {
+    int bit = 0;
+    while (v >>= 1) bit++;
+    return bit;
+}
+
+bool PcmCodec::create(const CodecConfig& config, MemoryLedger* /*ledger*/) {
+    if (config.type != CodecType::PCM16 && config.type != CodecType::PCMU &&
+        config.type != CodecType::PCMA) {
+        LOGE("PCM create failed: type %d", static_cast<int>(config.type));
+        return false;
+    }
+    if (config.channels != 1 || config.sampleRate <= 0) {
+        LOGE("PCM create failed: rate=%d ch=%d (mono only)", config.sampleRate, config.channels);
+        return false;
+    }
+
+    type_ = config.type;
+    channels_ = 1;
+    sampleRate_ = config.sampleRate;
+
+    LOGI("PCM created: type=%d rate=%d bytesPerSample=%d",
+         static_cast<int>(type_), sampleRate_, bytesPerSample());
+    return true;
+}
+
+int PcmCodec::decode(const uint8_t* encoded, int encodedBytes,
+                     int16_t* output, int maxOutputSamples) {
+    int samples = encodedBytes / bytesPerSample();
+    if (samples > maxOutputSamples) {
+        LOGW("PCM decode: output buffer too small (%d > %d)", samples, maxOutputSamples);
+        return -1;
+    }
+
+    switch (type_) {
+        case CodecType::PCM16:
+            for (int i = 0; i < samples; i++) {
+                output[i] = static_cast<int16_t>(encoded[2 * i] | (encoded[2 * i + 1] << 8));
+            }
+            break;
+        case CodecType::PCMU:
+            for (int i = 0; i < samples; i++) output[i] = ulawToLinear(encoded[i]);
+            break;
+        case CodecType::PCMA:
+            for (int i = 0; i < samples; i++) output[i] = alawToLinear(encoded[i]);
+            break;
+        default:
+            return -1;
+    }
+    return samples;
+}
+
+int PcmCodec::encode(const int16_t* pcm, int pcmSamples,
+                     uint8_t* output, int maxOutputBytes) {
+    int encodedSize = pcmSamples * bytesPerSample();
+    if (encodedSize > maxOutputBytes) {
+        LOGW("PCM encode: output buffer too small (%d > %d)", encodedSize, maxOutputBytes);
+        return -1;
+    }
+
+    switch (type_) {
+        case CodecType::PCM16:
+            for (int i = 0; i < pcmSamples; i++) {
+                auto v = static_cast<uint16_t>(pcm[i]);
+                output[2 * i] = static_cast<uint8_t>(v);
+                output[2 * i + 1] = static_cast<uint8_t>(v >> 8);
+            }
+            break;
+        case CodecType::PCMU:
+            for (int i = 0; i < pcmSamples; i++) output[i] = linearToUlaw(pcm[i]);
+            break;
+        case CodecType::PCMA:
+            for (int i = 0; i < pcmSamples; i++) output[i] = linearToAlaw(pcm[i]);
+            break;
+        default:
+            return -1;
+    }
+    return encodedSize;
+}
+
+// --- G.711 companding (ITU-T G.711, 16-bit linear in/out) ---
+// Segment (exponent) = position of the top bit above the 4-bit mantissa.
+
+uint8_t PcmCodec::linearToUlaw(int16_t sample) {
+    int v = sample;
+    int sign = 0;
+    if (v < 0) {
+        v = -v;
+        sign = 0x80;
+    }
+    if (v > ULAW_CLIP) v = ULAW_CLIP;
+    v += ULAW_BIAS;
+
+    int exponent = topBit(v) - 7;           // Bias puts the top bit at 7..14
+    int mantissa = (v >> (exponent + 3)) & 0x0F;
+    return static_cast<uint8_t>(~(sign | (exponent << 4) | mantissa));
+}
+
+int16_t PcmCodec::ulawToLinear(uint8_t code) {
+    int u = ~code & 0xFF;
+    int exponent = (u >> 4) & 0x07;
+    int mantissa = u & 0x0F;
+    int v = (((mantissa << 3) + ULAW_BIAS) << exponent) - ULAW_BIAS;
+    return static_cast<int16_t>((u & 0x80) ? -v : v);
+}
+
+uint8_t PcmCodec::linearToAlaw(int16_t sample) {
+    int v = sample;
+    int sign = 0x80;                        // A-law sets the bit for positive
+    if (v < 0) {
+        v = -v - 1;                         // One's complement: -32768 fits
+        sign = 0x00;
+    }
+
+    int code;
+    if (v < 256) {
+        code = v >> 4;
+    } else {
+        int exponent = topBit(v) - 7;       // 1..7
+        code = (exponent << 4) | ((v >> (exponent + 3)) & 0x0F);
+    }
+    return static_cast<uint8_t>((sign | code) ^ 0x55);
+}
+
+int16_t PcmCodec::alawToLinear(uint8_t code) {
+    int a = code ^ 0x55;
+    int exponent = (a >> 4) & 0x07;
+    int v = ((a & 0x0F) << 4) + 8;          // Mid-point of the step
+    if (exponent > 0) v = (v + 0x100) << (exponent - 1);
+    return static_cast<int16_t>((a & 0x80) ? v : -v);
+}
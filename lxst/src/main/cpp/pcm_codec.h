@@ -0,0 +1,39 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_PCM_CODEC_H
+#define LXST_PCM_CODEC_H
+
+#include "codec_backend.h"
+
+/**
+ * Uncompressed and G.711 companded PCM, for links where bandwidth is
+ * free and only CPU and latency count (wired LAN).
+ *
+ * - PCM16: int16 little-endian, 2 bytes/sample (same layout as the
+ *   Kotlin Null codec)
+ * - PCMU / PCMA: G.711 µ-law / A-law, 1 byte/sample
+ *
+ * Stateless and sample-by-sample, so there is no lookahead and any frame
+ * size and sample rate works (G.711 is specified at 8kHz, but the
+ * companding doesn't care). Mono only: capture is mono.
+ */
+class PcmCodec : public CodecBackend {
+public:
+    /** Uses type (PCM16, PCMU or PCMA) and sampleRate from config. */
+    bool create(const CodecConfig& config, MemoryLedger* ledger);
+
+    int decode(const uint8_t* encoded, int encodedBytes, int16_t* output, int maxOutputSamples);
+    int encode(const int16_t* pcm, int pcmSamples, uint8_t* output, int maxOutputBytes);
+
+    static uint8_t linearToUlaw(int16_t sample);
+    static int16_t ulawToLinear(uint8_t code);
+    static uint8_t linearToAlaw(int16_t sample);
+    static int16_t alawToLinear(uint8_t code);
+
+private:
+    int bytesPerSample() const { return type_ == CodecType::PCM16 ? 2 : 1; }
+};
+
+#endif // LXST_PCM_CODEC_H
@@ -0,0 +1,61 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_PEER_PROFILE_H
+#define LXST_PEER_PROFILE_H
+
+#include <cstdint>
+
+/**
+ * Learned link summary for one remote peer.
+ *
+ * The playback engine exports it at call end and takes it back as a seed
+ * on the next create() for the same peer, so the prebuffer and PLC policy
+ * fit the link from the first packet instead of converging over seconds.
+ * Only network measures are kept; the buffer policy is derived from them
+ * per call, so a summary learned on one profile applies to any other.
+ *
+ * Flat int array (Kotlin stores it as IntArray keyed by peer hash):
+ *   [0] PEER_PROFILE_VERSION
+ *   [1] jitter, µs (RFC 3550 mean deviation)
+ *   [2] jitter peak, µs (95th percentile of the per-packet deviation)
+ *   [3] loss, per mille (-1 = not measured: no header extension)
+ *   [4] calls folded into the summary
+ */
+constexpr int PEER_PROFILE_VERSION = 1;
+constexpr int PEER_PROFILE_FIELDS = 5;
+
+struct PeerProfile {
+    bool valid = false;
+    int jitterUs = 0;
+    int jitterPeakUs = 0;
+    int lossPermille = -1;
+    int calls = 0;
+};
+
+/** @return false (and an invalid profile) for a missing or foreign-version array */
+inline bool readPeerProfile(const int32_t* in, int len, PeerProfile* out) {
+    *out = PeerProfile();
+    if (!in || len < PEER_PROFILE_FIELDS || in[0] != PEER_PROFILE_VERSION) return false;
+    if (in[1] < 0 || in[2] < 0 || in[4] <= 0) return false;
+    out->valid = true;
+    out->jitterUs = in[1];
+    out->jitterPeakUs = in[2];
+    out->lossPermille = in[3] < 0 ? -1 : in[3];
+    out->calls = in[4];
+    return true;
+}
+
+/** @return Fields written (PEER_PROFILE_FIELDS), or 0 if out is too small */
+inline int writePeerProfile(const PeerProfile& p, int32_t* out, int maxLen) {
+    if (maxLen < PEER_PROFILE_FIELDS) return 0;
+    out[0] = PEER_PROFILE_VERSION;
+    out[1] = p.jitterUs;
+    out[2] = p.jitterPeakUs;
+    out[3] = p.lossPermille;
+    out[4] = p.calls;
+    return PEER_PROFILE_FIELDS;
+}
+
+#endif // LXST_PEER_PROFILE_H
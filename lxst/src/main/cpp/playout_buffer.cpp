@@ -0,0 +1,141 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "playout_buffer.h"
+
+static uint32_t silentMaskFor(int frameSamples, int segmentSamples) {
+    int numSegments = (frameSamples + segmentSamples - 1) / segmentSamples;
+    return numSegments >= 32 ? 0xFFFFFFFFu : (1u << numSegments) - 1;
+}
+
+PlayoutBuffer::PlayoutBuffer(int frameSamples, int slots, const PlayoutLevels& levels,
+                             int segmentSamples, MemoryLedger* ledger)
+    : frameSamples_(frameSamples),
+      levels_(levels),
+      segmentSamples_(segmentSamples > 0 ? segmentSamples : frameSamples),
+      allSilentMask_(silentMaskFor(frameSamples, segmentSamples_)),
+      ring_(std::make_unique<PacketRingBuffer>(slots, frameSamples, ledger)),
+      partial_(makeTrackedArray<int16_t>(ledger, MEM_SCRATCH, frameSamples)),
+      dropBuffer_(makeTrackedArray<int16_t>(ledger, MEM_SCRATCH, frameSamples)) {
+}
+
+bool PlayoutBuffer::write(const int16_t* samples, int count, const FrameInfo& info) {
+    if (ring_->write(samples, count, info)) return true;
+    // Full: drop the oldest frame and retry
+    ring_->read(dropBuffer_.get(), count);
+    ring_->write(samples, count, info);
+    return false;
+}
+
+int16_t* PlayoutBuffer::writeSlot(bool* dropped) {
+    *dropped = false;
+    int16_t* slot = ring_->writeSlot();
+    if (!slot) {
+        ring_->read(dropBuffer_.get(), frameSamples_);
+        slot = ring_->writeSlot();
+        *dropped = true;
+    }
+    return slot;
+}
+
+PlayoutDrain PlayoutBuffer::drainStep() {
+    PlayoutDrain step = playoutDrainStep(bufferedSamples(), levels_, &softActive_);
+    switch (step) {
+        case PlayoutDrain::HARD:
+            drainTo(levels_.prebufferSamples);
+            drainCount_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case PlayoutDrain::SOFT:
+            dropSilence(levels_.prebufferSamples);
+            break;
+        case PlayoutDrain::NONE:
+            break;
+    }
+    return step;
+}
+
+void PlayoutBuffer::drainTo(int targetSamples) {
+    int partial = partialValid_ - partialOffset_;
+    int ringFrames = ring_->availableFrames();
+    int excess = ringFrames * frameSamples_ + partial - targetSamples;
+    if (excess <= 0) return;
+
+    // Oldest audio first: the unplayed tail of the current frame...
+    if (partial > 0) {
+        int skip = (excess < partial) ? excess : partial;
+        partialOffset_ += skip;
+        excess -= skip;
+        if (partialOffset_ >= partialValid_) {
+            partialOffset_ = 0;
+            partialValid_ = 0;
+        }
+    }
+
+    // ...then whole frames from the ring...
+    int wholeFrames = excess / frameSamples_;
+    if (wholeFrames > 0) {
+        ring_->drain(ringFrames - wholeFrames);
+        excess -= wholeFrames * frameSamples_;
+    }
+
+    // ...then start the next frame part-way through for the remainder.
+    if (excess > 0 && ring_->read(partial_.get(), frameSamples_, &partialInfo_)) {
+        partialValid_ = frameSamples_;
+        partialOffset_ = excess;
+    }
+    publishPartial();
+}
+
+void PlayoutBuffer::dropSilence(int targetSamples) {
+    int64_t dropped = 0;
+
+    while (true) {
+        int partial = partialValid_ - partialOffset_;
+        int excess = ring_->availableFrames() * frameSamples_ + partial - targetSamples;
+        if (excess <= 0) break;
+
+        if (partial > 0) {
+            // Skip within the current frame, one silent segment at a time
+            int seg = partialOffset_ / segmentSamples_;
+            if (seg >= 32 || !(partialInfo_.silentMask & (1u << seg))) break;
+            int segEnd = (seg + 1) * segmentSamples_;
+            if (segEnd > partialValid_) segEnd = partialValid_;
+            int skip = segEnd - partialOffset_;
+            if (skip > excess) skip = excess;
+            partialOffset_ += skip;
+            dropped += skip;
+            if (partialOffset_ >= partialValid_) {
+                partialOffset_ = 0;
+                partialValid_ = 0;
+            }
+            continue;
+        }
+
+        // Next frame must at least start with silence to be worth pulling
+        FrameInfo head;
+        if (!ring_->peekInfo(&head) || !(head.silentMask & 1u)) break;
+
+        if (head.silentMask == allSilentMask_ && excess >= frameSamples_) {
+            ring_->read(partial_.get(), frameSamples_);
+            dropped += frameSamples_;
+        } else {
+            // Partly silent, or only part of it is excess — the segment
+            // loop above takes it from here
+            ring_->read(partial_.get(), frameSamples_, &partialInfo_);
+            partialValid_ = frameSamples_;
+            partialOffset_ = 0;
+        }
+    }
+
+    if (dropped > 0) {
+        silenceDroppedSamples_.fetch_add(dropped, std::memory_order_relaxed);
+    }
+    publishPartial();
+}
+
+void PlayoutBuffer::resetPartial() {
+    partialOffset_ = 0;
+    partialValid_ = 0;
+    publishPartial();
+}
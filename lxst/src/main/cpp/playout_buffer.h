@@ -0,0 +1,202 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_PLAYOUT_BUFFER_H
+#define LXST_PLAYOUT_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include "memory_ledger.h"
+#include "packet_ring_buffer.h"
+#include "playout_policy.h"
+
+/**
+ * Playout queue of OboePlaybackEngine: the PCM ring plus the frame the
+ * output callback is part-way through, with the callback's drain and
+ * fill steps. The engine keeps the stream, the decoder and PLC; the
+ * host soak test drives this same code with simulated callbacks.
+ *
+ * Oboe's burst size often differs from the LXST frame size (e.g. 192
+ * samples against 960), so the callback reads one frame into a scratch
+ * buffer and serves it over several callbacks — the inverse of the
+ * capture engine's accumBuffer_ pattern.
+ *
+ * Threads: write() and writeSlot()/commitWrite() on the one producer;
+ * drainStep(), drainTo(), fill() and resetPartial() on the callback (or
+ * with the callback stopped). Counters and queuedSamples() from anywhere.
+ */
+class PlayoutBuffer {
+public:
+    /**
+     * @param frameSamples   Samples per LXST frame (all channels)
+     * @param slots          Ring capacity in frames (see slotsForSamples())
+     * @param levels         Prebuffer, soft-drop and drain depths in samples
+     * @param segmentSamples Silence-analysis segment length (FrameInfo::silentMask)
+     * @param ledger         Charged with the ring and scratch buffers (null = untracked)
+     */
+    PlayoutBuffer(int frameSamples, int slots, const PlayoutLevels& levels,
+                  int segmentSamples, MemoryLedger* ledger = nullptr);
+
+    // Non-copyable
+    PlayoutBuffer(const PlayoutBuffer&) = delete;
+    PlayoutBuffer& operator=(const PlayoutBuffer&) = delete;
+
+    // --- Producer ---
+
+    /**
+     * Queue one frame. If the ring is full the oldest frame is dropped
+     * to make room.
+     *
+     * @return false if a frame was dropped
+     */
+    bool write(const int16_t* samples, int count, const FrameInfo& info);
+
+    /**
+     * Zero-copy write: a free slot for frameSamples samples, dropping
+     * the oldest frame if the ring is full (*dropped is then set).
+     * Publish with commitWrite().
+     */
+    int16_t* writeSlot(bool* dropped);
+    void commitWrite(const FrameInfo& info) { ring_->commitWrite(info); }
+
+    // --- Callback ---
+
+    /** Samples queued: ring plus the unplayed part of the current frame. */
+    int bufferedSamples() const {
+        return ring_->availableFrames() * frameSamples_ + (partialValid_ - partialOffset_);
+    }
+
+    /**
+     * Apply playoutDrainStep() to the current depth: drop silence (soft)
+     * or any audio (hard) down to the prebuffer.
+     *
+     * @return The step taken
+     */
+    PlayoutDrain drainStep();
+
+    /** Drop the oldest audio, regardless of content, down to targetSamples. */
+    void drainTo(int targetSamples);
+
+    /**
+     * Fill out[0, totalSamples) from the partial frame, then whole frames
+     * from the ring, until it is full or the ring runs dry.
+     *
+     * @param onServed Called as onServed(const FrameInfo&, int outOffset)
+     *                 for each frame taken from the ring, with the offset
+     *                 of its first sample in out
+     * @return Samples written; the caller conceals or zeroes the rest
+     */
+    template <typename OnServed>
+    int fill(int16_t* out, int totalSamples, OnServed&& onServed);
+
+    /** Forget the partial frame (stream reopened: its offsets are stale). */
+    void resetPartial();
+
+    /**
+     * Frame-sized scratch for the caller once fill() came up short (the
+     * partial frame is then used up). Overwritten by the next fill().
+     */
+    int16_t* scratch() { return partial_.get(); }
+
+    // --- Any thread ---
+
+    /** bufferedSamples() as last published by the callback thread. */
+    int queuedSamples() const {
+        return ring_->availableFrames() * frameSamples_
+            + partialSamples_.load(std::memory_order_relaxed);
+    }
+
+    int availableFrames() const { return ring_->availableFrames(); }
+    int capacity() const { return ring_->capacity(); }
+    int frameSamples() const { return frameSamples_; }
+    const PlayoutLevels& levels() const { return levels_; }
+
+    /** Frames taken from the ring by fill(). */
+    int framesServed() const { return framesServed_.load(std::memory_order_relaxed); }
+
+    /** Hard drains by drainStep(). */
+    int drainCount() const { return drainCount_.load(std::memory_order_relaxed); }
+
+    /** Silent samples skipped by the soft drain. */
+    int64_t silenceDroppedSamples() const {
+        return silenceDroppedSamples_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void dropSilence(int targetSamples);
+    void publishPartial() {
+        partialSamples_.store(partialValid_ - partialOffset_, std::memory_order_relaxed);
+    }
+
+    const int frameSamples_;
+    const PlayoutLevels levels_;
+    const int segmentSamples_;
+    const uint32_t allSilentMask_;   // silentMask value of a fully silent frame
+
+    std::unique_ptr<PacketRingBuffer> ring_;
+
+    // Callback-thread-only partial frame state
+    TrackedArray<int16_t> partial_;  // The frame being served
+    int partialOffset_ = 0;          // Next sample to copy from partial_
+    int partialValid_ = 0;           // Valid samples in partial_
+    FrameInfo partialInfo_;          // Metadata of the frame in partial_
+    bool softActive_ = false;        // Soft drain in progress (hysteresis)
+
+    // Producer-only: the drop-oldest path must not touch partial_
+    TrackedArray<int16_t> dropBuffer_;
+
+    std::atomic<int> partialSamples_{0};  // Published partialValid_ - partialOffset_
+    std::atomic<int> framesServed_{0};
+    std::atomic<int> drainCount_{0};
+    std::atomic<int64_t> silenceDroppedSamples_{0};
+};
+
+template <typename OnServed>
+int PlayoutBuffer::fill(int16_t* out, int totalSamples, OnServed&& onServed) {
+    int written = 0;
+    int served = 0;
+    FrameInfo info;
+
+    while (written < totalSamples) {
+        int remaining = totalSamples - written;
+
+        // 1) Leftover samples from a partly served frame
+        if (partialValid_ > 0) {
+            int available = partialValid_ - partialOffset_;
+            int toCopy = remaining < available ? remaining : available;
+            std::memcpy(out + written, partial_.get() + partialOffset_, sizeof(int16_t) * toCopy);
+            written += toCopy;
+            partialOffset_ += toCopy;
+            if (partialOffset_ >= partialValid_) {
+                partialOffset_ = 0;
+                partialValid_ = 0;
+            }
+            continue;
+        }
+
+        // 2) A new frame: straight into out if it fits, else via partial_
+        // with the remainder kept for the next callbacks
+        if (remaining >= frameSamples_) {
+            if (!ring_->read(out + written, frameSamples_, &info)) break;
+            onServed(static_cast<const FrameInfo&>(info), written);
+            written += frameSamples_;
+        } else {
+            if (!ring_->read(partial_.get(), frameSamples_, &partialInfo_)) break;
+            onServed(static_cast<const FrameInfo&>(partialInfo_), written);
+            std::memcpy(out + written, partial_.get(), sizeof(int16_t) * remaining);
+            written += remaining;
+            partialOffset_ = remaining;
+            partialValid_ = frameSamples_;
+        }
+        served++;
+    }
+
+    if (served > 0) framesServed_.fetch_add(served, std::memory_order_relaxed);
+    publishPartial();
+    return written;
+}
+
+#endif // LXST_PLAYOUT_BUFFER_H
@@ -0,0 +1,154 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_PLAYOUT_POLICY_H
+#define LXST_PLAYOUT_POLICY_H
+
+#include <cstdint>
+
+/**
+ * Playout buffer policy of OboePlaybackEngine: the knobs that trade
+ * latency against underruns and concealment.
+ *
+ * The defaults are the hand-picked values the engine has always used.
+ * The playout tuner (lxst/tools/playout_tuner) replays recorded arrival
+ * traces through the same decision code (playoutDrainStep() below) and
+ * emits a per-profile table of these fields; Kotlin passes a row to
+ * create() (NativePlayoutPolicy.kt has the same layout).
+ *
+ * Flat int array, one entry per field. Fields missing from the end of a
+ * shorter array keep their defaults, so the layout can grow.
+ */
+enum PlayoutPolicyField : int {
+    PLAYOUT_PREBUFFER_MS = 0,      // Prebuffer/drain target (0 = the caller's)
+    PLAYOUT_DRAIN_PCT,             // Hard drain threshold, % of the prebuffer
+    PLAYOUT_SOFT_DROP_PCT,         // Silence dropping starts this far (%) from prebuffer to threshold
+    PLAYOUT_PLC_MAX_CALLBACKS,     // Consecutive PLC callbacks before silence
+    PLAYOUT_PLC_MAX_CALLBACKS_LOSSY, // Same, for peers seeded as lossy
+    PLAYOUT_BUFFER_BURSTS,         // Oboe buffer size in bursts
+    PLAYOUT_POLICY_FIELDS
+};
+
+struct PlayoutPolicy {
+    int prebufferMs = 0;
+    int drainPct = 200;
+    int softDropPct = 25;
+    /**
+     * Consecutive PLC callbacks before falling back to silence. Peers known
+     * to lose or badly delay packets get the longer run: their holes are
+     * mostly late packets that still arrive, so bridging beats a dropout.
+     */
+    int plcMaxCallbacks = 5;
+    int plcMaxCallbacksLossy = 10;
+    /** 2 bursts: low latency while riding out one late callback. */
+    int bufferBursts = 2;
+};
+
+// Bounds applied when reading a policy array. A drain threshold must sit
+// above the prebuffer, or every callback would drain.
+constexpr int PLAYOUT_PREBUFFER_MAX_MS = 2000;
+constexpr int PLAYOUT_DRAIN_PCT_MIN = 110;
+constexpr int PLAYOUT_DRAIN_PCT_MAX = 500;
+constexpr int PLAYOUT_PLC_MAX_CALLBACKS_MAX = 100;
+constexpr int PLAYOUT_BUFFER_BURSTS_MAX = 8;
+
+inline int clampPolicyField(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+/** @return false (and the default policy) for a missing or empty array */
+inline bool readPlayoutPolicy(const int32_t* in, int len, PlayoutPolicy* out) {
+    *out = PlayoutPolicy();
+    if (!in || len <= 0) return false;
+    auto field = [&](int i, int fallback) { return i < len ? in[i] : fallback; };
+    out->prebufferMs = clampPolicyField(field(PLAYOUT_PREBUFFER_MS, out->prebufferMs),
+                                        0, PLAYOUT_PREBUFFER_MAX_MS);
+    out->drainPct = clampPolicyField(field(PLAYOUT_DRAIN_PCT, out->drainPct),
+                                     PLAYOUT_DRAIN_PCT_MIN, PLAYOUT_DRAIN_PCT_MAX);
+    out->softDropPct = clampPolicyField(field(PLAYOUT_SOFT_DROP_PCT, out->softDropPct), 0, 100);
+    out->plcMaxCallbacks = clampPolicyField(field(PLAYOUT_PLC_MAX_CALLBACKS, out->plcMaxCallbacks),
+                                            0, PLAYOUT_PLC_MAX_CALLBACKS_MAX);
+    out->plcMaxCallbacksLossy = clampPolicyField(
+        field(PLAYOUT_PLC_MAX_CALLBACKS_LOSSY, out->plcMaxCallbacksLossy),
+        0, PLAYOUT_PLC_MAX_CALLBACKS_MAX);
+    out->bufferBursts = clampPolicyField(field(PLAYOUT_BUFFER_BURSTS, out->bufferBursts),
+                                         1, PLAYOUT_BUFFER_BURSTS_MAX);
+    return true;
+}
+
+/** @return Fields written (PLAYOUT_POLICY_FIELDS), or 0 if out is too small */
+inline int writePlayoutPolicy(const PlayoutPolicy& p, int32_t* out, int maxLen) {
+    if (maxLen < PLAYOUT_POLICY_FIELDS) return 0;
+    out[PLAYOUT_PREBUFFER_MS] = p.prebufferMs;
+    out[PLAYOUT_DRAIN_PCT] = p.drainPct;
+    out[PLAYOUT_SOFT_DROP_PCT] = p.softDropPct;
+    out[PLAYOUT_PLC_MAX_CALLBACKS] = p.plcMaxCallbacks;
+    out[PLAYOUT_PLC_MAX_CALLBACKS_LOSSY] = p.plcMaxCallbacksLossy;
+    out[PLAYOUT_BUFFER_BURSTS] = p.bufferBursts;
+    return PLAYOUT_POLICY_FIELDS;
+}
+
+/** Buffer depths derived from a policy, in samples. */
+struct PlayoutLevels {
+    int prebufferSamples = 0;       // Start threshold and drain target
+    int softDropSamples = 0;        // Depth that starts dropping silence
+    int drainThresholdSamples = 0;  // Depth that forces a drain (hard cap)
+};
+
+/** Soft-drop depth: softDropPct of the way from prebuffer to the drain threshold. */
+inline int playoutSoftDropSamples(int prebufferSamples, int drainThresholdSamples, int softDropPct) {
+    return prebufferSamples
+        + static_cast<int>(static_cast<int64_t>(drainThresholdSamples - prebufferSamples) * softDropPct / 100);
+}
+
+enum class PlayoutDrain {
+    NONE,   // Play as is
+    SOFT,   // Drop silent audio at the head down to the prebuffer
+    HARD,   // Drop audio regardless of content down to the prebuffer
+};
+
+/**
+ * Per-callback drain decision, shared by the engine and the tuner.
+ *
+ * Hard above the drain threshold. Otherwise soft from the soft-drop depth
+ * until back at the prebuffer (hysteresis in *softActive), so latency is
+ * shed in the pauses between words.
+ *
+ * @param buffered  Samples queued for playout (ring plus partial frame)
+ */
+inline PlayoutDrain playoutDrainStep(int buffered, const PlayoutLevels& levels, bool* softActive) {
+    if (levels.drainThresholdSamples <= 0) return PlayoutDrain::NONE;
+    if (buffered > levels.drainThresholdSamples) {
+        *softActive = false;
+        return PlayoutDrain::HARD;
+    }
+    if (buffered > levels.softDropSamples) *softActive = true;
+    if (*softActive && buffered <= levels.prebufferSamples) *softActive = false;
+    return *softActive ? PlayoutDrain::SOFT : PlayoutDrain::NONE;
+}
+
+/**
+ * Late-packet decision against callback concealment, shared by the
+ * engine and the host tests.
+ *
+ * concealedFrames slots have played as PLC since the last real frame. A
+ * packet `missing` sequence numbers after the last one written belongs
+ * to slot missing + 1 of those: its holes were concealed first, and it
+ * is late only if the play point has also passed its own slot. Without
+ * sequence numbers (missing < 0), any concealed frame is taken as its
+ * slot.
+ *
+ * @param late  Set if the packet's slot already played as PLC
+ * @return Concealed frames this packet accounts for
+ */
+inline int playoutConcealedClaim(int concealedFrames, int missing, bool* late) {
+    if (missing < 0) {
+        *late = concealedFrames > 0;
+        return *late ? 1 : 0;
+    }
+    *late = concealedFrames > missing;
+    return *late ? missing + 1 : concealedFrames;
+}
+
+#endif // LXST_PLAYOUT_POLICY_H
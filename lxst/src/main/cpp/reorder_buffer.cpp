@@ -0,0 +1,135 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "reorder_buffer.h"
+#include <cstring>
+
+void PacketReorderBuffer::configure(int depth) {
+    if (depth < 1) depth = 1;
+    if (depth > MAX_SLOTS - 1) depth = MAX_SLOTS - 1;
+    depth_ = depth;
+    reset();
+}
+
+void PacketReorderBuffer::setHoldLimit(int packets) {
+    if (packets < depth_) packets = depth_;
+    if (packets > MAX_SLOTS - 1) packets = MAX_SLOTS - 1;
+    holdLimit_ = packets;
+}
+
+bool PacketReorderBuffer::headHole(uint16_t* seq) const {
+    if (held_ == 0) return false;
+    *seq = nextSeq_;
+    return true;
+}
+
+int PacketReorderBuffer::missingSeqs(uint16_t* out, int maxCount) const {
+    if (held_ == 0) return 0;
+    // Last held packet bounds the holes
+    int last = 0;
+    for (int i = 1; i < MAX_SLOTS; i++) {
+        const Slot& slot = slots_[(nextSeq_ + i) & (MAX_SLOTS - 1)];
+        if (slot.present && slot.seq == static_cast<uint16_t>(nextSeq_ + i)) last = i;
+    }
+    int n = 0;
+    for (int i = 0; i < last && n < maxCount; i++) {
+        uint16_t seq = static_cast<uint16_t>(nextSeq_ + i);
+        const Slot& slot = slots_[seq & (MAX_SLOTS - 1)];
+        if (!slot.present || slot.seq != seq) out[n++] = seq;
+    }
+    return n;
+}
+
+void PacketReorderBuffer::reset() {
+    for (Slot& slot : slots_) slot.present = false;
+    started_ = false;
+    nextSeq_ = 0;
+    held_ = 0;
+    holdLimit_ = depth_;
+    history_ = 0;
+    lost_.store(0, std::memory_order_relaxed);
+    late_.store(0, std::memory_order_relaxed);
+    duplicates_.store(0, std::memory_order_relaxed);
+    reordered_.store(0, std::memory_order_relaxed);
+}
+
+void PacketReorderBuffer::restart() {
+    for (Slot& slot : slots_) slot.present = false;
+    bump(late_, held_);
+    started_ = false;
+    held_ = 0;
+    history_ = 0;
+}
+
+void PacketReorderBuffer::push(uint16_t seq, const uint8_t* data, int len, int tag,
+                               ReorderSink sink, void* ctx) {
+    if (len <= 0 || len > MAX_PACKET_BYTES) return;
+    if (!started_) {
+        nextSeq_ = seq;
+        started_ = true;
+    }
+
+    int d = static_cast<int16_t>(static_cast<uint16_t>(seq - nextSeq_));
+    if (d < 0) {
+        // Behind the play point: either played already or given up on.
+        // Beyond the history it can only be late.
+        bool played = d >= -32 && (history_ & (1u << (-d - 1)));
+        bump(played ? duplicates_ : late_);
+        return;
+    }
+    if (d >= MAX_SLOTS) {
+        // Too far ahead to hold: whatever is missing isn't coming in time
+        flush(sink, ctx);
+        int gap = static_cast<uint16_t>(seq - nextSeq_);
+        if (gap <= MAX_SLOTS * 8) bump(lost_, gap);  // Beyond that: sender restart
+        nextSeq_ = seq;
+        history_ = 0;
+        d = 0;
+    }
+
+    Slot& slot = slots_[seq & (MAX_SLOTS - 1)];
+    if (slot.present) {
+        bump(duplicates_);  // Same seq already waiting
+        return;
+    }
+    slot.present = true;
+    slot.seq = seq;
+    slot.tag = tag;
+    slot.len = len;
+    std::memcpy(slot.data, data, len);
+    held_++;
+
+    if (d == 0 && held_ > 1) bump(reordered_);  // Filled a hole
+    release(sink, ctx);
+
+    while (held_ > holdLimit_) {
+        skip();
+        release(sink, ctx);
+    }
+}
+
+void PacketReorderBuffer::flush(ReorderSink sink, void* ctx) {
+    while (held_ > 0) {
+        release(sink, ctx);
+        if (held_ > 0) skip();
+    }
+}
+
+void PacketReorderBuffer::release(ReorderSink sink, void* ctx) {
+    for (;;) {
+        Slot& slot = slots_[nextSeq_ & (MAX_SLOTS - 1)];
+        if (!slot.present || slot.seq != nextSeq_) return;
+        slot.present = false;
+        held_--;
+        nextSeq_++;
+        history_ = (history_ << 1) | 1u;
+        sink(ctx, slot.seq, slot.data, slot.len, slot.tag);
+    }
+}
+
+void PacketReorderBuffer::skip() {
+    bump(lost_);
+    nextSeq_++;
+    history_ <<= 1;
+}
@@ -0,0 +1,117 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_REORDER_BUFFER_H
+#define LXST_REORDER_BUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+/** Receives packets in sequence order. ctx and tag are passed through unchanged. */
+typedef void (*ReorderSink)(void* ctx, uint16_t seq, const uint8_t* data, int len, int tag);
+
+/**
+ * Small reorder window and duplicate filter keyed on a 16-bit packet
+ * sequence number (the LXST header extension).
+ *
+ * Packets are passed on as soon as they are next in sequence. One that
+ * arrives ahead of a hole is held; the hole is given up (counted as lost)
+ * once more than `depth` packets are waiting behind it, so the added
+ * delay is bounded by depth frames. Packets behind the play point are
+ * dropped and counted as duplicate (already played) or late (their slot
+ * was skipped) — late ones mean the window is too small for the path.
+ *
+ * A jump of more than the window resynchronises on the new sequence.
+ * Anything behind the play point is dropped as late, however far back:
+ * the owner calls restart() after a long silence, which is when a
+ * sender restart can show up.
+ *
+ * The owner may raise the hold limit above depth for a while (a NACKed
+ * hole whose retransmit can still make its playout time); missingSeqs()
+ * lists the holes to request.
+ *
+ * Not thread-safe: owned by the thread that receives packets. Only the
+ * counters may be read from elsewhere.
+ */
+class PacketReorderBuffer {
+public:
+    static constexpr int MAX_SLOTS = 16;        // Power of two
+    static constexpr int MAX_PACKET_BYTES = 1500;
+
+    /** @param depth Packets held behind a hole before skipping it (1..MAX_SLOTS-1) */
+    void configure(int depth);
+
+    /** Forget all state and held packets. */
+    void reset();
+
+    /**
+     * Drop held packets (counted as late) and take the next push() as
+     * the play point. Counters and the hold limit are kept.
+     */
+    void restart();
+
+    /** Feed one packet. May call sink zero or more times, in sequence order. */
+    void push(uint16_t seq, const uint8_t* data, int len, int tag,
+              ReorderSink sink, void* ctx);
+
+    /** Pass on everything held, skipping holes (stream end). */
+    void flush(ReorderSink sink, void* ctx);
+
+    int depth() const { return depth_; }
+
+    /**
+     * Packets that may wait behind a hole before it is skipped, from
+     * depth up to MAX_SLOTS-1. Applies from the next push(); reset to
+     * depth by configure()/reset().
+     */
+    void setHoldLimit(int packets);
+
+    /** @return true and the sequence of the hole at the play point, if one is blocking */
+    bool headHole(uint16_t* seq) const;
+
+    /** Sequence numbers missing behind held packets, oldest first. @return count written */
+    int missingSeqs(uint16_t* out, int maxCount) const;
+
+    // Counters since reset()
+    int lostCount() const { return lost_.load(std::memory_order_relaxed); }
+    int lateCount() const { return late_.load(std::memory_order_relaxed); }
+    int duplicateCount() const { return duplicates_.load(std::memory_order_relaxed); }
+    int reorderedCount() const { return reordered_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        bool present = false;
+        uint16_t seq = 0;
+        int tag = 0;
+        int len = 0;
+        uint8_t data[MAX_PACKET_BYTES];
+    };
+
+    // Emit consecutive packets from nextSeq_.
+    void release(ReorderSink sink, void* ctx);
+
+    // Give up on the packet at nextSeq_.
+    void skip();
+
+    // Single writer, so a relaxed load + store is enough
+    static void bump(std::atomic<int>& counter, int n = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    int depth_ = 2;
+    int holdLimit_ = 2;
+    bool started_ = false;
+    uint16_t nextSeq_ = 0;
+    int held_ = 0;
+    uint32_t history_ = 0;  // Bit i: packet nextSeq_-1-i was played (vs skipped)
+
+    std::atomic<int> lost_{0};
+    std::atomic<int> late_{0};
+    std::atomic<int> duplicates_{0};
+    std::atomic<int> reordered_{0};
+
+    Slot slots_[MAX_SLOTS];
+};
+
+#endif // LXST_REORDER_BUFFER_H
@@ -0,0 +1,205 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "rt_worker_pool.h"
+#include <android/log.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#define LOG_TAG "LXST:RtWorker"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN,  LOG_TAG, __VA_ARGS__)
+
+RtWorkerPool::RtWorkerPool() {
+    sem_init(&wakeup_, 0, 0);
+    resetQueue();
+}
+
+RtWorkerPool::~RtWorkerPool() {
+    stop();
+    sem_destroy(&wakeup_);
+}
+
+bool RtWorkerPool::start(const RtWorkerConfig& config) {
+    if (isRunning()) return true;
+
+    config_ = config;
+    affinityMask_ = config.bigCoresOnly ? bigCoreMask() : 0;
+    fifoWorkers_.store(0, std::memory_order_relaxed);
+    rejected_.store(0, std::memory_order_relaxed);
+    resetQueue();
+
+    running_.store(true, std::memory_order_release);
+    for (int i = 0; i < config.numWorkers; i++) {
+        threads_.emplace_back(&RtWorkerPool::workerMain, this, i);
+    }
+    return !threads_.empty();
+}
+
+void RtWorkerPool::stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) return;
+
+    for (size_t i = 0; i < threads_.size(); i++) {
+        sem_post(&wakeup_);
+    }
+    for (auto& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+    threads_.clear();
+
+    // Drain leftover wakeups so a restarted pool doesn't spin on stale posts
+    while (sem_trywait(&wakeup_) == 0) {}
+    resetQueue();
+}
+
+bool RtWorkerPool::submit(RtJobFn fn, void* ctx) {
+    if (!running_.load(std::memory_order_acquire)) return false;
+    if (!push(RtJob{fn, ctx})) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    sem_post(&wakeup_);
+    return true;
+}
+
+// --- Bounded MPMC queue (Dmitry Vyukov) ---
+//
+// Each cell carries a sequence number: seq == pos means free for the
+// producer claiming pos; seq == pos + 1 means filled for the consumer
+// claiming pos. Producers and consumers race only on their own CAS.
+
+bool RtWorkerPool::push(const RtJob& job) {
+    size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells_[pos & QUEUE_MASK];
+        size_t seq = cell->seq.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;  // Full
+        } else {
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+        }
+    }
+    cell->job = job;
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool RtWorkerPool::pop(RtJob* job) {
+    size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+        cell = &cells_[pos & QUEUE_MASK];
+        size_t seq = cell->seq.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            return false;  // Empty
+        } else {
+            pos = dequeuePos_.load(std::memory_order_relaxed);
+        }
+    }
+    *job = cell->job;
+    cell->seq.store(pos + QUEUE_MASK + 1, std::memory_order_release);
+    return true;
+}
+
+void RtWorkerPool::resetQueue() {
+    for (size_t i = 0; i < QUEUE_CAPACITY; i++) {
+        cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    enqueuePos_.store(0, std::memory_order_relaxed);
+    dequeuePos_.store(0, std::memory_order_relaxed);
+}
+
+// --- Worker threads ---
+
+void RtWorkerPool::workerMain(int index) {
+    applyScheduling(index);
+
+    RtJob job;
+    while (true) {
+        while (sem_wait(&wakeup_) != 0 && errno == EINTR) {}
+        if (!running_.load(std::memory_order_acquire)) break;
+        if (pop(&job)) {
+            job.fn(job.ctx);
+        }
+    }
+}
+
+void RtWorkerPool::applyScheduling(int index) {
+    char name[16];
+    snprintf(name, sizeof(name), "%s-%d", config_.name, index);
+    pthread_setname_np(pthread_self(), name);
+
+    if (affinityMask_ != 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < 64; cpu++) {
+            if (affinityMask_ & (1ULL << cpu)) CPU_SET(cpu, &set);
+        }
+        if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+            LOGW("%s: sched_setaffinity failed: %s", name, strerror(errno));
+        }
+    }
+
+    // SCHED_FIFO is normally reserved for audio HAL / AAudio threads and
+    // refused with EPERM for app processes, but some builds grant it.
+    bool fifo = false;
+    if (config_.trySchedFifo) {
+        sched_param param{};
+        param.sched_priority = config_.fifoPriority;
+        fifo = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+    }
+    if (fifo) {
+        fifoWorkers_.fetch_add(1, std::memory_order_relaxed);
+    } else if (setpriority(PRIO_PROCESS, gettid(), config_.niceValue) != 0) {
+        LOGW("%s: setpriority(%d) failed: %s", name, config_.niceValue, strerror(errno));
+    }
+
+    LOGI("%s started: cpus=0x%llx sched=%s nice=%d", name,
+         static_cast<unsigned long long>(affinityMask_),
+         fifo ? "FIFO" : "OTHER", fifo ? 0 : getpriority(PRIO_PROCESS, gettid()));
+}
+
+uint64_t RtWorkerPool::bigCoreMask() {
+    long numCpus = sysconf(_SC_NPROCESSORS_CONF);
+    if (numCpus <= 1) return 0;
+    if (numCpus > 64) numCpus = 64;
+
+    long maxFreq[64] = {};
+    long lowest = 0;
+    long highest = 0;
+    for (int cpu = 0; cpu < numCpus; cpu++) {
+        char path[96];
+        snprintf(path, sizeof(path),
+                 "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", cpu);
+        FILE* f = fopen(path, "r");
+        if (!f) return 0;
+        long freq = 0;
+        int n = fscanf(f, "%ld", &freq);
+        fclose(f);
+        if (n != 1 || freq <= 0) return 0;
+
+        maxFreq[cpu] = freq;
+        if (lowest == 0 || freq < lowest) lowest = freq;
+        if (freq > highest) highest = freq;
+    }
+    if (lowest == highest) return 0;  // Homogeneous — nothing to prefer
+
+    uint64_t mask = 0;
+    for (int cpu = 0; cpu < numCpus; cpu++) {
+        if (maxFreq[cpu] > lowest) mask |= 1ULL << cpu;
+    }
+    return mask;
+}
@@ -0,0 +1,125 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_RT_WORKER_POOL_H
+#define LXST_RT_WORKER_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <semaphore.h>
+#include <thread>
+#include <vector>
+
+/** Job entry point. ctx is passed through from submit() unchanged. */
+typedef void (*RtJobFn)(void* ctx);
+
+/**
+ * Thread placement and scheduling for an RtWorkerPool.
+ *
+ * Defaults suit the audio decode/encode path: pin to big cores, try
+ * SCHED_FIFO (usually refused for app processes), otherwise fall back to
+ * the same nice value as Android's THREAD_PRIORITY_URGENT_AUDIO.
+ */
+struct RtWorkerConfig {
+    const char* name = "lxst-rt";  // Thread name (truncated to 15 chars)
+    int numWorkers = 1;            // Use 1 where jobs must run in order
+    bool bigCoresOnly = true;      // Restrict affinity to the fastest cluster(s)
+    int niceValue = -19;           // Applied if SCHED_FIFO is unavailable
+    bool trySchedFifo = true;      // Attempt SCHED_FIFO before falling back to nice
+    int fifoPriority = 2;          // Kept below Oboe's callback thread
+};
+
+/**
+ * Small pool of native worker threads for real-time-adjacent audio work
+ * (decode, encode offload, recording, metrics).
+ *
+ * Kotlin dispatchers share threads with unrelated IO and may land on little
+ * cores; these threads are dedicated, pinned and prioritised so per-frame
+ * work has stable latency regardless of app-wide load.
+ *
+ * Jobs are {function, context} pairs pushed through a bounded lock-free
+ * MPMC queue (Vyukov), so submit() never allocates or takes a mutex and
+ * can be called from the Oboe callback. Workers sleep on a semaphore.
+ *
+ * Jobs should be idempotent "drain" operations (e.g. "decode everything in
+ * the inbound ring") — a full queue rejects the submit, and the next job
+ * will pick up the work.
+ */
+class RtWorkerPool {
+public:
+    RtWorkerPool();
+    ~RtWorkerPool();
+
+    RtWorkerPool(const RtWorkerPool&) = delete;
+    RtWorkerPool& operator=(const RtWorkerPool&) = delete;
+
+    /**
+     * Spawn the worker threads. Scheduling is applied by each worker to
+     * itself; failures are logged and the worker runs with what it got.
+     *
+     * @return true if at least one worker started
+     */
+    bool start(const RtWorkerConfig& config);
+
+    /** Stop and join all workers. Pending jobs are discarded. */
+    void stop();
+
+    /**
+     * Enqueue a job. Lock-free and allocation-free.
+     *
+     * @return false if the pool is not running or the queue is full
+     */
+    bool submit(RtJobFn fn, void* ctx);
+
+    bool isRunning() const { return running_.load(std::memory_order_acquire); }
+
+    /** Workers that obtained SCHED_FIFO (diagnostic). */
+    int getFifoWorkerCount() const { return fifoWorkers_.load(std::memory_order_relaxed); }
+
+    /** Jobs rejected because the queue was full (diagnostic). */
+    int getRejectedCount() const { return rejected_.load(std::memory_order_relaxed); }
+
+    /**
+     * CPU mask of the big cores, derived from cpufreq max frequencies.
+     * Excludes the slowest cluster; 0 if all cores look identical or
+     * sysfs is unreadable (leave affinity alone).
+     */
+    static uint64_t bigCoreMask();
+
+private:
+    struct RtJob {
+        RtJobFn fn;
+        void* ctx;
+    };
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        RtJob job;
+    };
+
+    static constexpr size_t QUEUE_CAPACITY = 64;  // Power of two
+    static constexpr size_t QUEUE_MASK = QUEUE_CAPACITY - 1;
+
+    bool push(const RtJob& job);
+    bool pop(RtJob* job);
+    void resetQueue();
+    void workerMain(int index);
+    void applyScheduling(int index);
+
+    RtWorkerConfig config_;
+    uint64_t affinityMask_ = 0;
+    std::vector<std::thread> threads_;
+    sem_t wakeup_;
+    std::atomic<bool> running_{false};
+
+    Cell cells_[QUEUE_CAPACITY];
+    alignas(64) std::atomic<size_t> enqueuePos_{0};
+    alignas(64) std::atomic<size_t> dequeuePos_{0};
+
+    std::atomic<int> fifoWorkers_{0};
+    std::atomic<int> rejected_{0};
+};
+
+#endif // LXST_RT_WORKER_POOL_H
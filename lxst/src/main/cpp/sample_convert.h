@@ -0,0 +1,90 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_SAMPLE_CONVERT_H
+#define LXST_SAMPLE_CONVERT_H
+
+#include <cstdint>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define LXST_CONVERT_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define LXST_CONVERT_SSE2 1
+#endif
+
+/**
+ * float32 ↔ int16 conversion for the Phase 2 (Kotlin codec) bridge.
+ *
+ * Matches the Kotlin helpers these replace: float → int16 clamps to
+ * [-1, 1], scales by 32767 and truncates toward zero; int16 → float
+ * divides by 32768. Vectorised 8 samples at a time with NEON (arm64,
+ * armv7 with NEON) or SSE2 (x86 emulators); the tail runs scalar.
+ */
+
+/** int16 → float32 with gain folded into the scale factor. */
+inline void int16ToFloat(const int16_t* in, float* out, int count, float gain) {
+    const float scale = gain / 32768.0f;
+    int i = 0;
+#if defined(LXST_CONVERT_NEON)
+    const float32x4_t vscale = vdupq_n_f32(scale);
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t s = vld1q_s16(in + i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+        vst1q_f32(out + i, vmulq_f32(lo, vscale));
+        vst1q_f32(out + i + 4, vmulq_f32(hi, vscale));
+    }
+#elif defined(LXST_CONVERT_SSE2)
+    const __m128 vscale = _mm_set1_ps(scale);
+    for (; i + 8 <= count; i += 8) {
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Sign-extend by unpacking into the high half and shifting back down
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16);
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), vscale));
+        _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), vscale));
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = static_cast<float>(in[i]) * scale;
+    }
+}
+
+/** float32 → int16, clamped to [-1, 1] before scaling. */
+inline void floatToInt16(const float* in, int16_t* out, int count) {
+    int i = 0;
+#if defined(LXST_CONVERT_NEON)
+    const float32x4_t vmin = vdupq_n_f32(-1.0f);
+    const float32x4_t vmax = vdupq_n_f32(1.0f);
+    const float32x4_t vscale = vdupq_n_f32(32767.0f);
+    for (; i + 8 <= count; i += 8) {
+        float32x4_t a = vminq_f32(vmaxq_f32(vld1q_f32(in + i), vmin), vmax);
+        float32x4_t b = vminq_f32(vmaxq_f32(vld1q_f32(in + i + 4), vmin), vmax);
+        int32x4_t ia = vcvtq_s32_f32(vmulq_f32(a, vscale));  // Truncates toward zero
+        int32x4_t ib = vcvtq_s32_f32(vmulq_f32(b, vscale));
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(ia), vqmovn_s32(ib)));
+    }
+#elif defined(LXST_CONVERT_SSE2)
+    const __m128 vmin = _mm_set1_ps(-1.0f);
+    const __m128 vmax = _mm_set1_ps(1.0f);
+    const __m128 vscale = _mm_set1_ps(32767.0f);
+    for (; i + 8 <= count; i += 8) {
+        __m128 a = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), vmin), vmax);
+        __m128 b = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), vmin), vmax);
+        __m128i ia = _mm_cvttps_epi32(_mm_mul_ps(a, vscale));
+        __m128i ib = _mm_cvttps_epi32(_mm_mul_ps(b, vscale));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(ia, ib));
+    }
+#endif
+    for (; i < count; i++) {
+        float v = in[i];
+        if (v > 1.0f) v = 1.0f;
+        if (v < -1.0f) v = -1.0f;
+        out[i] = static_cast<int16_t>(v * 32767.0f);
+    }
+}
+
+#endif // LXST_SAMPLE_CONVERT_H
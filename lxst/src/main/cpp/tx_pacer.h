@@ -0,0 +1,57 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_TX_PACER_H
+#define LXST_TX_PACER_H
+
+#include <cstdint>
+
+/**
+ * Token-bucket pacer for outgoing packets.
+ *
+ * Refills one packet every intervalNs up to burstPackets, kept as a
+ * theoretical send time (GCRA) so there is no refill timer: a packet may
+ * go once now >= tat - (burst - 1) * interval, and sending moves tat one
+ * interval past max(tat, now). An idle sender builds up the full burst;
+ * a backlog after a stall drains at the interval instead of all at once.
+ *
+ * Not thread-safe: owned by the one thread that dequeues packets.
+ */
+class TxPacer {
+public:
+    /**
+     * @param intervalNs   Time between packets at the nominal rate (<= 0 = off)
+     * @param burstPackets Packets that may go back to back after idle (>= 1)
+     */
+    void configure(int64_t intervalNs, int burstPackets) {
+        intervalNs_ = intervalNs;
+        burstPackets_ = burstPackets < 1 ? 1 : burstPackets;
+        tatNs_ = 0;
+    }
+
+    bool enabled() const { return intervalNs_ > 0; }
+
+    /** Nanoseconds until the next packet may be sent (0 = now). */
+    int64_t delayNs(int64_t nowNs) const {
+        if (intervalNs_ <= 0) return 0;
+        int64_t earliestNs = tatNs_ - static_cast<int64_t>(burstPackets_ - 1) * intervalNs_;
+        return earliestNs > nowNs ? earliestNs - nowNs : 0;
+    }
+
+    /** Record a packet sent at nowNs. */
+    void onSent(int64_t nowNs) {
+        if (intervalNs_ <= 0) return;
+        tatNs_ = (tatNs_ > nowNs ? tatNs_ : nowNs) + intervalNs_;
+    }
+
+    int64_t intervalNs() const { return intervalNs_; }
+    int burstPackets() const { return burstPackets_; }
+
+private:
+    int64_t intervalNs_ = 0;
+    int burstPackets_ = 1;
+    int64_t tatNs_ = 0;  // Theoretical send time of the next packet
+};
+
+#endif // LXST_TX_PACER_H
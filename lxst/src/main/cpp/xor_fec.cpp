@@ -0,0 +1,163 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "xor_fec.h"
+#include <cstring>
+
+// --- Encoder ---
+
+void XorFecEncoder::configure(int groupSize) {
+    if (groupSize > XOR_FEC_MAX_GROUP) groupSize = XOR_FEC_MAX_GROUP;
+    groupSize_ = groupSize >= 2 ? groupSize : 0;
+    groupSeq_ = 0;
+    resetGroup();
+}
+
+void XorFecEncoder::resetGroup() {
+    count_ = 0;
+    maxLen_ = 0;
+    std::memset(parity_, 0, sizeof(parity_));
+}
+
+int XorFecEncoder::wrapData(const uint8_t* payload, int len, uint8_t* out, int outSize) {
+    if (len <= 0 || len > XOR_FEC_MAX_PAYLOAD || len + 1 > outSize) return 0;
+    if (count_ >= groupSize_) return 0;
+
+    out[0] = static_cast<uint8_t>((groupSeq_ << 4) | count_);
+    std::memcpy(out + 1, payload, len);
+
+    for (int i = 0; i < len; i++) parity_[i] ^= payload[i];
+    lengths_[count_] = static_cast<uint16_t>(len);
+    if (len > maxLen_) maxLen_ = len;
+    count_++;
+    return len + 1;
+}
+
+int XorFecEncoder::takeParity(uint8_t* out, int outSize, bool force) {
+    if (count_ == 0 || (!force && count_ < groupSize_)) return 0;
+
+    int total = 1 + 2 * count_ + maxLen_;
+    int written = 0;
+    if (total <= outSize) {
+        uint8_t* p = out;
+        *p++ = static_cast<uint8_t>(XOR_FEC_TAG_PARITY | (groupSeq_ << 4) | (count_ - 1));
+        for (int i = 0; i < count_; i++) {
+            *p++ = static_cast<uint8_t>(lengths_[i] >> 8);
+            *p++ = static_cast<uint8_t>(lengths_[i] & 0xFF);
+        }
+        std::memcpy(p, parity_, maxLen_);
+        written = total;
+    }
+    // An oversized parity is dropped; the group just goes unprotected
+
+    groupSeq_ = (groupSeq_ + 1) & 0x7;
+    resetGroup();
+    return written;
+}
+
+// --- Decoder ---
+
+void XorFecDecoder::reset() {
+    groupSeq_ = -1;
+    nextEmit_ = 0;
+    received_ = 0;
+}
+
+bool XorFecDecoder::feed(const uint8_t* data, int len, XorFecSink sink, void* ctx) {
+    if (len < 2) return false;
+    uint8_t tag = data[0];
+    int seq = (tag >> 4) & 0x7;
+    int low = tag & 0xF;
+
+    if (tag & XOR_FEC_TAG_PARITY) {
+        return handleParity(data + 1, len - 1, low + 1, seq, sink, ctx);
+    }
+
+    int payloadLen = len - 1;
+    if (payloadLen > XOR_FEC_MAX_PAYLOAD) return false;
+    if (seq != groupSeq_) startGroup(seq, sink, ctx);
+
+    uint32_t bit = 1u << low;
+    if (low < nextEmit_ || (received_ & bit)) return true;  // Duplicate or already skipped
+
+    std::memcpy(payloads_[low], data + 1, payloadLen);
+    lengths_[low] = static_cast<uint16_t>(payloadLen);
+    received_ |= bit;
+
+    // More than one hole ahead of this packet: parity can't fill both,
+    // so stop holding and pass on what we have.
+    int missing = 0;
+    for (int i = nextEmit_; i < low; i++) {
+        if (!(received_ & (1u << i))) missing++;
+    }
+    if (missing > 1) {
+        releaseFrom(nextEmit_, low + 1, sink, ctx);
+        return true;
+    }
+
+    while (nextEmit_ < XOR_FEC_MAX_GROUP && (received_ & (1u << nextEmit_))) {
+        sink(ctx, payloads_[nextEmit_], lengths_[nextEmit_], false);
+        nextEmit_++;
+    }
+    return true;
+}
+
+bool XorFecDecoder::handleParity(const uint8_t* body, int len, int size, int seq,
+                                 XorFecSink sink, void* ctx) {
+    int xorLen = len - 2 * size;
+    if (xorLen < 0) return false;
+    if (seq != groupSeq_) startGroup(seq, sink, ctx);
+
+    int missingIndex = -1;
+    int missing = 0;
+    for (int i = 0; i < size; i++) {
+        if (!(received_ & (1u << i))) {
+            missing++;
+            missingIndex = i;
+        }
+    }
+
+    // Rebuild only if the hole is still ahead of playout; once the
+    // packets around it have been passed on, it has already been concealed.
+    if (missing == 1 && missingIndex >= nextEmit_) {
+        int rebuiltLen = (body[2 * missingIndex] << 8) | body[2 * missingIndex + 1];
+        if (rebuiltLen > 0 && rebuiltLen <= xorLen && rebuiltLen <= XOR_FEC_MAX_PAYLOAD) {
+            uint8_t* out = payloads_[missingIndex];
+            std::memcpy(out, body + 2 * size, rebuiltLen);
+            for (int i = 0; i < size; i++) {
+                if (i == missingIndex) continue;
+                int n = lengths_[i] < rebuiltLen ? lengths_[i] : rebuiltLen;
+                for (int b = 0; b < n; b++) out[b] ^= payloads_[i][b];
+            }
+            lengths_[missingIndex] = static_cast<uint16_t>(rebuiltLen);
+            received_ |= 1u << missingIndex;
+
+            releaseFrom(nextEmit_, missingIndex, sink, ctx);
+            sink(ctx, out, rebuiltLen, true);
+            nextEmit_ = missingIndex + 1;
+        }
+    }
+
+    // The group is complete either way; late data for it is dropped
+    releaseFrom(nextEmit_, XOR_FEC_MAX_GROUP, sink, ctx);
+    return true;
+}
+
+void XorFecDecoder::flush(XorFecSink sink, void* ctx) {
+    if (groupSeq_ >= 0) releaseFrom(nextEmit_, XOR_FEC_MAX_GROUP, sink, ctx);
+}
+
+void XorFecDecoder::startGroup(int seq, XorFecSink sink, void* ctx) {
+    flush(sink, ctx);
+    groupSeq_ = seq;
+    nextEmit_ = 0;
+    received_ = 0;
+}
+
+void XorFecDecoder::releaseFrom(int index, int end, XorFecSink sink, void* ctx) {
+    for (int i = index; i < end; i++) {
+        if (received_ & (1u << i)) sink(ctx, payloads_[i], lengths_[i], false);
+    }
+    if (end > nextEmit_) nextEmit_ = end;
+}
@@ -0,0 +1,111 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_XOR_FEC_H
+#define LXST_XOR_FEC_H
+
+#include <cstdint>
+
+/**
+ * Cross-packet XOR parity FEC, independent of the codec.
+ *
+ * Every K data packets the sender emits one parity packet; the receiver
+ * can rebuild any single packet of the group from the other K-1 plus the
+ * parity. Overhead is 1/K packets (plus the length vector).
+ *
+ * Wire format (the LXST header byte carries FLAG_FEC; this is the payload
+ * that follows it):
+ *
+ *   tag:     bit 7    1 = parity, 0 = data
+ *            bits 4-6 group sequence mod 8
+ *            bits 0-3 data: index in group; parity: group size - 1
+ *   data:    [tag][codec payload]
+ *   parity:  [tag][uint16 BE length × groupSize][XOR of payloads,
+ *             each zero-padded to the longest]
+ *
+ * A group closed early (talk-spurt end) simply has a smaller size in its
+ * parity tag.
+ */
+constexpr int XOR_FEC_MAX_GROUP = 16;      // Fits the 4-bit index
+constexpr int XOR_FEC_MAX_PAYLOAD = 1500;  // Per codec payload
+constexpr uint8_t XOR_FEC_TAG_PARITY = 0x80;
+
+/**
+ * Sender side. Owned by the encoding thread.
+ */
+class XorFecEncoder {
+public:
+    /** @param groupSize Data packets per parity packet (2..XOR_FEC_MAX_GROUP; < 2 = off) */
+    void configure(int groupSize);
+
+    bool enabled() const { return groupSize_ >= 2; }
+
+    /**
+     * Frame one codec payload as a FEC data packet and fold it into the
+     * group's parity.
+     *
+     * @return Bytes written to out, or 0 if it doesn't fit
+     */
+    int wrapData(const uint8_t* payload, int len, uint8_t* out, int outSize);
+
+    /**
+     * Emit the parity packet once the group is full (or, with force, for
+     * a partial group) and start the next group.
+     *
+     * @return Bytes written to out, or 0 if no parity is due
+     */
+    int takeParity(uint8_t* out, int outSize, bool force = false);
+
+private:
+    void resetGroup();
+
+    int groupSize_ = 0;
+    int count_ = 0;       // Data packets in the current group
+    int groupSeq_ = 0;    // mod 8
+    int maxLen_ = 0;
+    uint16_t lengths_[XOR_FEC_MAX_GROUP] = {};
+    uint8_t parity_[XOR_FEC_MAX_PAYLOAD] = {};
+};
+
+/** Receives codec payloads in order. ctx is passed through unchanged. */
+typedef void (*XorFecSink)(void* ctx, const uint8_t* payload, int len, bool recovered);
+
+/**
+ * Receiver side. Owned by the thread that feeds packets in.
+ *
+ * Packets are passed on as soon as they arrive in order. After a single
+ * gap the rest of the group is held until its parity arrives, then the
+ * missing packet is rebuilt and the group released in order. A second
+ * loss, the next group starting, or a parity that shows more than one
+ * packet missing releases what is held without recovery, so the added
+ * delay is bounded by one group.
+ */
+class XorFecDecoder {
+public:
+    void reset();
+
+    /**
+     * Feed one FEC-framed packet (tag + body, LXST header stripped).
+     *
+     * @return false if the packet is malformed
+     */
+    bool feed(const uint8_t* data, int len, XorFecSink sink, void* ctx);
+
+    /** Release anything held (stream end). */
+    void flush(XorFecSink sink, void* ctx);
+
+private:
+    void startGroup(int seq, XorFecSink sink, void* ctx);
+    void releaseFrom(int index, int end, XorFecSink sink, void* ctx);
+    bool handleParity(const uint8_t* body, int len, int size, int seq,
+                      XorFecSink sink, void* ctx);
+
+    int groupSeq_ = -1;   // -1 = no group open
+    int nextEmit_ = 0;    // Packets before this index have been passed on
+    uint32_t received_ = 0;  // Bit per index present in payloads_
+    uint16_t lengths_[XOR_FEC_MAX_GROUP] = {};
+    uint8_t payloads_[XOR_FEC_MAX_GROUP][XOR_FEC_MAX_PAYLOAD] = {};
+};
+
+#endif // LXST_XOR_FEC_H
@@ -0,0 +1,81 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package tech.torlando.lxst.audio
+
+/**
+ * Packet arrivals of one call, in the playout tuner's trace format
+ * (lxst/tools/playout_tuner):
+ *
+ *     # profile=0x40 frame_us=60000
+ *     <seq> <arrival_us>
+ *
+ * Filled by [LinkSource] from [NativePlaybackEngine.takeArrivalTrace]. The
+ * engine sees packets before decoding, so frames carry no silence mark;
+ * the tuner then counts every frame as speech.
+ *
+ * Thread-safe: one thread adds while another may [format].
+ *
+ * @param profileId Profile id of the call
+ * @param frameUs Frame duration in µs
+ * @param maxPackets Arrivals kept; later ones are dropped (about an hour
+ *                   of 20ms frames by default)
+ */
+class ArrivalTrace(
+    val profileId: Int,
+    val frameUs: Int,
+    private val maxPackets: Int = MAX_PACKETS,
+) {
+    companion object {
+        const val MAX_PACKETS = 180_000
+    }
+
+    private val lock = Any()
+    private var seqs = LongArray(1024)
+    private var arrivals = LongArray(1024)
+    private var count = 0
+
+    /** Arrivals recorded so far. */
+    val size: Int get() = synchronized(lock) { count }
+
+    /** Add arrivals from [NativePlaybackEngine.takeArrivalTrace] pairs. */
+    fun addPairs(
+        pairs: LongArray,
+        n: Int,
+    ) {
+        synchronized(lock) {
+            for (i in 0 until n) add(pairs[2 * i], pairs[2 * i + 1])
+        }
+    }
+
+    /** Add one arrival: the sender's frame index and the receive time in µs. */
+    fun add(
+        seq: Long,
+        arrivalUs: Long,
+    ) {
+        synchronized(lock) {
+            if (count >= maxPackets) return
+            if (count == seqs.size) {
+                val grown = minOf(seqs.size * 2, maxPackets)
+                seqs = seqs.copyOf(grown)
+                arrivals = arrivals.copyOf(grown)
+            }
+            seqs[count] = seq
+            arrivals[count] = arrivalUs
+            count++
+        }
+    }
+
+    /** The trace as the tuner reads it. */
+    fun format(): String =
+        synchronized(lock) {
+            buildString(32 + count * 20) {
+                append("# profile=0x").append(profileId.toString(16).padStart(2, '0'))
+                append(" frame_us=").append(frameUs).append('\n')
+                for (i in 0 until count) {
+                    append(seqs[i]).append(' ').append(arrivals[i]).append('\n')
+                }
+            }
+        }
+}
@@ -0,0 +1,154 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package tech.torlando.lxst.audio
+
+/**
+ * Snapshot of the running end-to-end latency estimate.
+ *
+ * @param rttMs            Smoothed signalling round-trip time
+ * @param rttVarMs         Smoothed RTT variation (RFC 6298 style), a jitter proxy
+ * @param oneWayMs         Network one-way delay estimate (rttMs / 2)
+ * @param captureDelayMs   Capture-side delay (input latency + frame accumulation + TX queue)
+ * @param playoutDelayMs   Playout-side delay (jitter buffer + output pipeline latency)
+ * @param mouthToEarMs     Estimated delay from remote microphone to local speaker
+ * @param samples          Number of echo round trips folded into the estimate
+ */
+data class LatencyEstimate(
+    val rttMs: Int,
+    val rttVarMs: Int,
+    val oneWayMs: Int,
+    val captureDelayMs: Int,
+    val playoutDelayMs: Int,
+    val mouthToEarMs: Int,
+    val samples: Int,
+)
+
+/**
+ * In-band latency probe carried over the call signalling channel.
+ *
+ * Sends [Signalling.LATENCY_PROBE] + a 16-bit millisecond token; the peer
+ * answers with [Signalling.LATENCY_ECHO] + the same token. The token is the
+ * sender's own clock, so the round trip is measured without clock sync and
+ * wraps safely for RTTs under ~65 seconds.
+ *
+ * The network RTT is combined with local native knowledge — capture delay
+ * from the Oboe input stream and playout delay from the jitter buffer and
+ * Oboe output timestamp — into a mouth-to-ear estimate:
+ *
+ *   mouthToEar = remote capture delay + RTT/2 + local playout delay
+ *
+ * The remote capture delay is not observable from here; it is approximated
+ * by the local capture delay (both ends run the same engine and profile).
+ *
+ * Threading: [handleSignal] is called from the transport thread, [sendProbe]
+ * and [updateLocalDelays] from the Telephone scope. State is guarded by a lock
+ * since updates are a few times per second at most.
+ *
+ * @param sendSignal Sends a signal to the remote peer (e.g. NetworkTransport.sendSignal)
+ * @param clockMs    Monotonic millisecond clock (injectable for tests)
+ */
+class LatencyProbe(
+    private val sendSignal: (Int) -> Unit,
+    private val clockMs: () -> Long = { System.nanoTime() / 1_000_000 },
+) {
+    companion object {
+        /** Round trips longer than this are treated as stale and discarded. */
+        const val MAX_RTT_MS = 30_000
+
+        // RFC 6298 smoothing gains (alpha = 1/8, beta = 1/4)
+        private const val RTT_ALPHA = 0.125
+        private const val RTT_BETA = 0.25
+    }
+
+    private val lock = Any()
+    private var srttMs = 0.0
+    private var rttVarMs = 0.0
+    private var sampleCount = 0
+    private var captureDelayMs = 0
+    private var playoutDelayMs = 0
+
+    /** Send a probe carrying the current clock as token. */
+    fun sendProbe() {
+        val token = (clockMs() and Signalling.LATENCY_TOKEN_MASK.toLong()).toInt()
+        sendSignal(Signalling.LATENCY_PROBE + token)
+    }
+
+    /**
+     * Handle a signal if it belongs to the latency probe.
+     *
+     * Probes are echoed back immediately; echoes update the RTT estimate.
+     *
+     * @return true if the signal was consumed
+     */
+    fun handleSignal(signal: Int): Boolean {
+        if (!Signalling.isLatencySignal(signal)) return false
+        val token = signal and Signalling.LATENCY_TOKEN_MASK
+        if (signal < Signalling.LATENCY_ECHO) {
+            sendSignal(Signalling.LATENCY_ECHO + token)
+        } else {
+            val now = (clockMs() and Signalling.LATENCY_TOKEN_MASK.toLong()).toInt()
+            val rtt = (now - token) and Signalling.LATENCY_TOKEN_MASK
+            if (rtt <= MAX_RTT_MS) addRttSample(rtt)
+        }
+        return true
+    }
+
+    /**
+     * Update the local (native) delay components.
+     *
+     * @param captureDelayMs Capture-side delay from NativeCaptureEngine
+     * @param playoutDelayMs Playout-side delay from NativePlaybackEngine
+     */
+    fun updateLocalDelays(
+        captureDelayMs: Int,
+        playoutDelayMs: Int,
+    ) {
+        synchronized(lock) {
+            this.captureDelayMs = captureDelayMs.coerceAtLeast(0)
+            this.playoutDelayMs = playoutDelayMs.coerceAtLeast(0)
+        }
+    }
+
+    /** Current estimate, or null until the first echo has arrived. */
+    val estimate: LatencyEstimate?
+        get() =
+            synchronized(lock) {
+                if (sampleCount == 0) return null
+                val oneWay = (srttMs / 2).toInt()
+                LatencyEstimate(
+                    rttMs = srttMs.toInt(),
+                    rttVarMs = rttVarMs.toInt(),
+                    oneWayMs = oneWay,
+                    captureDelayMs = captureDelayMs,
+                    playoutDelayMs = playoutDelayMs,
+                    mouthToEarMs = captureDelayMs + oneWay + playoutDelayMs,
+                    samples = sampleCount,
+                )
+            }
+
+    /** Forget all samples (call end). */
+    fun reset() {
+        synchronized(lock) {
+            srttMs = 0.0
+            rttVarMs = 0.0
+            sampleCount = 0
+            captureDelayMs = 0
+            playoutDelayMs = 0
+        }
+    }
+
+    private fun addRttSample(rttMs: Int) {
+        synchronized(lock) {
+            if (sampleCount == 0) {
+                srttMs = rttMs.toDouble()
+                rttVarMs = rttMs / 2.0
+            } else {
+                rttVarMs = (1 - RTT_BETA) * rttVarMs + RTT_BETA * kotlin.math.abs(srttMs - rttMs)
+                srttMs = (1 - RTT_ALPHA) * srttMs + RTT_ALPHA * rttMs
+            }
+            sampleCount++
+        }
+    }
+}
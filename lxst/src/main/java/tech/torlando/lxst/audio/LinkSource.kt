@@ -48,31 +48,61 @@ class LinkSource(
         /** Maximum packets in queue before dropping oldest (backpressure) */
         const val MAX_PACKETS = 32
 
-        /** Minimum prebuffer frames (floor for any profile). */
+        /**
+         * Minimum prebuffer depth in frames (floor for any profile).
+         *
+         * The same five-frame floor as the frame-count prebuffer this
+         * replaced: Codec2 long-frame profiles (LBW, VLBW, ULBW) keep the
+         * depth they have always had, so switching to milliseconds changes
+         * only the profiles whose 450ms target is above the floor.
+         */
         const val MIN_PREBUFFER_FRAMES = 5
 
         /**
          * Target prebuffer time in milliseconds.
          *
-         * Used by [computePrebufferFrames] to calculate the number of decoded
-         * frames to accumulate before auto-starting the Oboe playback stream.
+         * Audio to accumulate before auto-starting the Oboe playback stream;
+         * also the level the native engine drains back to after bursts.
          * Must be large enough to absorb Reticulum network jitter (~100-185ms RTT)
-         * plus Oboe startup latency. 450ms provides ~7 frames for MQ (60ms),
-         * trading ~150ms additional one-way latency for significantly less
-         * ring buffer starvation on high-jitter links.
+         * plus Oboe startup latency. 450ms trades ~150ms additional one-way
+         * latency for significantly less ring buffer starvation on high-jitter links.
          */
         const val PREBUFFER_TARGET_MS = 450
 
+        /** Native ring capacity in milliseconds (before the drain-headroom floor). */
+        const val MAX_BUFFER_MS = 1500
+
+        /**
+         * Compute the prebuffer time for a given profile frame time.
+         *
+         * [PREBUFFER_TARGET_MS] for every profile, except that long-frame
+         * profiles get at least [MIN_PREBUFFER_FRAMES] frames (ULBW: 400ms →
+         * 2000ms). The native engine budgets in samples, so the result is
+         * honoured exactly rather than rounded to whole frames.
+         */
+        fun computePrebufferMs(frameTimeMs: Int): Int = maxOf(PREBUFFER_TARGET_MS, MIN_PREBUFFER_FRAMES * frameTimeMs)
+
         /**
-         * Compute the prebuffer frame count for a given profile frame time.
+         * Compute the native ring capacity for a given profile frame time.
          *
-         * Returns at least [MIN_PREBUFFER_FRAMES] frames, targeting
-         * [PREBUFFER_TARGET_MS] of buffered audio. For profiles with large
-         * frames (MQ: 60ms → 5 frames = 300ms) this matches the old fixed
-         * value. For low-latency profiles (ULL: 10ms → 30 frames = 300ms)
-         * this provides adequate jitter absorption.
+         * [MAX_BUFFER_MS], raised if needed so the default drain threshold
+         * (2 × prebuffer) plus one incoming frame always fits.
          */
-        fun computePrebufferFrames(frameTimeMs: Int): Int = maxOf(MIN_PREBUFFER_FRAMES, PREBUFFER_TARGET_MS / frameTimeMs)
+        fun computeMaxBufferMs(frameTimeMs: Int): Int = maxOf(MAX_BUFFER_MS, 2 * computePrebufferMs(frameTimeMs) + frameTimeMs)
+
+        /**
+         * Oldest audio worth sending to a peer: past its drain threshold
+         * the receiver would only discard it. Used as the sender's TX age
+         * limit. The threshold comes from the same tuned policy row the
+         * receiver loads for this profile (both ends share the table), or
+         * the defaults (2 × [computePrebufferMs]) without one.
+         *
+         * @param playoutPolicy The profile's [NativePlayoutPolicy] row, or null
+         */
+        fun computeTxMaxAgeMs(
+            frameTimeMs: Int,
+            playoutPolicy: IntArray? = null,
+        ): Int = NativePlayoutPolicy.drainThresholdMs(playoutPolicy, computePrebufferMs(frameTimeMs))
     }
 
     // RemoteSource properties
@@ -105,25 +135,53 @@ class LinkSource(
     var useNativeCodec: Boolean = false
 
     /**
-     * Number of decoded frames to accumulate before auto-starting the Oboe stream.
+     * Milliseconds of decoded audio to accumulate before auto-starting the Oboe stream.
      *
      * Set by Telephone based on the active profile's frame time via
-     * [computePrebufferFrames]. Low-latency profiles (ULL: 10ms) need many
-     * more frames (30) than standard profiles (MQ: 60ms → 5) to achieve
-     * the same ~300ms of jitter absorption.
+     * [computePrebufferMs]. Time-based so every profile gets the same
+     * jitter absorption regardless of frame size.
      */
     @Volatile
-    var prebufferFrames: Int = MIN_PREBUFFER_FRAMES
+    var prebufferMs: Int = PREBUFFER_TARGET_MS
 
     /**
      * Phase 3: When true, auto-start the native playback stream after
-     * [prebufferFrames] decoded frames have accumulated in the ring buffer.
+     * [prebufferMs] of decoded audio has accumulated in the ring buffer.
      *
      * Mirrors the Phase 2 pattern where OboeLineSink defers startStream() until
      * the buffer has enough data to prevent callback starvation.
      */
     @Volatile
     var deferPlaybackStart: Boolean = false
+
+    /**
+     * Phase 3: send the native engine's NACK requests to the peer as
+     * [Signalling.NACK] signals. The engine only raises them for packets
+     * with the header extension, once [NativePlaybackEngine.setNackRttMs] is set.
+     */
+    @Volatile
+    var nackEnabled: Boolean = false
+    private val nackSeqs = IntArray(16)
+
+    /**
+     * Phase 3: packet arrivals for the playout tuner, drained from the
+     * native engine after each packet with the header extension (null =
+     * off). Enable recording with [NativePlaybackEngine.setArrivalTrace].
+     */
+    @Volatile
+    var arrivalTrace: ArrivalTrace? = null
+    private val tracePairs = LongArray(2 * 64)
+
+    /**
+     * Codec header byte the decoder expects, flags aside (null = accept
+     * any). Packets for another codec are dropped rather than decoded as
+     * noise: a profile can map to different codecs on the two paths (LAN
+     * is G.722 natively but PCM16 in Phase 2), so the peers may disagree.
+     */
+    @Volatile
+    var codecHeader: Byte? = null
+    private var codecMismatchCount = 0
+
     private val playbackStarted = AtomicBoolean(false)
     private val packetQueue = ArrayDeque<ByteArray>(MAX_PACKETS)
     private val receiveLock = Any()
@@ -185,21 +243,41 @@ class LinkSource(
             Log.d(TAG, "RX: decoded=$debugPacketCount received=$received dropped=${received - debugPacketCount}")
         }
 
+        val expectedCodec = codecHeader
+        if (expectedCodec != null && Packetizer.headerCodec(data[0]) != expectedCodec) {
+            codecMismatchCount++
+            if (codecMismatchCount == 1 || codecMismatchCount % 100 == 0) {
+                val header = data[0].toInt() and 0xFF
+                Log.w(TAG, "Dropping packet for another codec: hdr=0x${header.toString(16)} (x$codecMismatchCount)")
+            }
+            return
+        }
+
+        val flags = Packetizer.headerFlags(data[0])
+
         if (useNativeCodec) {
             // Phase 3: Send encoded data directly to native playback engine.
             // Skip header byte via offset parameter (no copyOfRange allocation).
             try {
-                NativePlaybackEngine.writeEncodedPacket(data, 1, data.size - 1)
+                NativePlaybackEngine.writeEncodedPacket(data, 1, data.size - 1, flags)
+                if (nackEnabled && (flags and Packetizer.FLAG_EXT) != 0) {
+                    val n = NativePlaybackEngine.takeNackRequests(nackSeqs)
+                    for (i in 0 until n) bridge.sendSignal(Signalling.NACK + nackSeqs[i])
+                }
+                val trace = arrivalTrace
+                if (trace != null && (flags and Packetizer.FLAG_EXT) != 0) {
+                    trace.addPairs(tracePairs, NativePlaybackEngine.takeArrivalTrace(tracePairs))
+                }
 
                 // Auto-start playback stream once prebuffer has accumulated.
                 // Mirrors Phase 2's OboeLineSink pattern: defer startStream() until
                 // the ring buffer has enough data to prevent callback starvation.
                 if (deferPlaybackStart && !playbackStarted.get()) {
-                    val buffered = NativePlaybackEngine.getBufferedFrameCount()
-                    if (buffered >= prebufferFrames) {
+                    val bufferedMs = NativePlaybackEngine.getBufferedMs()
+                    if (bufferedMs >= prebufferMs) {
                         if (playbackStarted.compareAndSet(false, true)) {
                             val started = NativePlaybackEngine.startStream()
-                            Log.i(TAG, "Auto-started native playback: prebuf=$buffered/$prebufferFrames, ok=$started")
+                            Log.i(TAG, "Auto-started native playback: prebuf=${bufferedMs}ms/${prebufferMs}ms, ok=$started")
                         }
                     }
                 }
@@ -209,7 +287,17 @@ class LinkSource(
         } else {
             // Phase 2: Kotlin codec decode → float32 → Mixer → sink
             val currentSink = sink ?: return
-            val frameData = data.copyOfRange(1, data.size)
+            // No reorder or FEC receiver here: step over the extension and
+            // the FEC tag, skip parity
+            var start = 1
+            if ((flags and Packetizer.FLAG_EXT) != 0) start += Packetizer.HEADER_EXT_BYTES
+            if ((flags and Packetizer.FLAG_FEC) != 0) {
+                if (start >= data.size) return
+                if ((data[start].toInt() and Packetizer.FEC_TAG_PARITY) != 0) return
+                start++
+            }
+            if (start >= data.size) return
+            val frameData = data.copyOfRange(start, data.size)
 
             try {
                 val decodedFrame = codec.decode(frameData)
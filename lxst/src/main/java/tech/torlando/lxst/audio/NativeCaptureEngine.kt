@@ -5,6 +5,7 @@
 package tech.torlando.lxst.audio
 
 import android.util.Log
+import java.nio.FloatBuffer
 
 /**
  * JNI bridge to the native Oboe capture engine (lxst_capture_engine.so).
@@ -19,6 +20,12 @@ import android.util.Log
 object NativeCaptureEngine {
     private const val TAG = "LXST:NativeCapture"
 
+    /** Audio replayed ahead of live frames on PTT key-down. */
+    const val DEFAULT_PTT_PREROLL_MS = 300
+
+    /** Packets [setTxPacing] lets go back to back: covers FEC parity and a retransmit. */
+    const val DEFAULT_TX_PACING_BURST = 3
+
     @Volatile
     private var libraryLoaded = false
 
@@ -45,18 +52,18 @@ object NativeCaptureEngine {
      * @param sampleRate      Input sample rate (e.g., 48000)
      * @param channels        Number of channels (1=mono)
      * @param frameSamples    Number of int16 samples per LXST frame
-     * @param maxBufferFrames Maximum frames in ring buffer
+     * @param maxBufferMs     Maximum audio held in the ring buffer
      * @param enableFilters   Enable native HPF/LPF/AGC filter chain
      */
     fun create(
         sampleRate: Int,
         channels: Int,
         frameSamples: Int,
-        maxBufferFrames: Int,
+        maxBufferMs: Int,
         enableFilters: Boolean,
     ): Boolean {
         ensureLoaded()
-        return nativeCreate(sampleRate, channels, frameSamples, maxBufferFrames, enableFilters)
+        return nativeCreate(sampleRate, channels, frameSamples, maxBufferMs, enableFilters)
     }
 
     /**
@@ -67,6 +74,22 @@ object NativeCaptureEngine {
      */
     fun readSamples(dest: ShortArray): Boolean = nativeReadSamples(dest)
 
+    /**
+     * Read one frame as float32 with gain applied (Phase 2 path).
+     *
+     * Conversion and gain run natively in one pass out of the ring slot.
+     *
+     * @param dest  Direct FloatBuffer, filled from index 0
+     * @param count Number of samples (must equal frameSamples)
+     * @param gain  Linear gain (1.0 = unity)
+     * @return true if a frame was read, false if buffer is empty
+     */
+    fun readSamplesFloat(
+        dest: FloatBuffer,
+        count: Int,
+        gain: Float = 1.0f,
+    ): Boolean = nativeReadSamplesFloat(dest, count, gain)
+
     /** Open and start the Oboe input stream. */
     fun startStream(): Boolean = nativeStartStream()
 
@@ -85,6 +108,12 @@ object NativeCaptureEngine {
     /** Cumulative xrun count from the Oboe input stream. */
     fun getXRunCount(): Int = nativeGetXRunCount()
 
+    /**
+     * Estimated capture delay in milliseconds: Oboe input latency plus one
+     * frame of accumulation plus frames queued for the consumer.
+     */
+    fun getCaptureDelayMs(): Int = nativeGetCaptureDelayMs()
+
     // --- Phase 3: Native codec methods ---
 
     /**
@@ -92,36 +121,50 @@ object NativeCaptureEngine {
      *
      * When configured, the Oboe callback encodes directly after filtering.
      * Use readEncodedPacket() instead of readSamples() to get encoded output.
+     *
+     * @param codecConfig   Codec in the [NativeCodecConfig] layout
+     *                      (NativeCodecParams.toConfigArray). Its DRED span
+     *                      is the Opus DRED redundancy carried per packet (0 = off).
+     * @param fecGroupSize  Send one XOR parity packet per this many packets
+     *                      (0 = off). Packets are then FEC framed; the header
+     *                      must carry [Packetizer.FLAG_FEC].
+     * @param codec2Interleave Spread Codec2 sub-frames across consecutive
+     *                      packets so a loss leaves short scattered holes
+     *                      (one extra frame of latency; ignored for Opus)
+     * @param headerExt     Prefix every packet with the sequence/timestamp
+     *                      extension; the header must carry [Packetizer.FLAG_EXT].
      */
     fun configureEncoder(
-        codecType: Int,
-        sampleRate: Int,
-        channels: Int,
-        opusApp: Int = 0,
-        opusBitrate: Int = 0,
-        opusComplexity: Int = 10,
-        codec2Mode: Int = 0,
+        codecConfig: IntArray,
+        fecGroupSize: Int = 0,
+        codec2Interleave: Boolean = false,
+        headerExt: Boolean = false,
     ): Boolean {
         ensureLoaded()
-        return nativeConfigureEncoder(
-            codecType,
-            sampleRate,
-            channels,
-            opusApp,
-            opusBitrate,
-            opusComplexity,
-            codec2Mode,
-        )
+        return nativeConfigureEncoder(codecConfig, fecGroupSize, codec2Interleave, headerExt)
     }
 
     /**
      * Read one encoded packet from the native encoded ring buffer.
+     * Packets past the [setTxMaxAgeMs] limit are dropped first.
      *
      * @param dest ByteArray to fill with encoded data
      * @return Number of bytes read, or 0 if buffer is empty
      */
     fun readEncodedPacket(dest: ByteArray): Int = nativeReadEncodedPacket(dest)
 
+    /**
+     * Blocking [readEncodedPacket] for a dedicated reader: waits up to
+     * [timeoutMs] for a packet and, with [setTxPacing] on, for the pacer
+     * to release it. Blocks the calling thread; use from Dispatchers.IO.
+     *
+     * @return Number of bytes read, or 0 on timeout or once the stream has stopped
+     */
+    fun readEncodedPacketBlocking(
+        dest: ByteArray,
+        timeoutMs: Int,
+    ): Int = nativeReadEncodedPacketBlocking(dest, timeoutMs)
+
     /**
      * Set capture mute state.
      *
@@ -132,6 +175,96 @@ object NativeCaptureEngine {
         nativeSetCaptureMute(mute)
     }
 
+    /**
+     * Enable or disable push-to-talk gating.
+     *
+     * While enabled and not keyed, the stream and filters keep running but
+     * nothing is encoded; the last [prerollMs] of filtered audio is held and
+     * sent ahead of live frames on key-down. State persists across
+     * configureEncoder().
+     */
+    fun setPttMode(
+        enabled: Boolean,
+        prerollMs: Int = DEFAULT_PTT_PREROLL_MS,
+    ) {
+        ensureLoaded()
+        nativeSetPttMode(enabled, prerollMs)
+    }
+
+    /** PTT key down (true) or up (false). Ignored outside PTT mode. */
+    fun setPttKeyed(keyed: Boolean) {
+        ensureLoaded()
+        nativeSetPttKeyed(keyed)
+    }
+
+    /**
+     * Thermal headroom hint (PowerManager.getThermalHeadroom: 0 = cool,
+     * 1.0 = severe throttling; NaN = unknown). Caps the Opus encoder
+     * complexity the native governor may choose. Persists across
+     * configureEncoder().
+     */
+    fun setThermalHeadroom(headroom: Float) {
+        ensureLoaded()
+        nativeSetThermalHeadroom(headroom)
+    }
+
+    /** Opus encoder complexity currently chosen by the native governor (0 if none). */
+    fun getEncoderComplexity(): Int = nativeGetEncoderComplexity()
+
+    /**
+     * Resend a recently sent packet the peer NACKed, by header-extension
+     * sequence number. Needs the encoder configured with headerExt; packets
+     * too old for the native cache are skipped.
+     *
+     * @return false if the native request queue is full
+     */
+    fun requestRetransmit(seq: Int): Boolean = nativeRequestRetransmit(seq)
+
+    /** Packets resent on request since the encoder was configured. */
+    fun getRetransmitCount(): Int = nativeGetRetransmitCount()
+
+    /**
+     * Drop encoded packets that have waited longer than [maxAgeMs] since
+     * capture instead of returning them from [readEncodedPacket], so the
+     * queue recovers at once after a link stall. 0 = off. Persists across
+     * configureEncoder().
+     */
+    fun setTxMaxAgeMs(maxAgeMs: Int) {
+        ensureLoaded()
+        nativeSetTxMaxAgeMs(maxAgeMs)
+    }
+
+    /**
+     * Packet loss for the Opus DRED encoder to plan for, in percent; DRED
+     * is given no bits at 0. Feed it the loss measured on the receive side
+     * ([NativePlaybackEngine.getLossPermille]). -1 = not measured. Persists
+     * across configureEncoder().
+     */
+    fun setExpectedLossPct(pct: Int) {
+        ensureLoaded()
+        nativeSetExpectedLossPct(pct)
+    }
+
+    /**
+     * Pace [readEncodedPacketBlocking] to the encoder's packet rate, letting
+     * up to [burstPackets] go back to back after idle, so a reader that
+     * fell behind doesn't burst a slow interface. 0 = off. Persists across
+     * configureEncoder().
+     */
+    fun setTxPacing(burstPackets: Int) {
+        ensureLoaded()
+        nativeSetTxPacing(burstPackets)
+    }
+
+    /** Packets dropped by the TX age limit since the encoder was configured. */
+    fun getStaleDropCount(): Int = nativeGetStaleDropCount()
+
+    /**
+     * Native memory in bytes since the engine was created, current and peak
+     * per component; see [NativeMemory] for the layout. All zero if no engine.
+     */
+    fun getMemoryStats(): IntArray = nativeGetMemoryStats()
+
     /** Destroy the native encoder, freeing codec resources. */
     fun destroyEncoder() {
         ensureLoaded()
@@ -144,12 +277,18 @@ object NativeCaptureEngine {
         sampleRate: Int,
         channels: Int,
         frameSamples: Int,
-        maxBufferFrames: Int,
+        maxBufferMs: Int,
         enableFilters: Boolean,
     ): Boolean
 
     private external fun nativeReadSamples(dest: ShortArray): Boolean
 
+    private external fun nativeReadSamplesFloat(
+        dest: FloatBuffer,
+        count: Int,
+        gain: Float,
+    ): Boolean
+
     private external fun nativeStartStream(): Boolean
 
     private external fun nativeStopStream()
@@ -162,20 +301,49 @@ object NativeCaptureEngine {
 
     private external fun nativeGetXRunCount(): Int
 
+    private external fun nativeGetCaptureDelayMs(): Int
+
     // Phase 3: Native codec JNI methods
     private external fun nativeConfigureEncoder(
-        codecType: Int,
-        sampleRate: Int,
-        channels: Int,
-        opusApp: Int,
-        opusBitrate: Int,
-        opusComplexity: Int,
-        codec2Mode: Int,
+        codecConfig: IntArray,
+        fecGroupSize: Int,
+        codec2Interleave: Boolean,
+        headerExt: Boolean,
     ): Boolean
 
     private external fun nativeReadEncodedPacket(dest: ByteArray): Int
 
+    private external fun nativeReadEncodedPacketBlocking(
+        dest: ByteArray,
+        timeoutMs: Int,
+    ): Int
+
     private external fun nativeSetCaptureMute(mute: Boolean)
 
+    private external fun nativeSetPttMode(
+        enabled: Boolean,
+        prerollMs: Int,
+    )
+
+    private external fun nativeSetPttKeyed(keyed: Boolean)
+
+    private external fun nativeSetThermalHeadroom(headroom: Float)
+
+    private external fun nativeGetEncoderComplexity(): Int
+
+    private external fun nativeRequestRetransmit(seq: Int): Boolean
+
+    private external fun nativeGetRetransmitCount(): Int
+
+    private external fun nativeSetTxMaxAgeMs(maxAgeMs: Int)
+
+    private external fun nativeSetTxPacing(burstPackets: Int)
+
+    private external fun nativeSetExpectedLossPct(pct: Int)
+
+    private external fun nativeGetStaleDropCount(): Int
+
+    private external fun nativeGetMemoryStats(): IntArray
+
     private external fun nativeDestroyEncoder()
 }
@@ -0,0 +1,45 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package tech.torlando.lxst.audio
+
+/**
+ * Layout of the codec config array taken by [NativeCaptureEngine.configureEncoder]
+ * and [NativePlaybackEngine.configureDecoder] (codec_backend.h): one int per
+ * field. Native code fills fields missing from the end of a shorter array
+ * with defaults, so new fields go at the end.
+ *
+ * Built from a profile by NativeCodecParams.toConfigArray().
+ */
+object NativeCodecConfig {
+    /** Codec type, Profile.CODEC_TYPE_* (C++ CodecType). */
+    const val TYPE = 0
+
+    const val SAMPLE_RATE = 1
+
+    const val CHANNELS = 2
+
+    /** Opus application (VOIP/AUDIO/RESTRICTED_LOWDELAY); Opus only. */
+    const val OPUS_APPLICATION = 3
+
+    /** Opus bitrate in bps; Opus only. */
+    const val OPUS_BITRATE = 4
+
+    /** Opus encoder complexity (0-10), the governor's ceiling; Opus only. */
+    const val OPUS_COMPLEXITY = 5
+
+    /** Codec2 library mode; Codec2 only. */
+    const val CODEC2_MODE = 6
+
+    /** Opus DRED span in ms (0 = off); Opus only. */
+    const val DRED_DURATION_MS = 7
+
+    const val FIELDS = 8
+
+    /** Codec type of a config array, 0 if empty. */
+    fun codecType(config: IntArray): Int = config.getOrElse(TYPE) { 0 }
+
+    /** Sample rate of a config array, 0 if missing. */
+    fun sampleRate(config: IntArray): Int = config.getOrElse(SAMPLE_RATE) { 0 }
+}
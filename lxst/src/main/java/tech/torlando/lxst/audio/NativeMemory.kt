@@ -0,0 +1,58 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package tech.torlando.lxst.audio
+
+/**
+ * Layout of the native memory stats returned by
+ * [NativePlaybackEngine.getMemoryStats] and [NativeCaptureEngine.getMemoryStats]
+ * (memory_ledger.h): current and peak bytes per component, then the total.
+ *
+ * Counts cover one engine since it was created, so the peaks of the
+ * playback engine are those of one call. Codec2 state is allocated inside
+ * the library and is not included.
+ */
+object NativeMemory {
+    /** Engine object: fixed packet buffers, reorder window, queues. */
+    const val ENGINE = 0
+
+    /** Decoded/captured PCM ring buffer. */
+    const val PCM_RING = 1
+
+    /** Encoded packet ring buffer. */
+    const val ENCODED_RING = 2
+
+    /** Codec wrapper and Opus encoder/decoder/DRED states. */
+    const val CODEC = 3
+
+    /** Capture voice filters. */
+    const val FILTERS = 4
+
+    /** Decode, PLC, DRED, pre-roll and retransmit buffers. */
+    const val SCRATCH = 5
+
+    const val COMPONENTS = 6
+
+    /** Pseudo-component for the sum of all components. */
+    const val TOTAL = COMPONENTS
+
+    const val STATS_FIELDS = (COMPONENTS + 1) * 2
+
+    private val NAMES = arrayOf("engine", "pcmRing", "encRing", "codec", "filters", "scratch", "total")
+
+    fun currentBytes(stats: IntArray, component: Int): Int = stats.getOrElse(2 * component) { 0 }
+
+    fun peakBytes(stats: IntArray, component: Int): Int = stats.getOrElse(2 * component + 1) { 0 }
+
+    /** One-line summary for logs: "total=…/…KB engine=…/…KB …" (current/peak). */
+    fun describe(stats: IntArray): String {
+        if (stats.size < STATS_FIELDS) return "n/a"
+        val order = listOf(TOTAL) + (0 until COMPONENTS)
+        return order.joinToString(" ") { c ->
+            "${NAMES[c]}=${kb(currentBytes(stats, c))}/${kb(peakBytes(stats, c))}KB"
+        }
+    }
+
+    private fun kb(bytes: Int): Int = (bytes + 1023) / 1024
+}
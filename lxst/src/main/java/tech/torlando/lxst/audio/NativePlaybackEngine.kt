@@ -5,6 +5,7 @@
 package tech.torlando.lxst.audio
 
 import android.util.Log
+import java.nio.FloatBuffer
 
 /**
  * JNI bridge to the native Oboe playback engine (lxst_playback_engine.so).
@@ -41,23 +42,59 @@ object NativePlaybackEngine {
     /**
      * Create the native engine with audio parameters.
      *
-     * @param sampleRate      Output sample rate (e.g., 48000)
-     * @param channels        Number of channels (1=mono, 2=stereo)
-     * @param frameSamples    Number of int16 samples per LXST frame
-     * @param maxBufferFrames Maximum frames in ring buffer
-     * @param prebufferFrames Frames to accumulate before starting playback
+     * Buffer policy is time-based so latency is consistent across profiles
+     * (5ms XLL to 400ms ULBW frames); the native side tracks samples and
+     * drains with sub-frame granularity.
+     *
+     * @param sampleRate       Output sample rate (e.g., 48000)
+     * @param channels         Number of channels (1=mono, 2=stereo)
+     * @param frameSamples     Number of int16 samples per LXST frame
+     * @param prebufferMs      Audio to accumulate before playback; also the drain target
+     * @param maxBufferMs      Maximum audio held in the ring buffer
+     * @param drainThresholdMs Depth that triggers a drain back to [prebufferMs];
+     *                         0 lets the playout policy choose (default 2 × prebufferMs)
+     * @param peerProfile      Summary from [exportPeerProfile] on an earlier call
+     *                         with the same peer. Replaces [prebufferMs] (and the
+     *                         drain threshold) with values sized to the peer's
+     *                         measured jitter; read the result back with
+     *                         [getPrebufferMs]. Null or stale keeps the static policy.
+     * @param playoutPolicy    Drain, PLC and output buffer policy ([NativePlayoutPolicy]),
+     *                         e.g. the profile's row of a tuned table. Its prebuffer,
+     *                         if set, replaces [prebufferMs]. Null keeps the defaults.
      */
     fun create(
         sampleRate: Int,
         channels: Int,
         frameSamples: Int,
-        maxBufferFrames: Int,
-        prebufferFrames: Int,
+        prebufferMs: Int,
+        maxBufferMs: Int,
+        drainThresholdMs: Int = 0,
+        peerProfile: IntArray? = null,
+        playoutPolicy: IntArray? = null,
     ): Boolean {
         ensureLoaded()
-        return nativeCreate(sampleRate, channels, frameSamples, maxBufferFrames, prebufferFrames)
+        return nativeCreate(
+            sampleRate,
+            channels,
+            frameSamples,
+            prebufferMs,
+            maxBufferMs,
+            drainThresholdMs,
+            peerProfile,
+            playoutPolicy,
+        )
     }
 
+    /** Prebuffer target in effect, after any peer profile seed. */
+    fun getPrebufferMs(): Int = nativeGetPrebufferMs()
+
+    /**
+     * Jitter/loss summary of this call's link, folded into the seed passed
+     * to [create], or null if too little was measured. Call before
+     * [destroyDecoder], which clears the measurements.
+     */
+    fun exportPeerProfile(): IntArray? = nativeExportPeerProfile()
+
     /**
      * Write decoded int16 samples into the native ring buffer.
      *
@@ -66,6 +103,20 @@ object NativePlaybackEngine {
      */
     fun writeSamples(samples: ShortArray): Boolean = nativeWriteSamples(samples)
 
+    /**
+     * Write float32 samples into the native ring buffer (Phase 2 path).
+     *
+     * Conversion to int16 happens natively, straight into the ring slot.
+     *
+     * @param buffer Direct FloatBuffer holding the frame from index 0
+     * @param count  Number of samples (must equal frameSamples)
+     * @return true if written without drop, false if oldest frame was dropped
+     */
+    fun writeSamplesFloat(
+        buffer: FloatBuffer,
+        count: Int,
+    ): Boolean = nativeWriteSamplesFloat(buffer, count)
+
     /** Open and start the Oboe output stream. */
     fun startStream(): Boolean {
         ensureLoaded()
@@ -98,6 +149,9 @@ object NativePlaybackEngine {
     /** Number of frames currently buffered in the native ring buffer. */
     fun getBufferedFrameCount(): Int = nativeGetBufferedFrameCount()
 
+    /** Milliseconds of audio buffered ahead of the Oboe callback. */
+    fun getBufferedMs(): Int = nativeGetBufferedMs()
+
     /** True if the Oboe stream is open and playing. */
     fun isPlaying(): Boolean = nativeIsPlaying()
 
@@ -113,38 +167,83 @@ object NativePlaybackEngine {
     /** Callbacks that used Opus PLC instead of silence (diagnostic). */
     fun getCallbackPlcCount(): Int = nativeGetCallbackPlcCount()
 
+    /**
+     * Estimated playout delay in milliseconds: ring buffer depth plus the
+     * Oboe output pipeline latency (from AudioStream::getTimestamp).
+     */
+    fun getPlayoutDelayMs(): Int = nativeGetPlayoutDelayMs()
+
+    /** Bucket width of [getResidenceHistogram] in microseconds. */
+    const val RESIDENCE_BUCKET_US = 25_000
+
+    /** Bucket width of [getOutputLatencyHistogram] in microseconds. */
+    const val OUTPUT_LATENCY_BUCKET_US = 5_000
+
+    /**
+     * Per-frame ring buffer residence time (arrival → callback dequeue).
+     *
+     * Bucket i counts frames in [i, i+1) × [RESIDENCE_BUCKET_US]; the last
+     * bucket is open-ended. Separates network jitter/prebuffer from device latency.
+     */
+    fun getResidenceHistogram(): IntArray = nativeGetResidenceHistogram()
+
+    /**
+     * Per-frame output pipeline latency (callback dequeue → speaker), from
+     * AudioStream::getTimestamp. Bucket layout as above with [OUTPUT_LATENCY_BUCKET_US].
+     */
+    fun getOutputLatencyHistogram(): IntArray = nativeGetOutputLatencyHistogram()
+
+    /** Bucket width of [getDredCostHistogram] in microseconds. */
+    const val DRED_COST_BUCKET_US = 250
+
+    /**
+     * Opus DRED decode cost per rebuilt frame, bucketed by [DRED_COST_BUCKET_US].
+     * Compare against the profile's frame time to judge whether the decoder
+     * budget allows DRED; the same summary is logged when the decoder is torn down.
+     */
+    fun getDredCostHistogram(): IntArray = nativeGetDredCostHistogram()
+
+    /** Default decoder complexity ceiling: allow NoLACE where the device keeps up. */
+    const val DEFAULT_DECODER_COMPLEXITY = 10
+
+    /** Opus decoder complexity currently chosen by the native governor (0 if none). */
+    fun getDecoderComplexity(): Int = nativeGetDecoderComplexity()
+
+    /** Frames rebuilt from Opus DRED since create(). */
+    fun getDredRecoveredFrames(): Int = nativeGetDredRecoveredFrames()
+
+    /**
+     * Packets that arrived after PLC had played their slot: decoded only to
+     * update the Opus state, PCM discarded instead of played late (diagnostic).
+     */
+    fun getLatePacketsSalvaged(): Int = nativeGetLatePacketsSalvaged()
+
+    /**
+     * Native memory in bytes since the engine was created (one call), current
+     * and peak per component; see [NativeMemory] for the layout. All zero if
+     * no engine.
+     */
+    fun getMemoryStats(): IntArray = nativeGetMemoryStats()
+
     // --- Phase 3: Native codec methods ---
 
     /**
      * Configure a native decoder on the playback engine.
      *
-     * @param codecType    1=Opus, 2=Codec2
-     * @param sampleRate   Decoder sample rate
-     * @param channels     Number of channels
-     * @param opusApp      Opus application type (ignored for Codec2)
-     * @param opusBitrate  Opus bitrate (ignored for Codec2)
-     * @param opusComplexity Opus complexity (ignored for Codec2)
-     * @param codec2Mode   Codec2 library mode (ignored for Opus)
+     * @param codecConfig  Codec in the [NativeCodecConfig] layout, at the
+     *                     decoder sample rate (NativeCodecParams.toConfigArray).
+     *                     Its DRED span is the longest burst loss rebuilt
+     *                     from Opus DRED (0 = off).
+     * @param decoderComplexity Ceiling for Opus decoder complexity (5 = deep PLC,
+     *                     6 = LACE, 7+ = NoLACE, 0 = classic). The engine steps
+     *                     between these from measured decode/PLC cost.
      */
     fun configureDecoder(
-        codecType: Int,
-        sampleRate: Int,
-        channels: Int,
-        opusApp: Int = 0,
-        opusBitrate: Int = 0,
-        opusComplexity: Int = 10,
-        codec2Mode: Int = 0,
+        codecConfig: IntArray,
+        decoderComplexity: Int = DEFAULT_DECODER_COMPLEXITY,
     ): Boolean {
         ensureLoaded()
-        return nativeConfigureDecoder(
-            codecType,
-            sampleRate,
-            channels,
-            opusApp,
-            opusBitrate,
-            opusComplexity,
-            codec2Mode,
-        )
+        return nativeConfigureDecoder(codecConfig, decoderComplexity)
     }
 
     /**
@@ -156,12 +255,70 @@ object NativePlaybackEngine {
      * @param data   Full packet data (with codec header byte)
      * @param offset Offset into data to start reading (typically 1 to skip header)
      * @param length Number of encoded bytes to decode
+     * @param flags  Header flags from [Packetizer.headerFlags]. With
+     *               [Packetizer.FLAG_EXT] the packet goes through the reorder
+     *               window first; with [Packetizer.FLAG_FEC] the XOR FEC
+     *               receiver may rebuild one lost packet per group
      */
     fun writeEncodedPacket(
         data: ByteArray,
         offset: Int,
         length: Int,
-    ): Boolean = nativeWriteEncodedPacket(data, offset, length)
+        flags: Int = 0,
+    ): Boolean = nativeWriteEncodedPacket(data, offset, length, flags)
+
+    /** Packets rebuilt from XOR FEC parity since the decoder was configured. */
+    fun getFecRecoveredPackets(): Int = nativeGetFecRecoveredPackets()
+
+    /**
+     * Sequence statistics from the header extension since the decoder was
+     * configured: [lost, late, duplicate, reordered]. All zero unless the
+     * peer sends [Packetizer.FLAG_EXT].
+     */
+    fun getSequenceStats(): IntArray = nativeGetSequenceStats()
+
+    /** Interarrival jitter (RFC 3550 estimator) in microseconds; 0 without the extension. */
+    fun getJitterUs(): Int = nativeGetJitterUs()
+
+    /**
+     * Packet loss measured from the header extension since the decoder was
+     * configured, per mille. Until enough extension packets have arrived,
+     * the loss from the peer profile passed to [create]; -1 if neither.
+     */
+    fun getLossPermille(): Int = nativeGetLossPermille()
+
+    /**
+     * Enable NACK retransmission requests with the current round-trip time
+     * (0 = off). Holes are only requested while the audio queued ahead of
+     * them outlasts the round trip, so the playout delay doesn't grow.
+     */
+    fun setNackRttMs(rttMs: Int) = nativeSetNackRttMs(rttMs)
+
+    /**
+     * Take pending NACK sequence numbers; send each as [Signalling.NACK].
+     * Call from the thread that calls [writeEncodedPacket].
+     *
+     * @return Count written to dest
+     */
+    fun takeNackRequests(dest: IntArray): Int = nativeTakeNackRequests(dest)
+
+    /** NACK statistics since the decoder was configured: [sent, recovered in time]. */
+    fun getNackStats(): IntArray = nativeGetNackStats()
+
+    /**
+     * Record packet arrivals for the playout tuner; drain them with
+     * [takeArrivalTrace] into an [ArrivalTrace]. Needs the header
+     * extension. Call after [create].
+     */
+    fun setArrivalTrace(enabled: Boolean) = nativeSetArrivalTrace(enabled)
+
+    /**
+     * Take recorded arrivals as (frame index, arrival µs) pairs. Call from
+     * the thread that calls [writeEncodedPacket], after each packet.
+     *
+     * @return Pairs written to dest (two values each)
+     */
+    fun takeArrivalTrace(dest: LongArray): Int = nativeTakeArrivalTrace(dest)
 
     /**
      * Set playback mute state.
@@ -185,12 +342,20 @@ object NativePlaybackEngine {
         sampleRate: Int,
         channels: Int,
         frameSamples: Int,
-        maxBufferFrames: Int,
-        prebufferFrames: Int,
+        prebufferMs: Int,
+        maxBufferMs: Int,
+        drainThresholdMs: Int,
+        peerProfile: IntArray?,
+        playoutPolicy: IntArray?,
     ): Boolean
 
     private external fun nativeWriteSamples(samples: ShortArray): Boolean
 
+    private external fun nativeWriteSamplesFloat(
+        buffer: FloatBuffer,
+        count: Int,
+    ): Boolean
+
     private external fun nativeStartStream(): Boolean
 
     private external fun nativeRestartStream(): Boolean
@@ -201,25 +366,23 @@ object NativePlaybackEngine {
 
     private external fun nativeGetBufferedFrameCount(): Int
 
+    private external fun nativeGetBufferedMs(): Int
+
     private external fun nativeIsPlaying(): Boolean
 
     private external fun nativeGetXRunCount(): Int
 
     // Phase 3: Native codec JNI methods
     private external fun nativeConfigureDecoder(
-        codecType: Int,
-        sampleRate: Int,
-        channels: Int,
-        opusApp: Int,
-        opusBitrate: Int,
-        opusComplexity: Int,
-        codec2Mode: Int,
+        codecConfig: IntArray,
+        decoderComplexity: Int,
     ): Boolean
 
     private external fun nativeWriteEncodedPacket(
         data: ByteArray,
         offset: Int,
         length: Int,
+        flags: Int,
     ): Boolean
 
     private external fun nativeSetPlaybackMute(mute: Boolean)
@@ -232,4 +395,42 @@ object NativePlaybackEngine {
     private external fun nativeGetCallbackSilenceCount(): Int
 
     private external fun nativeGetCallbackPlcCount(): Int
+
+    private external fun nativeGetPlayoutDelayMs(): Int
+
+    private external fun nativeGetResidenceHistogram(): IntArray
+
+    private external fun nativeGetOutputLatencyHistogram(): IntArray
+
+    private external fun nativeGetDredCostHistogram(): IntArray
+
+    private external fun nativeGetDredRecoveredFrames(): Int
+
+    private external fun nativeGetDecoderComplexity(): Int
+
+    private external fun nativeGetFecRecoveredPackets(): Int
+
+    private external fun nativeGetLatePacketsSalvaged(): Int
+
+    private external fun nativeGetMemoryStats(): IntArray
+
+    private external fun nativeGetSequenceStats(): IntArray
+
+    private external fun nativeGetJitterUs(): Int
+
+    private external fun nativeGetLossPermille(): Int
+
+    private external fun nativeSetNackRttMs(rttMs: Int)
+
+    private external fun nativeTakeNackRequests(dest: IntArray): Int
+
+    private external fun nativeGetNackStats(): IntArray
+
+    private external fun nativeSetArrivalTrace(enabled: Boolean)
+
+    private external fun nativeTakeArrivalTrace(dest: LongArray): Int
+
+    private external fun nativeGetPrebufferMs(): Int
+
+    private external fun nativeExportPeerProfile(): IntArray?
 }
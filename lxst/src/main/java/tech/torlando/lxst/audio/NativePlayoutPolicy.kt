@@ -0,0 +1,90 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package tech.torlando.lxst.audio
+
+/**
+ * Layout of the playout policy array taken by [NativePlaybackEngine.create]
+ * (playout_policy.h): one int per field. Native code fills fields missing
+ * from the end of a shorter array with defaults and clamps out-of-range
+ * values, so new fields go at the end.
+ *
+ * The playout tuner (lxst/tools/playout_tuner) writes a per-profile table
+ * of these arrays as text; [parseTable] reads it back.
+ */
+object NativePlayoutPolicy {
+    /** Prebuffer and drain target in ms; 0 keeps the caller's. */
+    const val PREBUFFER_MS = 0
+
+    /** Hard drain threshold, percent of the prebuffer (default 200). */
+    const val DRAIN_PCT = 1
+
+    /** Silence dropping starts this far from prebuffer to drain threshold, percent (default 25). */
+    const val SOFT_DROP_PCT = 2
+
+    /** Consecutive PLC callbacks before falling back to silence (default 5). */
+    const val PLC_MAX_CALLBACKS = 3
+
+    /** Same, for peers whose learned profile is lossy (default 10). */
+    const val PLC_MAX_CALLBACKS_LOSSY = 4
+
+    /** Oboe buffer size in bursts (default 2). */
+    const val BUFFER_BURSTS = 5
+
+    const val FIELDS = 6
+
+    /** The engine's built-in policy, with the caller's prebuffer. */
+    val DEFAULT: IntArray get() = intArrayOf(0, 200, 25, 5, 10, 2)
+
+    // Clamps applied by the engine (playout_policy.h)
+    private const val PREBUFFER_MAX_MS = 2000
+    private const val DRAIN_PCT_MIN = 110
+    private const val DRAIN_PCT_MAX = 500
+
+    /**
+     * Hard drain threshold the engine derives from [policy]: its prebuffer
+     * (or [prebufferMs] if it has none) times its drain percentage, with
+     * the engine's clamps. A peer seed is not applied.
+     *
+     * @param policy Policy array, or null for the defaults
+     * @param prebufferMs The caller's prebuffer target
+     */
+    fun drainThresholdMs(
+        policy: IntArray?,
+        prebufferMs: Int,
+    ): Int {
+        val tunedMs = (policy?.getOrNull(PREBUFFER_MS) ?: 0).coerceIn(0, PREBUFFER_MAX_MS)
+        val drainPct = (policy?.getOrNull(DRAIN_PCT) ?: DEFAULT[DRAIN_PCT]).coerceIn(DRAIN_PCT_MIN, DRAIN_PCT_MAX)
+        return (if (tunedMs > 0) tunedMs else prebufferMs) * drainPct / 100
+    }
+
+    /**
+     * Parse a tuner table: one row per profile, the profile id (decimal or
+     * 0x hex) followed by the policy fields in array order. Text after '#'
+     * is a comment.
+     *
+     * @return Policy arrays by profile id
+     * @throws IllegalArgumentException on a malformed row
+     */
+    fun parseTable(text: String): Map<Int, IntArray> {
+        val table = LinkedHashMap<Int, IntArray>()
+        text.lineSequence().forEachIndexed { index, raw ->
+            val line = raw.substringBefore('#').trim()
+            if (line.isEmpty()) return@forEachIndexed
+            val cols = line.split(Regex("\\s+"))
+            require(cols.size >= 2) { "Line ${index + 1}: expected a profile id and policy fields" }
+            val id = parseInt(cols[0], index)
+            table[id] = IntArray(cols.size - 1) { parseInt(cols[it + 1], index) }
+        }
+        return table
+    }
+
+    private fun parseInt(
+        s: String,
+        index: Int,
+    ): Int {
+        val value = if (s.startsWith("0x", ignoreCase = true)) s.substring(2).toIntOrNull(16) else s.toIntOrNull()
+        return requireNotNull(value) { "Line ${index + 1}: bad number '$s'" }
+    }
+}
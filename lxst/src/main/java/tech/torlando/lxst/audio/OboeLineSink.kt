@@ -6,6 +6,9 @@ package tech.torlando.lxst.audio
 
 import android.util.Log
 import tech.torlando.lxst.core.AudioDevice
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.nio.FloatBuffer
 import java.util.concurrent.atomic.AtomicBoolean
 import java.util.concurrent.atomic.AtomicLong
 
@@ -24,9 +27,9 @@ import java.util.concurrent.atomic.AtomicLong
  * 4. **Low-latency HAL**: Oboe requests `PerformanceMode::LowLatency` +
  *    `SharingMode::Exclusive` for direct HAL access on supported devices.
  *
- * The sink receives float32 frames from Mixer, converts to int16 (one
- * allocation per frame for the ShortArray — eliminated in Phase 3), and
- * pushes into the native ring buffer via JNI.
+ * The sink receives float32 frames from Mixer, copies them into a reused
+ * direct FloatBuffer, and the native engine converts to int16 straight
+ * into the ring buffer — no per-frame allocation.
  *
  * @param autodigest Auto-start playback when buffer reaches prebuffer threshold
  */
@@ -66,6 +69,9 @@ class OboeLineSink(
     private val nativeCreated = AtomicBoolean(false)
     private val handleFrameCount = AtomicLong(0)
 
+    // Reused float bridge to the native engine (Mixer thread only)
+    private var floatBridge: FloatBuffer? = null
+
     override fun canReceive(fromSource: Source?): Boolean {
         if (!nativeCreated.get()) return true // Accept frames before native is ready
         return NativePlaybackEngine.getBufferedFrameCount() < effectiveMaxFrames - 1
@@ -104,11 +110,14 @@ class OboeLineSink(
             createNativeEngine()
         }
 
-        // Convert float32 → int16 and push to native ring buffer.
-        // This is the one remaining per-frame allocation (ShortArray) — eliminated in Phase 3
-        // when codecs move to native and output int16 directly.
-        val samples = float32ToShortArray(frame)
-        NativePlaybackEngine.writeSamples(samples)
+        // Copy into the direct bridge buffer; native converts float32 → int16
+        // (SIMD) directly into the ring slot.
+        val bridge =
+            floatBridge?.takeIf { it.capacity() >= frame.size }
+                ?: directFloatBuffer(frame.size).also { floatBridge = it }
+        bridge.clear()
+        bridge.put(frame)
+        NativePlaybackEngine.writeSamplesFloat(bridge, frame.size)
 
         val count = handleFrameCount.incrementAndGet()
         if (count % 100L == 0L) {
@@ -184,8 +193,8 @@ class OboeLineSink(
                     sampleRate = sampleRate,
                     channels = channels,
                     frameSamples = frameSamples,
-                    maxBufferFrames = effectiveMaxFrames.coerceAtMost(MAX_QUEUE_SLOTS),
-                    prebufferFrames = effectiveAutostartMin,
+                    prebufferMs = (effectiveAutostartMin * frameTimeMs).toInt(),
+                    maxBufferMs = (effectiveMaxFrames * frameTimeMs).toInt(),
                 )
             nativeCreated.set(created)
             Log.i(TAG, "Native engine created: $created (max=$effectiveMaxFrames, prebuf=$effectiveAutostartMin)")
@@ -212,14 +221,13 @@ class OboeLineSink(
 }
 
 /**
- * Convert float32 audio samples to int16 ShortArray for native engine.
+ * Allocate a native-order direct FloatBuffer for the JNI float bridge.
  *
- * Performs clamping to [-1.0, 1.0] and scaling to int16 range.
- * This is a single allocation (the ShortArray) vs LineSink's float32ToBytes()
- * which allocates a ByteBuffer + ByteArray.
+ * Direct buffers let native code read/write in place via
+ * GetDirectBufferAddress — no array pinning or copy-back.
  */
-internal fun float32ToShortArray(samples: FloatArray): ShortArray =
-    ShortArray(samples.size) { i ->
-        val clamped = samples[i].coerceIn(-1f, 1f)
-        (clamped * 32767f).toInt().toShort()
-    }
+internal fun directFloatBuffer(samples: Int): FloatBuffer =
+    ByteBuffer
+        .allocateDirect(samples * Float.SIZE_BYTES)
+        .order(ByteOrder.nativeOrder())
+        .asFloatBuffer()
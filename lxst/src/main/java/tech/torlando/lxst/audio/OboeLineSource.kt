@@ -31,9 +31,10 @@ import kotlin.math.ceil
  * 4. **Zero per-frame allocations on capture side**: Lock-free SPSC ring buffer
  *    is pre-allocated. No LinkedBlockingQueue or ByteArray.copyOf().
  *
- * The source reads filtered int16 frames from the native ring buffer via JNI,
- * converts to float32 (one ShortArray read per frame), applies gain, and pushes
- * to the transmit Mixer.
+ * The source reads filtered frames from the native ring buffer via JNI as
+ * float32 with gain already applied (one native SIMD pass), and pushes them
+ * to the transmit Mixer. The Mixer queues the FloatArray it receives, so that
+ * array is the only per-frame allocation.
  *
  * @param codec        Codec instance (determines sample rate, frame time alignment)
  * @param targetFrameMs Target frame duration in milliseconds (default 80ms)
@@ -51,8 +52,9 @@ class OboeLineSource(
 
         // Ring buffer sizing (same policy as OboeLineSink)
         const val BUFFER_CAPACITY_MS = 1500L
-        const val MAX_QUEUE_SLOTS = 150
-        const val MAX_FRAMES = 15
+
+        // Longest a native-codec read blocks before re-checking for stop
+        private const val ENCODED_READ_TIMEOUT_MS = 50
     }
 
     /** Sink to push captured frames to (set by Telephone/Pipeline) — Phase 2 path */
@@ -72,18 +74,28 @@ class OboeLineSource(
     var codecHeaderByte: Byte = Packetizer.CODEC_OPUS
 
     /**
-     * Phase 3: Native encoder params to configure after native engine creation.
+     * Phase 3: Native encoder to configure after native engine creation, in
+     * the [NativeCodecConfig] layout (null = no native encoder).
      *
      * Must be set before start(). The encoder is configured in start() after
      * NativeCaptureEngine.create() succeeds, ensuring the C++ singleton exists.
      */
-    var nativeEncoderCodecType: Int = 0
-    var nativeEncoderSampleRate: Int = 0
-    var nativeEncoderChannels: Int = 0
-    var nativeEncoderOpusApp: Int = 0
-    var nativeEncoderOpusBitrate: Int = 0
-    var nativeEncoderOpusComplexity: Int = 10
-    var nativeEncoderCodec2Mode: Int = 0
+    var nativeEncoderConfig: IntArray? = null
+
+    /** XOR FEC group size (0 = off); sets [Packetizer.FLAG_FEC] on every packet. */
+    var nativeEncoderFecGroupSize: Int = 0
+
+    /** Interleave Codec2 sub-frames across packets (ignored for Opus). */
+    var nativeEncoderCodec2Interleave: Boolean = false
+
+    /** Sequence/timestamp header extension; sets [Packetizer.FLAG_EXT] on every packet. */
+    var nativeEncoderHeaderExt: Boolean = false
+
+    /**
+     * Tuned playout policy row the peer plays this profile with (null =
+     * engine defaults); sets the TX age limit, see [LinkSource.computeTxMaxAgeMs].
+     */
+    var peerPlayoutPolicy: IntArray? = null
 
     // Audio configuration (derived from codec, same as LineSource)
     override var sampleRate: Int = DEFAULT_SAMPLE_RATE
@@ -91,7 +103,6 @@ class OboeLineSource(
 
     private val samplesPerFrame: Int
     private val frameTimeMs: Int
-    private val effectiveMaxFrames: Int
 
     // Coroutine management
     private val scope = CoroutineScope(Dispatchers.IO + SupervisorJob())
@@ -109,16 +120,10 @@ class OboeLineSource(
         // Calculate samples per frame
         samplesPerFrame = ((frameTimeMs / 1000f) * sampleRate).toInt()
 
-        // Compute buffer limits from frame time
-        effectiveMaxFrames =
-            (BUFFER_CAPACITY_MS / frameTimeMs)
-                .toInt()
-                .coerceIn(MAX_FRAMES, MAX_QUEUE_SLOTS)
-
         Log.d(
             TAG,
             "Init: rate=$sampleRate, frameMs=$frameTimeMs, samples=$samplesPerFrame, " +
-                "gain=$gain, maxFrames=$effectiveMaxFrames",
+                "gain=$gain, maxBuffer=${BUFFER_CAPACITY_MS}ms",
         )
     }
 
@@ -138,7 +143,7 @@ class OboeLineSource(
                         sampleRate = sampleRate,
                         channels = channels,
                         frameSamples = samplesPerFrame,
-                        maxBufferFrames = effectiveMaxFrames.coerceAtMost(MAX_QUEUE_SLOTS),
+                        maxBufferMs = BUFFER_CAPACITY_MS.toInt(),
                         enableFilters = true,
                     )
                 nativeCreated.set(created)
@@ -151,18 +156,23 @@ class OboeLineSource(
         }
 
         // Phase 3: Configure native encoder now that the C++ engine exists
-        if (useNativeCodec && nativeEncoderCodecType > 0) {
+        val encoderConfig = nativeEncoderConfig
+        if (useNativeCodec && encoderConfig != null && NativeCodecConfig.codecType(encoderConfig) > 0) {
             val configured =
                 NativeCaptureEngine.configureEncoder(
-                    codecType = nativeEncoderCodecType,
-                    sampleRate = nativeEncoderSampleRate,
-                    channels = nativeEncoderChannels,
-                    opusApp = nativeEncoderOpusApp,
-                    opusBitrate = nativeEncoderOpusBitrate,
-                    opusComplexity = nativeEncoderOpusComplexity,
-                    codec2Mode = nativeEncoderCodec2Mode,
+                    codecConfig = encoderConfig,
+                    fecGroupSize = nativeEncoderFecGroupSize,
+                    codec2Interleave = nativeEncoderCodec2Interleave,
+                    headerExt = nativeEncoderHeaderExt,
                 )
-            Log.i(TAG, "Native encoder configured: $configured (type=$nativeEncoderCodecType rate=$nativeEncoderSampleRate)")
+            Log.i(
+                TAG,
+                "Native encoder configured: $configured (type=${NativeCodecConfig.codecType(encoderConfig)} " +
+                    "rate=${NativeCodecConfig.sampleRate(encoderConfig)})",
+            )
+
+            // Don't spend the link on backlog the peer would only drain
+            NativeCaptureEngine.setTxMaxAgeMs(LinkSource.computeTxMaxAgeMs(frameTimeMs, peerPlayoutPolicy))
         }
 
         // Start Oboe input stream
@@ -210,7 +220,7 @@ class OboeLineSource(
      * producer; this coroutine is the consumer. The lock-free SPSC ring buffer
      * ensures zero contention between threads.
      *
-     * Phase 2: Reads raw PCM → float32 → gain → transmit Mixer
+     * Phase 2: Reads float32 PCM (gain applied natively) → transmit Mixer
      * Phase 3: Reads encoded packets → prepend header → PacketRouter → Python
      */
     private suspend fun ingestJob() {
@@ -221,28 +231,22 @@ class OboeLineSource(
         }
     }
 
-    /** Phase 2: Read raw PCM, convert to float32, push to Mixer */
+    /** Phase 2: Read float32 PCM from the native bridge, push to Mixer */
     private suspend fun ingestJobPcm() {
         Log.d(TAG, "Ingest job started (PCM mode)")
-        val shortBuffer = ShortArray(samplesPerFrame)
+        val bridge = directFloatBuffer(samplesPerFrame)
         var frameCount = 0L
 
         while (isRunningFlag.get() && !releasedFlag.get()) {
-            if (NativeCaptureEngine.readSamples(shortBuffer)) {
+            if (NativeCaptureEngine.readSamplesFloat(bridge, samplesPerFrame, gain)) {
                 frameCount++
 
-                val floatSamples = shortToFloat32(shortBuffer)
-
-                val gained =
-                    if (gain != 1.0f) {
-                        FloatArray(floatSamples.size) { i -> floatSamples[i] * gain }
-                    } else {
-                        floatSamples
-                    }
-
                 val currentSink = sink
                 if (currentSink != null && currentSink.canReceive(this)) {
-                    currentSink.handleFrame(gained, this)
+                    val frame = FloatArray(samplesPerFrame)
+                    bridge.clear()
+                    bridge.get(frame)
+                    currentSink.handleFrame(frame, this)
                 } else if (currentSink != null && frameCount % 50L == 0L) {
                     Log.w(TAG, "Sink backpressure, dropping frame #$frameCount")
                 }
@@ -259,33 +263,40 @@ class OboeLineSource(
     }
 
     /** Phase 3: Read encoded packets, prepend header, send via PacketRouter */
-    private suspend fun ingestJobNativeCodec() {
+    private fun ingestJobNativeCodec() {
         Log.d(TAG, "Ingest job started (native codec mode)")
         val encodedBuf = ByteArray(1500) // Pre-allocated, reused each iteration
         var frameCount = 0L
+        var headerFlags = 0
+        if (nativeEncoderFecGroupSize >= 2) headerFlags = headerFlags or Packetizer.FLAG_FEC
+        if (nativeEncoderHeaderExt) headerFlags = headerFlags or Packetizer.FLAG_EXT
+        val header = (codecHeaderByte.toInt() or headerFlags).toByte()
 
         while (isRunningFlag.get() && !releasedFlag.get()) {
-            val len = NativeCaptureEngine.readEncodedPacket(encodedBuf)
+            // Blocks until the next packet (and the TX pacer, if on) instead of polling
+            val len = NativeCaptureEngine.readEncodedPacketBlocking(encodedBuf, ENCODED_READ_TIMEOUT_MS)
             if (len > 0) {
                 frameCount++
 
                 // Prepend codec header byte and send (1 allocation per frame)
                 val packet = ByteArray(1 + len)
-                packet[0] = codecHeaderByte
+                packet[0] = header
                 encodedBuf.copyInto(packet, 1, 0, len)
                 packetRouter?.sendPacket(packet)
 
                 if (frameCount <= 5L) {
-                    Log.d(TAG, "TX native #$frameCount: ${packet.size} bytes, hdr=0x${(codecHeaderByte.toInt() and 0xFF).toString(16)}")
+                    Log.d(TAG, "TX native #$frameCount: ${packet.size} bytes, hdr=0x${(header.toInt() and 0xFF).toString(16)}")
                 } else if (frameCount % 100L == 0L) {
                     Log.d(TAG, "TX native #$frameCount")
                 }
-            } else {
-                delay(2)
             }
         }
 
-        Log.d(TAG, "Ingest job ended (native codec), sent $frameCount frames")
+        Log.d(
+            TAG,
+            "Ingest job ended (native codec), sent $frameCount frames, " +
+                "dropped ${NativeCaptureEngine.getStaleDropCount()} stale",
+        )
     }
 
     /**
@@ -321,12 +332,3 @@ class OboeLineSource(
     }
 }
 
-/**
- * Convert int16 ShortArray to float32 FloatArray.
- *
- * Inverse of [float32ToShortArray] in OboeLineSink.kt.
- */
-internal fun shortToFloat32(samples: ShortArray): FloatArray =
-    FloatArray(samples.size) { i ->
-        samples[i] / 32768f
-    }
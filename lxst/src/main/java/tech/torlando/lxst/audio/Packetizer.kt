@@ -28,6 +28,20 @@ import java.util.concurrent.atomic.AtomicBoolean
  * - 0x01 = Opus codec
  * - 0x02 = Codec2 codec
  *
+ * Android-only native codecs (extension profiles; Python LXST has none):
+ * - 0x03 = PCM16, 0x04 = G.711 µ-law, 0x05 = G.711 A-law, 0x06 = G.722
+ *
+ * [FLAG_FEC] (0x40) OR'd into the header marks an XOR-FEC framed payload
+ * from the native encoder: a tag byte (bit 7 = parity, bits 4-6 = group
+ * sequence, bits 0-3 = index or group size - 1) ahead of the codec frame,
+ * with a parity packet after every group. Only sent to peers that enable it.
+ *
+ * [FLAG_EXT] (0x20) marks a 4-byte header extension right after the header
+ * byte: uint16 BE sequence number, then uint16 BE media timestamp (ms). The
+ * receiver uses it to reorder, drop duplicates and measure jitter. Order on
+ * the wire is [header][extension][FEC tag][codec frame]. Opt-in as well.
+ * Neither flag is ever set on [CODEC_NULL].
+ *
  * **Threading:**
  * - handleFrame is called from audio thread (Pipeline/Mixer)
  * - PacketRouter.sendPacket uses Dispatchers.IO (non-blocking)
@@ -50,6 +64,51 @@ class Packetizer(
         const val CODEC_RAW: Byte = 0x00.toByte()
         const val CODEC_OPUS: Byte = 0x01.toByte()
         const val CODEC_CODEC2: Byte = 0x02.toByte()
+
+        // Android-only native codecs, same values as Profile.CODEC_TYPE_*
+        const val CODEC_PCM16: Byte = 0x03.toByte()
+        const val CODEC_PCMU: Byte = 0x04.toByte()
+        const val CODEC_PCMA: Byte = 0x05.toByte()
+        const val CODEC_G722: Byte = 0x06.toByte()
+
+        /** Header flag: payload is XOR-FEC framed (see native xor_fec.h). */
+        const val FLAG_FEC: Int = 0x40
+
+        /** FEC tag bit marking a parity packet. */
+        const val FEC_TAG_PARITY: Int = 0x80
+
+        /** Header flag: a sequence/timestamp extension follows the header byte. */
+        const val FLAG_EXT: Int = 0x20
+
+        /** Size of the [FLAG_EXT] header extension. */
+        const val HEADER_EXT_BYTES = 4
+
+        /**
+         * Optional flags ([FLAG_FEC], [FLAG_EXT]) carried by a header byte.
+         * [CODEC_NULL] has every bit set and carries none.
+         */
+        fun headerFlags(header: Byte): Int =
+            if (header == CODEC_NULL) 0 else header.toInt() and (FLAG_FEC or FLAG_EXT)
+
+        /** Codec byte of a header, without its [headerFlags]. */
+        fun headerCodec(header: Byte): Byte = (header.toInt() and headerFlags(header).inv()).toByte()
+
+        /**
+         * Get the codec header byte for a given codec.
+         *
+         * Matches Python LXST Codecs/__init__.py codec_header_byte function.
+         *
+         * @param codec The codec instance
+         * @return Header byte identifying the codec type
+         */
+        fun codecHeaderByte(codec: Codec?): Byte {
+            return when (codec) {
+                is Null -> CODEC_NULL
+                is Opus -> CODEC_OPUS
+                is Codec2 -> CODEC_CODEC2
+                else -> CODEC_RAW
+            }
+        }
     }
 
     private val shouldRun = AtomicBoolean(false)
@@ -75,23 +134,6 @@ class Packetizer(
     @Volatile
     var transmitFailure: Boolean = false
 
-    /**
-     * Get the codec header byte for a given codec.
-     *
-     * Matches Python LXST Codecs/__init__.py codec_header_byte function.
-     *
-     * @param codec The codec instance
-     * @return Header byte identifying the codec type
-     */
-    private fun codecHeaderByte(codec: Codec?): Byte {
-        return when (codec) {
-            is Null -> CODEC_NULL
-            is Opus -> CODEC_OPUS
-            is Codec2 -> CODEC_CODEC2
-            else -> CODEC_RAW
-        }
-    }
-
     /**
      * Check if this sink can receive frames.
      *
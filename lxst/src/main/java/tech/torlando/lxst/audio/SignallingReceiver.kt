@@ -33,6 +33,31 @@ object Signalling {
     // e.g., 0xFF + 0x40 = profile MQ (QUALITY_MEDIUM)
     /** Base for profile change signals. Signal = PREFERRED_PROFILE + profile_byte. */
     const val PREFERRED_PROFILE = 0xFF
+
+    // Latency probe (LXST-kt extension, see LatencyProbe)
+    // Signal = base + 16-bit millisecond token. Placed far above the profile
+    // range (0xFF + 0x00..0xFF) so peers without support see an unknown
+    // profile and ignore it.
+    /** Timestamp probe; the receiver echoes the token back unchanged. */
+    const val LATENCY_PROBE = 0x10000
+    /** Echo of a [LATENCY_PROBE] token. */
+    const val LATENCY_ECHO = 0x20000
+    /** Mask for the millisecond token carried by probe/echo signals. */
+    const val LATENCY_TOKEN_MASK = 0xFFFF
+
+    /** True if [signal] is a [LATENCY_PROBE] or [LATENCY_ECHO]. */
+    fun isLatencySignal(signal: Int): Boolean =
+        signal >= LATENCY_PROBE && signal < LATENCY_ECHO + LATENCY_TOKEN_MASK + 1
+
+    // NACK (LXST-kt extension): request a retransmit of one packet by its
+    // header-extension sequence number. Signal = base + 16-bit sequence.
+    /** Retransmit request for the packet with the carried sequence number. */
+    const val NACK = 0x30000
+    /** Mask for the sequence number carried by a [NACK]. */
+    const val NACK_SEQ_MASK = 0xFFFF
+
+    /** True if [signal] is a [NACK]. */
+    fun isNackSignal(signal: Int): Boolean = signal >= NACK && signal <= NACK + NACK_SEQ_MASK
 }
 
 /**
@@ -111,6 +136,14 @@ class SignallingReceiver(
      */
     private fun handleSignalling(signal: Int) {
         when {
+            Signalling.isLatencySignal(signal) -> {
+                // Latency probe/echo: not a profile change despite the large value
+                onSignalReceived(signal, false, null)
+            }
+            Signalling.isNackSignal(signal) -> {
+                // Retransmit request: not a profile change either
+                onSignalReceived(signal, false, null)
+            }
             signal >= Signalling.PREFERRED_PROFILE -> {
                 // Profile change: signal = 0xFF + profile_byte
                 val profile = signal - Signalling.PREFERRED_PROFILE
@@ -148,7 +181,13 @@ class SignallingReceiver(
             Signalling.STATUS_RINGING -> "RINGING"
             Signalling.STATUS_CONNECTING -> "CONNECTING"
             Signalling.STATUS_ESTABLISHED -> "ESTABLISHED"
-            else -> if (status >= Signalling.PREFERRED_PROFILE) {
+            else -> if (status >= Signalling.LATENCY_ECHO && Signalling.isLatencySignal(status)) {
+                "LATENCY_ECHO(${status and Signalling.LATENCY_TOKEN_MASK})"
+            } else if (Signalling.isLatencySignal(status)) {
+                "LATENCY_PROBE(${status and Signalling.LATENCY_TOKEN_MASK})"
+            } else if (Signalling.isNackSignal(status)) {
+                "NACK(${status and Signalling.NACK_SEQ_MASK})"
+            } else if (status >= Signalling.PREFERRED_PROFILE) {
                 "PROFILE_CHANGE(${status - Signalling.PREFERRED_PROFILE})"
             } else {
                 "UNKNOWN($status)"
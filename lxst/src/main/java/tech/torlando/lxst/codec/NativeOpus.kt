@@ -20,6 +20,9 @@ object NativeOpus {
     const val OPUS_APPLICATION_VOIP = 2048
     const val OPUS_APPLICATION_AUDIO = 2049
 
+    /** CELT only: no SILK/LP lookahead, so the only mode that allows 2.5/5ms frames at low delay. */
+    const val OPUS_APPLICATION_RESTRICTED_LOWDELAY = 2051
+
     /**
      * Create an encoder+decoder pair. Returns opaque handle (0 on failure).
      */
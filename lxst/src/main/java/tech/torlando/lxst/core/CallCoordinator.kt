@@ -72,6 +72,16 @@ interface CallController {
     fun muteMicrophone(muted: Boolean)
 
     fun setSpeaker(enabled: Boolean)
+
+    /**
+     * Enter or leave push-to-talk. Implementations backed by Telephone
+     * should forward to Telephone.setPttMode() so capture stays warm with
+     * pre-roll; the default just mutes.
+     */
+    fun setPttMode(enabled: Boolean) = muteMicrophone(enabled)
+
+    /** PTT key down/up. The default maps to microphone mute. */
+    fun setPttKeyed(keyed: Boolean) = muteMicrophone(!keyed)
 }
 
 /**
@@ -439,14 +449,15 @@ class CallCoordinator private constructor(
     fun setPttMode(enabled: Boolean) {
         Log.d(TAG, "PTT mode: $enabled")
         _isPttMode.value = enabled
-        if (enabled) {
-            // Enter PTT mode: mute transmit by default
-            _isPttActive.value = false
-            setMuted(true)
-        } else {
-            // Leave PTT mode: unmute transmit (back to full duplex)
-            _isPttActive.value = false
-            setMuted(false)
+        _isPttActive.value = false
+        // Entering PTT mutes transmit until keyed; leaving returns to full duplex
+        _isMuted.value = enabled
+        scope.launch {
+            try {
+                callController?.setPttMode(enabled)
+            } catch (e: Exception) {
+                Log.e(TAG, "Error setting PTT mode", e)
+            }
         }
     }
 
@@ -462,7 +473,14 @@ class CallCoordinator private constructor(
         if (_callState.value !is CallState.Active) return
         Log.d(TAG, "PTT active: $active")
         _isPttActive.value = active
-        setMuted(!active) // Pressed = unmuted (transmitting), released = muted (listening)
+        _isMuted.value = !active // Pressed = transmitting, released = listening
+        scope.launch {
+            try {
+                callController?.setPttKeyed(active)
+            } catch (e: Exception) {
+                Log.e(TAG, "Error setting PTT key", e)
+            }
+        }
     }
 
     // ===== Helper Methods =====
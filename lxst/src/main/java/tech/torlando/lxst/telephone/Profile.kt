@@ -4,11 +4,13 @@
 
 package tech.torlando.lxst.telephone
 
+import tech.torlando.lxst.audio.NativeCodecConfig
 import tech.torlando.lxst.audio.Packetizer
 import tech.torlando.lxst.codec.Codec
 import tech.torlando.lxst.codec.Codec2
 import tech.torlando.lxst.codec.NativeCodec2
 import tech.torlando.lxst.codec.NativeOpus
+import tech.torlando.lxst.codec.Null
 import tech.torlando.lxst.codec.Opus
 
 /**
@@ -17,7 +19,7 @@ import tech.torlando.lxst.codec.Opus
  * Used by [Profile.nativeEncodeParams] and [Profile.nativeDecodeParams] to pass
  * codec configuration to C++ CodecWrapper through NativePlaybackEngine/NativeCaptureEngine.
  *
- * @param codecType      Codec type (1=Opus, 2=Codec2) matching C++ CodecType enum
+ * @param codecType      Codec type ([Profile.CODEC_TYPE_OPUS] etc.) matching C++ CodecType enum
  * @param sampleRate     Audio sample rate in Hz
  * @param channels       Number of audio channels (1=mono, 2=stereo)
  * @param opusApplication Opus application type (VOIP/AUDIO/RESTRICTED_LOWDELAY), 0 if Codec2
@@ -25,6 +27,9 @@ import tech.torlando.lxst.codec.Opus
  * @param opusComplexity Opus encoder complexity (0-10), 10 if Codec2
  * @param codec2LibraryMode Codec2 library mode constant, 0 if Opus
  * @param codecHeaderByte Wire protocol codec header byte for Packetizer
+ * @param dredDurationMs Opus DRED burst-loss redundancy in ms (0 = off). On the
+ *                       encode side it is carried in every packet; on the decode
+ *                       side it bounds the gap rebuilt from the next packet.
  */
 data class NativeCodecParams(
     val codecType: Int,
@@ -35,7 +40,21 @@ data class NativeCodecParams(
     val opusComplexity: Int = 10,
     val codec2LibraryMode: Int = 0,
     val codecHeaderByte: Byte = 0x00,
-)
+    val dredDurationMs: Int = 0,
+) {
+    /** Codec config for the native engines, in the [NativeCodecConfig] layout. */
+    fun toConfigArray(): IntArray =
+        IntArray(NativeCodecConfig.FIELDS).also {
+            it[NativeCodecConfig.TYPE] = codecType
+            it[NativeCodecConfig.SAMPLE_RATE] = sampleRate
+            it[NativeCodecConfig.CHANNELS] = channels
+            it[NativeCodecConfig.OPUS_APPLICATION] = opusApplication
+            it[NativeCodecConfig.OPUS_BITRATE] = opusBitrate
+            it[NativeCodecConfig.OPUS_COMPLEXITY] = opusComplexity
+            it[NativeCodecConfig.CODEC2_MODE] = codec2LibraryMode
+            it[NativeCodecConfig.DRED_DURATION_MS] = dredDurationMs
+        }
+}
 
 /**
  * Quality profile definitions for LXST telephony.
@@ -46,6 +65,9 @@ data class NativeCodecParams(
  * - MQ=0x40, HQ=0x50, SHQ=0x60 (Opus standard)
  * - ULL=0x70, LL=0x80 (Opus low-latency)
  *
+ * Extension profiles (XLL=0x90, LAN=0xA0) are Android-only and not in [all]:
+ * Python LXST does not know them, so offer them only to peers known to be local.
+ *
  * Each profile encapsulates codec configuration and frame timing parameters.
  * Profile.createCodec() returns a properly configured codec instance.
  */
@@ -99,6 +121,12 @@ sealed class Profile(
      */
     open fun nativeDecodeParams(): NativeCodecParams = nativeEncodeParams()
 
+    /**
+     * Opus DRED span this profile can afford, in ms (0 = none). Not part of
+     * the native params: DRED is off unless Telephone.setDred turns it on.
+     */
+    open val dredDurationMs: Int get() = 0
+
     // ====== Codec2 Profiles (Low Bandwidth) ======
 
     /** Ultra Low Bandwidth - Codec2 700C (700 bps) */
@@ -147,6 +175,8 @@ sealed class Profile(
 
     /** Medium Quality - Opus voice medium (8000 bps, 24kHz) */
     data object MQ : Profile(0x40, "Medium Quality", "MQ", 60) {
+        override val dredDurationMs = DRED_DURATION_MS
+
         override fun createCodec(): Codec = Opus(profile = Opus.PROFILE_VOICE_MEDIUM)
 
         override fun createDecodeCodec(): Codec = Opus(profile = Opus.PROFILE_VOICE_HIGH)
@@ -174,6 +204,8 @@ sealed class Profile(
 
     /** High Quality - Opus voice high (16000 bps, 48kHz) */
     data object HQ : Profile(0x50, "High Quality", "HQ", 60) {
+        override val dredDurationMs = DRED_DURATION_MS
+
         override fun createCodec(): Codec = Opus(profile = Opus.PROFILE_VOICE_HIGH)
 
         override fun nativeEncodeParams() =
@@ -258,24 +290,98 @@ sealed class Profile(
             )
     }
 
+    // ====== Extension Profiles (not in Python LXST) ======
+
+    /**
+     * Extreme Low Latency - CELT-only Opus with 5ms frames, for LAN/Wi-Fi
+     * links between nearby units.
+     *
+     * RESTRICTED_LOWDELAY drops SILK and its lookahead, so codec delay is
+     * ~2.5ms + frame instead of ~6.5ms + frame. Frames are shorter than a
+     * typical Oboe burst; both engines serve several per callback. No DRED:
+     * the rebuild runs in 5ms of callback time, and on a local link loss is
+     * rare. The Kotlin (Phase 2) codec only does VOIP/AUDIO, so it falls
+     * back to the HQ Opus profile at the same frame time.
+     */
+    data object XLL : Profile(0x90, "Extreme Low Latency", "XLL", 5) {
+        override fun createCodec(): Codec = Opus(profile = Opus.PROFILE_VOICE_HIGH)
+
+        override fun nativeEncodeParams() =
+            NativeCodecParams(
+                codecType = CODEC_TYPE_OPUS,
+                sampleRate = 48000,
+                channels = 1,
+                opusApplication = NativeOpus.OPUS_APPLICATION_RESTRICTED_LOWDELAY,
+                opusBitrate = 32000,
+                codecHeaderByte = Packetizer.CODEC_OPUS,
+            )
+    }
+
+    /**
+     * Wired LAN - G.722 wideband (64 kbps, 16kHz) with 20ms frames, for
+     * links where bandwidth is free and CPU or latency is what counts.
+     *
+     * G.722 is a few multiplies per sample with ~1.5ms codec delay, against
+     * Opus's ~6.5ms and far more CPU. Packets are 160 bytes. Loss leaves the
+     * ADPCM state off for a few ms and there is no PLC, so this is for
+     * clean links only.
+     *
+     * There is no Kotlin G.722: the Kotlin (Phase 2) codec is uncompressed
+     * PCM16 ([Null]) at the same rate, which also sets the 16kHz capture
+     * rate. Both ends must then be on the same path; a receiver on the
+     * other one drops the packets by their codec byte (LinkSource.codecHeader)
+     * instead of decoding them as noise.
+     */
+    data object LAN : Profile(0xA0, "Wired LAN", "LAN", 20) {
+        override fun createCodec(): Codec = Null().apply { preferredSamplerate = 16000 }
+
+        override fun nativeEncodeParams() =
+            NativeCodecParams(
+                codecType = CODEC_TYPE_G722,
+                sampleRate = 16000,
+                channels = 1,
+                codecHeaderByte = Packetizer.CODEC_G722,
+            )
+    }
+
     companion object {
         /** Codec type constants matching C++ CodecType enum */
         const val CODEC_TYPE_OPUS = 1
         const val CODEC_TYPE_CODEC2 = 2
 
+        /** Android-only native codecs (no Kotlin implementation) */
+        const val CODEC_TYPE_PCM16 = 3
+        const val CODEC_TYPE_PCMU = 4
+        const val CODEC_TYPE_PCMA = 5
+        const val CODEC_TYPE_G722 = 6
+
+        /**
+         * DRED span for the 60ms mono Opus profiles (MQ, HQ) once enabled
+         * with Telephone.setDred: four frames, enough for typical Reticulum
+         * loss bursts. Rebuilding a gap costs a neural decode per frame and
+         * the redundancy costs bits, so DRED is off by default and never
+         * used for LL/ULL, whose
+         * 10-20ms callbacks leave no decoder headroom, and for stereo SHQ.
+         * Check the DRED cost report (NativePlaybackEngine) before widening.
+         */
+        const val DRED_DURATION_MS = 240
+
         /** Default profile for new calls */
         val DEFAULT: Profile get() = MQ
 
         /** All profiles in order (low bandwidth to low latency) */
         val all: List<Profile> get() = listOf(ULBW, VLBW, LBW, MQ, HQ, SHQ, LL, ULL)
 
+        /** Android-only extension profiles, kept out of [all] and [next] */
+        val extensions: List<Profile> get() = listOf(XLL, LAN)
+
         /**
-         * Look up profile by ID.
+         * Look up profile by ID, including extension profiles.
          *
          * @param id Profile ID byte
          * @return Profile or null if not found
          */
-        fun fromId(id: Int): Profile? = all.find { it.id == id }
+        fun fromId(id: Int): Profile? = all.find { it.id == id } ?: extensions.find { it.id == id }
 
         /**
          * Get next profile in cycle (wraps around).
@@ -7,6 +7,8 @@ package tech.torlando.lxst.telephone
 import android.content.Context
 import android.media.Ringtone
 import android.media.RingtoneManager
+import android.os.Build
+import android.os.PowerManager
 import android.util.Log
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
@@ -15,6 +17,9 @@ import kotlinx.coroutines.SupervisorJob
 import kotlinx.coroutines.delay
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.withTimeoutOrNull
+import tech.torlando.lxst.audio.ArrivalTrace
+import tech.torlando.lxst.audio.LatencyEstimate
+import tech.torlando.lxst.audio.LatencyProbe
 import tech.torlando.lxst.audio.LineSink
 import tech.torlando.lxst.audio.LineSource
 import tech.torlando.lxst.audio.LinkSource
@@ -22,7 +27,9 @@ import tech.torlando.lxst.audio.LocalSink
 import tech.torlando.lxst.audio.LocalSource
 import tech.torlando.lxst.audio.Mixer
 import tech.torlando.lxst.audio.NativeCaptureEngine
+import tech.torlando.lxst.audio.NativeMemory
 import tech.torlando.lxst.audio.NativePlaybackEngine
+import tech.torlando.lxst.audio.NativePlayoutPolicy
 import tech.torlando.lxst.audio.OboeLineSink
 import tech.torlando.lxst.audio.OboeLineSource
 import tech.torlando.lxst.audio.Packetizer
@@ -88,6 +95,34 @@ class Telephone(
         const val DIAL_TONE_EASE_MS = 3.14159f
         const val DIAL_TONE_GAIN = 0.04f
         const val BUSY_TONE_SECONDS = 4.25f
+
+        /** Interval between in-band latency probes during an established call. */
+        const val LATENCY_PROBE_INTERVAL_MS = 5_000L
+
+        /** Interval between thermal headroom reads for the native encoder governor. */
+        const val THERMAL_POLL_INTERVAL_MS = 10_000L
+
+        /** Forecast horizon passed to PowerManager.getThermalHeadroom(). */
+        const val THERMAL_FORECAST_SECONDS = 10
+
+        /** Largest XOR FEC group the 4-bit tag index can address. */
+        const val MAX_FEC_GROUP_SIZE = 16
+
+        /** Peers whose learned link profile is kept (least recently used dropped). */
+        const val MAX_PEER_PROFILES = 64
+
+        /**
+         * Approximate thermal headroom for a PowerManager thermal status, for
+         * API 29 where getThermalHeadroom() doesn't exist. 1.0 = severe.
+         */
+        internal fun thermalStatusToHeadroom(status: Int): Float =
+            when (status) {
+                PowerManager.THERMAL_STATUS_NONE -> 0f
+                PowerManager.THERMAL_STATUS_LIGHT -> 0.75f
+                PowerManager.THERMAL_STATUS_MODERATE -> 0.9f
+                PowerManager.THERMAL_STATUS_SEVERE -> 1.0f
+                else -> if (status > PowerManager.THERMAL_STATUS_SEVERE) 1.2f else Float.NaN
+            }
     }
 
     // ===== State (matches Python Telephony.py lines 159-180) =====
@@ -110,6 +145,51 @@ class Telephone(
     @Volatile
     private var receiveMuted = false
 
+    /** Push-to-talk gating (persists across profile switches like mute) */
+    @Volatile
+    private var pttMode = false
+
+    @Volatile
+    private var pttKeyed = false
+
+    /** XOR FEC group size for native TX (0 = off; persists across profile switches) */
+    @Volatile
+    private var fecGroupSize = 0
+
+    /** Codec2 sub-frame interleaving for native TX (persists across profile switches) */
+    @Volatile
+    private var codec2Interleave = false
+
+    /** Sequence/timestamp header extension for native TX (persists across profile switches) */
+    @Volatile
+    private var headerExt = false
+
+    /** Native TX pacer burst, 0 = off (persists across profile switches) */
+    @Volatile
+    private var txPacingBurst = 0
+
+    /** Request retransmits of lost packets on native RX (persists across profile switches) */
+    @Volatile
+    private var nack = false
+
+    /** Opus DRED on native TX and RX for profiles that afford it (persists across profile switches) */
+    @Volatile
+    private var dred = false
+
+    /** Learned jitter/loss summaries by remote hash, in access order (LRU) */
+    private val peerProfiles = LinkedHashMap<String, IntArray>(16, 0.75f, true)
+
+    /** Native playout policies by profile id (tuned table; missing = engine defaults) */
+    @Volatile
+    private var playoutPolicies: Map<Int, IntArray> = emptyMap()
+
+    /** Record native RX packet arrivals for the playout tuner (persists across calls) */
+    @Volatile
+    private var arrivalTraceEnabled = false
+
+    /** Arrival traces of the current or last call, one per receive profile */
+    private val arrivalTraces = mutableListOf<ArrivalTrace>()
+
     /** True if current call is incoming */
     @Volatile
     private var isIncomingCall = false
@@ -158,6 +238,13 @@ class Telephone(
     private val scope = CoroutineScope(Dispatchers.Default + SupervisorJob())
     private var dialToneJob: Job? = null
     private var timeoutJob: Job? = null
+    private var latencyProbeJob: Job? = null
+    private var thermalJob: Job? = null
+
+    // ===== Latency Measurement =====
+
+    /** Timestamp echo over the signalling channel (RTT + native delays → mouth-to-ear). */
+    private val latencyProbe = LatencyProbe(sendSignal = { networkTransport.sendSignal(it) })
 
     init {
         // Wire up signal callback to handle incoming signals
@@ -275,6 +362,8 @@ class Telephone(
         // Cancel timeout
         timeoutJob?.cancel()
         timeoutJob = null
+        stopLatencyProbe()
+        stopThermalMonitor()
 
         // If incoming and not answered, signal rejection
         if (isIncomingCall && callStatus == Signalling.STATUS_RINGING && reason == null) {
@@ -293,6 +382,14 @@ class Telephone(
 
         // Destroy native codecs and engine (safe no-op if not configured)
         if (useNativeCodec && useNativePlayback) {
+            // Learn this peer's link before the decoder drops its measurements
+            remoteIdentityHash?.let { hash ->
+                NativePlaybackEngine.exportPeerProfile()?.let { setPeerProfile(hash, it) }
+            }
+            // Per-call native memory, for budgeting (engines are torn down next)
+            val playbackMemory = NativeMemory.describe(NativePlaybackEngine.getMemoryStats())
+            val captureMemory = NativeMemory.describe(NativeCaptureEngine.getMemoryStats())
+            Log.i(TAG, "Native memory: playback $playbackMemory; capture $captureMemory")
             NativePlaybackEngine.destroyDecoder()
             NativePlaybackEngine.stopStream()
             NativePlaybackEngine.destroy()
@@ -325,6 +422,8 @@ class Telephone(
         activeProfile = Profile.DEFAULT
         transmitMuted = false
         receiveMuted = false
+        pttMode = false
+        pttKeyed = false
         isIncomingCall = false
         remoteIdentityHash = null
 
@@ -381,8 +480,247 @@ class Telephone(
             // Phase 3: mute in native capture engine (encodes silence)
             NativeCaptureEngine.setCaptureMute(mute)
         } else {
-            // Phase 2: mute via Kotlin transmit mixer
-            transmitMixer?.mute(mute)
+            // Phase 2: mute via Kotlin transmit mixer (PTT idle also mutes)
+            transmitMixer?.mute(mute || (pttMode && !pttKeyed))
+        }
+    }
+
+    /**
+     * Enable or disable push-to-talk.
+     *
+     * Phase 3: the native capture engine keeps filtering while idle but
+     * skips encoding, and replays a short pre-roll on key-down so the first
+     * syllable isn't clipped. Phase 2: falls back to transmit mute.
+     *
+     * @param enabled True to gate transmit on [setPttKeyed]
+     */
+    fun setPttMode(enabled: Boolean) {
+        Log.d(TAG, "PTT mode: $enabled")
+        pttMode = enabled
+        pttKeyed = false
+        applyPttState()
+    }
+
+    /**
+     * PTT key down (transmitting) or up (listening). Ignored outside PTT mode.
+     */
+    fun setPttKeyed(keyed: Boolean) {
+        if (!pttMode) return
+        pttKeyed = keyed
+        if (useNativeCodec && useNativePlayback) {
+            NativeCaptureEngine.setPttKeyed(keyed)
+        } else {
+            transmitMixer?.mute(!keyed || transmitMuted)
+        }
+    }
+
+    private fun applyPttState() {
+        if (useNativeCodec && useNativePlayback) {
+            NativeCaptureEngine.setPttMode(pttMode)
+            if (pttKeyed) NativeCaptureEngine.setPttKeyed(true)
+        } else {
+            transmitMixer?.mute((pttMode && !pttKeyed) || transmitMuted)
+        }
+    }
+
+    /**
+     * Send one XOR parity packet per [groupSize] packets (0 = off), so the
+     * receiver can rebuild any single lost packet of each group. Costs
+     * 1/[groupSize] extra packets on any profile.
+     *
+     * Phase 3 only. FEC-framed packets carry [Packetizer.FLAG_FEC]; only
+     * enable it toward peers that understand the flag. Receiving needs no
+     * setting. Takes effect immediately on an active call.
+     */
+    fun setFecGroupSize(groupSize: Int) {
+        val size = if (groupSize >= 2) groupSize.coerceAtMost(MAX_FEC_GROUP_SIZE) else 0
+        if (size == fecGroupSize) return
+        Log.d(TAG, "FEC group size: $size")
+        fecGroupSize = size
+        if (callStatus == Signalling.STATUS_ESTABLISHED && useNativeCodec && useNativePlayback) {
+            reconfigureTransmitPipeline()
+        }
+    }
+
+    /**
+     * Interleave Codec2 sub-frames across consecutive packets, so a lost
+     * 320-400ms ULBW/VLBW packet becomes scattered 40ms holes that are
+     * concealed instead of one long dropout. Adds one frame of latency.
+     *
+     * Phase 3 only, Codec2 profiles only. Interleaved packets carry a
+     * flag in the Codec2 mode header that older peers don't know, so only
+     * enable it toward peers that do. Receiving needs no setting.
+     */
+    fun setCodec2Interleave(enabled: Boolean) {
+        if (enabled == codec2Interleave) return
+        Log.d(TAG, "Codec2 interleave: $enabled")
+        codec2Interleave = enabled
+        if (callStatus == Signalling.STATUS_ESTABLISHED && useNativeCodec && useNativePlayback) {
+            reconfigureTransmitPipeline()
+        }
+    }
+
+    /**
+     * Send a sequence number and media timestamp with every packet, so the
+     * peer can put reordered packets back in order, drop duplicates and
+     * measure jitter. Costs 4 bytes per packet.
+     *
+     * Phase 3 only. Extended packets carry [Packetizer.FLAG_EXT]; only
+     * enable it toward peers that understand the flag. Receiving needs no
+     * setting. Takes effect immediately on an active call.
+     */
+    fun setHeaderExtension(enabled: Boolean) {
+        if (enabled == headerExt) return
+        Log.d(TAG, "Header extension: $enabled")
+        headerExt = enabled
+        if (callStatus == Signalling.STATUS_ESTABLISHED && useNativeCodec && useNativePlayback) {
+            reconfigureTransmitPipeline()
+        }
+    }
+
+    /**
+     * Release outgoing packets at the profile's packet rate, at most
+     * [NativeCaptureEngine.DEFAULT_TX_PACING_BURST] back to back, instead
+     * of as fast as the sender catches up after a hiccup. For slow
+     * interfaces that drop bursts; costs nothing on the wire.
+     *
+     * Phase 3 only. Takes effect immediately on an active call.
+     */
+    fun setTxPacing(enabled: Boolean) {
+        val burst = if (enabled) NativeCaptureEngine.DEFAULT_TX_PACING_BURST else 0
+        if (burst == txPacingBurst) return
+        Log.d(TAG, "TX pacing: $enabled")
+        txPacingBurst = burst
+        if (callStatus == Signalling.STATUS_ESTABLISHED && useNativeCodec && useNativePlayback) {
+            NativeCaptureEngine.setTxPacing(burst)
+        }
+    }
+
+    /**
+     * Ask the peer to resend lost packets when the round trip is short
+     * enough for the resend to arrive before its playout time, e.g. HQ/SHQ
+     * over IP-backed links. Holes that can't make it are left to PLC, so
+     * the playout delay doesn't grow.
+     *
+     * Phase 3 only. Needs the peer to send the header extension
+     * ([setHeaderExtension]) and to understand [Signalling.NACK]; NACKs from
+     * the peer are always answered when our header extension is on. Starts
+     * once the latency probe has a round-trip estimate.
+     */
+    fun setNack(enabled: Boolean) {
+        if (enabled == nack) return
+        Log.d(TAG, "NACK: $enabled")
+        nack = enabled
+        linkSource?.nackEnabled = enabled
+        if (!enabled && useNativeCodec && useNativePlayback) {
+            try {
+                NativePlaybackEngine.setNackRttMs(0)
+            } catch (e: UnsatisfiedLinkError) {
+                Log.w(TAG, "Native playback engine unavailable: ${e.message}")
+            }
+        }
+    }
+
+    /**
+     * Carry Opus Deep REDundancy in sent packets and rebuild lost bursts
+     * from it on receive, for the profiles that can afford the decode
+     * ([Profile.dredDurationMs]: MQ and HQ). The encoder sizes the
+     * redundancy to the loss measured on the receive side, so it costs
+     * few bits on a clean link; best with the header extension on both
+     * sides, which measures loss and tells holes from late packets.
+     *
+     * Phase 3 only, and needs a libopus built with DRED. Applies from the
+     * next native call setup or profile switch.
+     */
+    fun setDred(enabled: Boolean) {
+        if (enabled == dred) return
+        Log.d(TAG, "DRED: $enabled")
+        dred = enabled
+    }
+
+    /** [params] with [profile]'s DRED span if [setDred] is on. */
+    private fun withDred(
+        params: NativeCodecParams,
+        profile: Profile,
+    ): NativeCodecParams = if (dred) params.copy(dredDurationMs = profile.dredDurationMs) else params
+
+    /**
+     * Learned link summary for a peer (see [NativePlaybackEngine.exportPeerProfile]),
+     * or null if none. Recorded at the end of every native call with enough
+     * packets, and used to seed the playback buffer on the next call.
+     *
+     * @param remoteHash Hex destination/identity hash, as passed to [call]
+     *                   or [onIncomingCall]
+     */
+    fun getPeerProfile(remoteHash: String): IntArray? =
+        synchronized(peerProfiles) { peerProfiles[remoteHash]?.copyOf() }
+
+    /**
+     * All learned link summaries. Kept in memory only: persist this map
+     * and restore it with [setPeerProfile] to keep them across restarts.
+     */
+    fun getPeerProfiles(): Map<String, IntArray> =
+        synchronized(peerProfiles) { peerProfiles.mapValues { it.value.copyOf() } }
+
+    /** Store (or restore) a peer's learned link summary. */
+    fun setPeerProfile(
+        remoteHash: String,
+        profile: IntArray,
+    ) {
+        synchronized(peerProfiles) {
+            peerProfiles[remoteHash] = profile.copyOf()
+            if (peerProfiles.size > MAX_PEER_PROFILES) {
+                peerProfiles.remove(peerProfiles.keys.first())
+            }
+        }
+        Log.d(TAG, "Peer profile ${remoteHash.take(16)}: ${profile.joinToString(",")}")
+    }
+
+    /**
+     * Install a per-profile native playout policy table, as written by the
+     * playout tuner and read with [NativePlayoutPolicy.parseTable]. Applies
+     * from the next native call setup; profiles without a row keep the
+     * engine defaults.
+     *
+     * @param table Policy arrays ([NativePlayoutPolicy] layout) by profile id
+     */
+    fun setPlayoutPolicies(table: Map<Int, IntArray>) {
+        playoutPolicies = table.mapValues { it.value.copyOf() }
+        Log.d(TAG, "Playout policies for ${table.size} profiles")
+    }
+
+    /**
+     * Record received packet arrivals for the playout tuner, one trace per
+     * receive profile of a call; read them with [getArrivalTraces]. Needs
+     * the header extension from the peer: without it packets carry no
+     * send time. Phase 3 only. Applies from the next call setup.
+     */
+    fun setArrivalTrace(enabled: Boolean) {
+        Log.d(TAG, "Arrival trace: $enabled")
+        arrivalTraceEnabled = enabled
+        if (!enabled) synchronized(arrivalTraces) { arrivalTraces.clear() }
+    }
+
+    /**
+     * Arrival traces of the current or last call in the playout tuner's
+     * trace format, one per receive profile; empty unless recording.
+     */
+    fun getArrivalTraces(): List<String> =
+        synchronized(arrivalTraces) { arrivalTraces.filter { it.size > 0 }.map { it.format() } }
+
+    /** Start a trace for the active receive profile, if recording. */
+    private fun startArrivalTrace(clear: Boolean) {
+        if (!arrivalTraceEnabled) return
+        val trace = ArrivalTrace(activeProfile.id, activeProfile.frameTimeMs * 1000)
+        synchronized(arrivalTraces) {
+            if (clear) arrivalTraces.clear()
+            arrivalTraces.add(trace)
+        }
+        linkSource?.arrivalTrace = trace
+        try {
+            NativePlaybackEngine.setArrivalTrace(true)
+        } catch (e: UnsatisfiedLinkError) {
+            Log.w(TAG, "Native playback engine unavailable: ${e.message}")
         }
     }
 
@@ -420,6 +758,12 @@ class Telephone(
      */
     fun isCallActive(): Boolean = callStatus != Signalling.STATUS_AVAILABLE
 
+    /**
+     * Current end-to-end latency estimate, or null until the first probe
+     * round trip of the call has completed.
+     */
+    fun getLatencyEstimate(): LatencyEstimate? = latencyProbe.estimate
+
     // ===== Ringtone Configuration =====
 
     /**
@@ -461,6 +805,21 @@ class Telephone(
      */
     @Synchronized
     private fun onSignalReceived(signal: Int) {
+        // Latency probes/echoes are answered inline and never touch call state
+        if (latencyProbe.handleSignal(signal)) return
+
+        // Retransmit requests: hand straight to the encoder, no logging
+        if (Signalling.isNackSignal(signal)) {
+            if (useNativeCodec && useNativePlayback && callStatus == Signalling.STATUS_ESTABLISHED) {
+                try {
+                    NativeCaptureEngine.requestRetransmit(signal and Signalling.NACK_SEQ_MASK)
+                } catch (e: UnsatisfiedLinkError) {
+                    Log.w(TAG, "Native capture engine unavailable for retransmit: ${e.message}")
+                }
+            }
+            return
+        }
+
         Log.d(TAG, "Signal received: 0x${signal.toString(16)} (status=$callStatus)")
 
         when {
@@ -748,6 +1107,7 @@ class Telephone(
                     sink = receiveMixerAsSink,
                 ).apply {
                     codec = decodeCodec
+                    codecHeader = Packetizer.codecHeaderByte(decodeCodec)
                     sampleRate = decodeRate
                     channels = decodeChannels
                 }
@@ -767,8 +1127,8 @@ class Telephone(
      * TX: NativeCaptureEngine encodes in callback, OboeLineSource reads encoded → Python
      */
     private fun openPipelinesNativeCodec() {
-        val encodeParams = activeProfile.nativeEncodeParams()
-        val decodeParams = activeProfile.nativeDecodeParams()
+        val encodeParams = withDred(activeProfile.nativeEncodeParams(), activeProfile)
+        val decodeParams = withDred(activeProfile.nativeDecodeParams(), activeProfile)
 
         // --- RX: Configure native decoder on playback engine ---
         if (linkSource == null) {
@@ -778,24 +1138,29 @@ class Telephone(
             // NativePlaybackEngine.create() safely destroys any stale engine first.
             val decodedFrameSamples =
                 decodeParams.sampleRate * activeProfile.frameTimeMs / 1000 * decodeParams.channels
-            val prebufferFrames = LinkSource.computePrebufferFrames(activeProfile.frameTimeMs)
-            Log.d(TAG, "Prebuffer: $prebufferFrames frames × ${activeProfile.frameTimeMs}ms = ${prebufferFrames * activeProfile.frameTimeMs}ms")
+            // A peer we've called before seeds the prebuffer from its learned
+            // jitter; otherwise the static per-profile target applies.
+            val staticPrebufferMs = LinkSource.computePrebufferMs(activeProfile.frameTimeMs)
+            val maxBufferMs = LinkSource.computeMaxBufferMs(activeProfile.frameTimeMs)
+            val peerProfile = remoteIdentityHash?.let { getPeerProfile(it) }
+            val playoutPolicy = playoutPolicies[activeProfile.id]
             NativePlaybackEngine.create(
                 sampleRate = decodeParams.sampleRate,
                 channels = decodeParams.channels,
                 frameSamples = decodedFrameSamples,
-                maxBufferFrames = OboeLineSink.MAX_QUEUE_SLOTS,
-                prebufferFrames = prebufferFrames,
+                prebufferMs = staticPrebufferMs,
+                maxBufferMs = maxBufferMs,
+                peerProfile = peerProfile,
+                playoutPolicy = playoutPolicy,
             )
-            NativePlaybackEngine.configureDecoder(
-                codecType = decodeParams.codecType,
-                sampleRate = decodeParams.sampleRate,
-                channels = decodeParams.channels,
-                opusApp = decodeParams.opusApplication,
-                opusBitrate = decodeParams.opusBitrate,
-                opusComplexity = decodeParams.opusComplexity,
-                codec2Mode = decodeParams.codec2LibraryMode,
+            val prebufferMs = NativePlaybackEngine.getPrebufferMs().takeIf { it > 0 } ?: staticPrebufferMs
+            Log.d(
+                TAG,
+                "Prebuffer: ${prebufferMs}ms (static ${staticPrebufferMs}ms, seeded=${peerProfile != null}, " +
+                    "tuned=${playoutPolicy != null}, " +
+                    "max ${maxBufferMs}ms, frame ${activeProfile.frameTimeMs}ms)",
             )
+            NativePlaybackEngine.configureDecoder(decodeParams.toConfigArray())
             // Do NOT call startStream() here — the ring buffer is empty.
             // LinkSource will auto-start playback once prebuffer frames accumulate.
             Log.d(TAG, "Native decoder configured (stream deferred): ${decodeParams.codecType} @ ${decodeParams.sampleRate}Hz")
@@ -811,10 +1176,13 @@ class Telephone(
                     bridge = networkPacketBridge,
                 ).apply {
                     useNativeCodec = true
+                    codecHeader = decodeParams.codecHeaderByte
                     deferPlaybackStart = true
-                    this.prebufferFrames = prebufferFrames
+                    this.prebufferMs = prebufferMs
+                    nackEnabled = nack
                     // Codec/sink/sampleRate unused in native mode — decode is in C++
                 }
+            startArrivalTrace(clear = true)
         }
 
         // --- TX: Configure native encoder on capture engine ---
@@ -831,13 +1199,11 @@ class Telephone(
                     useNativeCodec = true
                     packetRouter = networkPacketBridge
                     codecHeaderByte = encodeParams.codecHeaderByte
-                    nativeEncoderCodecType = encodeParams.codecType
-                    nativeEncoderSampleRate = encodeParams.sampleRate
-                    nativeEncoderChannels = encodeParams.channels
-                    nativeEncoderOpusApp = encodeParams.opusApplication
-                    nativeEncoderOpusBitrate = encodeParams.opusBitrate
-                    nativeEncoderOpusComplexity = encodeParams.opusComplexity
-                    nativeEncoderCodec2Mode = encodeParams.codec2LibraryMode
+                    nativeEncoderConfig = encodeParams.toConfigArray()
+                    nativeEncoderFecGroupSize = fecGroupSize
+                    nativeEncoderCodec2Interleave = codec2Interleave
+                    nativeEncoderHeaderExt = headerExt
+                    peerPlayoutPolicy = playoutPolicies[activeProfile.id]
                 }
             Log.d(TAG, "TX pipeline prepared with native encoder: ${encodeParams.codecType} @ ${encodeParams.sampleRate}Hz")
         }
@@ -864,6 +1230,12 @@ class Telephone(
         audioInput?.start()
         linkSource?.start()
         packetizer?.start()
+        if (pttMode) applyPttState()
+        if (txPacingBurst > 0 && useNativeCodec && useNativePlayback) {
+            NativeCaptureEngine.setTxPacing(txPacingBurst)
+        }
+        startLatencyProbe()
+        startThermalMonitor()
 
         Log.i(TAG, "Audio pipelines started")
     }
@@ -937,7 +1309,7 @@ class Telephone(
         packetizer?.codec = activeProfile.createCodec()
 
         // Restore mute state (CONTEXT.md: mute persists across profile switches)
-        transmitMixer?.mute(wasMuted)
+        transmitMixer?.mute(wasMuted || (pttMode && !pttKeyed))
 
         // Start new pipeline
         transmitMixer?.start()
@@ -951,7 +1323,7 @@ class Telephone(
      * and restarts the capture pipeline.
      */
     private fun reconfigureTransmitNativeCodec(wasMuted: Boolean) {
-        val encodeParams = activeProfile.nativeEncodeParams()
+        val encodeParams = withDred(activeProfile.nativeEncodeParams(), activeProfile)
 
         // Stop capture stream
         audioInput?.stop()
@@ -964,22 +1336,114 @@ class Telephone(
         // engine is confirmed to exist (avoids the nullptr lifecycle bug).
         (audioInput as? OboeLineSource)?.apply {
             codecHeaderByte = encodeParams.codecHeaderByte
-            nativeEncoderCodecType = encodeParams.codecType
-            nativeEncoderSampleRate = encodeParams.sampleRate
-            nativeEncoderChannels = encodeParams.channels
-            nativeEncoderOpusApp = encodeParams.opusApplication
-            nativeEncoderOpusBitrate = encodeParams.opusBitrate
-            nativeEncoderOpusComplexity = encodeParams.opusComplexity
-            nativeEncoderCodec2Mode = encodeParams.codec2LibraryMode
+            nativeEncoderConfig = encodeParams.toConfigArray()
+            nativeEncoderFecGroupSize = fecGroupSize
+            nativeEncoderCodec2Interleave = codec2Interleave
+            nativeEncoderHeaderExt = headerExt
+            peerPlayoutPolicy = playoutPolicies[activeProfile.id]
         }
 
-        // Restore mute state (atomic bool persists across configureEncoder)
+        // Restore mute state (atomic bool persists across configureEncoder,
+        // and so does the PTT gate)
         NativeCaptureEngine.setCaptureMute(wasMuted)
 
         // Restart capture — start() configures the new encoder
         audioInput?.start()
     }
 
+    // ===== Latency Probe =====
+
+    /**
+     * Periodically probe round-trip time while the call is established and
+     * fold in the native capture/playout delays for a mouth-to-ear estimate.
+     */
+    private fun startLatencyProbe() {
+        latencyProbeJob?.cancel()
+        latencyProbe.reset()
+        latencyProbeJob =
+            scope.launch {
+                while (true) {
+                    delay(LATENCY_PROBE_INTERVAL_MS)
+                    if (callStatus != Signalling.STATUS_ESTABLISHED) continue
+
+                    updateLocalLatency()
+                    if (dred && useNativeCodec && useNativePlayback) {
+                        // Plan the TX redundancy for the loss we see on RX
+                        val lossPermille = NativePlaybackEngine.getLossPermille()
+                        if (lossPermille >= 0) NativeCaptureEngine.setExpectedLossPct((lossPermille + 9) / 10)
+                    }
+                    latencyProbe.sendProbe()
+                    latencyProbe.estimate?.let {
+                        if (nack && useNativeCodec && useNativePlayback) {
+                            NativePlaybackEngine.setNackRttMs(it.rttMs)
+                        }
+                        Log.d(
+                            TAG,
+                            "Latency: rtt=${it.rttMs}±${it.rttVarMs}ms capture=${it.captureDelayMs}ms " +
+                                "playout=${it.playoutDelayMs}ms mouthToEar=${it.mouthToEarMs}ms (n=${it.samples})",
+                        )
+                    }
+                }
+            }
+    }
+
+    private fun stopLatencyProbe() {
+        latencyProbeJob?.cancel()
+        latencyProbeJob = null
+    }
+
+    /**
+     * Feed thermal headroom to the native encoder's complexity governor, so
+     * a throttling phone drops Opus complexity before encodes start to
+     * overrun. Native codec path only; needs API 29.
+     */
+    private fun startThermalMonitor() {
+        if (!(useNativeCodec && useNativePlayback)) return
+        if (Build.VERSION.SDK_INT < Build.VERSION_CODES.Q) return
+        val powerManager = context.getSystemService(PowerManager::class.java) ?: return
+
+        thermalJob?.cancel()
+        thermalJob =
+            scope.launch {
+                while (true) {
+                    val headroom =
+                        if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.R) {
+                            powerManager.getThermalHeadroom(THERMAL_FORECAST_SECONDS)
+                        } else {
+                            thermalStatusToHeadroom(powerManager.currentThermalStatus)
+                        }
+                    try {
+                        NativeCaptureEngine.setThermalHeadroom(headroom)
+                    } catch (e: UnsatisfiedLinkError) {
+                        Log.w(TAG, "Native capture engine unavailable for thermal hint: ${e.message}")
+                        return@launch
+                    }
+                    delay(THERMAL_POLL_INTERVAL_MS)
+                }
+            }
+    }
+
+    private fun stopThermalMonitor() {
+        thermalJob?.cancel()
+        thermalJob = null
+    }
+
+    /**
+     * Read capture and playout delays from the Oboe engines. The legacy
+     * AudioRecord/AudioTrack path has no equivalent, so only RTT is tracked there.
+     */
+    private fun updateLocalLatency() {
+        if (!useNativePlayback) return
+        try {
+            latencyProbe.updateLocalDelays(
+                captureDelayMs = NativeCaptureEngine.getCaptureDelayMs(),
+                playoutDelayMs = NativePlaybackEngine.getPlayoutDelayMs(),
+            )
+        } catch (e: UnsatisfiedLinkError) {
+            Log.w(TAG, "Native engines unavailable for latency: ${e.message}")
+        }
+    }
+
     // ===== Dial Tone / Ring Tone =====
 
     /**
@@ -1219,17 +1683,11 @@ class Telephone(
 
         if (useNativeCodec && useNativePlayback) {
             // Phase 3: Reconfigure native decoder for new profile
-            val decodeParams = profile.nativeDecodeParams()
+            val decodeParams = withDred(profile.nativeDecodeParams(), profile)
             NativePlaybackEngine.destroyDecoder()
-            NativePlaybackEngine.configureDecoder(
-                codecType = decodeParams.codecType,
-                sampleRate = decodeParams.sampleRate,
-                channels = decodeParams.channels,
-                opusApp = decodeParams.opusApplication,
-                opusBitrate = decodeParams.opusBitrate,
-                opusComplexity = decodeParams.opusComplexity,
-                codec2Mode = decodeParams.codec2LibraryMode,
-            )
+            NativePlaybackEngine.configureDecoder(decodeParams.toConfigArray())
+            linkSource?.codecHeader = decodeParams.codecHeaderByte
+            startArrivalTrace(clear = false)
 
             // Reconfigure audio output for new decode rate
             audioOutput?.let { sink ->
@@ -1241,6 +1699,7 @@ class Telephone(
             val decodeCodec = profile.createDecodeCodec()
             val decodeRate = decodeCodec.preferredSamplerate ?: 48000
             linkSource?.codec = decodeCodec
+            linkSource?.codecHeader = Packetizer.codecHeaderByte(decodeCodec)
             linkSource?.sampleRate = decodeRate
 
             // Reconfigure audio output for new decode rate
@@ -1333,6 +1792,8 @@ class Telephone(
         dialToneJob?.cancel()
         ringToneJob?.cancel()
         timeoutJob?.cancel()
+        latencyProbeJob?.cancel()
+        thermalJob?.cancel()
     }
 }
 
@@ -0,0 +1,167 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+#include "codec2_codec.h"
+#include "include/codec2/codec2.h"
+
+// Runs against fake_codec2.cpp: a sub-frame decodes to the first sample
+// it was encoded from, so every output sub-frame names its source.
+
+namespace {
+
+typedef std::vector<uint8_t> Packet;
+typedef std::vector<int16_t> Pcm;
+
+// ULBW geometry: 700C, 40 ms sub-frames, 400 ms frames
+constexpr int SUB_SAMPLES = 320;
+constexpr int SUBS = 10;
+constexpr int FRAME_SAMPLES = SUB_SAMPLES * SUBS;
+
+int16_t marker(int frame, int sub) {
+    return static_cast<int16_t>(frame * 100 + sub + 1);
+}
+
+Pcm voiceFrame(int frame) {
+    Pcm pcm(FRAME_SAMPLES);
+    for (int i = 0; i < FRAME_SAMPLES; i++) pcm[i] = marker(frame, i / SUB_SAMPLES);
+    return pcm;
+}
+
+// Source marker of each sub-frame of decoded output
+std::vector<int16_t> subMarkers(const Pcm& pcm) {
+    std::vector<int16_t> out;
+    for (size_t i = 0; i < pcm.size(); i += SUB_SAMPLES) out.push_back(pcm[i]);
+    return out;
+}
+
+std::vector<int16_t> frameMarkers(int frame) {
+    std::vector<int16_t> out;
+    for (int s = 0; s < SUBS; s++) out.push_back(marker(frame, s));
+    return out;
+}
+
+class Codec2InterleaveTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        CodecConfig config;
+        config.type = CodecType::CODEC2;
+        config.codec2Mode = CODEC2_MODE_700C;
+        ASSERT_TRUE(encoder.create(config, nullptr));
+        ASSERT_TRUE(decoder.create(config, nullptr));
+        encoder.setInterleave(true);
+    }
+
+    Packet encode(const Pcm& pcm) {
+        Packet out(1 + SUBS * 4);
+        int n = encoder.encode(pcm.data(), static_cast<int>(pcm.size()), out.data(),
+                               static_cast<int>(out.size()));
+        EXPECT_EQ(static_cast<int>(out.size()), n);
+        return out;
+    }
+
+    Pcm decode(const Packet& packet) {
+        Pcm out(3 * FRAME_SAMPLES);
+        int n = decoder.decode(packet.data(), static_cast<int>(packet.size()), out.data(),
+                               static_cast<int>(out.size()));
+        EXPECT_GE(n, 0);
+        out.resize(n < 0 ? 0 : n);
+        return out;
+    }
+
+    // A talk spurt of `frames` voice frames, then the silence frame the
+    // capture engine sends at spurt end
+    std::vector<Packet> spurt(int frames) {
+        std::vector<Packet> wire;
+        for (int f = 0; f < frames; f++) wire.push_back(encode(voiceFrame(f)));
+        wire.push_back(encode(Pcm(FRAME_SAMPLES, 0)));
+        return wire;
+    }
+
+    Codec2Codec encoder;
+    Codec2Codec decoder;
+};
+
+TEST_F(Codec2InterleaveTest, HeaderCarriesFlagModeAndSequence) {
+    for (int f = 0; f < 10; f++) {
+        Packet p = encode(voiceFrame(f));
+        EXPECT_EQ(Codec2Codec::INTERLEAVE_FLAG, p[0] & Codec2Codec::INTERLEAVE_FLAG);
+        EXPECT_EQ(0x00, p[0] & 0x0F);  // 700C wire header
+        EXPECT_EQ(f & 0x7, (p[0] >> 4) & 0x7);
+    }
+}
+
+TEST_F(Codec2InterleaveTest, PacketsCarryEvenHalfOfThisFrameAndOddHalfOfThePrevious) {
+    encode(voiceFrame(0));
+    Packet p = encode(voiceFrame(1));
+    for (int s = 0; s < SUBS; s++) {
+        int16_t value;
+        std::memcpy(&value, &p[1 + s * 4], sizeof(value));
+        EXPECT_EQ(marker((s & 1) ? 0 : 1, s), value) << "slot " << s;
+    }
+}
+
+TEST_F(Codec2InterleaveTest, InOrderRoundTripIsOneFrameLate) {
+    const int frames = 12;  // Sequence wraps past 7
+    std::vector<Packet> wire = spurt(frames);
+
+    // The first packet completes the encoder's silent "previous frame"
+    EXPECT_EQ(std::vector<int16_t>(SUBS, 0), subMarkers(decode(wire[0])));
+    for (int f = 1; f < frames; f++) {
+        EXPECT_EQ(frameMarkers(f - 1), subMarkers(decode(wire[f]))) << "packet " << f;
+    }
+}
+
+TEST_F(Codec2InterleaveTest, SpurtEndSilenceFrameCompletesTheLastFrame) {
+    const int frames = 3;
+    std::vector<Packet> wire = spurt(frames);
+    ASSERT_EQ(static_cast<size_t>(frames + 1), wire.size());
+    for (int f = 0; f < frames; f++) decode(wire[f]);
+
+    // Without the silence packet the last frame's odd half never leaves
+    EXPECT_EQ(frameMarkers(frames - 1), subMarkers(decode(wire[frames])));
+}
+
+TEST_F(Codec2InterleaveTest, LostPacketLeavesScatteredSubFrameGaps) {
+    std::vector<Packet> wire = spurt(6);
+    const int lost = 3;
+    for (int f = 0; f < lost; f++) decode(wire[f]);
+
+    // The next packet yields both frames the lost one touched. Each
+    // missing slot repeats its neighbour; no two adjacent slots are lost.
+    std::vector<int16_t> got = subMarkers(decode(wire[lost + 1]));
+    ASSERT_EQ(static_cast<size_t>(2 * SUBS), got.size());
+    for (int s = 0; s < SUBS; s++) {
+        // Frame lost-1: even half was held, odd half went with the lost packet
+        int src = (s & 1) ? s - 1 : s;
+        EXPECT_EQ(marker(lost - 1, src), got[s]) << "frame " << lost - 1 << " slot " << s;
+    }
+    for (int s = 0; s < SUBS; s++) {
+        // Frame lost: odd half arrived, even half went with the lost packet
+        int src = (s & 1) ? s : (s == 0 ? 1 : s - 1);
+        EXPECT_EQ(marker(lost, src), got[SUBS + s]) << "frame " << lost << " slot " << s;
+    }
+
+    // Back in step from the following packet
+    EXPECT_EQ(frameMarkers(lost + 1), subMarkers(decode(wire[lost + 2])));
+    EXPECT_EQ(frameMarkers(lost + 2), subMarkers(decode(wire[lost + 3])));
+}
+
+TEST_F(Codec2InterleaveTest, OutputTooSmallIsRejected) {
+    Packet p = encode(voiceFrame(0));
+    Pcm out(FRAME_SAMPLES - 1);
+    EXPECT_EQ(-1, decoder.decode(p.data(), static_cast<int>(p.size()), out.data(),
+                                 static_cast<int>(out.size())));
+}
+
+TEST_F(Codec2InterleaveTest, PlainPacketsStillDecodeInPlace) {
+    encoder.setInterleave(false);
+    Packet p = encode(voiceFrame(4));
+    EXPECT_EQ(0x00, p[0]);
+    EXPECT_EQ(frameMarkers(4), subMarkers(decode(p)));
+}
+
+} // namespace
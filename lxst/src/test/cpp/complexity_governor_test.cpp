@@ -0,0 +1,89 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <gtest/gtest.h>
+#include "complexity_governor.h"
+
+namespace {
+
+// Opus decoder tiers as the playback engine uses them
+const int kTiers[] = {0, 5, 6, 7};
+
+ComplexityGovernor makeGovernor(int startIndex, int holdSamples = 4) {
+    ComplexityGovernor g;
+    g.configure(kTiers, 4, startIndex, 40, 15, holdSamples);
+    return g;
+}
+
+}  // namespace
+
+TEST(ComplexityGovernor, StartsAtTheStartIndex) {
+    ComplexityGovernor g = makeGovernor(1);
+    EXPECT_EQ(1, g.index());
+    EXPECT_EQ(5, g.level());
+    EXPECT_EQ(4, g.numLevels());
+}
+
+TEST(ComplexityGovernor, StepsDownOnceTheSmoothedLoadCrossesHigh) {
+    ComplexityGovernor g = makeGovernor(3);
+    int steps = 0;
+    int samples = 0;
+    while (steps == 0 && samples < 100) {
+        steps += g.update(60) ? 1 : 0;
+        samples++;
+    }
+    ASSERT_EQ(1, steps);
+    EXPECT_GT(samples, 1);  // Smoothed: one sample at 60% is not enough
+    EXPECT_EQ(2, g.index());
+    EXPECT_EQ(15, g.smoothedPct());  // Restarts at the low mark
+}
+
+TEST(ComplexityGovernor, SingleOverrunStepsDownAtOnce) {
+    ComplexityGovernor g = makeGovernor(3);
+    EXPECT_TRUE(g.update(100));
+    EXPECT_EQ(6, g.level());
+}
+
+TEST(ComplexityGovernor, NeverStepsBelowTheCheapestLevel) {
+    ComplexityGovernor g = makeGovernor(0);
+    for (int i = 0; i < 20; i++) EXPECT_FALSE(g.update(150));
+    EXPECT_EQ(0, g.level());
+}
+
+TEST(ComplexityGovernor, StepsUpAfterAHoldOfLowLoad) {
+    ComplexityGovernor g = makeGovernor(1, 4);
+    for (int i = 0; i < 3; i++) EXPECT_FALSE(g.update(5));
+    EXPECT_TRUE(g.update(5));
+    EXPECT_EQ(6, g.level());
+}
+
+TEST(ComplexityGovernor, ModerateLoadRestartsTheHold) {
+    ComplexityGovernor g = makeGovernor(1, 4);
+    for (int i = 0; i < 3; i++) g.update(5);
+    EXPECT_FALSE(g.update(20));  // Between low and high: holds the level
+    for (int i = 0; i < 3; i++) EXPECT_FALSE(g.update(5));
+    EXPECT_TRUE(g.update(5));
+    EXPECT_EQ(2, g.index());
+}
+
+TEST(ComplexityGovernor, CeilingDropsTheLevelAndBlocksSteppingUp) {
+    ComplexityGovernor g = makeGovernor(3, 2);
+    EXPECT_TRUE(g.setCeilingIndex(1));
+    EXPECT_EQ(5, g.level());
+    for (int i = 0; i < 10; i++) EXPECT_FALSE(g.update(0));
+    EXPECT_EQ(5, g.level());
+
+    EXPECT_FALSE(g.setCeilingIndex(3));  // Raising it doesn't jump...
+    EXPECT_EQ(5, g.level());
+    EXPECT_TRUE(g.update(0));            // ...but the hold already served counts
+    EXPECT_EQ(6, g.level());
+}
+
+TEST(ComplexityGovernor, OutOfRangeConfigurationIsClamped) {
+    ComplexityGovernor g;
+    g.configure(kTiers, 4, 9, 40, 15, 1);
+    EXPECT_EQ(7, g.level());
+    EXPECT_TRUE(g.setCeilingIndex(-3));
+    EXPECT_EQ(0, g.level());
+}
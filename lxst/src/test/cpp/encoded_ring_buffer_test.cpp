@@ -0,0 +1,86 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <gtest/gtest.h>
+#include "encoded_ring_buffer.h"
+
+namespace {
+
+constexpr int64_t kMs = 1000000;
+
+// One-byte packet carrying its index, stamped with a capture time
+bool writePacket(EncodedRingBuffer& b, uint8_t index, int64_t captureNs) {
+    return b.write(&index, 1, captureNs, index);
+}
+
+// Index of the next packet read, or -1 if none
+int readIndex(EncodedRingBuffer& b) {
+    uint8_t data[8];
+    int length = 0;
+    int tag = -1;
+    if (!b.read(data, sizeof(data), &length, &tag)) return -1;
+    EXPECT_EQ(1, length);
+    EXPECT_EQ(data[0], tag);
+    return data[0];
+}
+
+}  // namespace
+
+TEST(EncodedRingBuffer, DropsStalePacketsAtTheHeadAndCountsThem) {
+    EncodedRingBuffer b(8, 16);
+    int64_t now = 1000 * kMs;
+    // Three packets held up by a stalled reader, then two fresh ones
+    writePacket(b, 0, now - 300 * kMs);
+    writePacket(b, 1, now - 280 * kMs);
+    writePacket(b, 2, now - 260 * kMs);
+    writePacket(b, 3, now - 40 * kMs);
+    writePacket(b, 4, now - 20 * kMs);
+
+    // As the capture engine dequeues with a 120ms age limit
+    EXPECT_EQ(3, b.dropStale(now - 120 * kMs));
+    EXPECT_EQ(2, b.availableSlots());
+    EXPECT_EQ(3, readIndex(b));
+    EXPECT_EQ(4, readIndex(b));
+    EXPECT_EQ(-1, readIndex(b));
+}
+
+TEST(EncodedRingBuffer, StopsAtTheFirstFreshPacketToKeepOrder) {
+    EncodedRingBuffer b(8, 16);
+    int64_t now = 1000 * kMs;
+    writePacket(b, 0, now - 300 * kMs);
+    writePacket(b, 1, now - 10 * kMs);
+    writePacket(b, 2, now - 300 * kMs);  // Out of order stamp behind a fresh one
+
+    EXPECT_EQ(1, b.dropStale(now - 120 * kMs));
+    EXPECT_EQ(1, readIndex(b));
+    EXPECT_EQ(2, readIndex(b));
+}
+
+TEST(EncodedRingBuffer, UnstampedPacketsAreNeverStale) {
+    EncodedRingBuffer b(8, 16);
+    writePacket(b, 0, 0);
+    writePacket(b, 1, 5 * kMs);
+
+    EXPECT_EQ(0, b.dropStale(1000 * kMs));
+    EXPECT_EQ(2, b.availableSlots());
+    EXPECT_EQ(0, readIndex(b));
+    EXPECT_EQ(1, b.dropStale(1000 * kMs));
+    EXPECT_EQ(0, b.availableSlots());
+}
+
+TEST(EncodedRingBuffer, DropsAcrossTheWrapAndFreesTheSlots) {
+    EncodedRingBuffer b(4, 16);  // Holds 3
+    int64_t now = 1000 * kMs;
+    for (uint8_t i = 0; i < 2; i++) {
+        ASSERT_TRUE(writePacket(b, i, now));
+        ASSERT_EQ(i, readIndex(b));
+    }
+    for (uint8_t i = 2; i < 5; i++) ASSERT_TRUE(writePacket(b, i, now - 500 * kMs));
+    EXPECT_FALSE(writePacket(b, 5, now));  // Full
+
+    EXPECT_EQ(3, b.dropStale(now - 120 * kMs));
+    EXPECT_EQ(0, b.dropStale(now - 120 * kMs));  // Empty: nothing more
+    for (uint8_t i = 5; i < 8; i++) EXPECT_TRUE(writePacket(b, i, now));
+    EXPECT_EQ(5, readIndex(b));
+}
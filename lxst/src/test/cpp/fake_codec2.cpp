@@ -0,0 +1,52 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+// Host stand-in for libcodec2 with the real frame geometry. A sub-frame
+// encodes to its first sample, and decodes to that value repeated, so
+// tests can tell exactly which sub-frame ended up where.
+
+#include <cstring>
+#include <new>
+#include "include/codec2/codec2.h"
+
+struct CODEC2 {
+    int samplesPerFrame;
+    int bytesPerFrame;
+};
+
+struct CODEC2* codec2_create(int mode) {
+    switch (mode) {
+        case CODEC2_MODE_3200: return new (std::nothrow) CODEC2{160, 8};
+        case CODEC2_MODE_2400: return new (std::nothrow) CODEC2{160, 6};
+        case CODEC2_MODE_1600: return new (std::nothrow) CODEC2{320, 8};
+        case CODEC2_MODE_1400: return new (std::nothrow) CODEC2{320, 7};
+        case CODEC2_MODE_1300: return new (std::nothrow) CODEC2{320, 7};
+        case CODEC2_MODE_1200: return new (std::nothrow) CODEC2{320, 6};
+        case CODEC2_MODE_700C: return new (std::nothrow) CODEC2{320, 4};
+        default: return nullptr;
+    }
+}
+
+void codec2_destroy(struct CODEC2* codec2_state) {
+    delete codec2_state;
+}
+
+void codec2_encode(struct CODEC2* codec2_state, unsigned char bytes[], short speech_in[]) {
+    std::memset(bytes, 0, codec2_state->bytesPerFrame);
+    std::memcpy(bytes, &speech_in[0], sizeof(short));
+}
+
+void codec2_decode(struct CODEC2* codec2_state, short speech_out[], const unsigned char bytes[]) {
+    short value;
+    std::memcpy(&value, bytes, sizeof(short));
+    for (int i = 0; i < codec2_state->samplesPerFrame; i++) speech_out[i] = value;
+}
+
+int codec2_samples_per_frame(struct CODEC2* codec2_state) {
+    return codec2_state->samplesPerFrame;
+}
+
+int codec2_bytes_per_frame(struct CODEC2* codec2_state) {
+    return codec2_state->bytesPerFrame;
+}
@@ -0,0 +1,235 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include "g722_codec.h"
+#include "pcm_codec.h"
+
+namespace {
+
+CodecConfig config(CodecType type, int sampleRate) {
+    CodecConfig c;
+    c.type = type;
+    c.sampleRate = sampleRate;
+    c.channels = 1;
+    return c;
+}
+
+std::vector<int16_t> tone(int sampleRate, double hz, double amplitude, int samples) {
+    std::vector<int16_t> out(samples);
+    for (int i = 0; i < samples; i++) {
+        out[i] = static_cast<int16_t>(std::lround(amplitude * std::sin(2.0 * M_PI * hz * i / sampleRate)));
+    }
+    return out;
+}
+
+// Encode and decode in 20ms frames, as the engines do
+std::vector<int16_t> roundTrip(PcmCodec& codec, const std::vector<int16_t>& in, int frame) {
+    std::vector<int16_t> out;
+    std::vector<uint8_t> enc(frame * 2);
+    std::vector<int16_t> dec(frame);
+    for (size_t pos = 0; pos + frame <= in.size(); pos += frame) {
+        int bytes = codec.encode(&in[pos], frame, enc.data(), static_cast<int>(enc.size()));
+        EXPECT_GT(bytes, 0);
+        int n = codec.decode(enc.data(), bytes, dec.data(), frame);
+        EXPECT_EQ(frame, n);
+        out.insert(out.end(), dec.begin(), dec.begin() + n);
+    }
+    return out;
+}
+
+std::vector<int16_t> roundTrip(G722Codec& enc, G722Codec& dec, const std::vector<int16_t>& in, int frame) {
+    std::vector<int16_t> out;
+    std::vector<uint8_t> bytes(frame / 2);
+    std::vector<int16_t> pcm(frame);
+    for (size_t pos = 0; pos + frame <= in.size(); pos += frame) {
+        EXPECT_EQ(frame / 2, enc.encode(&in[pos], frame, bytes.data(), frame / 2));
+        EXPECT_EQ(frame, dec.decode(bytes.data(), frame / 2, pcm.data(), frame));
+        out.insert(out.end(), pcm.begin(), pcm.end());
+    }
+    return out;
+}
+
+// SNR in dB of out against in, at the lag (0..maxLag) that fits best,
+// over [from, end). The QMF pair delays G.722 output by a few samples.
+double bestSnrDb(const std::vector<int16_t>& in, const std::vector<int16_t>& out,
+                 size_t from, int maxLag, int* lagOut) {
+    double best = -1e9;
+    for (int lag = 0; lag <= maxLag; lag++) {
+        double sig = 0, err = 0;
+        for (size_t i = from; i + lag < out.size() && i < in.size(); i++) {
+            double d = out[i + lag] - static_cast<double>(in[i]);
+            sig += static_cast<double>(in[i]) * in[i];
+            err += d * d;
+        }
+        double snr = 10.0 * std::log10(sig / (err + 1e-9));
+        if (snr > best) {
+            best = snr;
+            *lagOut = lag;
+        }
+    }
+    return best;
+}
+
+double rms(const std::vector<int16_t>& v, size_t from) {
+    double sum = 0;
+    for (size_t i = from; i < v.size(); i++) sum += static_cast<double>(v[i]) * v[i];
+    return std::sqrt(sum / (v.size() - from));
+}
+
+}  // namespace
+
+TEST(PcmCodecTest, Pcm16IsBitExactLittleEndian) {
+    PcmCodec codec;
+    ASSERT_TRUE(codec.create(config(CodecType::PCM16, 8000), nullptr));
+
+    const int16_t pcm[] = {0, 1, -1, 0x1234, -32768, 32767};
+    uint8_t enc[12];
+    ASSERT_EQ(12, codec.encode(pcm, 6, enc, sizeof(enc)));
+    EXPECT_EQ(0x34, enc[6]);
+    EXPECT_EQ(0x12, enc[7]);
+    EXPECT_EQ(0x00, enc[8]);
+    EXPECT_EQ(0x80, enc[9]);
+
+    int16_t dec[6];
+    ASSERT_EQ(6, codec.decode(enc, 12, dec, 6));
+    for (int i = 0; i < 6; i++) EXPECT_EQ(pcm[i], dec[i]);
+
+    EXPECT_EQ(-1, codec.encode(pcm, 6, enc, 11));
+    EXPECT_EQ(-1, codec.decode(enc, 12, dec, 5));
+}
+
+TEST(PcmCodecTest, UlawKnownCodePoints) {
+    // ITU-T G.711 / Sun g711.c reference values
+    EXPECT_EQ(0xFF, PcmCodec::linearToUlaw(0));
+    EXPECT_EQ(0x7F, PcmCodec::linearToUlaw(-1));
+    EXPECT_EQ(0x80, PcmCodec::linearToUlaw(32767));
+    EXPECT_EQ(0x00, PcmCodec::linearToUlaw(-32768));
+    EXPECT_EQ(0, PcmCodec::ulawToLinear(0xFF));
+    EXPECT_EQ(0, PcmCodec::ulawToLinear(0x7F));
+    EXPECT_EQ(8, PcmCodec::ulawToLinear(0xFE));
+    EXPECT_EQ(-8, PcmCodec::ulawToLinear(0x7E));
+    EXPECT_EQ(32124, PcmCodec::ulawToLinear(0x80));
+    EXPECT_EQ(-32124, PcmCodec::ulawToLinear(0x00));
+}
+
+TEST(PcmCodecTest, AlawKnownCodePoints) {
+    EXPECT_EQ(0xD5, PcmCodec::linearToAlaw(0));
+    EXPECT_EQ(0x55, PcmCodec::linearToAlaw(-1));
+    EXPECT_EQ(0xAA, PcmCodec::linearToAlaw(32767));
+    EXPECT_EQ(0x2A, PcmCodec::linearToAlaw(-32768));
+    EXPECT_EQ(8, PcmCodec::alawToLinear(0xD5));
+    EXPECT_EQ(-8, PcmCodec::alawToLinear(0x55));
+    EXPECT_EQ(32256, PcmCodec::alawToLinear(0xAA));
+    EXPECT_EQ(-32256, PcmCodec::alawToLinear(0x2A));
+}
+
+TEST(PcmCodecTest, G711CodesSurviveDecodeEncode) {
+    for (int code = 0; code < 256; code++) {
+        auto c = static_cast<uint8_t>(code);
+        // 0x7F is µ-law negative zero; it decodes to 0, which encodes as 0xFF
+        if (c != 0x7F) {
+            EXPECT_EQ(c, PcmCodec::linearToUlaw(PcmCodec::ulawToLinear(c))) << code;
+        }
+        EXPECT_EQ(c, PcmCodec::linearToAlaw(PcmCodec::alawToLinear(c))) << code;
+    }
+}
+
+TEST(PcmCodecTest, G711ErrorStaysWithinHalfASegmentStep) {
+    // 4-bit mantissa: a step is at most 1/16 of the value, plus the
+    // fixed steps near zero (µ-law bias, A-law linear segment)
+    for (int x = -32635; x <= 32635; x += 7) {
+        auto s = static_cast<int16_t>(x);
+        int bound = std::abs(x) / 32 + 16;
+        EXPECT_LE(std::abs(PcmCodec::ulawToLinear(PcmCodec::linearToUlaw(s)) - x), bound) << x;
+        EXPECT_LE(std::abs(PcmCodec::alawToLinear(PcmCodec::linearToAlaw(s)) - x), bound) << x;
+    }
+}
+
+TEST(PcmCodecTest, CompandedFramesRoundTripAtAnyRate) {
+    for (CodecType type : {CodecType::PCMU, CodecType::PCMA}) {
+        PcmCodec codec;
+        ASSERT_TRUE(codec.create(config(type, 48000), nullptr));
+        auto in = tone(48000, 1000, 12000, 48000);
+
+        uint8_t enc[960];
+        ASSERT_EQ(960, codec.encode(in.data(), 960, enc, sizeof(enc)));  // 1 byte/sample
+
+        auto out = roundTrip(codec, in, 960);
+        ASSERT_EQ(in.size(), out.size());
+        int lag = -1;
+        EXPECT_GT(bestSnrDb(in, out, 0, 0, &lag), 35.0) << static_cast<int>(type);
+    }
+}
+
+TEST(PcmCodecTest, RejectsOtherTypesAndStereo) {
+    PcmCodec codec;
+    EXPECT_FALSE(codec.create(config(CodecType::G722, 16000), nullptr));
+    CodecConfig stereo = config(CodecType::PCMU, 8000);
+    stereo.channels = 2;
+    EXPECT_FALSE(codec.create(stereo, nullptr));
+}
+
+TEST(G722CodecTest, PacksTwoSamplesPerByte) {
+    G722Codec codec;
+    ASSERT_TRUE(codec.create(config(CodecType::G722, 16000), nullptr));
+
+    auto in = tone(16000, 1000, 8000, 321);
+    uint8_t enc[161];
+    EXPECT_EQ(160, codec.encode(in.data(), 321, enc, sizeof(enc)));  // Odd sample dropped
+    EXPECT_EQ(-1, codec.encode(in.data(), 320, enc, 159));
+
+    int16_t out[320];
+    EXPECT_EQ(320, codec.decode(enc, 160, out, 320));
+    EXPECT_EQ(-1, codec.decode(enc, 160, out, 319));
+}
+
+TEST(G722CodecTest, OnlyWidebandMono) {
+    G722Codec codec;
+    EXPECT_FALSE(codec.create(config(CodecType::G722, 8000), nullptr));
+    CodecConfig stereo = config(CodecType::G722, 16000);
+    stereo.channels = 2;
+    EXPECT_FALSE(codec.create(stereo, nullptr));
+}
+
+TEST(G722CodecTest, VoiceBandToneRoundTripsWithHighSnr) {
+    G722Codec enc, dec;
+    ASSERT_TRUE(enc.create(config(CodecType::G722, 16000), nullptr));
+    ASSERT_TRUE(dec.create(config(CodecType::G722, 16000), nullptr));
+
+    auto in = tone(16000, 1000, 10000, 16000);
+    auto out = roundTrip(enc, dec, in, 320);
+    ASSERT_EQ(in.size(), out.size());
+
+    // Skip the first 100ms while both ADPCM states adapt
+    int lag = -1;
+    double snr = bestSnrDb(in, out, 1600, 64, &lag);
+    EXPECT_GT(snr, 25.0);
+    EXPECT_GE(lag, 1);    // The QMF pair adds a fixed delay...
+    EXPECT_LE(lag, 30);   // ...of about 1.5ms
+    EXPECT_NEAR(rms(in, 1600), rms(out, 1600 + lag), rms(in, 1600) * 0.1);
+}
+
+TEST(G722CodecTest, PassesTheUpperBandAndStaysQuietOnSilence) {
+    // 6kHz sits in the high sub-band: G.722 is 7kHz audio, unlike G.711
+    G722Codec enc, dec;
+    ASSERT_TRUE(enc.create(config(CodecType::G722, 16000), nullptr));
+    ASSERT_TRUE(dec.create(config(CodecType::G722, 16000), nullptr));
+
+    auto high = tone(16000, 6000, 8000, 8000);
+    auto out = roundTrip(enc, dec, high, 320);
+    double ratio = rms(out, 1600) / rms(high, 1600);
+    EXPECT_GT(ratio, 0.7);
+    EXPECT_LT(ratio, 1.3);
+
+    G722Codec enc2, dec2;
+    ASSERT_TRUE(enc2.create(config(CodecType::G722, 16000), nullptr));
+    ASSERT_TRUE(dec2.create(config(CodecType::G722, 16000), nullptr));
+    std::vector<int16_t> silence(3200, 0);
+    auto quiet = roundTrip(enc2, dec2, silence, 320);
+    for (int16_t s : quiet) EXPECT_LE(std::abs(s), 32);
+}
@@ -0,0 +1,84 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <gtest/gtest.h>
+#include "playout_policy.h"
+
+namespace {
+
+// The engine's concealment counter, in frames: the callback adds PLC
+// frames and clears it when it serves real audio; packets claim from it.
+struct Concealment {
+    int frames = 0;
+
+    void conceal(int n) { frames += n; }
+    void serve() { frames = 0; }
+
+    bool arrive(int missing) {
+        bool late = false;
+        frames -= playoutConcealedClaim(frames, missing, &late);
+        return late;
+    }
+};
+
+TEST(PlayoutConcealedClaimTest, NothingConcealedIsOnTime) {
+    bool late = true;
+    EXPECT_EQ(0, playoutConcealedClaim(0, 0, &late));
+    EXPECT_FALSE(late);
+    EXPECT_EQ(0, playoutConcealedClaim(0, -1, &late));
+    EXPECT_FALSE(late);
+}
+
+TEST(PlayoutConcealedClaimTest, PacketAfterALossIsOnTime) {
+    // Packet 11 lost, one frame concealed in its slot; packet 12 is on time
+    Concealment c;
+    c.conceal(1);
+    EXPECT_FALSE(c.arrive(1));
+    EXPECT_EQ(0, c.frames);
+}
+
+TEST(PlayoutConcealedClaimTest, BurstLossThenOnTime) {
+    Concealment c;
+    c.conceal(2);
+    EXPECT_FALSE(c.arrive(3));  // Three holes, only two concealed so far
+    EXPECT_EQ(0, c.frames);
+}
+
+TEST(PlayoutConcealedClaimTest, DelayedPacketsAreLate) {
+    // Two slots concealed, then both packets turn up
+    Concealment c;
+    c.conceal(2);
+    EXPECT_TRUE(c.arrive(0));
+    EXPECT_TRUE(c.arrive(0));
+    EXPECT_FALSE(c.arrive(0));
+}
+
+TEST(PlayoutConcealedClaimTest, LossThenLatePacket) {
+    // Hole at 11, 12 delayed: three slots concealed before 12 shows up
+    Concealment c;
+    c.conceal(3);
+    EXPECT_TRUE(c.arrive(1));
+    EXPECT_EQ(1, c.frames);
+    EXPECT_TRUE(c.arrive(0));  // 13 too
+    EXPECT_FALSE(c.arrive(0));
+}
+
+TEST(PlayoutConcealedClaimTest, ServedFrameSettlesConcealment) {
+    // Real audio (a DRED rebuild, say) played after the concealment:
+    // the next packet is measured from there, not from the old PLC
+    Concealment c;
+    c.conceal(1);
+    c.serve();
+    EXPECT_FALSE(c.arrive(0));
+}
+
+TEST(PlayoutConcealedClaimTest, WithoutSequenceNumbersAnyConcealmentIsTheSlot) {
+    Concealment c;
+    c.conceal(2);
+    EXPECT_TRUE(c.arrive(-1));
+    EXPECT_TRUE(c.arrive(-1));
+    EXPECT_FALSE(c.arrive(-1));
+}
+
+} // namespace
@@ -0,0 +1,317 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include "audio_clock.h"
+#include "memory_ledger.h"
+#include "playout_buffer.h"
+#include "playout_policy.h"
+
+// Long XLL calls through the playback engine's PlayoutBuffer: its drain
+// step and callback fill, sized and charged to the memory ledger as
+// create() does. The sender's capture callbacks run on their own clock,
+// skewed against the playback callbacks, and cut their bursts into
+// frames. The link has jitter and optionally delay spikes, loss and
+// periodic stalls that arrive as one burst, alternately into the
+// silence-drop and the hard-drain range; the engine can be torn down and
+// re-created every few hours like a profile switch. Oboe, the codecs and
+// PLC are not involved: each frame's samples hold its sequence number,
+// so the output shows order and drops.
+
+namespace {
+
+constexpr int SAMPLE_RATE = 48000;
+constexpr int FRAME_US = 5000;                        // XLL
+constexpr int FRAME_SAMPLES = SAMPLE_RATE / 1000 * FRAME_US / 1000;
+constexpr int BURST_SAMPLES = 96;                     // 2 ms playback callbacks
+constexpr int64_t BURST_NS = 1000000000LL * BURST_SAMPLES / SAMPLE_RATE;
+constexpr int CAPTURE_BURST_SAMPLES = 192;            // 4 ms capture callbacks
+constexpr int PREBUFFER_MS = 450;                     // LinkSource.computePrebufferMs(5)
+constexpr int MAX_BUFFER_MS = 1500;                   // LinkSource.computeMaxBufferMs(5)
+constexpr int64_t MS_NS = 1000000;
+constexpr int64_t HOUR_NS = 3600LL * 1000 * MS_NS;
+constexpr int SEQ_MASK = 0x3FFF;                      // Sample value of a frame: its seq, wrapped
+
+struct Rng {
+    uint32_t state = 12345;
+    int below(int n) {
+        state = state * 1664525u + 1013904223u;
+        return static_cast<int>((state >> 8) % static_cast<uint32_t>(n));
+    }
+};
+
+// The engine's buffer as create() sizes it for a 5ms frame: one silence
+// segment per frame, ring room above the drain threshold.
+std::unique_ptr<PlayoutBuffer> createBuffer(const PlayoutPolicy& policy, MemoryLedger* ledger) {
+    PlayoutLevels levels;
+    levels.prebufferSamples = samplesForMs(PREBUFFER_MS, SAMPLE_RATE, 1);
+    levels.drainThresholdSamples = levels.prebufferSamples * policy.drainPct / 100;
+    levels.softDropSamples = playoutSoftDropSamples(levels.prebufferSamples,
+                                                    levels.drainThresholdSamples,
+                                                    policy.softDropPct);
+    int maxSamples = samplesForMs(MAX_BUFFER_MS, SAMPLE_RATE, 1);
+    if (maxSamples < levels.drainThresholdSamples + FRAME_SAMPLES) {
+        maxSamples = levels.drainThresholdSamples + FRAME_SAMPLES;
+    }
+    return std::make_unique<PlayoutBuffer>(FRAME_SAMPLES, slotsForSamples(maxSamples, FRAME_SAMPLES),
+                                           levels, FRAME_SAMPLES, ledger);
+}
+
+struct SentFrame {
+    int64_t seq;
+    int64_t arrivalNs;
+};
+
+// What the test saw of one engine's life, against which its counters
+// are checked at teardown
+struct Observed {
+    int64_t written = 0;         // write() calls
+    int64_t overflowDrops = 0;   // write() returned false
+    int64_t served = 0;          // onServed calls
+    int64_t outputSamples = 0;   // Returned by fill()
+    int64_t hardSteps = 0;
+    int64_t hardDrained = 0;     // Depth shed by HARD steps
+    int64_t softDropped = 0;     // Depth shed by SOFT steps
+};
+
+struct Link {
+    int64_t durationNs = 0;
+    int64_t recreateNs = 0;      // Engine lifetime (0 = the whole call)
+    int skewPpm = 0;             // Sender clock against playback, first half
+    int skewPpmLater = 0;        // Second half
+    bool lossy = false;          // 2% loss, rare 150 ms spikes
+    bool stalls = false;         // A stall every five minutes, 700 and 1100 ms in turn
+};
+
+struct Result {
+    int maxBuffered = 0;         // After the drain step, at any callback
+    int worstHourMeanMs = 0;
+    int64_t served = 0;
+    int64_t hardDrains = 0;
+    int64_t silenceDropped = 0;  // Samples
+    int64_t underrunSamples = 0; // Short of a full burst, once started
+    int64_t outOfOrder = 0;
+    int drainThreshold = 0;
+    int capacitySamples = 0;
+};
+
+void checkCounters(const PlayoutBuffer& b, const Observed& o) {
+    EXPECT_EQ(o.served, b.framesServed());
+    EXPECT_EQ(o.hardSteps, b.drainCount());
+    EXPECT_EQ(o.softDropped, b.silenceDroppedSamples());
+    // Every sample queued was played, drained, dropped as silence,
+    // displaced by an overflow or is still queued
+    EXPECT_EQ((o.written - o.overflowDrops) * FRAME_SAMPLES,
+              o.outputSamples + o.hardDrained + o.softDropped + b.bufferedSamples());
+}
+
+Result run(const Link& link) {
+    const PlayoutPolicy policy;
+    MemoryLedger ledger;
+    auto buffer = createBuffer(policy, &ledger);
+    const int64_t createdBytes = ledger.totalBytes();
+    EXPECT_GT(createdBytes, 0);
+
+    Result r;
+    r.drainThreshold = buffer->levels().drainThresholdSamples;
+    r.capacitySamples = (buffer->capacity() - 1) * FRAME_SAMPLES;
+    Observed o;
+    auto retire = [&](const PlayoutBuffer& b) {
+        checkCounters(b, o);
+        r.served += b.framesServed();
+        r.hardDrains += b.drainCount();
+        r.silenceDropped += b.silenceDroppedSamples();
+    };
+
+    Rng rng;
+    // Sender: capture callbacks on the skewed clock, cut into frames
+    int64_t nextCaptureNs = 0;
+    int captured = 0;              // Samples toward the next frame
+    int64_t nextSeq = 0;
+    std::deque<SentFrame> inFlight;
+    int64_t lastArrivalNs = 0;
+
+    // Receiver
+    int16_t frame[FRAME_SAMPLES];
+    int16_t out[BURST_SAMPLES];
+    bool started = false;          // LinkSource defers the stream to the prebuffer
+    int lastValue = -1;
+    int64_t nextRecreateNs = link.recreateNs > 0 ? link.recreateNs : link.durationNs;
+    int64_t hourDepthSum = 0;
+    int64_t hourCallbacks = 0;
+    int64_t hourEndNs = HOUR_NS;
+
+    for (int64_t nowNs = 0; nowNs < link.durationNs; nowNs += BURST_NS) {
+        if (nowNs >= nextRecreateNs) {
+            // Profile switch: destroy() then create()
+            retire(*buffer);
+            buffer.reset();
+            EXPECT_EQ(0, ledger.totalBytes());
+            buffer = createBuffer(policy, &ledger);
+            EXPECT_EQ(createdBytes, ledger.totalBytes());
+            o = Observed();
+            started = false;
+            lastValue = -1;
+            nextRecreateNs += link.recreateNs;
+        }
+
+        // Capture callbacks due by now; a frame is sent when one completes.
+        // The link is FIFO with 60-80 ms delay; stalled frames queue up
+        // and arrive together.
+        while (nextCaptureNs <= nowNs) {
+            captured += CAPTURE_BURST_SAMPLES;
+            while (captured >= FRAME_SAMPLES) {
+                captured -= FRAME_SAMPLES;
+                int64_t sendNs = nextCaptureNs;
+                int64_t arrivalNs = sendNs + 60 * MS_NS + rng.below(20000) * 1000LL;
+                if (link.lossy && rng.below(100) == 0) arrivalNs += 150 * MS_NS;
+                if (link.stalls) {
+                    int64_t window = sendNs / (300000 * MS_NS);
+                    int64_t stallStartNs = window * 300000 * MS_NS + 150000 * MS_NS;
+                    int64_t stallNs = ((window & 1) ? 1100 : 700) * MS_NS;
+                    if (sendNs >= stallStartNs && sendNs < stallStartNs + stallNs) {
+                        arrivalNs = stallStartNs + stallNs + 60 * MS_NS;
+                    }
+                }
+                if (arrivalNs < lastArrivalNs) arrivalNs = lastArrivalNs;
+                lastArrivalNs = arrivalNs;
+                inFlight.push_back({nextSeq++, arrivalNs});
+            }
+            int ppm = nextCaptureNs < link.durationNs / 2 ? link.skewPpm : link.skewPpmLater;
+            nextCaptureNs += 1000000000LL * CAPTURE_BURST_SAMPLES / SAMPLE_RATE
+                * 1000000 / (1000000 + ppm);
+        }
+
+        // Deliver every frame that has arrived by now
+        while (!inFlight.empty() && inFlight.front().arrivalNs <= nowNs) {
+            SentFrame f = inFlight.front();
+            inFlight.pop_front();
+            int64_t seq = f.seq;
+            if (link.lossy && rng.below(50) == 0) continue;  // Lost
+
+            for (int16_t& s : frame) s = static_cast<int16_t>(seq & SEQ_MASK);
+            FrameInfo info;
+            info.arrivalNs = f.arrivalNs;
+            info.silentMask = seq % 720 >= 480 ? 1u : 0u;  // 2.4 s talk, 1.2 s pause
+            o.written++;
+            if (!buffer->write(frame, FRAME_SAMPLES, info)) o.overflowDrops++;
+        }
+
+        // Playback callback
+        PlayoutBuffer& b = *buffer;
+        if (!started && b.bufferedSamples() >= b.levels().prebufferSamples) started = true;
+        if (!started) continue;
+
+        int before = b.bufferedSamples();
+        switch (b.drainStep()) {
+            case PlayoutDrain::HARD:
+                o.hardSteps++;
+                o.hardDrained += before - b.bufferedSamples();
+                break;
+            case PlayoutDrain::SOFT:
+                o.softDropped += before - b.bufferedSamples();
+                break;
+            case PlayoutDrain::NONE:
+                EXPECT_EQ(before, b.bufferedSamples());
+                break;
+        }
+        int depth = b.bufferedSamples();
+        if (depth > r.maxBuffered) r.maxBuffered = depth;
+        hourDepthSum += depth;
+        hourCallbacks++;
+
+        int written = b.fill(out, BURST_SAMPLES, [&](const FrameInfo&, int) { o.served++; });
+        o.outputSamples += written;
+        r.underrunSamples += BURST_SAMPLES - written;
+        for (int i = 0; i < written; i++) {
+            // Sequence numbers only move forward (modulo the wrap)
+            if (lastValue >= 0 && ((out[i] - lastValue) & SEQ_MASK) >= SEQ_MASK / 2) r.outOfOrder++;
+            lastValue = out[i];
+        }
+
+        if (nowNs + BURST_NS >= hourEndNs) {
+            if (hourCallbacks > 0) {
+                int meanMs = static_cast<int>(hourDepthSum / hourCallbacks * 1000 / SAMPLE_RATE);
+                if (meanMs > r.worstHourMeanMs) r.worstHourMeanMs = meanMs;
+            }
+            hourDepthSum = 0;
+            hourCallbacks = 0;
+            hourEndNs += HOUR_NS;
+        }
+    }
+    retire(*buffer);
+
+    // Memory: fixed per engine, nothing grows with call length
+    EXPECT_EQ(createdBytes, ledger.totalBytes());
+    EXPECT_EQ(createdBytes, ledger.totalPeakBytes());
+    buffer.reset();
+    EXPECT_EQ(0, ledger.totalBytes());
+    return r;
+}
+
+// Audio a sender skewed by ppm adds (or, negative, takes) over durationNs
+int64_t skewSamples(int64_t durationNs, int ppm) {
+    return durationNs / MS_NS * SAMPLE_RATE / 1000 * ppm / 1000000;
+}
+
+}  // namespace
+
+TEST(PlayoutSoakTest, TwentyFourHoursStayBounded) {
+    Link link;
+    link.durationNs = 24 * HOUR_NS;
+    link.recreateNs = 3 * HOUR_NS;
+    link.skewPpm = 300;
+    link.skewPpmLater = -300;
+    link.lossy = true;
+    link.stalls = true;
+    Result r = run(link);
+
+    // Depth: the hard drain caps it, and latency does not ratchet up hour
+    // over hour. The soft drop keeps the mean near the prebuffer.
+    EXPECT_LE(r.maxBuffered, r.drainThreshold);
+    EXPECT_LE(r.maxBuffered, r.capacitySamples);
+    EXPECT_LE(r.worstHourMeanMs, PREBUFFER_MS + PREBUFFER_MS / 2);
+    EXPECT_GT(r.silenceDropped, 0);
+    EXPECT_GT(r.hardDrains, 0);
+    EXPECT_GT(r.served, 0);
+    EXPECT_EQ(0, r.outOfOrder);
+}
+
+TEST(PlayoutSoakTest, FastSenderClockIsShedInPauses) {
+    Link link;
+    link.durationNs = 3 * HOUR_NS;
+    link.skewPpm = link.skewPpmLater = 300;
+    Result r = run(link);
+
+    // 3.2 s of surplus: dropped as silence, never as speech, and the
+    // queue stays below the soft-drop depth plus one frame
+    int64_t surplus = skewSamples(link.durationNs, link.skewPpm);
+    EXPECT_EQ(0, r.hardDrains);
+    EXPECT_GE(r.silenceDropped, surplus * 9 / 10);
+    EXPECT_LE(r.silenceDropped, surplus);
+    EXPECT_LE(r.worstHourMeanMs, PREBUFFER_MS + PREBUFFER_MS / 4);
+    EXPECT_EQ(0, r.underrunSamples);
+    EXPECT_EQ(0, r.outOfOrder);
+}
+
+TEST(PlayoutSoakTest, SlowSenderClockRunsThePrebufferDry) {
+    Link link;
+    link.durationNs = 3 * HOUR_NS;
+    link.skewPpm = link.skewPpmLater = -300;
+    Result r = run(link);
+
+    // 3.2 s of deficit: the prebuffer covers the first 450 ms of it,
+    // the rest plays out as underruns (PLC in the engine). Nothing is
+    // dropped.
+    int64_t deficit = -skewSamples(link.durationNs, link.skewPpm);
+    int64_t prebuffer = samplesForMs(PREBUFFER_MS, SAMPLE_RATE, 1);
+    EXPECT_EQ(0, r.hardDrains);
+    EXPECT_EQ(0, r.silenceDropped);
+    EXPECT_NEAR(static_cast<double>(deficit - prebuffer), static_cast<double>(r.underrunSamples),
+                deficit / 10.0);
+    EXPECT_EQ(0, r.outOfOrder);
+}
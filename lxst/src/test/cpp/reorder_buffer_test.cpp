@@ -0,0 +1,146 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <gtest/gtest.h>
+#include <vector>
+#include "reorder_buffer.h"
+
+namespace {
+
+void collect(void* ctx, uint16_t seq, const uint8_t* /*data*/, int /*len*/, int /*tag*/) {
+    static_cast<std::vector<uint16_t>*>(ctx)->push_back(seq);
+}
+
+class ReorderBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override { buffer.configure(2); }
+
+    void push(uint16_t seq) {
+        uint8_t payload[4] = {static_cast<uint8_t>(seq), 0, 0, 0};
+        buffer.push(seq, payload, sizeof(payload), 0, &collect, &out);
+    }
+
+    PacketReorderBuffer buffer;
+    std::vector<uint16_t> out;
+};
+
+TEST_F(ReorderBufferTest, InOrderPassesStraightThrough) {
+    for (uint16_t s = 100; s < 110; s++) push(s);
+    EXPECT_EQ(10u, out.size());
+    EXPECT_EQ(100, out.front());
+    EXPECT_EQ(109, out.back());
+    EXPECT_EQ(0, buffer.lostCount());
+    EXPECT_EQ(0, buffer.reorderedCount());
+}
+
+TEST_F(ReorderBufferTest, SwappedPairIsReordered) {
+    push(10);
+    push(12);
+    EXPECT_EQ(std::vector<uint16_t>({10}), out);
+    uint16_t hole = 0;
+    ASSERT_TRUE(buffer.headHole(&hole));
+    EXPECT_EQ(11, hole);
+    push(11);
+    EXPECT_EQ(std::vector<uint16_t>({10, 11, 12}), out);
+    EXPECT_EQ(1, buffer.reorderedCount());
+    EXPECT_FALSE(buffer.headHole(&hole));
+}
+
+TEST_F(ReorderBufferTest, HoleIsSkippedPastTheDepth) {
+    push(10);
+    push(12);
+    push(13);
+    EXPECT_EQ(std::vector<uint16_t>({10}), out);
+    push(14);  // Three waiting behind the hole: give up on 11
+    EXPECT_EQ(std::vector<uint16_t>({10, 12, 13, 14}), out);
+    EXPECT_EQ(1, buffer.lostCount());
+
+    push(11);  // Its slot was skipped
+    EXPECT_EQ(1, buffer.lateCount());
+    EXPECT_EQ(4u, out.size());
+}
+
+TEST_F(ReorderBufferTest, DuplicatesAreDropped) {
+    push(10);
+    push(11);
+    push(11);  // Already played
+    push(13);
+    push(13);  // Already waiting
+    EXPECT_EQ(std::vector<uint16_t>({10, 11}), out);
+    EXPECT_EQ(2, buffer.duplicateCount());
+    EXPECT_EQ(0, buffer.lateCount());
+}
+
+TEST_F(ReorderBufferTest, SequenceWrapsThrough65535) {
+    push(65534);
+    push(0);
+    push(65535);
+    push(1);
+    EXPECT_EQ(std::vector<uint16_t>({65534, 65535, 0, 1}), out);
+    EXPECT_EQ(0, buffer.lostCount());
+}
+
+TEST_F(ReorderBufferTest, FarBehindIsLateNotARestart) {
+    for (uint16_t s = 1000; s < 1005; s++) push(s);
+    push(100);    // Beyond the 32-packet history
+    push(40000);  // Half the sequence space back
+    EXPECT_EQ(2, buffer.lateCount());
+    push(1005);   // Play point unchanged
+    EXPECT_EQ(1005, out.back());
+    EXPECT_EQ(6u, out.size());
+    EXPECT_EQ(0, buffer.lostCount());
+}
+
+TEST_F(ReorderBufferTest, JumpAheadCountsTheGapAsLost) {
+    push(10);
+    push(12);
+    push(40);  // Past the window
+    EXPECT_EQ(std::vector<uint16_t>({10, 12, 40}), out);
+    EXPECT_EQ(28, buffer.lostCount());  // 11, then 13..39
+}
+
+TEST_F(ReorderBufferTest, RestartDropsHeldPacketsAndFollowsTheNewSequence) {
+    push(10);
+    push(12);
+    push(13);
+    buffer.restart();
+    EXPECT_EQ(2, buffer.lateCount());  // 12 and 13 never played
+    uint16_t hole = 0;
+    EXPECT_FALSE(buffer.headHole(&hole));
+
+    push(5);  // Behind the old play point, but a new stream
+    push(6);
+    EXPECT_EQ(std::vector<uint16_t>({10, 5, 6}), out);
+    EXPECT_EQ(0, buffer.lostCount());
+}
+
+TEST_F(ReorderBufferTest, MissingSeqsListsHolesBehindHeldPackets) {
+    buffer.configure(4);
+    push(10);
+    push(12);
+    push(15);
+    uint16_t missing[PacketReorderBuffer::MAX_SLOTS];
+    int n = buffer.missingSeqs(missing, PacketReorderBuffer::MAX_SLOTS);
+    EXPECT_EQ(std::vector<uint16_t>({11, 13, 14}), std::vector<uint16_t>(missing, missing + n));
+}
+
+TEST_F(ReorderBufferTest, HoldLimitWaitsLongerForARequestedHole) {
+    push(10);
+    buffer.setHoldLimit(4);
+    for (uint16_t s = 12; s < 16; s++) push(s);
+    EXPECT_EQ(std::vector<uint16_t>({10}), out);
+    push(11);  // The retransmit made it
+    EXPECT_EQ(6u, out.size());
+    EXPECT_EQ(0, buffer.lostCount());
+}
+
+TEST_F(ReorderBufferTest, FlushSkipsHoles) {
+    push(10);
+    push(12);
+    buffer.flush(&collect, &out);
+    EXPECT_EQ(std::vector<uint16_t>({10, 12}), out);
+    EXPECT_EQ(1, buffer.lostCount());
+}
+
+} // namespace
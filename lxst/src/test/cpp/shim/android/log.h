@@ -0,0 +1,22 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#ifndef LXST_TEST_ANDROID_LOG_H
+#define LXST_TEST_ANDROID_LOG_H
+
+// Host stand-in for the NDK logging header: native sources log through
+// __android_log_print, which the tests discard.
+
+enum {
+    ANDROID_LOG_DEBUG = 3,
+    ANDROID_LOG_INFO = 4,
+    ANDROID_LOG_WARN = 5,
+    ANDROID_LOG_ERROR = 6,
+};
+
+inline int __android_log_print(int /*prio*/, const char* /*tag*/, const char* /*fmt*/, ...) {
+    return 0;
+}
+
+#endif // LXST_TEST_ANDROID_LOG_H
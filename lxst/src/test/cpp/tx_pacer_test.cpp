@@ -0,0 +1,102 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <gtest/gtest.h>
+#include "tx_pacer.h"
+
+namespace {
+
+constexpr int64_t kMs = 1000000;
+constexpr int64_t kInterval = 20 * kMs;
+
+// Send every packet the pacer lets go at nowNs; returns how many went
+int sendAllowed(TxPacer& p, int64_t nowNs, int max) {
+    int sent = 0;
+    while (sent < max && p.delayNs(nowNs) == 0) {
+        p.onSent(nowNs);
+        sent++;
+    }
+    return sent;
+}
+
+}  // namespace
+
+TEST(TxPacer, OffByDefaultAndNeverHolds) {
+    TxPacer p;
+    EXPECT_FALSE(p.enabled());
+    EXPECT_EQ(100, sendAllowed(p, 1000 * kMs, 100));
+
+    p.configure(0, 4);
+    EXPECT_FALSE(p.enabled());
+    EXPECT_EQ(100, sendAllowed(p, 1000 * kMs, 100));
+}
+
+TEST(TxPacer, IdleSenderGetsTheFullBurst) {
+    TxPacer p;
+    p.configure(kInterval, 3);
+    int64_t now = 1000 * kMs;
+    EXPECT_EQ(3, sendAllowed(p, now, 10));
+    // The fourth waits one interval after the first
+    EXPECT_EQ(kInterval, p.delayNs(now));
+}
+
+TEST(TxPacer, BurstIsClampedToOne) {
+    TxPacer p;
+    p.configure(kInterval, 0);
+    EXPECT_EQ(1, p.burstPackets());
+    EXPECT_EQ(1, sendAllowed(p, 1000 * kMs, 10));
+}
+
+TEST(TxPacer, SteadyRateIsNeverHeld) {
+    TxPacer p;
+    p.configure(kInterval, 2);
+    for (int64_t now = 1000 * kMs; now < 2000 * kMs; now += kInterval) {
+        ASSERT_EQ(0, p.delayNs(now)) << now;
+        p.onSent(now);
+    }
+}
+
+TEST(TxPacer, FasterSenderIsHeldToTheIntervalAfterTheBurst) {
+    TxPacer p;
+    p.configure(kInterval, 2);
+    int sent = 0;
+    // Offered every 5ms for a second: a burst of 2, then one per 20ms
+    for (int64_t now = 1000 * kMs; now < 2000 * kMs; now += 5 * kMs) {
+        sent += sendAllowed(p, now, 1);
+    }
+    EXPECT_EQ(2 + 1000 / 20 - 1, sent);
+}
+
+TEST(TxPacer, BacklogAfterAStallDrainsAtTheInterval) {
+    TxPacer p;
+    p.configure(kInterval, 3);
+    int64_t now = 1000 * kMs;
+    for (int i = 0; i < 10; i++, now += kInterval) p.onSent(now);
+
+    // Stalled for 200ms with 10 packets queued: only the burst goes at
+    // once, the rest one interval apart
+    now += 200 * kMs;
+    EXPECT_EQ(3, sendAllowed(p, now, 10));
+    int64_t last = now;
+    for (int left = 7; left > 0; left--) {
+        int64_t wait = p.delayNs(now);
+        ASSERT_GT(wait, 0);
+        now += wait;
+        ASSERT_EQ(1, sendAllowed(p, now, 1));
+        EXPECT_EQ(kInterval, now - last);
+        last = now;
+    }
+}
+
+TEST(TxPacer, ConfigureForgetsTheBacklog) {
+    TxPacer p;
+    p.configure(kInterval, 1);
+    int64_t now = 1000 * kMs;
+    for (int i = 0; i < 5; i++) p.onSent(now);
+    EXPECT_EQ(5 * kInterval, p.delayNs(now));
+
+    p.configure(kInterval, 1);
+    EXPECT_EQ(0, p.delayNs(now));
+    EXPECT_EQ(kInterval, p.intervalNs());
+}
@@ -0,0 +1,101 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include "native_audio_filters.h"
+
+namespace {
+
+constexpr int RATE = 48000;
+constexpr int MS = RATE / 1000;
+
+// The capture engine's chain (oboe_capture_engine.cpp)
+VoiceFilterChain* makeChain() {
+    return new VoiceFilterChain(1, 300.0f, 3400.0f, -12.0f, 12.0f);
+}
+
+void appendTone(std::vector<int16_t>& pcm, int ms, float amplitude, float hz = 1000.0f) {
+    size_t start = pcm.size();
+    for (int i = 0; i < ms * MS; i++) {
+        double t = static_cast<double>(start + i) / RATE;
+        pcm.push_back(static_cast<int16_t>(amplitude * 32767.0 * std::sin(2.0 * M_PI * hz * t)));
+    }
+}
+
+std::vector<int16_t> processInChunks(std::vector<int16_t> pcm, int chunk) {
+    std::unique_ptr<VoiceFilterChain> chain(makeChain());
+    for (size_t off = 0; off < pcm.size(); off += chunk) {
+        chain->process(pcm.data() + off, static_cast<int>(std::min<size_t>(chunk, pcm.size() - off)), RATE);
+    }
+    return pcm;
+}
+
+// Peak |sample| of each millisecond
+std::vector<int> envelope(const std::vector<int16_t>& pcm, size_t from, int ms) {
+    std::vector<int> env;
+    for (int b = 0; b < ms; b++) {
+        int peak = 0;
+        for (int i = 0; i < MS; i++) peak = std::max(peak, std::abs(static_cast<int>(pcm[from + b * MS + i])));
+        env.push_back(peak);
+    }
+    return env;
+}
+
+TEST(VoiceFilterChainTest, OutputDoesNotDependOnChunkSize) {
+    // Speech-like levels: quiet, loud enough to limit, silence, noise floor
+    std::vector<int16_t> pcm;
+    appendTone(pcm, 300, 0.02f, 440.0f);
+    appendTone(pcm, 200, 0.9f, 1200.0f);
+    appendTone(pcm, 300, 0.0f);
+    appendTone(pcm, 400, 0.001f, 700.0f);
+    appendTone(pcm, 400, 0.3f, 2000.0f);
+    appendTone(pcm, 400, 0.05f, 300.0f);
+    ASSERT_EQ(0u, pcm.size() % 19200);
+
+    std::vector<int16_t> ull = processInChunks(pcm, 120);      // 2.5 ms
+    std::vector<int16_t> hq = processInChunks(pcm, 960);       // 20 ms
+    std::vector<int16_t> ulbw = processInChunks(pcm, 19200);   // 400 ms
+    EXPECT_EQ(ull, hq);
+    EXPECT_EQ(ull, ulbw);
+}
+
+TEST(VoiceFilterChainTest, LimiterClampsAndHoldsBeforeReleasing) {
+    std::vector<int16_t> pcm;
+    appendTone(pcm, 1000, 0.05f);  // Settle the gain on a quiet talker
+    size_t burstAt = pcm.size();
+    appendTone(pcm, 50, 0.9f);     // Shout
+    size_t afterAt = pcm.size();
+    appendTone(pcm, 1500, 0.05f);
+
+    std::vector<int16_t> out = processInChunks(pcm, 960);
+    const int settled = envelope(out, burstAt - 10 * MS, 10).back();
+    ASSERT_GT(settled, 0);
+
+    // Never past the peak limit (0.75 full scale)
+    std::vector<int> burst = envelope(out, burstAt, 50);
+    EXPECT_LE(*std::max_element(burst.begin(), burst.end()), static_cast<int>(0.75f * 32767.0f) + 1);
+
+    std::vector<int> env = envelope(out, afterAt, 1500);
+
+    // Just after the shout the gain is still pulled down...
+    EXPECT_LT(env[0], settled / 2);
+    // ...and held: no recovery within the 2 ms hold
+    EXPECT_LE(env[2], env[0] + env[0] / 20);
+
+    // Then it releases smoothly (200 ms time constant) back to the level
+    // it had before, without overshooting it
+    EXPECT_GT(env[100], env[10]);
+    EXPECT_GT(env[400], env[100]);
+    for (int ms = 3; ms < 1500; ms++) {
+        EXPECT_GE(env[ms] + env[ms] / 20 + 2, env[ms - 1]) << "dip at " << ms << " ms";
+    }
+    EXPECT_NEAR(settled, env[1499], settled / 10);
+}
+
+} // namespace
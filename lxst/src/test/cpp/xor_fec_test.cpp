@@ -0,0 +1,196 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+#include "xor_fec.h"
+
+namespace {
+
+typedef std::vector<uint8_t> Bytes;
+
+struct Received {
+    Bytes payload;
+    bool recovered;
+};
+
+void collect(void* ctx, const uint8_t* payload, int len, bool recovered) {
+    static_cast<std::vector<Received>*>(ctx)->push_back({Bytes(payload, payload + len), recovered});
+}
+
+// Distinct payloads of different lengths, so padding and length
+// recovery are exercised
+std::vector<Bytes> makePayloads(int count) {
+    std::vector<Bytes> out;
+    for (int i = 0; i < count; i++) {
+        Bytes p(10 + 7 * i);
+        for (size_t b = 0; b < p.size(); b++) p[b] = static_cast<uint8_t>(i * 31 + b * 5 + 1);
+        out.push_back(p);
+    }
+    return out;
+}
+
+// One group as it goes on the wire: data packets, then parity
+std::vector<Bytes> encodeGroup(XorFecEncoder& enc, const std::vector<Bytes>& payloads,
+                               bool force = false) {
+    std::vector<Bytes> wire;
+    uint8_t buf[XOR_FEC_MAX_PAYLOAD + 64];
+    for (const Bytes& p : payloads) {
+        int len = enc.wrapData(p.data(), static_cast<int>(p.size()), buf, sizeof(buf));
+        EXPECT_EQ(static_cast<int>(p.size()) + 1, len);
+        wire.emplace_back(buf, buf + len);
+    }
+    int len = enc.takeParity(buf, sizeof(buf), force);
+    EXPECT_GT(len, 0);
+    wire.emplace_back(buf, buf + len);
+    return wire;
+}
+
+class XorFecTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        enc.configure(4);
+        dec = std::make_unique<XorFecDecoder>();
+        dec->reset();
+    }
+
+    void feed(const Bytes& packet) {
+        EXPECT_TRUE(dec->feed(packet.data(), static_cast<int>(packet.size()), collect, &out));
+    }
+
+    XorFecEncoder enc;
+    std::unique_ptr<XorFecDecoder> dec;  // ~24 KB of held payloads
+    std::vector<Received> out;
+};
+
+}  // namespace
+
+TEST_F(XorFecTest, ParityIsDueOnlyWhenTheGroupIsFull) {
+    uint8_t buf[256];
+    uint8_t payload[8] = {1, 2, 3};
+    for (int i = 0; i < 3; i++) {
+        ASSERT_GT(enc.wrapData(payload, sizeof(payload), buf, sizeof(buf)), 0);
+        EXPECT_EQ(0, enc.takeParity(buf, sizeof(buf)));
+    }
+    ASSERT_GT(enc.wrapData(payload, sizeof(payload), buf, sizeof(buf)), 0);
+    int len = enc.takeParity(buf, sizeof(buf));
+    EXPECT_EQ(1 + 2 * 4 + 8, len);
+    EXPECT_TRUE(buf[0] & XOR_FEC_TAG_PARITY);
+    EXPECT_EQ(3, buf[0] & 0xF);  // Group size - 1
+}
+
+TEST_F(XorFecTest, RoundTripPassesPayloadsInOrder) {
+    std::vector<Bytes> payloads = makePayloads(4);
+    for (const Bytes& packet : encodeGroup(enc, payloads)) feed(packet);
+
+    ASSERT_EQ(4u, out.size());
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(payloads[i], out[i].payload);
+        EXPECT_FALSE(out[i].recovered);
+    }
+}
+
+TEST_F(XorFecTest, SingleLossIsRebuiltInPlace) {
+    std::vector<Bytes> payloads = makePayloads(4);
+    std::vector<Bytes> wire = encodeGroup(enc, payloads);
+    for (size_t i = 0; i < wire.size(); i++) {
+        if (i == 1) continue;
+        feed(wire[i]);
+        if (i == 0) {
+            EXPECT_EQ(1u, out.size());  // Passed on at once
+        }
+        if (i == 2 || i == 3) {
+            EXPECT_EQ(1u, out.size());  // Held behind the hole
+        }
+    }
+
+    ASSERT_EQ(4u, out.size());
+    for (int i = 0; i < 4; i++) EXPECT_EQ(payloads[i], out[i].payload) << "index " << i;
+    EXPECT_TRUE(out[1].recovered);
+    EXPECT_FALSE(out[2].recovered);
+}
+
+TEST_F(XorFecTest, LongestPayloadIsRebuilt) {
+    std::vector<Bytes> payloads = makePayloads(4);
+    std::vector<Bytes> wire = encodeGroup(enc, payloads);
+    for (size_t i = 0; i < wire.size(); i++) {
+        if (i != 3) feed(wire[i]);
+    }
+    ASSERT_EQ(4u, out.size());
+    EXPECT_EQ(payloads[3], out[3].payload);
+    EXPECT_TRUE(out[3].recovered);
+}
+
+TEST_F(XorFecTest, ParityLossLosesNothing) {
+    std::vector<Bytes> group1 = makePayloads(4);
+    std::vector<Bytes> wire = encodeGroup(enc, group1);
+    for (size_t i = 0; i + 1 < wire.size(); i++) feed(wire[i]);  // Parity lost
+    ASSERT_EQ(4u, out.size());
+
+    // The next group starts cleanly
+    std::vector<Bytes> group2 = makePayloads(4);
+    for (const Bytes& packet : encodeGroup(enc, group2)) feed(packet);
+    ASSERT_EQ(8u, out.size());
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(group1[i], out[i].payload);
+        EXPECT_EQ(group2[i], out[4 + i].payload);
+        EXPECT_FALSE(out[4 + i].recovered);
+    }
+}
+
+TEST_F(XorFecTest, LossWithParityLostIsReleasedByTheNextGroup) {
+    std::vector<Bytes> group1 = makePayloads(4);
+    std::vector<Bytes> wire = encodeGroup(enc, group1);
+    feed(wire[0]);
+    feed(wire[2]);
+    feed(wire[3]);
+    EXPECT_EQ(1u, out.size());
+
+    std::vector<Bytes> wire2 = encodeGroup(enc, makePayloads(4));
+    feed(wire2[0]);
+    ASSERT_EQ(4u, out.size());  // Held packets, then the new group's first
+    EXPECT_EQ(group1[2], out[1].payload);
+    EXPECT_EQ(group1[3], out[2].payload);
+}
+
+TEST_F(XorFecTest, DoubleLossReleasesWithoutRecovery) {
+    std::vector<Bytes> payloads = makePayloads(4);
+    std::vector<Bytes> wire = encodeGroup(enc, payloads);
+    feed(wire[0]);
+    feed(wire[3]);  // 1 and 2 missing: nothing to wait for
+    ASSERT_EQ(2u, out.size());
+    feed(wire[4]);
+    ASSERT_EQ(2u, out.size());
+    EXPECT_EQ(payloads[3], out[1].payload);
+    EXPECT_FALSE(out[1].recovered);
+}
+
+TEST_F(XorFecTest, PartialGroupIsProtectedWhenForced) {
+    std::vector<Bytes> payloads = makePayloads(2);
+    std::vector<Bytes> wire = encodeGroup(enc, payloads, true);
+    ASSERT_EQ(3u, wire.size());
+    feed(wire[1]);
+    feed(wire[2]);
+    ASSERT_EQ(2u, out.size());
+    EXPECT_EQ(payloads[0], out[0].payload);
+    EXPECT_TRUE(out[0].recovered);
+    EXPECT_EQ(payloads[1], out[1].payload);
+}
+
+TEST_F(XorFecTest, DuplicatesAreDropped) {
+    std::vector<Bytes> wire = encodeGroup(enc, makePayloads(4));
+    feed(wire[0]);
+    feed(wire[0]);
+    feed(wire[1]);
+    EXPECT_EQ(2u, out.size());
+}
+
+TEST_F(XorFecTest, MalformedPacketsAreRejected) {
+    uint8_t shortPacket[1] = {0};
+    EXPECT_FALSE(dec->feed(shortPacket, 1, collect, &out));
+    uint8_t parity[3] = {XOR_FEC_TAG_PARITY | 3, 0, 4};  // Claims 4 lengths, carries 1
+    EXPECT_FALSE(dec->feed(parity, sizeof(parity), collect, &out));
+    EXPECT_TRUE(out.empty());
+}
@@ -0,0 +1,34 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package tech.torlando.lxst.audio
+
+import org.junit.Assert.assertEquals
+import org.junit.Test
+
+/**
+ * Unit tests for [ArrivalTrace]: the text must match what the playout
+ * tuner (lxst/tools/playout_tuner) reads.
+ */
+class ArrivalTraceTest {
+    @Test
+    fun `formats the tuner header and one line per arrival`() {
+        val trace = ArrivalTrace(profileId = 0x40, frameUs = 60000)
+        trace.addPairs(longArrayOf(0, 1_000_000, 1, 1_061_250, 3, 1_185_000), 3)
+        assertEquals(
+            "# profile=0x40 frame_us=60000\n0 1000000\n1 1061250\n3 1185000\n",
+            trace.format(),
+        )
+    }
+
+    @Test
+    fun `small profile ids are padded and the cap drops later arrivals`() {
+        val trace = ArrivalTrace(profileId = 0x10, frameUs = 400000, maxPackets = 2000)
+        repeat(2500) { trace.add(it.toLong(), it * 400_000L) }
+        assertEquals(2000, trace.size)
+        val lines = trace.format().lines()
+        assertEquals("# profile=0x10 frame_us=400000", lines.first())
+        assertEquals("1999 799600000", lines[2000])
+    }
+}
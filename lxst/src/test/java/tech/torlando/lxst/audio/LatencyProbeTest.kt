@@ -0,0 +1,134 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package tech.torlando.lxst.audio
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertFalse
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+
+/**
+ * Unit tests for LatencyProbe token echo and RTT smoothing.
+ *
+ * Uses an injected clock and captures outgoing signals in a list,
+ * so no transport or native engine is needed.
+ */
+class LatencyProbeTest {
+
+    private var now = 0L
+    private val sent = mutableListOf<Int>()
+    private lateinit var probe: LatencyProbe
+
+    @Before
+    fun setup() {
+        now = 1_000L
+        sent.clear()
+        probe = LatencyProbe(sendSignal = { sent.add(it) }, clockMs = { now })
+    }
+
+    @Test
+    fun `non-latency signals are not consumed`() {
+        assertFalse(probe.handleSignal(Signalling.STATUS_ESTABLISHED))
+        assertFalse(probe.handleSignal(Signalling.PREFERRED_PROFILE + 0x40))
+        assertTrue(sent.isEmpty())
+    }
+
+    @Test
+    fun `nack signals are not latency signals`() {
+        assertFalse(probe.handleSignal(Signalling.NACK + 0))
+        assertFalse(probe.handleSignal(Signalling.NACK + Signalling.NACK_SEQ_MASK))
+        assertTrue(Signalling.isNackSignal(Signalling.NACK + 0x1234))
+        assertFalse(Signalling.isNackSignal(Signalling.LATENCY_ECHO + Signalling.LATENCY_TOKEN_MASK))
+        assertTrue(sent.isEmpty())
+        assertEquals("NACK(4660)", SignallingReceiver.statusToString(Signalling.NACK + 0x1234))
+    }
+
+    @Test
+    fun `probe is echoed with the same token`() {
+        assertTrue(probe.handleSignal(Signalling.LATENCY_PROBE + 1234))
+        assertEquals(listOf(Signalling.LATENCY_ECHO + 1234), sent)
+        assertNull(probe.estimate)
+    }
+
+    @Test
+    fun `estimate is null before first echo`() {
+        probe.sendProbe()
+        assertEquals(Signalling.LATENCY_PROBE + 1_000, sent.single())
+        assertNull(probe.estimate)
+    }
+
+    @Test
+    fun `echo produces rtt sample`() {
+        probe.sendProbe()
+        val token = sent.single() - Signalling.LATENCY_PROBE
+        now += 180
+        assertTrue(probe.handleSignal(Signalling.LATENCY_ECHO + token))
+
+        val estimate = assertNotNullEstimate()
+        assertEquals(180, estimate.rttMs)
+        assertEquals(90, estimate.oneWayMs)
+        assertEquals(1, estimate.samples)
+    }
+
+    @Test
+    fun `rtt is wrap-safe across token rollover`() {
+        now = 0xFFF0L
+        probe.sendProbe()
+        val token = sent.single() - Signalling.LATENCY_PROBE
+        now += 0x40 // clock wraps past 16 bits
+        probe.handleSignal(Signalling.LATENCY_ECHO + token)
+
+        assertEquals(0x40, assertNotNullEstimate().rttMs)
+    }
+
+    @Test
+    fun `stale echoes are discarded`() {
+        probe.handleSignal(Signalling.LATENCY_ECHO + 0)
+        now = LatencyProbe.MAX_RTT_MS + 1L
+        probe.handleSignal(Signalling.LATENCY_ECHO + 0)
+        // First sample used now=1000, second exceeds MAX_RTT_MS and is dropped
+        assertEquals(1, assertNotNullEstimate().samples)
+    }
+
+    @Test
+    fun `rtt is smoothed across samples`() {
+        repeat(2) { i ->
+            val token = (now and 0xFFFF).toInt()
+            now += if (i == 0) 100 else 200
+            probe.handleSignal(Signalling.LATENCY_ECHO + token)
+        }
+        // srtt = 7/8 * 100 + 1/8 * 200
+        assertEquals(112, assertNotNullEstimate().rttMs)
+    }
+
+    @Test
+    fun `mouth-to-ear sums capture, one-way and playout`() {
+        probe.updateLocalDelays(captureDelayMs = 40, playoutDelayMs = 120)
+        val token = (now and 0xFFFF).toInt()
+        now += 200
+        probe.handleSignal(Signalling.LATENCY_ECHO + token)
+
+        val estimate = assertNotNullEstimate()
+        assertEquals(40, estimate.captureDelayMs)
+        assertEquals(120, estimate.playoutDelayMs)
+        assertEquals(40 + 100 + 120, estimate.mouthToEarMs)
+    }
+
+    @Test
+    fun `reset clears samples`() {
+        probe.handleSignal(Signalling.LATENCY_ECHO + 0)
+        probe.reset()
+        assertNull(probe.estimate)
+    }
+
+    private fun assertNotNullEstimate(): LatencyEstimate {
+        val estimate = probe.estimate
+        assertNotNull(estimate)
+        return estimate!!
+    }
+}
@@ -0,0 +1,165 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package tech.torlando.lxst.audio
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import tech.torlando.lxst.telephone.Telephone
+import java.util.PriorityQueue
+import java.util.Random
+import kotlin.math.abs
+
+/**
+ * Long-duration soak of the call's latency bookkeeping on a simulated clock.
+ *
+ * Two [LatencyProbe]s probe each other at the Telephone interval over a
+ * simulated link for 24 simulated hours (well under a second of real
+ * time). The peer's clock runs fast, each leg has jitter and loss, the
+ * route restarts every few hours with a new base delay (in-flight signals
+ * are lost), and mid-call profile switches change the local delays.
+ *
+ * Checks that the estimate stays bounded and re-converges after every
+ * restart, that the 16-bit token survives its ~1300 daily wraps, and that
+ * the sample counter only grows and misses no echo.
+ */
+class LatencySoakTest {
+
+    private companion object {
+        const val SIM_END_MS = 24L * 3_600_000L
+        const val PROBE_INTERVAL_MS = Telephone.LATENCY_PROBE_INTERVAL_MS
+        const val PEER_SKEW_PPM = 200L
+        const val PEER_CLOCK_OFFSET_MS = 987_654L
+        const val JITTER_MS = 40
+        const val LOSS_PCT = 5
+        const val ROUTE_RESTART_MS = 3L * 3_600_000L
+        const val PROFILE_SWITCH_MS = 40L * 60_000L
+
+        /** Probes after a restart before the estimate must have re-converged. */
+        const val SETTLE_PROBES = 60
+
+        /** One-way base delay per route epoch, cycled. */
+        val ROUTE_BASE_MS = intArrayOf(90, 350, 60, 1200, 180, 45, 700, 120)
+
+        /** (capture, playout) delays per simulated profile. */
+        val PROFILE_DELAYS = arrayOf(20 to 450, 60 to 800, 40 to 450, 400 to 1200)
+    }
+
+    private class Event(val timeMs: Long, val order: Long, val action: () -> Unit)
+
+    private val events = PriorityQueue<Event>(compareBy<Event>({ it.timeMs }, { it.order }))
+    private var eventOrder = 0L
+    private var nowMs = 0L
+    private val random = Random(0x5eed)
+
+    private var routeEpoch = 0
+    private var echoesToLocal = 0
+
+    private fun schedule(
+        atMs: Long,
+        action: () -> Unit,
+    ) {
+        events.add(Event(atMs, eventOrder++, action))
+    }
+
+    private fun baseDelayMs(): Int = ROUTE_BASE_MS[routeEpoch % ROUTE_BASE_MS.size]
+
+    /** One leg of the link: lost, or delivered after base + jitter unless the route restarts first. */
+    private fun deliver(
+        signal: Int,
+        to: () -> LatencyProbe,
+        onDeliver: () -> Unit = {},
+    ) {
+        if (random.nextInt(100) < LOSS_PCT) return
+        val epoch = routeEpoch
+        schedule(nowMs + baseDelayMs() + random.nextInt(JITTER_MS + 1)) {
+            if (epoch == routeEpoch) {
+                onDeliver()
+                to().handleSignal(signal)
+            }
+        }
+    }
+
+    @Test
+    fun `latency estimate stays bounded over 24 simulated hours`() {
+        lateinit var local: LatencyProbe
+        lateinit var peer: LatencyProbe
+        local =
+            LatencyProbe(
+                sendSignal = { signal -> deliver(signal, { peer }) },
+                clockMs = { nowMs },
+            )
+        peer =
+            LatencyProbe(
+                sendSignal = { signal ->
+                    val isEcho = signal >= Signalling.LATENCY_ECHO
+                    deliver(signal, { local }, onDeliver = { if (isEcho) echoesToLocal++ })
+                },
+                clockMs = { PEER_CLOCK_OFFSET_MS + nowMs + nowMs * PEER_SKEW_PPM / 1_000_000 },
+            )
+
+        var routeStartMs = 0L
+        var profile = 0
+        var lastSamples = 0
+        var convergedChecks = 0
+
+        // Both ends probe, offset by half an interval
+        var t = 0L
+        while (t < SIM_END_MS) {
+            schedule(t) { local.sendProbe() }
+            schedule(t + PROBE_INTERVAL_MS / 2) { peer.sendProbe() }
+            t += PROBE_INTERVAL_MS
+        }
+        t = ROUTE_RESTART_MS
+        while (t < SIM_END_MS) {
+            schedule(t) {
+                routeEpoch++
+                routeStartMs = nowMs
+            }
+            t += ROUTE_RESTART_MS
+        }
+        t = 0L
+        while (t < SIM_END_MS) {
+            schedule(t) {
+                val (capture, playout) = PROFILE_DELAYS[profile++ % PROFILE_DELAYS.size]
+                local.updateLocalDelays(capture, playout)
+            }
+            t += PROFILE_SWITCH_MS
+        }
+
+        while (events.isNotEmpty()) {
+            val event = events.poll()!!
+            nowMs = event.timeMs
+            event.action()
+
+            val estimate = local.estimate ?: continue
+            assertTrue("rtt ${estimate.rttMs} at $nowMs", estimate.rttMs in 0..LatencyProbe.MAX_RTT_MS)
+            assertTrue("samples went backwards at $nowMs", estimate.samples >= lastSamples)
+            lastSamples = estimate.samples
+            assertEquals(
+                estimate.captureDelayMs + estimate.oneWayMs + estimate.playoutDelayMs,
+                estimate.mouthToEarMs,
+            )
+
+            if (nowMs - routeStartMs >= SETTLE_PROBES * PROBE_INTERVAL_MS) {
+                // Mean RTT is two legs of base + uniform jitter
+                val expectedRtt = 2 * baseDelayMs() + JITTER_MS
+                assertTrue(
+                    "rtt ${estimate.rttMs} vs $expectedRtt at $nowMs (route $routeEpoch)",
+                    abs(estimate.rttMs - expectedRtt) <= JITTER_MS,
+                )
+                convergedChecks++
+            }
+        }
+
+        val estimate = local.estimate
+        assertNotNull(estimate)
+        // Every echo that reached us was folded in: no dropped or wrapped counts
+        assertEquals(echoesToLocal, estimate!!.samples)
+        assertTrue("too few echoes: $echoesToLocal", echoesToLocal > (SIM_END_MS / PROBE_INTERVAL_MS) * 8 / 10)
+        assertTrue(convergedChecks > 0)
+    }
+}
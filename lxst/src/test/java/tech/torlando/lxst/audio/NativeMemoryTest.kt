@@ -0,0 +1,46 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package tech.torlando.lxst.audio
+
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+
+/**
+ * Unit tests for the native memory stats layout (memory_ledger.h).
+ */
+class NativeMemoryTest {
+
+    private fun stats(vararg pairs: Pair<Int, Int>): IntArray {
+        val out = IntArray(NativeMemory.STATS_FIELDS)
+        pairs.forEachIndexed { c, (current, peak) ->
+            out[2 * c] = current
+            out[2 * c + 1] = peak
+        }
+        return out
+    }
+
+    @Test
+    fun `current and peak read per component`() {
+        val s = stats(100 to 200, 0 to 0, 0 to 0, 3000 to 4000, 0 to 0, 0 to 0, 3100 to 4200)
+        assertEquals(100, NativeMemory.currentBytes(s, NativeMemory.ENGINE))
+        assertEquals(4000, NativeMemory.peakBytes(s, NativeMemory.CODEC))
+        assertEquals(4200, NativeMemory.peakBytes(s, NativeMemory.TOTAL))
+    }
+
+    @Test
+    fun `short arrays read as zero`() {
+        assertEquals(0, NativeMemory.peakBytes(IntArray(0), NativeMemory.TOTAL))
+        assertEquals("n/a", NativeMemory.describe(IntArray(3)))
+    }
+
+    @Test
+    fun `describe leads with the total in KB`() {
+        val s = stats(1024 to 2048, 0 to 0, 0 to 0, 0 to 0, 0 to 0, 0 to 0, 1025 to 2048)
+        val text = NativeMemory.describe(s)
+        assertEquals("total=2/2KB", text.substringBefore(' '))
+        assertTrue(text.contains("engine=1/2KB"))
+    }
+}
@@ -0,0 +1,65 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package tech.torlando.lxst.audio
+
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Test
+import tech.torlando.lxst.telephone.Profile
+
+/**
+ * Unit tests for the playout policy layout (playout_policy.h) and the
+ * playout tuner's table format.
+ */
+class NativePlayoutPolicyTest {
+
+    @Test
+    fun `default policy matches the engine's built-in values`() {
+        val p = NativePlayoutPolicy.DEFAULT
+        assertEquals(NativePlayoutPolicy.FIELDS, p.size)
+        assertEquals(0, p[NativePlayoutPolicy.PREBUFFER_MS])
+        assertEquals(200, p[NativePlayoutPolicy.DRAIN_PCT])
+        assertEquals(25, p[NativePlayoutPolicy.SOFT_DROP_PCT])
+        assertEquals(5, p[NativePlayoutPolicy.PLC_MAX_CALLBACKS])
+        assertEquals(10, p[NativePlayoutPolicy.PLC_MAX_CALLBACKS_LOSSY])
+        assertEquals(2, p[NativePlayoutPolicy.BUFFER_BURSTS])
+    }
+
+    @Test
+    fun `tuner table parses by profile id`() {
+        val text =
+            """
+            # profile prebuffer_ms drain_pct soft_drop_pct plc_max plc_max_lossy buffer_bursts
+            0x40 380 175 25 5 8 2   # MQ: score=412.0
+            0x10 520 200 50 3 10 3
+
+            """.trimIndent()
+        val table = NativePlayoutPolicy.parseTable(text)
+        assertEquals(setOf(Profile.MQ.id, 0x10), table.keys)
+        assertArrayEquals(intArrayOf(380, 175, 25, 5, 8, 2), table[Profile.MQ.id])
+        assertEquals(3, table[0x10]!![NativePlayoutPolicy.BUFFER_BURSTS])
+    }
+
+    @Test
+    fun `drain threshold follows the tuned prebuffer and drain percentage`() {
+        // Defaults: 2 × the caller's prebuffer, as LinkSource.computeTxMaxAgeMs always was
+        assertEquals(900, NativePlayoutPolicy.drainThresholdMs(null, 450))
+        assertEquals(900, LinkSource.computeTxMaxAgeMs(20))
+        // A tuned prebuffer replaces the caller's, on both ends
+        val tuned = intArrayOf(700, 150, 25, 5, 10, 2)
+        assertEquals(1050, NativePlayoutPolicy.drainThresholdMs(tuned, 450))
+        assertEquals(1050, LinkSource.computeTxMaxAgeMs(20, tuned))
+        // No prebuffer in the row, short row, and the engine's clamps
+        assertEquals(675, NativePlayoutPolicy.drainThresholdMs(intArrayOf(0, 150), 450))
+        assertEquals(1400, NativePlayoutPolicy.drainThresholdMs(intArrayOf(700), 450))
+        assertEquals(495, NativePlayoutPolicy.drainThresholdMs(intArrayOf(0, 50), 450))
+        assertEquals(10000, NativePlayoutPolicy.drainThresholdMs(intArrayOf(5000, 900), 450))
+    }
+
+    @Test(expected = IllegalArgumentException::class)
+    fun `malformed row is rejected`() {
+        NativePlayoutPolicy.parseTable("0x40 380 lots")
+    }
+}
@@ -0,0 +1,42 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+package tech.torlando.lxst.audio
+
+import org.junit.Assert.assertEquals
+import org.junit.Test
+
+/**
+ * Unit tests for the codec header byte flags read on receive.
+ */
+class PacketizerTest {
+
+    @Test
+    fun `plain codec headers carry no flags`() {
+        listOf(Packetizer.CODEC_RAW, Packetizer.CODEC_OPUS, Packetizer.CODEC_CODEC2, Packetizer.CODEC_G722)
+            .forEach { assertEquals(0, Packetizer.headerFlags(it)) }
+    }
+
+    @Test
+    fun `FEC and extension flags are read off any codec header`() {
+        val fec = (Packetizer.CODEC_OPUS.toInt() or Packetizer.FLAG_FEC).toByte()
+        val both = (Packetizer.CODEC_CODEC2.toInt() or Packetizer.FLAG_FEC or Packetizer.FLAG_EXT).toByte()
+        assertEquals(Packetizer.FLAG_FEC, Packetizer.headerFlags(fec))
+        assertEquals(Packetizer.FLAG_FEC or Packetizer.FLAG_EXT, Packetizer.headerFlags(both))
+    }
+
+    @Test
+    fun `CODEC_NULL is not read as FEC framed`() {
+        // 0xFF has every bit set; a plain `and FLAG_FEC` would see FEC
+        assertEquals(0, Packetizer.headerFlags(Packetizer.CODEC_NULL))
+    }
+
+    @Test
+    fun `headerCodec strips the flags but keeps CODEC_NULL`() {
+        val both = (Packetizer.CODEC_G722.toInt() or Packetizer.FLAG_FEC or Packetizer.FLAG_EXT).toByte()
+        assertEquals(Packetizer.CODEC_G722, Packetizer.headerCodec(both))
+        assertEquals(Packetizer.CODEC_OPUS, Packetizer.headerCodec(Packetizer.CODEC_OPUS))
+        assertEquals(Packetizer.CODEC_NULL, Packetizer.headerCodec(Packetizer.CODEC_NULL))
+    }
+}
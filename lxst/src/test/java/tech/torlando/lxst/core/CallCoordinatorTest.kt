@@ -422,6 +422,46 @@ class CallCoordinatorTest {
             }
         }
 
+    // ========== Push-to-Talk Tests ==========
+
+    @Test
+    fun `setPttMode mutes and delegates to call manager`() =
+        runTest {
+            callBridge.setPttMode(true)
+            advanceUntilIdle()
+
+            assertTrue(callBridge.isPttMode.value)
+            assertTrue(callBridge.isMuted.value)
+            verify { mockCallManager.setPttMode(true) }
+        }
+
+    @Test
+    fun `setPttActive keys transmit during active call`() =
+        runTest {
+            callBridge.onCallEstablished("abc123")
+            callBridge.setPttMode(true)
+            advanceUntilIdle()
+
+            callBridge.setPttActive(true)
+            advanceUntilIdle()
+
+            assertTrue(callBridge.isPttActive.value)
+            assertFalse(callBridge.isMuted.value)
+            verify { mockCallManager.setPttKeyed(true) }
+        }
+
+    @Test
+    fun `setPttActive is ignored outside PTT mode`() =
+        runTest {
+            callBridge.onCallEstablished("abc123")
+            advanceUntilIdle()
+            callBridge.setPttActive(true)
+            advanceUntilIdle()
+
+            assertFalse(callBridge.isPttActive.value)
+            verify(exactly = 0) { mockCallManager.setPttKeyed(any()) }
+        }
+
     // ========== Helper Method Tests ==========
 
     @Test
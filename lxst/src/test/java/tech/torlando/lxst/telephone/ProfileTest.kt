@@ -8,6 +8,8 @@ import org.junit.Assert.assertEquals
 import org.junit.Assert.assertNull
 import org.junit.Assert.assertTrue
 import org.junit.Test
+import tech.torlando.lxst.audio.NativeCodecConfig
+import tech.torlando.lxst.audio.Packetizer
 
 /**
  * Unit tests for Profile class configuration logic.
@@ -176,6 +178,49 @@ class ProfileTest {
         }
     }
 
+    // ===== Extension profiles (Android-only) =====
+
+    @Test
+    fun `XLL is an extension profile outside the wire-compatible list`() {
+        assertEquals(0x90, Profile.XLL.id)
+        assertTrue(Profile.XLL in Profile.extensions)
+        assertTrue(Profile.XLL !in Profile.all)
+        assertEquals(Profile.XLL, Profile.fromId(0x90))
+    }
+
+    @Test
+    fun `XLL uses 5ms CELT-only frames`() {
+        val params = Profile.XLL.nativeEncodeParams()
+        assertEquals(5, Profile.XLL.frameTimeMs)
+        assertEquals(2051, params.opusApplication)
+        assertEquals(0, params.dredDurationMs)
+        // Whole samples per frame at 48kHz
+        assertEquals(0, params.sampleRate * Profile.XLL.frameTimeMs % 1000)
+    }
+
+    @Test
+    fun `LAN is a G722 extension profile within one packet`() {
+        val params = Profile.LAN.nativeEncodeParams()
+        assertEquals(Profile.LAN, Profile.fromId(0xA0))
+        assertTrue(Profile.LAN !in Profile.all)
+        assertEquals(Profile.CODEC_TYPE_G722, params.codecType)
+        assertEquals(Packetizer.CODEC_G722.toInt(), params.codecType)
+        assertEquals(16000, params.sampleRate)
+        // One byte per two samples: 160 bytes per 20ms frame
+        assertEquals(160, params.sampleRate * Profile.LAN.frameTimeMs / 1000 / 2)
+    }
+
+    @Test
+    fun `toConfigArray follows the NativeCodecConfig layout`() {
+        val params = Profile.MQ.nativeDecodeParams().copy(dredDurationMs = Profile.MQ.dredDurationMs)
+        val config = params.toConfigArray()
+        assertEquals(NativeCodecConfig.FIELDS, config.size)
+        assertEquals(Profile.CODEC_TYPE_OPUS, config[NativeCodecConfig.TYPE])
+        assertEquals(48000, config[NativeCodecConfig.SAMPLE_RATE])
+        assertEquals(params.opusBitrate, config[NativeCodecConfig.OPUS_BITRATE])
+        assertEquals(Profile.DRED_DURATION_MS, config[NativeCodecConfig.DRED_DURATION_MS])
+    }
+
     // ===== next() cycling =====
 
     @Test
@@ -461,6 +506,24 @@ class ProfileTest {
         assertEquals(mqEncode.opusBitrate, ullEncode.opusBitrate)
     }
 
+    // ===== DRED =====
+
+    @Test
+    fun `DRED is off by default`() {
+        (Profile.all + Profile.extensions).forEach { profile ->
+            assertEquals("${profile.abbreviation} encode DRED", 0, profile.nativeEncodeParams().dredDurationMs)
+            assertEquals("${profile.abbreviation} decode DRED", 0, profile.nativeDecodeParams().dredDurationMs)
+        }
+    }
+
+    @Test
+    fun `DRED is affordable only for MQ and HQ`() {
+        (Profile.all + Profile.extensions).forEach { profile ->
+            val expected = if (profile == Profile.MQ || profile == Profile.HQ) Profile.DRED_DURATION_MS else 0
+            assertEquals(profile.abbreviation, expected, profile.dredDurationMs)
+        }
+    }
+
     // ===== Codec type constants =====
 
     @Test
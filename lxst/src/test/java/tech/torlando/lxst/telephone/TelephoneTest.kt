@@ -5,6 +5,7 @@
 package tech.torlando.lxst.telephone
 
 import android.content.Context
+import android.os.PowerManager
 import io.mockk.coEvery
 import io.mockk.coVerify
 import io.mockk.every
@@ -21,9 +22,11 @@ import kotlinx.coroutines.test.resetMain
 import kotlinx.coroutines.test.runTest
 import kotlinx.coroutines.test.setMain
 import org.junit.After
+import org.junit.Assert.assertArrayEquals
 import org.junit.Assert.assertEquals
 import org.junit.Assert.assertFalse
 import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertNull
 import org.junit.Assert.assertTrue
 import org.junit.Before
 import org.junit.Test
@@ -641,4 +644,42 @@ class TelephoneTest {
 
             assertFalse(telephone.isCallActive())
         }
+
+    // ===== Thermal hint =====
+
+    @Test
+    fun `thermal status maps to rising headroom`() {
+        assertEquals(0f, Telephone.thermalStatusToHeadroom(PowerManager.THERMAL_STATUS_NONE), 0f)
+        assertTrue(
+            Telephone.thermalStatusToHeadroom(PowerManager.THERMAL_STATUS_LIGHT) <
+                Telephone.thermalStatusToHeadroom(PowerManager.THERMAL_STATUS_MODERATE),
+        )
+        assertEquals(1.0f, Telephone.thermalStatusToHeadroom(PowerManager.THERMAL_STATUS_SEVERE), 0f)
+        assertTrue(Telephone.thermalStatusToHeadroom(PowerManager.THERMAL_STATUS_CRITICAL) > 1.0f)
+    }
+
+    // ===== Peer link profiles =====
+
+    @Test
+    fun `peer profile round-trips by hash`() {
+        val profile = intArrayOf(1, 8000, 40000, 12, 3)
+        telephone.setPeerProfile("peer1", profile)
+
+        assertArrayEquals(profile, telephone.getPeerProfile("peer1"))
+        assertNull(telephone.getPeerProfile("peer2"))
+        assertArrayEquals(profile, telephone.getPeerProfiles()["peer1"])
+    }
+
+    @Test
+    fun `peer profiles drop the least recently used beyond the limit`() {
+        for (i in 0 until Telephone.MAX_PEER_PROFILES) {
+            telephone.setPeerProfile("peer$i", intArrayOf(1, i, i, -1, 1))
+        }
+        telephone.getPeerProfile("peer0") // Touch: peer1 is now the oldest
+        telephone.setPeerProfile("new", intArrayOf(1, 0, 0, -1, 1))
+
+        assertEquals(Telephone.MAX_PEER_PROFILES, telephone.getPeerProfiles().size)
+        assertNotNull(telephone.getPeerProfile("peer0"))
+        assertNull(telephone.getPeerProfile("peer1"))
+    }
 }
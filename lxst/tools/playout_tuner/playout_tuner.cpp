@@ -0,0 +1,472 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+/*
+ * playout_tuner — offline tuner for the native playout policy.
+ *
+ * Replays recorded packet-arrival traces through the playback engine's
+ * buffer policy under a virtual clock and searches PlayoutPolicy
+ * (playout_policy.h) for the lowest combined cost of latency, underruns,
+ * concealment and discarded speech. Prints one table row per profile;
+ * NativePlayoutPolicy.parseTable() reads the table and
+ * Telephone.setPlayoutPolicies() installs it.
+ *
+ * The replay uses the engine's own PacketRingBuffer and playoutDrainStep();
+ * the Oboe output is a virtual stream pulling one burst per callback, with
+ * deterministic scheduling jitter that a deeper device buffer (more bursts)
+ * rides out at the cost of latency. Soft drain drops whole silent frames
+ * (the engine also drops silent 10ms segments inside a frame).
+ *
+ * Trace format, one file per recorded call:
+ *
+ *   # profile=0x40 frame_us=60000
+ *   <seq> <arrival_us> [s]
+ *
+ * seq is the sender's frame index (send time = seq × frame_us), arrival_us
+ * the receive time on any clock, "s" marks a silent frame. Lost packets are
+ * simply absent. Latency is measured from the earliest transit in the trace,
+ * so sender and receiver clocks need not agree.
+ *
+ * Telephone.setArrivalTrace() records these on native receive from the
+ * header extension (Telephone.getArrivalTraces() returns the text). Those
+ * traces have no silence marks.
+ *
+ * Usage: playout_tuner [options] trace...
+ *   --burst-us N            Output burst (default 4000)
+ *   --callback-jitter-us N  Mean late-callback delay (default 500)
+ *   --w-underrun N          Cost in ms per % of time in silence (default 50)
+ *   --w-plc N               Cost in ms per % of time concealed (default 10)
+ *   --w-drop N              Cost in ms per % of speech discarded (default 20)
+ *   --w-glitch N            Cost in ms per % of time glitched (default 50)
+ *
+ * The search is a coordinate-wise grid: each field in turn is swept over
+ * its candidate values with the others fixed, until a full round changes
+ * nothing.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "packet_ring_buffer.h"
+#include "playout_policy.h"
+
+// The replay runs at 8 samples per ms (8 kHz mono): the policy is in time,
+// so the rate only sets the drain granularity.
+static constexpr int SAMPLES_PER_MS = 8;
+
+// Ring capacity, as LinkSource.MAX_BUFFER_MS (raised to fit the drain cap)
+static constexpr int MAX_BUFFER_MS = 1500;
+
+// OboePlaybackEngine::PEER_LOSSY_PERMILLE: traces this lossy are scored
+// with plcMaxCallbacksLossy, as a peer seeded with that loss would be.
+static constexpr int LOSSY_PERMILLE = 30;
+
+struct Packet {
+    int64_t seq;
+    int64_t arrivalUs;
+    bool silent;
+};
+
+struct Trace {
+    std::string path;
+    int profile = -1;
+    int frameUs = 0;
+    std::vector<Packet> packets;  // By arrival
+    int64_t minTransitUs = 0;     // Earliest arrival − send time
+    bool lossy = false;
+};
+
+struct Options {
+    int burstUs = 4000;
+    int callbackJitterUs = 500;
+    double wUnderrun = 50;
+    double wPlc = 10;
+    double wDrop = 20;
+    double wGlitch = 50;
+};
+
+struct Score {
+    double latencyMs = 0;   // Mean playout delay above the fastest packet
+    double underrunPct = 0; // Time in silence after PLC ran out
+    double plcPct = 0;      // Time concealed
+    double dropPct = 0;     // Speech discarded (hard drain, ring overflow)
+    double glitchPct = 0;   // Time lost to late callbacks
+    double cost = 0;
+};
+
+static int samplesForUs(int64_t us) {
+    return static_cast<int>(us * SAMPLES_PER_MS / 1000);
+}
+
+static bool parseProfile(const std::string& s, int* out) {
+    char* end = nullptr;
+    long v = std::strtol(s.c_str(), &end, 0);
+    if (end == s.c_str() || *end) return false;
+    *out = static_cast<int>(v);
+    return true;
+}
+
+static bool loadTrace(const char* path, Trace* trace) {
+    std::ifstream in(path);
+    if (!in) {
+        std::fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+    trace->path = path;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (line.empty()) continue;
+        std::istringstream ls(line);
+        if (line[0] == '#') {
+            std::string tok;
+            ls >> tok;  // '#'
+            while (ls >> tok) {
+                size_t eq = tok.find('=');
+                if (eq == std::string::npos) continue;
+                std::string key = tok.substr(0, eq), value = tok.substr(eq + 1);
+                if (key == "profile" && !parseProfile(value, &trace->profile)) {
+                    std::fprintf(stderr, "%s:%d: bad profile '%s'\n", path, lineNo, value.c_str());
+                    return false;
+                }
+                if (key == "frame_us") trace->frameUs = std::atoi(value.c_str());
+            }
+            continue;
+        }
+        Packet p{};
+        std::string flag;
+        if (!(ls >> p.seq >> p.arrivalUs)) {
+            std::fprintf(stderr, "%s:%d: expected '<seq> <arrival_us> [s]'\n", path, lineNo);
+            return false;
+        }
+        p.silent = (ls >> flag) && flag == "s";
+        trace->packets.push_back(p);
+    }
+    if (trace->profile < 0 || trace->frameUs <= 0 || trace->packets.empty()) {
+        std::fprintf(stderr, "%s: needs a '# profile=.. frame_us=..' header and packets\n", path);
+        return false;
+    }
+
+    std::stable_sort(trace->packets.begin(), trace->packets.end(),
+                     [](const Packet& a, const Packet& b) { return a.arrivalUs < b.arrivalUs; });
+    int64_t minSeq = INT64_MAX, maxSeq = INT64_MIN;
+    trace->minTransitUs = INT64_MAX;
+    for (const Packet& p : trace->packets) {
+        minSeq = std::min(minSeq, p.seq);
+        maxSeq = std::max(maxSeq, p.seq);
+        trace->minTransitUs = std::min(trace->minTransitUs, p.arrivalUs - p.seq * trace->frameUs);
+    }
+    int64_t expected = maxSeq - minSeq + 1;
+    int64_t lost = expected - static_cast<int64_t>(trace->packets.size());
+    trace->lossy = lost > 0 && lost * 1000 >= LOSSY_PERMILLE * expected;
+    return true;
+}
+
+/** Deterministic xorshift, so every policy sees the same callback timing. */
+struct Rng {
+    uint32_t s;
+    explicit Rng(uint32_t seed) : s(seed ? seed : 1) {}
+    double uniform() {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        return (s + 0.5) / 4294967296.0;
+    }
+};
+
+/**
+ * Replay one trace through the policy. Mirrors OboePlaybackEngine: the
+ * stream starts once the prebuffer has filled, each callback first runs
+ * playoutDrainStep() and then serves a burst from the partial frame and
+ * the ring, concealing a shortfall for up to plcMax consecutive callbacks.
+ */
+static Score replay(const Trace& trace, const PlayoutPolicy& policy, const Options& opt) {
+    const int frameSamples = std::max(1, samplesForUs(trace.frameUs));
+    const int burstSamples = std::max(1, samplesForUs(opt.burstUs));
+    const int frameMs = (trace.frameUs + 999) / 1000;
+    const int prebufferMs = policy.prebufferMs > 0 ? policy.prebufferMs : std::max(450, 2 * frameMs);
+    const int plcMax = trace.lossy ? policy.plcMaxCallbacksLossy : policy.plcMaxCallbacks;
+
+    PlayoutLevels levels;
+    levels.prebufferSamples = prebufferMs * SAMPLES_PER_MS;
+    levels.drainThresholdSamples = prebufferMs * policy.drainPct / 100 * SAMPLES_PER_MS;
+    levels.softDropSamples = playoutSoftDropSamples(levels.prebufferSamples,
+                                                    levels.drainThresholdSamples, policy.softDropPct);
+    int maxSamples = std::max(MAX_BUFFER_MS * SAMPLES_PER_MS, levels.drainThresholdSamples + frameSamples);
+    PacketRingBuffer ring((maxSamples + frameSamples - 1) / frameSamples, frameSamples);
+
+    std::vector<int16_t> frame(frameSamples, 0), scratch(frameSamples, 0);
+    FrameInfo partialInfo;
+    int partialValid = 0, partialOffset = 0;
+    bool softActive = false;
+    int plcRun = 0;
+
+    int64_t droppedSpeech = 0, concealed = 0, silence = 0, glitchUs = 0;
+    double latencySumUs = 0;
+    int64_t latencyCount = 0;
+
+    auto write = [&](const Packet& p) {
+        FrameInfo info;
+        info.mediaSample = p.seq;
+        info.silentMask = p.silent ? 1u : 0u;
+        if (!ring.write(frame.data(), frameSamples, info)) {
+            FrameInfo old;
+            ring.read(scratch.data(), frameSamples, &old);
+            if (!old.silentMask) droppedSpeech += frameSamples;
+            ring.write(frame.data(), frameSamples, info);
+        }
+    };
+    auto buffered = [&]() { return ring.availableFrames() * frameSamples + partialValid - partialOffset; };
+    auto dropPartial = [&](int n) {
+        if (!partialInfo.silentMask) droppedSpeech += n;
+        partialOffset += n;
+        if (partialOffset >= partialValid) partialOffset = partialValid = 0;
+    };
+
+    size_t next = 0;
+    const size_t count = trace.packets.size();
+    const int64_t endUs = trace.packets.back().arrivalUs;
+
+    // Prebuffer: the stream starts on the arrival that fills it
+    int64_t t = trace.packets.front().arrivalUs;
+    while (next < count) {
+        t = trace.packets[next].arrivalUs;
+        write(trace.packets[next++]);
+        if (buffered() >= levels.prebufferSamples) break;
+    }
+
+    Rng rng(static_cast<uint32_t>(count * 2654435761u) ^ static_cast<uint32_t>(trace.frameUs));
+    const int64_t slackUs = static_cast<int64_t>(policy.bufferBursts - 1) * opt.burstUs;
+    const int64_t outputUs = static_cast<int64_t>(policy.bufferBursts) * opt.burstUs;
+    const int64_t startUs = t;
+
+    for (int64_t k = 0; t <= endUs || buffered() > 0; k++) {
+        int64_t nominal = startUs + k * opt.burstUs;
+        // Late callbacks: exponential delay. Past the device buffer's slack
+        // the output runs dry for the difference.
+        int64_t late = opt.callbackJitterUs > 0
+            ? static_cast<int64_t>(-std::log(rng.uniform()) * opt.callbackJitterUs) : 0;
+        if (late > slackUs && nominal <= endUs) glitchUs += std::min<int64_t>(late - slackUs, opt.burstUs);
+        t = nominal + late;
+
+        while (next < count && trace.packets[next].arrivalUs <= t) write(trace.packets[next++]);
+
+        switch (playoutDrainStep(buffered(), levels, &softActive)) {
+            case PlayoutDrain::HARD: {
+                int excess = buffered() - levels.prebufferSamples;
+                if (partialValid > 0) {
+                    int skip = std::min(excess, partialValid - partialOffset);
+                    dropPartial(skip);
+                    excess -= skip;
+                }
+                while (excess > 0 && ring.read(scratch.data(), frameSamples, &partialInfo)) {
+                    partialValid = frameSamples;
+                    partialOffset = 0;
+                    int skip = std::min(excess, frameSamples);
+                    dropPartial(skip);
+                    excess -= skip;
+                }
+                break;
+            }
+            case PlayoutDrain::SOFT: {
+                if (partialValid > 0 && partialInfo.silentMask) {
+                    dropPartial(std::min(buffered() - levels.prebufferSamples, partialValid - partialOffset));
+                }
+                FrameInfo head;
+                while (partialValid == 0 && buffered() - levels.prebufferSamples >= frameSamples
+                       && ring.peekInfo(&head) && head.silentMask) {
+                    ring.read(scratch.data(), frameSamples);
+                }
+                break;
+            }
+            case PlayoutDrain::NONE:
+                break;
+        }
+
+        int served = 0;
+        while (served < burstSamples) {
+            if (partialValid > 0) {
+                int n = std::min(burstSamples - served, partialValid - partialOffset);
+                served += n;
+                partialOffset += n;
+                if (partialOffset >= partialValid) partialOffset = partialValid = 0;
+                continue;
+            }
+            if (!ring.read(scratch.data(), frameSamples, &partialInfo)) break;
+            partialValid = frameSamples;
+            partialOffset = 0;
+            plcRun = 0;
+            int64_t playUs = t + outputUs + static_cast<int64_t>(served) * 1000 / SAMPLES_PER_MS;
+            int64_t sentUs = partialInfo.mediaSample * trace.frameUs + trace.minTransitUs;
+            latencySumUs += static_cast<double>(playUs - sentUs);
+            latencyCount++;
+        }
+
+        if (served < burstSamples && t <= endUs) {
+            int shortfall = burstSamples - served;
+            if (plcRun < plcMax) {
+                concealed += shortfall;
+                plcRun++;
+            } else {
+                silence += shortfall;
+            }
+        }
+        if (t > endUs && next >= count && ring.availableFrames() == 0) break;
+    }
+
+    double totalSamples = std::max<double>(1.0, samplesForUs(endUs - startUs));
+    double speechSamples = std::max<double>(1.0, static_cast<double>(count) * frameSamples);
+    Score s;
+    s.latencyMs = latencyCount ? latencySumUs / latencyCount / 1000.0 : 0;
+    s.underrunPct = 100.0 * silence / totalSamples;
+    s.plcPct = 100.0 * concealed / totalSamples;
+    s.dropPct = 100.0 * droppedSpeech / speechSamples;
+    s.glitchPct = 100.0 * glitchUs / std::max<double>(1.0, static_cast<double>(endUs - startUs));
+    s.cost = s.latencyMs + opt.wUnderrun * s.underrunPct + opt.wPlc * s.plcPct
+           + opt.wDrop * s.dropPct + opt.wGlitch * s.glitchPct;
+    return s;
+}
+
+/** Mean score over a profile's traces. */
+static Score evaluate(const std::vector<const Trace*>& traces, const PlayoutPolicy& policy,
+                      const Options& opt) {
+    Score sum;
+    for (const Trace* trace : traces) {
+        Score s = replay(*trace, policy, opt);
+        sum.latencyMs += s.latencyMs;
+        sum.underrunPct += s.underrunPct;
+        sum.plcPct += s.plcPct;
+        sum.dropPct += s.dropPct;
+        sum.glitchPct += s.glitchPct;
+        sum.cost += s.cost;
+    }
+    double n = static_cast<double>(traces.size());
+    sum.latencyMs /= n;
+    sum.underrunPct /= n;
+    sum.plcPct /= n;
+    sum.dropPct /= n;
+    sum.glitchPct /= n;
+    sum.cost /= n;
+    return sum;
+}
+
+static PlayoutPolicy tune(const std::vector<const Trace*>& traces, const Options& opt, Score* best) {
+    int frameMs = (traces.front()->frameUs + 999) / 1000;
+    PlayoutPolicy policy;
+    policy.prebufferMs = std::max(450, 2 * frameMs);  // LinkSource.computePrebufferMs()
+
+    std::vector<int> prebuffers;
+    int lo = std::max(10, (frameMs + 9) / 10 * 10);
+    int hi = std::min(PLAYOUT_PREBUFFER_MAX_MS, std::max(1000, 4 * frameMs));
+    for (int ms = lo; ms <= hi; ms += 10) prebuffers.push_back(ms);
+    const std::vector<int> drainPcts = {125, 150, 175, 200, 250, 300, 400};
+    const std::vector<int> softPcts = {0, 10, 25, 50, 75, 100};
+    const std::vector<int> plcRuns = {0, 1, 2, 3, 5, 8, 10, 15, 20, 30};
+    const std::vector<int> bursts = {1, 2, 3, 4};
+    bool anyLossy = std::any_of(traces.begin(), traces.end(), [](const Trace* t) { return t->lossy; });
+    bool anyClean = std::any_of(traces.begin(), traces.end(), [](const Trace* t) { return !t->lossy; });
+
+    struct Axis {
+        int PlayoutPolicy::*field;
+        const std::vector<int>* values;
+        bool active;
+    };
+    const Axis axes[] = {
+        {&PlayoutPolicy::prebufferMs, &prebuffers, true},
+        {&PlayoutPolicy::drainPct, &drainPcts, true},
+        {&PlayoutPolicy::softDropPct, &softPcts, true},
+        {&PlayoutPolicy::plcMaxCallbacks, &plcRuns, anyClean},
+        {&PlayoutPolicy::plcMaxCallbacksLossy, &plcRuns, anyLossy},
+        {&PlayoutPolicy::bufferBursts, &bursts, true},
+    };
+
+    *best = evaluate(traces, policy, opt);
+    for (int round = 0; round < 8; round++) {
+        bool changed = false;
+        for (const Axis& axis : axes) {
+            if (!axis.active) continue;
+            for (int v : *axis.values) {
+                if (policy.*axis.field == v) continue;
+                PlayoutPolicy candidate = policy;
+                candidate.*axis.field = v;
+                Score s = evaluate(traces, candidate, opt);
+                if (s.cost < best->cost) {
+                    *best = s;
+                    policy = candidate;
+                    changed = true;
+                }
+            }
+        }
+        if (!changed) break;
+    }
+    return policy;
+}
+
+static bool parseOption(const char* name, const char* value, Options* opt) {
+    if (!value) return false;
+    if (!std::strcmp(name, "--burst-us")) opt->burstUs = std::max(1, std::atoi(value));
+    else if (!std::strcmp(name, "--callback-jitter-us")) opt->callbackJitterUs = std::max(0, std::atoi(value));
+    else if (!std::strcmp(name, "--w-underrun")) opt->wUnderrun = std::atof(value);
+    else if (!std::strcmp(name, "--w-plc")) opt->wPlc = std::atof(value);
+    else if (!std::strcmp(name, "--w-drop")) opt->wDrop = std::atof(value);
+    else if (!std::strcmp(name, "--w-glitch")) opt->wGlitch = std::atof(value);
+    else return false;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    std::vector<Trace> traces;
+    for (int i = 1; i < argc; i++) {
+        if (!std::strncmp(argv[i], "--", 2)) {
+            if (!parseOption(argv[i], i + 1 < argc ? argv[i + 1] : nullptr, &opt)) {
+                std::fprintf(stderr, "Unknown option or missing value: %s\n", argv[i]);
+                return 2;
+            }
+            i++;
+            continue;
+        }
+        Trace trace;
+        if (!loadTrace(argv[i], &trace)) return 1;
+        traces.push_back(std::move(trace));
+    }
+    if (traces.empty()) {
+        std::fprintf(stderr, "Usage: %s [options] trace...\n", argv[0]);
+        return 2;
+    }
+
+    // A profile's traces must agree on the frame time
+    std::map<int, std::vector<const Trace*>> byProfile;
+    for (const Trace& trace : traces) {
+        auto& group = byProfile[trace.profile];
+        if (!group.empty() && group.front()->frameUs != trace.frameUs) {
+            std::fprintf(stderr, "%s: frame_us %d differs from %s (%d)\n", trace.path.c_str(),
+                         trace.frameUs, group.front()->path.c_str(), group.front()->frameUs);
+            return 1;
+        }
+        group.push_back(&trace);
+    }
+
+    std::printf("# LXST playout policy table (playout_tuner, %zu traces, burst %dus, jitter %dus)\n",
+                traces.size(), opt.burstUs, opt.callbackJitterUs);
+    std::printf("# profile prebuffer_ms drain_pct soft_drop_pct plc_max plc_max_lossy buffer_bursts\n");
+    for (const auto& [profile, group] : byProfile) {
+        Score score;
+        PlayoutPolicy p = tune(group, opt, &score);
+        std::printf("0x%02X %d %d %d %d %d %d  # traces=%zu cost=%.1f latency=%.1fms underrun=%.2f%% "
+                    "plc=%.2f%% drop=%.2f%% glitch=%.2f%%\n",
+                    profile, p.prebufferMs, p.drainPct, p.softDropPct, p.plcMaxCallbacks,
+                    p.plcMaxCallbacksLossy, p.bufferBursts, group.size(), score.cost,
+                    score.latencyMs, score.underrunPct, score.plcPct, score.dropPct, score.glitchPct);
+    }
+    return 0;
+}